@@ -9,4 +9,20 @@
 
 #define REG_LR_IDX 12
 
+#ifdef __arm__
+/*
+ * pthread keys are indices into the thread's TLS array (the same slots
+ * wrap.S reads with get_tls): the hot path reads and writes them directly
+ */
+#define HAVE_TLS_SLOTS
+
+static inline void **arch_tls_slots(void)
+{
+	void **tls;
+
+	asm volatile("mrc p15, 0, %0, c13, c0, 3" : "=r"(tls));
+	return tls;
+}
+#endif
+
 #endif
@@ -39,20 +39,34 @@
 #include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <linux/perf_event.h>
+
+#include "wtime_clock.h"
 
 #define MAX_FRAMES 5
 #define NAME_LEN 4096
 #define LINE_LEN 4096
 #define BUF_LEN 8192
+#define BOOT_ARENA_LEN (64 * 1024)
 #define MODE O_RDWR | O_CREAT,  S_IRWXU
 
 
+/*
+ * Touched on every call: initial-exec TLS is a fixed offset from the
+ * thread pointer (no __tls_get_addr), and as 'entered' is only ever
+ * changed by its own thread, it needs no atomics either.
+ */
+#define __hot_tls __attribute__((tls_model("initial-exec")))
+
 __thread char filename[NAME_LEN];
-__thread int thread_fd = -1;
-__thread unsigned int entered = 0;
-__thread char tmpbuf[BUF_LEN];
-__thread unsigned long tmppos = 0;
-__thread unsigned long tmpallocs = 0;
+__thread int thread_fd __hot_tls = -1;
+__thread unsigned int entered __hot_tls = 0;
+
+/* what each traced call logs: see TRACE_MODE in backtrace.c */
+#define TRACE_BT   0x1
+#define TRACE_TIME 0x2
+
+static int trace_mode = TRACE_BT | TRACE_TIME;
 
 static void * (*libc_calloc)(size_t, size_t);
 static void * (*temp_calloc)(size_t nmemb, size_t size);
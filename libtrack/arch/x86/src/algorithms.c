@@ -9,7 +9,7 @@ tdelete (const void *key, void **rootp, int (*compar)(const void *, const void *
         static void * (*fn)(const void *, void **,
                      int (*compar)(const void *, const void *));
 
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         if (fn == NULL)
             *(void**)(&fn) = dlsym(RTLD_NEXT, "tdelete");
         if (fn == NULL){
@@ -18,9 +18,9 @@ tdelete (const void *key, void **rootp, int (*compar)(const void *, const void *
         }
         if (entered == 1) {
             _backtrace();
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+            _gettime(&start);
             rval =  fn(key, rootp, compar);
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+            _gettime(&end);
             _timespec_sub(&end, &start);
             _logtime("tdelete", end);
         } else {
@@ -28,7 +28,7 @@ tdelete (const void *key, void **rootp, int (*compar)(const void *, const void *
         }
 
 out:
-        __sync_fetch_and_sub(&entered, 1);
+        entered--;
         return rval;
 }
 
@@ -39,7 +39,7 @@ qsort_r (void *base, size_t nmemb, size_t size, int (*compar)(const void *, cons
         static void (*fn)(void *base, size_t, size_t,
                    int (*compar)(const void *, const void *, void *), void *arg);
 
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         if (fn == NULL)
             *(void**)(&fn) = dlsym(RTLD_NEXT, "qsort_r");
         if (fn == NULL){
@@ -49,15 +49,15 @@ qsort_r (void *base, size_t nmemb, size_t size, int (*compar)(const void *, cons
         }
         if (entered == 1) {
             _backtrace();
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+            _gettime(&start);
             fn(base, nmemb, size, compar, arg);
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+            _gettime(&end);
             _timespec_sub(&end, &start);
         } else {
             fn(base, nmemb, size, compar, arg);
         }
 out:
-        __sync_fetch_and_sub(&entered, 1);
+        entered--;
         _logtime("qsort_r", end);
 }
 
@@ -68,7 +68,7 @@ qsort (void *base, size_t nmemb, size_t size, int (*compar)(const void *, const
         static void (*fn)(void *, size_t, size_t,
                    int (*compar)(const void *, const void *));
 
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         if (fn == NULL)
             *(void**)(&fn) = dlsym(RTLD_NEXT, "qsort");
         if (fn == NULL){
@@ -78,15 +78,15 @@ qsort (void *base, size_t nmemb, size_t size, int (*compar)(const void *, const
         }
         if (entered == 1) {
             _backtrace();
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+            _gettime(&start);
             fn(base, nmemb, size, compar);
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+            _gettime(&end);
             _timespec_sub(&end, &start);
         } else {
             fn(base, nmemb, size, compar);
         }
 out:
-        __sync_fetch_and_sub(&entered, 1);
+        entered--;
         _logtime("qsort", end);
 }
 
@@ -98,7 +98,7 @@ lsearch (const void *key, void *base, size_t *nmemb, size_t size, int(*compar)(c
         static void * (*fn)(const void *, void *, size_t *, size_t,
                     int(*compar)(const void *, const void *));
 
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         if (fn == NULL)
             *(void**)(&fn) = dlsym(RTLD_NEXT, "lsearch");
         if (fn == NULL){
@@ -108,16 +108,16 @@ lsearch (const void *key, void *base, size_t *nmemb, size_t size, int(*compar)(c
         }
         if (entered == 1) {
             _backtrace();
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+            _gettime(&start);
             rval = fn(key, base, nmemb, size, compar);
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+            _gettime(&end);
             _timespec_sub(&end, &start);
             _logtime("lsearch", end);
         } else {
             rval = fn(key, base, nmemb, size, compar);
         }
 out:
-        __sync_fetch_and_sub(&entered, 1);
+        entered--;
         return rval;
 }
 
@@ -129,7 +129,7 @@ lfind (const void *key, const void *base, size_t *nmemb, size_t size, int(*compa
         static void * (*fn)(const void *, void *, size_t *, size_t,
                      int(*compar)(const void *, const void *));
 
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         if (fn == NULL)
             *(void**)(&fn) = dlsym(RTLD_NEXT, "lfind");
         if (fn == NULL){
@@ -139,16 +139,16 @@ lfind (const void *key, const void *base, size_t *nmemb, size_t size, int(*compa
         }
         if (entered == 1) {
             _backtrace();
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+            _gettime(&start);
             rval = fn(key, base, nmemb, size, compar);
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+            _gettime(&end);
             _timespec_sub(&end, &start);
             _logtime("lfind", end);
         } else {
              rval = fn(key, base, nmemb, size, compar);
         }
 out:
-        __sync_fetch_and_sub(&entered, 1);
+        entered--;
         return rval;
 }
 
@@ -160,7 +160,7 @@ bsearch (const void *key, const void *base, size_t nmemb, size_t size, int (*com
         static void * (*fn)(const void *, void *, size_t *, size_t,
                      int(*compar)(const void *, const void *));
 
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         if (fn == NULL)
             *(void**)(&fn) = dlsym(RTLD_NEXT, "bsearch");
         if (fn == NULL){
@@ -170,16 +170,16 @@ bsearch (const void *key, const void *base, size_t nmemb, size_t size, int (*com
         }
         if (entered == 1) {
             _backtrace();
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+            _gettime(&start);
             rval = fn(key, base, nmemb, size, compar);
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+            _gettime(&end);
             _timespec_sub(&end, &start);
             _logtime("bsearch", end);
         } else {
             rval = fn(key, base, nmemb, size, compar);
         }
 out:
-        __sync_fetch_and_sub(&entered, 1);
+        entered--;
         return rval;
 }
 
@@ -188,7 +188,7 @@ hcreate_r (size_t nel, struct hsearch_data *htab)
 {
        struct timespec start, end;
        static int  (*fn)(size_t , struct hsearch_data *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "hcreate_r");
        if (fn == NULL){
@@ -198,16 +198,16 @@ hcreate_r (size_t nel, struct hsearch_data *htab)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(nel, htab);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("hcreate_r", end);
        } else {
                rval = fn(nel, htab);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -216,7 +216,7 @@ hcreate (size_t nel)
 {
        struct timespec start, end;
        static int  (*fn)(size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "hcreate");
        if (fn == NULL){
@@ -226,16 +226,16 @@ hcreate (size_t nel)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(nel);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("hcreate", end);
        } else {
                rval = fn(nel);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -244,7 +244,7 @@ hsearch_r (ENTRY item, ACTION action, ENTRY **retval, struct hsearch_data *htab)
 {
        struct timespec start, end;
        static int  (*fn)(ENTRY , ACTION , ENTRY **, struct hsearch_data *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "hsearch_r");
        if (fn == NULL){
@@ -254,16 +254,16 @@ hsearch_r (ENTRY item, ACTION action, ENTRY **retval, struct hsearch_data *htab)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(item, action, retval, htab);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("hsearch_r", end);
        } else {
                rval = fn(item, action, retval, htab);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -272,7 +272,7 @@ hdestroy_r (struct hsearch_data *htab)
 {
        struct timespec start, end;
        static void  (*fn)(struct hsearch_data *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "hdestroy_r");
        if (fn == NULL){
@@ -281,16 +281,16 @@ hdestroy_r (struct hsearch_data *htab)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(htab);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("hdestroy_r", end);
        } else {
                fn(htab);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -298,7 +298,7 @@ hdestroy (void)
 {
        struct timespec start, end;
        static void  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "hdestroy");
        if (fn == NULL){
@@ -307,16 +307,16 @@ hdestroy (void)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("hdestroy", end);
        } else {
                fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 /*
  * End of Algorithms
@@ -6,7 +6,7 @@ uname (struct utsname *buf)
 {
        struct timespec start, end;
        static int  (*fn)(struct utsname *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "uname");
        if (fn == NULL){
@@ -16,16 +16,16 @@ uname (struct utsname *buf)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(buf);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("uname", end);
        } else {
                rval = fn(buf);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -34,7 +34,7 @@ putenv (char *string)
 {
        struct timespec start, end;
        static int  (*fn)(char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "putenv");
        if (fn == NULL){
@@ -44,16 +44,16 @@ putenv (char *string)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(string);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("putenv", end);
        } else {
                rval = fn(string);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -62,7 +62,7 @@ nl_langinfo (nl_item item)
 {
        struct timespec start, end;
        static char * (*fn)(nl_item );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "nl_langinfo");
        if (fn == NULL){
@@ -72,16 +72,16 @@ nl_langinfo (nl_item item)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(item);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("nl_langinfo", end);
        } else {
                rval = fn(item);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -90,7 +90,7 @@ setlocale (int category, const char *locale)
 {
        struct timespec start, end;
        static char * (*fn)(int , const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setlocale");
        if (fn == NULL){
@@ -100,16 +100,16 @@ setlocale (int category, const char *locale)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(category, locale);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setlocale", end);
        } else {
                rval = fn(category, locale);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -118,7 +118,7 @@ getsubopt (char **optionp, char * const *tokens, char **valuep)
 {
        struct timespec start, end;
        static int  (*fn)(char **, char * const *, char **);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getsubopt");
        if (fn == NULL){
@@ -128,16 +128,16 @@ getsubopt (char **optionp, char * const *tokens, char **valuep)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(optionp, tokens, valuep);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getsubopt", end);
        } else {
                rval = fn(optionp, tokens, valuep);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -146,7 +146,7 @@ getopt (int argc, char * const argv[], const char *optstring)
 {
        struct timespec start, end;
        static int  (*fn)(int , char * const , const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getopt");
        if (fn == NULL){
@@ -156,16 +156,16 @@ getopt (int argc, char * const argv[], const char *optstring)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(argc, argv, optstring);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getopt", end);
        } else {
                rval = fn(argc, argv, optstring);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -174,7 +174,7 @@ getenv (const char *name)
 {
        struct timespec start, end;
        static char * (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getenv");
        if (fn == NULL){
@@ -184,16 +184,16 @@ getenv (const char *name)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getenv", end);
        } else {
                rval = fn(name);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 	
@@ -202,7 +202,7 @@ unsetenv (const char *name)
 {
        struct timespec start, end;
        static int  (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "unsetenv");
        if (fn == NULL){
@@ -212,16 +212,16 @@ unsetenv (const char *name)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("unsetenv", end);
        } else {
                rval = fn(name);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -230,7 +230,7 @@ setenv (const char *name, const char *value, int overwrite)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, const char *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setenv");
        if (fn == NULL){
@@ -240,16 +240,16 @@ setenv (const char *name, const char *value, int overwrite)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name, value, overwrite);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setenv", end);
        } else {
                rval = fn(name, value, overwrite);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 /*
@@ -3,6 +3,30 @@
  * creating log-files. It writes unwond stack frames in a
  * per-thread private log-file, named "__progname.pid.tid".
  */
+
+/*
+ * TRACE_MODE=none still goes through every wrapper, but logs nothing,
+ * TRACE_MODE=time only logs timing, TRACE_MODE=bt (the default) logs
+ * timing and backtraces, TRACE_MODE=btonly backtraces without timing.
+ */
+static void __attribute__((constructor))
+_init_trace_mode (void)
+{
+	const char *mode;
+
+	entered++;
+	mode = getenv("TRACE_MODE");
+	if (mode && strcmp(mode, "none") == 0)
+		trace_mode = 0;
+	else if (mode && strcmp(mode, "time") == 0)
+		trace_mode = TRACE_TIME;
+	else if (mode && strcmp(mode, "bt") == 0)
+		trace_mode = TRACE_BT | TRACE_TIME;
+	else if (mode && strcmp(mode, "btonly") == 0)
+		trace_mode = TRACE_BT;
+	entered--;
+}
+
 void _backtrace()
 {
 	int rval;
@@ -11,6 +35,9 @@ void _backtrace()
 	char line[LINE_LEN];
 	void *frames[MAX_FRAMES];
 
+	if (!(trace_mode & TRACE_BT))
+		return;
+
 	static ssize_t (*libc_perror)(const char *s);
 	if (libc_perror == NULL) {
 		*(void **)(&libc_perror) = dlsym(RTLD_NEXT, "perror");
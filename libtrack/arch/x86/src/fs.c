@@ -6,7 +6,7 @@ chdir (const char *path)
 {
        struct timespec start, end;
        static int  (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "chdir");
        if (fn == NULL){
@@ -16,16 +16,16 @@ chdir (const char *path)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(path);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("chdir", end);
        } else {
                rval = fn(path);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -34,7 +34,7 @@ mkdir (const char *pathname, mode_t mode)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, mode_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mkdir");
        if (fn == NULL){
@@ -44,16 +44,16 @@ mkdir (const char *pathname, mode_t mode)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pathname, mode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mkdir", end);
        } else {
                rval = fn(pathname, mode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -62,7 +62,7 @@ catgets (nl_catd catalog, int set_number, int message_number, const char *messag
 {
        struct timespec start, end;
        static char * (*fn)(nl_catd , int , int , const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "catgets");
        if (fn == NULL){
@@ -72,16 +72,16 @@ catgets (nl_catd catalog, int set_number, int message_number, const char *messag
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(catalog, set_number, message_number, message);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("catgets", end);
        } else {
                rval = fn(catalog, set_number, message_number, message);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 char *
@@ -89,7 +89,7 @@ dirname (char *path)
 {
        struct timespec start, end;
        static char * (*fn)(char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "dirname");
        if (fn == NULL){
@@ -99,16 +99,16 @@ dirname (char *path)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(path);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("dirname", end);
        } else {
                rval = fn(path);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -117,7 +117,7 @@ fgets (char *s, int size, FILE *stream)
 {
        struct timespec start, end;
        static char * (*fn)(char *, int , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fgets");
        if (fn == NULL){
@@ -127,16 +127,16 @@ fgets (char *s, int size, FILE *stream)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(s, size, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fgets", end);
        } else {
                rval = fn(s, size, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -145,7 +145,7 @@ fgets_unlocked (char *s, int n, FILE *stream)
 {
        struct timespec start, end;
        static char * (*fn)(char *, int , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fgets_unlocked");
        if (fn == NULL){
@@ -155,16 +155,16 @@ fgets_unlocked (char *s, int n, FILE *stream)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(s, n, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fgets_unlocked", end);
        } else {
                rval = fn(s, n, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -173,7 +173,7 @@ get_current_dir_name (void)
 {
        struct timespec start, end;
        static char * (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "get_current_dir_name");
        if (fn == NULL){
@@ -183,16 +183,16 @@ get_current_dir_name (void)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("get_current_dir_name", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -201,7 +201,7 @@ getcwd (char *buf, size_t size)
 {
        struct timespec start, end;
        static char * (*fn)(char *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getcwd");
        if (fn == NULL){
@@ -211,16 +211,16 @@ getcwd (char *buf, size_t size)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(buf, size);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getcwd", end);
        } else {
                rval = fn(buf, size);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -229,7 +229,7 @@ gets (char *s)
 {
        struct timespec start, end;
        static char * (*fn)(char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "gets");
        if (fn == NULL){
@@ -239,16 +239,16 @@ gets (char *s)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(s);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("gets", end);
        } else {
                rval = fn(s);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -257,7 +257,7 @@ getwd (char *buf)
 {
        struct timespec start, end;
        static char * (*fn)(char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getwd");
        if (fn == NULL){
@@ -267,16 +267,16 @@ getwd (char *buf)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(buf);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getwd", end);
        } else {
                rval = fn(buf);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -285,7 +285,7 @@ mkdtemp (char *template)
 {
        struct timespec start, end;
        static char * (*fn)(char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mkdtemp");
        if (fn == NULL){
@@ -295,16 +295,16 @@ mkdtemp (char *template)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(template);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mkdtemp", end);
        } else {
                rval = fn(template);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -313,7 +313,7 @@ fdopendir (int fd)
 {
        struct timespec start, end;
        static DIR * (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fdopendir");
        if (fn == NULL){
@@ -323,16 +323,16 @@ fdopendir (int fd)
        DIR * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fdopendir", end);
        } else {
                rval = fn(fd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -341,7 +341,7 @@ opendir (const char *name)
 {
        struct timespec start, end;
        static DIR * (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "opendir");
        if (fn == NULL){
@@ -351,16 +351,16 @@ opendir (const char *name)
        DIR * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("opendir", end);
        } else {
                rval = fn(name);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -369,7 +369,7 @@ fdopen (int fd, const char *mode)
 {
        struct timespec start, end;
        static FILE * (*fn)(int , const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fdopen");
        if (fn == NULL){
@@ -379,16 +379,16 @@ fdopen (int fd, const char *mode)
        FILE * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, mode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fdopen", end);
        } else {
                rval = fn(fd, mode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -397,7 +397,7 @@ fmemopen (void *buf, size_t size, const char *mode)
 {
        struct timespec start, end;
        static FILE * (*fn)(void *, size_t , const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fmemopen");
        if (fn == NULL){
@@ -407,16 +407,16 @@ fmemopen (void *buf, size_t size, const char *mode)
        FILE * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(buf, size, mode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fmemopen", end);
        } else {
                rval = fn(buf, size, mode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -425,7 +425,7 @@ fopen (const char *path, const char *mode)
 {
        struct timespec start, end;
        static FILE * (*fn)(const char *, const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fopen");
        if (fn == NULL){
@@ -435,16 +435,16 @@ fopen (const char *path, const char *mode)
        FILE * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(path, mode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fopen", end);
        } else {
                rval = fn(path, mode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -453,7 +453,7 @@ freopen (const char *path, const char *mode, FILE *stream)
 {
        struct timespec start, end;
        static FILE * (*fn)(const char *, const char *, FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "freopen");
        if (fn == NULL){
@@ -463,16 +463,16 @@ freopen (const char *path, const char *mode, FILE *stream)
        FILE * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(path, mode, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("freopen", end);
        } else {
                rval = fn(path, mode, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -481,7 +481,7 @@ popen (const char *command, const char *type)
 {
        struct timespec start, end;
        static FILE * (*fn)(const char *, const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "popen");
        if (fn == NULL){
@@ -491,16 +491,16 @@ popen (const char *command, const char *type)
        FILE * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(command, type);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("popen", end);
        } else {
                rval = fn(command, type);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -509,7 +509,7 @@ tmpfile (void)
 {
        struct timespec start, end;
        static FILE * (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "tmpfile");
        if (fn == NULL){
@@ -519,16 +519,16 @@ tmpfile (void)
        FILE * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("tmpfile", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -537,7 +537,7 @@ access (const char *pathname, int mode)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "access");
        if (fn == NULL){
@@ -547,16 +547,16 @@ access (const char *pathname, int mode)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pathname, mode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("access", end);
        } else {
                rval = fn(pathname, mode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -565,7 +565,7 @@ aio_cancel (int fd, struct aiocb *aiocbp)
 {
        struct timespec start, end;
        static int  (*fn)(int , struct aiocb *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "aio_cancel");
        if (fn == NULL){
@@ -575,16 +575,16 @@ aio_cancel (int fd, struct aiocb *aiocbp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, aiocbp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("aio_cancel", end);
        } else {
                rval = fn(fd, aiocbp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -593,7 +593,7 @@ aio_error (const struct aiocb *aiocbp)
 {
        struct timespec start, end;
        static int  (*fn)(const struct aiocb *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "aio_error");
        if (fn == NULL){
@@ -603,16 +603,16 @@ aio_error (const struct aiocb *aiocbp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(aiocbp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("aio_error", end);
        } else {
                rval = fn(aiocbp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -621,7 +621,7 @@ aio_fsync (int op, struct aiocb *aiocbp)
 {
        struct timespec start, end;
        static int  (*fn)(int , struct aiocb *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "aio_fsync");
        if (fn == NULL){
@@ -631,16 +631,16 @@ aio_fsync (int op, struct aiocb *aiocbp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(op, aiocbp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("aio_fsync", end);
        } else {
                rval = fn(op, aiocbp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -649,7 +649,7 @@ aio_read (struct aiocb *aiocbp)
 {
        struct timespec start, end;
        static int  (*fn)(struct aiocb *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "aio_read");
        if (fn == NULL){
@@ -659,16 +659,16 @@ aio_read (struct aiocb *aiocbp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(aiocbp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("aio_read", end);
        } else {
                rval = fn(aiocbp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -677,7 +677,7 @@ aio_suspend (const struct aiocb * const aiocb_list[], int nitems, const struct t
 {
        struct timespec start, end;
        static int  (*fn)(const struct aiocb * const , int , const struct timespec *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "aio_suspend");
        if (fn == NULL){
@@ -687,16 +687,16 @@ aio_suspend (const struct aiocb * const aiocb_list[], int nitems, const struct t
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(aiocb_list, nitems, timeout);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("aio_suspend", end);
        } else {
                rval = fn(aiocb_list, nitems, timeout);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -705,7 +705,7 @@ aio_write (struct aiocb *aiocbp)
 {
        struct timespec start, end;
        static int  (*fn)(struct aiocb *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "aio_write");
        if (fn == NULL){
@@ -715,16 +715,16 @@ aio_write (struct aiocb *aiocbp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(aiocbp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("aio_write", end);
        } else {
                rval = fn(aiocbp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -733,7 +733,7 @@ atoi (const char *nptr)
 {
        struct timespec start, end;
        static int  (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "atoi");
        if (fn == NULL){
@@ -743,16 +743,16 @@ atoi (const char *nptr)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(nptr);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("atoi", end);
        } else {
                rval = fn(nptr);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -761,7 +761,7 @@ catclose (nl_catd catalog)
 {
        struct timespec start, end;
        static int  (*fn)(nl_catd );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "catclose");
        if (fn == NULL){
@@ -771,16 +771,16 @@ catclose (nl_catd catalog)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(catalog);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("catclose", end);
        } else {
                rval = fn(catalog);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -789,7 +789,7 @@ chmod (const char *path, mode_t mode)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, mode_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "chmod");
        if (fn == NULL){
@@ -799,16 +799,16 @@ chmod (const char *path, mode_t mode)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(path, mode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("chmod", end);
        } else {
                rval = fn(path, mode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -817,7 +817,7 @@ chown (const char *path, uid_t owner, gid_t group)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, uid_t , gid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "chown");
        if (fn == NULL){
@@ -827,16 +827,16 @@ chown (const char *path, uid_t owner, gid_t group)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(path, owner, group);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("chown", end);
        } else {
                rval = fn(path, owner, group);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -845,7 +845,7 @@ closedir (DIR *dirp)
 {
        struct timespec start, end;
        static int  (*fn)(DIR *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "closedir");
        if (fn == NULL){
@@ -855,16 +855,16 @@ closedir (DIR *dirp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dirp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("closedir", end);
        } else {
                rval = fn(dirp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -873,7 +873,7 @@ close (int fd)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "close");
        if (fn == NULL){
@@ -883,16 +883,16 @@ close (int fd)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("close", end);
        } else {
                rval = fn(fd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -901,7 +901,7 @@ creat (const char *pathname, mode_t mode)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, mode_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "creat");
        if (fn == NULL){
@@ -911,16 +911,16 @@ creat (const char *pathname, mode_t mode)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pathname, mode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("creat", end);
        } else {
                rval = fn(pathname, mode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -929,7 +929,7 @@ dirfd (DIR *dirp)
 {
        struct timespec start, end;
        static int  (*fn)(DIR *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "dirfd");
        if (fn == NULL){
@@ -939,16 +939,16 @@ dirfd (DIR *dirp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dirp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("dirfd", end);
        } else {
                rval = fn(dirp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -957,7 +957,7 @@ dup2 (int oldfd, int newfd)
 {
        struct timespec start, end;
        static int  (*fn)(int, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "dup2");
        if (fn == NULL){
@@ -967,16 +967,16 @@ dup2 (int oldfd, int newfd)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(oldfd, newfd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("dup2", end);
        } else {
                rval = fn(oldfd, newfd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -985,7 +985,7 @@ dup (int oldfd)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "dup");
        if (fn == NULL){
@@ -995,16 +995,16 @@ dup (int oldfd)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(oldfd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("dup", end);
        } else {
                rval = fn(oldfd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1013,7 +1013,7 @@ faccessat (int dirfd, const char *pathname, int mode, int flags)
 {
        struct timespec start, end;
        static int  (*fn)(int , const char *, int , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "faccessat");
        if (fn == NULL){
@@ -1023,16 +1023,16 @@ faccessat (int dirfd, const char *pathname, int mode, int flags)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dirfd, pathname, mode, flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("faccessat", end);
        } else {
                rval = fn(dirfd, pathname, mode, flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1041,7 +1041,7 @@ fchdir (int fd)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fchdir");
        if (fn == NULL){
@@ -1051,16 +1051,16 @@ fchdir (int fd)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fchdir", end);
        } else {
                rval = fn(fd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1069,7 +1069,7 @@ fchmodat (int dirfd, const char *pathname, mode_t mode, int flags)
 {
        struct timespec start, end;
        static int  (*fn)(int , const char *, mode_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fchmodat");
        if (fn == NULL){
@@ -1079,16 +1079,16 @@ fchmodat (int dirfd, const char *pathname, mode_t mode, int flags)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dirfd, pathname, mode, flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fchmodat", end);
        } else {
                rval = fn(dirfd, pathname, mode, flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1097,7 +1097,7 @@ fchmod (int fd, mode_t mode)
 {
        struct timespec start, end;
        static int  (*fn)(int , mode_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fchmod");
        if (fn == NULL){
@@ -1107,16 +1107,16 @@ fchmod (int fd, mode_t mode)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, mode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fchmod", end);
        } else {
                rval = fn(fd, mode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1125,7 +1125,7 @@ fchownat (int dirfd, const char *pathname, uid_t owner, gid_t group, int flags)
 {
        struct timespec start, end;
        static int  (*fn)(int , const char *, uid_t , gid_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fchownat");
        if (fn == NULL){
@@ -1135,16 +1135,16 @@ fchownat (int dirfd, const char *pathname, uid_t owner, gid_t group, int flags)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dirfd, pathname, owner, group, flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fchownat", end);
        } else {
                rval = fn(dirfd, pathname, owner, group, flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1153,7 +1153,7 @@ fchown (int fd, uid_t owner, gid_t group)
 {
        struct timespec start, end;
        static int  (*fn)(int , uid_t , gid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fchown");
        if (fn == NULL){
@@ -1163,16 +1163,16 @@ fchown (int fd, uid_t owner, gid_t group)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, owner, group);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fchown", end);
        } else {
                rval = fn(fd, owner, group);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1181,7 +1181,7 @@ fclose (FILE *fp)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fclose");
        if (fn == NULL){
@@ -1191,16 +1191,16 @@ fclose (FILE *fp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fclose", end);
        } else {
                rval = fn(fp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1209,7 +1209,7 @@ fdatasync (int fd)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fdatasync");
        if (fn == NULL){
@@ -1219,16 +1219,16 @@ fdatasync (int fd)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fdatasync", end);
        } else {
                rval = fn(fd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1237,7 +1237,7 @@ feof (FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "feof");
        if (fn == NULL){
@@ -1247,16 +1247,16 @@ feof (FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("feof", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1265,7 +1265,7 @@ feof_unlocked (FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "feof_unlocked");
        if (fn == NULL){
@@ -1275,16 +1275,16 @@ feof_unlocked (FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("feof_unlocked", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1293,7 +1293,7 @@ fflush (FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fflush");
        if (fn == NULL){
@@ -1303,16 +1303,16 @@ fflush (FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fflush", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1321,7 +1321,7 @@ fflush_unlocked (FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fflush_unlocked");
        if (fn == NULL){
@@ -1331,16 +1331,16 @@ fflush_unlocked (FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fflush_unlocked", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1349,7 +1349,7 @@ ffs (int i)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ffs");
        if (fn == NULL){
@@ -1359,16 +1359,16 @@ ffs (int i)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(i);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ffs", end);
        } else {
                rval = fn(i);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1377,7 +1377,7 @@ ffsll (long long int i)
 {
        struct timespec start, end;
        static int  (*fn)(long long int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ffsll");
        if (fn == NULL){
@@ -1387,16 +1387,16 @@ ffsll (long long int i)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(i);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ffsll", end);
        } else {
                rval = fn(i);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1405,7 +1405,7 @@ ffsl (long int i)
 {
        struct timespec start, end;
        static int  (*fn)(long int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ffsl");
        if (fn == NULL){
@@ -1415,16 +1415,16 @@ ffsl (long int i)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(i);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ffsl", end);
        } else {
                rval = fn(i);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1433,7 +1433,7 @@ fgetc (FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fgetc");
        if (fn == NULL){
@@ -1443,16 +1443,16 @@ fgetc (FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fgetc", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1461,7 +1461,7 @@ fgetc_unlocked (FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fgetc_unlocked");
        if (fn == NULL){
@@ -1471,16 +1471,16 @@ fgetc_unlocked (FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fgetc_unlocked", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1489,7 +1489,7 @@ fgetpos (FILE *stream, fpos_t *pos)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *, fpos_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fgetpos");
        if (fn == NULL){
@@ -1499,16 +1499,16 @@ fgetpos (FILE *stream, fpos_t *pos)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream, pos);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fgetpos", end);
        } else {
                rval = fn(stream, pos);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1517,7 +1517,7 @@ fileno (FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fileno");
        if (fn == NULL){
@@ -1527,16 +1527,16 @@ fileno (FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fileno", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1545,7 +1545,7 @@ fileno_unlocked (FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fileno_unlocked");
        if (fn == NULL){
@@ -1555,16 +1555,16 @@ fileno_unlocked (FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fileno_unlocked", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1573,7 +1573,7 @@ fputc (int c, FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(int , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fputc");
        if (fn == NULL){
@@ -1583,16 +1583,16 @@ fputc (int c, FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(c, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fputc", end);
        } else {
                rval = fn(c, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1601,7 +1601,7 @@ fputc_unlocked (int c, FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(int , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fputc_unlocked");
        if (fn == NULL){
@@ -1611,16 +1611,16 @@ fputc_unlocked (int c, FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(c, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fputc_unlocked", end);
        } else {
                rval = fn(c, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1629,7 +1629,7 @@ fputs (const char *s, FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fputs");
        if (fn == NULL){
@@ -1639,16 +1639,16 @@ fputs (const char *s, FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(s, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fputs", end);
        } else {
                rval = fn(s, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1657,7 +1657,7 @@ fputs_unlocked (const char *s, FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fputs_unlocked");
        if (fn == NULL){
@@ -1667,16 +1667,16 @@ fputs_unlocked (const char *s, FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(s, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fputs_unlocked", end);
        } else {
                rval = fn(s, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1685,7 +1685,7 @@ fputws (const wchar_t *ws, FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(const wchar_t *, FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fputws");
        if (fn == NULL){
@@ -1695,16 +1695,16 @@ fputws (const wchar_t *ws, FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ws, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fputws", end);
        } else {
                rval = fn(ws, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1713,7 +1713,7 @@ fputws_unlocked (const wchar_t *ws, FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(const wchar_t *, FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fputws_unlocked");
        if (fn == NULL){
@@ -1723,16 +1723,16 @@ fputws_unlocked (const wchar_t *ws, FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ws, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fputws_unlocked", end);
        } else {
                rval = fn(ws, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1741,7 +1741,7 @@ fseek (FILE *stream, long offset, int whence)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *, long , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fseek");
        if (fn == NULL){
@@ -1751,16 +1751,16 @@ fseek (FILE *stream, long offset, int whence)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream, offset, whence);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fseek", end);
        } else {
                rval = fn(stream, offset, whence);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1769,7 +1769,7 @@ fseeko (FILE *stream, off_t offset, int whence)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *, off_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fseeko");
        if (fn == NULL){
@@ -1779,16 +1779,16 @@ fseeko (FILE *stream, off_t offset, int whence)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream, offset, whence);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fseeko", end);
        } else {
                rval = fn(stream, offset, whence);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1797,7 +1797,7 @@ fstatvfs (int fd, struct statvfs *buf)
 {
        struct timespec start, end;
        static int  (*fn)(int , struct statvfs *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fstatvfs");
        if (fn == NULL){
@@ -1807,16 +1807,16 @@ fstatvfs (int fd, struct statvfs *buf)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, buf);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fstatvfs", end);
        } else {
                rval = fn(fd, buf);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1825,7 +1825,7 @@ fsync (int fd)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fsync");
        if (fn == NULL){
@@ -1835,16 +1835,16 @@ fsync (int fd)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fsync", end);
        } else {
                rval = fn(fd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1853,7 +1853,7 @@ ftruncate (int fd, off_t length)
 {
        struct timespec start, end;
        static int  (*fn)(int , off_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ftruncate");
        if (fn == NULL){
@@ -1863,16 +1863,16 @@ ftruncate (int fd, off_t length)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, length);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ftruncate", end);
        } else {
                rval = fn(fd, length);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1881,7 +1881,7 @@ ftrylockfile (FILE *filehandle)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ftrylockfile");
        if (fn == NULL){
@@ -1891,16 +1891,16 @@ ftrylockfile (FILE *filehandle)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(filehandle);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ftrylockfile", end);
        } else {
                rval = fn(filehandle);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1909,7 +1909,7 @@ futimens (int fd, const struct timespec times[2])
 {
        struct timespec start, end;
        static int  (*fn)(int , const struct timespec times[2]);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "futimens");
        if (fn == NULL){
@@ -1919,16 +1919,16 @@ futimens (int fd, const struct timespec times[2])
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, times);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("futimens", end);
        } else {
                rval = fn(fd, times);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1937,7 +1937,7 @@ fwide (FILE *stream, int mode)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fwide");
        if (fn == NULL){
@@ -1947,16 +1947,16 @@ fwide (FILE *stream, int mode)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream, mode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fwide", end);
        } else {
                rval = fn(stream, mode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1965,7 +1965,7 @@ getc (FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getc");
        if (fn == NULL){
@@ -1975,16 +1975,16 @@ getc (FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getc", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1993,7 +1993,7 @@ getchar_unlocked (void)
 {
        struct timespec start, end;
        static int  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getchar_unlocked");
        if (fn == NULL){
@@ -2003,16 +2003,16 @@ getchar_unlocked (void)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getchar_unlocked", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -2021,7 +2021,7 @@ getchar (void)
 {
        struct timespec start, end;
        static int  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getchar");
        if (fn == NULL){
@@ -2031,16 +2031,16 @@ getchar (void)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getchar", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -2049,7 +2049,7 @@ getc_unlocked (FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getc_unlocked");
        if (fn == NULL){
@@ -2059,16 +2059,16 @@ getc_unlocked (FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getc_unlocked", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2077,7 +2077,7 @@ klogctl (int type, char *bufp, int len)
 {
        struct timespec start, end;
        static int  (*fn)(int , char *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "klogctl");
        if (fn == NULL){
@@ -2087,16 +2087,16 @@ klogctl (int type, char *bufp, int len)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(type, bufp, len);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("klogctl", end);
        } else {
                rval = fn(type, bufp, len);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2105,7 +2105,7 @@ lchown (const char *path, uid_t owner, gid_t group)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, uid_t , gid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "lchown");
        if (fn == NULL){
@@ -2115,16 +2115,16 @@ lchown (const char *path, uid_t owner, gid_t group)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(path, owner, group);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("lchown", end);
        } else {
                rval = fn(path, owner, group);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2133,7 +2133,7 @@ linkat (int olddirfd, const char *oldpath, int newdirfd, const char *newpath, in
 {
        struct timespec start, end;
        static int  (*fn)(int , const char *, int , const char *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "linkat");
        if (fn == NULL){
@@ -2143,16 +2143,16 @@ linkat (int olddirfd, const char *oldpath, int newdirfd, const char *newpath, in
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(olddirfd, oldpath, newdirfd, newpath, flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("linkat", end);
        } else {
                rval = fn(olddirfd, oldpath, newdirfd, newpath, flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2161,7 +2161,7 @@ link (const char *oldpath, const char *newpath)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "link");
        if (fn == NULL){
@@ -2171,16 +2171,16 @@ link (const char *oldpath, const char *newpath)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(oldpath, newpath);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("link", end);
        } else {
                rval = fn(oldpath, newpath);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2189,7 +2189,7 @@ lio_listio (int mode, struct aiocb *const aiocb_list[], int nitems, struct sigev
 {
        struct timespec start, end;
        static int  (*fn)(int , struct aiocb *const , int , struct sigevent *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "lio_listio");
        if (fn == NULL){
@@ -2199,16 +2199,16 @@ lio_listio (int mode, struct aiocb *const aiocb_list[], int nitems, struct sigev
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(mode, aiocb_list, nitems, sevp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("lio_listio", end);
        } else {
                rval = fn(mode, aiocb_list, nitems, sevp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2217,7 +2217,7 @@ lockf (int fd, int cmd, off_t len)
 {
        struct timespec start, end;
        static int  (*fn)(int , int , off_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "lockf");
        if (fn == NULL){
@@ -2227,16 +2227,16 @@ lockf (int fd, int cmd, off_t len)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, cmd, len);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("lockf", end);
        } else {
                rval = fn(fd, cmd, len);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2245,7 +2245,7 @@ lstat (const char *path, struct stat *buf)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, struct stat *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "lstat");
        if (fn == NULL){
@@ -2255,16 +2255,16 @@ lstat (const char *path, struct stat *buf)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(path, buf);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("lstat", end);
        } else {
                rval = fn(path, buf);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2273,7 +2273,7 @@ mkdirat (int dirfd, const char *pathname, mode_t mode)
 {
        struct timespec start, end;
        static int  (*fn)(int , const char *, mode_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mkdirat");
        if (fn == NULL){
@@ -2283,16 +2283,16 @@ mkdirat (int dirfd, const char *pathname, mode_t mode)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dirfd, pathname, mode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mkdirat", end);
        } else {
                rval = fn(dirfd, pathname, mode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2301,7 +2301,7 @@ mkfifoat (int dirfd, const char *pathname, mode_t mode)
 {
        struct timespec start, end;
        static int  (*fn)(int , const char *, mode_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mkfifoat");
        if (fn == NULL){
@@ -2311,16 +2311,16 @@ mkfifoat (int dirfd, const char *pathname, mode_t mode)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dirfd, pathname, mode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mkfifoat", end);
        } else {
                rval = fn(dirfd, pathname, mode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2329,7 +2329,7 @@ mkfifo (const char *pathname, mode_t mode)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, mode_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mkfifo");
        if (fn == NULL){
@@ -2339,16 +2339,16 @@ mkfifo (const char *pathname, mode_t mode)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pathname, mode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mkfifo", end);
        } else {
                rval = fn(pathname, mode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2357,7 +2357,7 @@ mknodat (int dirfd, const char *pathname, mode_t mode, dev_t dev)
 {
        struct timespec start, end;
        static int  (*fn)(int , const char *, mode_t , dev_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mknodat");
        if (fn == NULL){
@@ -2367,16 +2367,16 @@ mknodat (int dirfd, const char *pathname, mode_t mode, dev_t dev)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dirfd, pathname, mode, dev);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mknodat", end);
        } else {
                rval = fn(dirfd, pathname, mode, dev);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2385,7 +2385,7 @@ mknod (const char *pathname, mode_t mode, dev_t dev)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, mode_t , dev_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mknod");
        if (fn == NULL){
@@ -2395,16 +2395,16 @@ mknod (const char *pathname, mode_t mode, dev_t dev)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pathname, mode, dev);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mknod", end);
        } else {
                rval = fn(pathname, mode, dev);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2413,7 +2413,7 @@ mkostemps (char *template, int suffixlen, int flags)
 {
        struct timespec start, end;
        static int  (*fn)(char *, int , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mkostemps");
        if (fn == NULL){
@@ -2423,16 +2423,16 @@ mkostemps (char *template, int suffixlen, int flags)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(template, suffixlen, flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mkostemps", end);
        } else {
                rval = fn(template, suffixlen, flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2441,7 +2441,7 @@ pclose (FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pclose");
        if (fn == NULL){
@@ -2451,16 +2451,16 @@ pclose (FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pclose", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2469,7 +2469,7 @@ poll (struct pollfd *fds, nfds_t nfds, int timeout)
 {
        struct timespec start, end;
        static int  (*fn)(struct pollfd *, nfds_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "poll");
        if (fn == NULL){
@@ -2479,16 +2479,16 @@ poll (struct pollfd *fds, nfds_t nfds, int timeout)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fds, nfds, timeout);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("poll", end);
        } else {
                rval = fn(fds, nfds, timeout);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2497,7 +2497,7 @@ posix_fadvise (int fd, off_t offset, off_t len, int advice)
 {
        struct timespec start, end;
        static int  (*fn)(int , off_t , off_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "posix_fadvise");
        if (fn == NULL){
@@ -2507,16 +2507,16 @@ posix_fadvise (int fd, off_t offset, off_t len, int advice)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, offset, len, advice);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("posix_fadvise", end);
        } else {
                rval = fn(fd, offset, len, advice);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2525,7 +2525,7 @@ posix_fallocate (int fd, off_t offset, off_t len)
 {
        struct timespec start, end;
        static int  (*fn)(int , off_t , off_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "posix_fallocate");
        if (fn == NULL){
@@ -2535,16 +2535,16 @@ posix_fallocate (int fd, off_t offset, off_t len)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, offset, len);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("posix_fallocate", end);
        } else {
                rval = fn(fd, offset, len);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2553,7 +2553,7 @@ putchar (int c)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "putchar");
        if (fn == NULL){
@@ -2563,16 +2563,16 @@ putchar (int c)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(c);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("putchar", end);
        } else {
                rval = fn(c);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2581,7 +2581,7 @@ putchar_unlocked (int c)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "putchar_unlocked");
        if (fn == NULL){
@@ -2591,16 +2591,16 @@ putchar_unlocked (int c)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(c);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("putchar_unlocked", end);
        } else {
                rval = fn(c);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2609,7 +2609,7 @@ putc (int c, FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(int , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "putc");
        if (fn == NULL){
@@ -2619,16 +2619,16 @@ putc (int c, FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(c, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("putc", end);
        } else {
                rval = fn(c, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2637,7 +2637,7 @@ putc_unlocked (int c, FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(int , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "putc_unlocked");
        if (fn == NULL){
@@ -2647,16 +2647,16 @@ putc_unlocked (int c, FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(c, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("putc_unlocked", end);
        } else {
                rval = fn(c, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2665,7 +2665,7 @@ puts (const char *s)
 {
        struct timespec start, end;
        static int  (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "puts");
        if (fn == NULL){
@@ -2675,16 +2675,16 @@ puts (const char *s)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(s);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("puts", end);
        } else {
                rval = fn(s);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2693,7 +2693,7 @@ readdir_r (DIR *dirp, struct dirent *entry, struct dirent **result)
 {
        struct timespec start, end;
        static int  (*fn)(DIR *, struct dirent *, struct dirent **);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "readdir_r");
        if (fn == NULL){
@@ -2703,16 +2703,16 @@ readdir_r (DIR *dirp, struct dirent *entry, struct dirent **result)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dirp, entry, result);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("readdir_r", end);
        } else {
                rval = fn(dirp, entry, result);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2721,7 +2721,7 @@ remove (const char *pathname)
 {
        struct timespec start, end;
        static int  (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "remove");
        if (fn == NULL){
@@ -2731,16 +2731,16 @@ remove (const char *pathname)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pathname);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("remove", end);
        } else {
                rval = fn(pathname);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2749,7 +2749,7 @@ renameat (int olddirfd, const char *oldpath, int newdirfd, const char *newpath)
 {
        struct timespec start, end;
        static int  (*fn)(int , const char *, int , const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "renameat");
        if (fn == NULL){
@@ -2759,16 +2759,16 @@ renameat (int olddirfd, const char *oldpath, int newdirfd, const char *newpath)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(olddirfd, oldpath, newdirfd, newpath);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("renameat", end);
        } else {
                rval = fn(olddirfd, oldpath, newdirfd, newpath);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2777,7 +2777,7 @@ rename (const char *oldpath, const char *newpath)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "rename");
        if (fn == NULL){
@@ -2787,16 +2787,16 @@ rename (const char *oldpath, const char *newpath)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(oldpath, newpath);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("rename", end);
        } else {
                rval = fn(oldpath, newpath);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2805,7 +2805,7 @@ rmdir (const char *pathname)
 {
        struct timespec start, end;
        static int  (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "rmdir");
        if (fn == NULL){
@@ -2815,16 +2815,16 @@ rmdir (const char *pathname)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pathname);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("rmdir", end);
        } else {
                rval = fn(pathname);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2833,7 +2833,7 @@ setvbuf (FILE *stream, char *buf, int mode, size_t size)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *, char *, int , size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setvbuf");
        if (fn == NULL){
@@ -2843,16 +2843,16 @@ setvbuf (FILE *stream, char *buf, int mode, size_t size)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream, buf, mode, size);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setvbuf", end);
        } else {
                rval = fn(stream, buf, mode, size);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2861,7 +2861,7 @@ stat (const char *path, struct stat *buf)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, struct stat *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "stat");
        if (fn == NULL){
@@ -2871,16 +2871,16 @@ stat (const char *path, struct stat *buf)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(path, buf);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("stat", end);
        } else {
                rval = fn(path, buf);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2889,7 +2889,7 @@ statvfs (const char *path, struct statvfs *buf)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, struct statvfs *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "statvfs");
        if (fn == NULL){
@@ -2899,16 +2899,16 @@ statvfs (const char *path, struct statvfs *buf)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(path, buf);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("statvfs", end);
        } else {
                rval = fn(path, buf);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2917,7 +2917,7 @@ symlinkat (const char *oldpath, int newdirfd, const char *newpath)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, int , const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "symlinkat");
        if (fn == NULL){
@@ -2927,16 +2927,16 @@ symlinkat (const char *oldpath, int newdirfd, const char *newpath)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(oldpath, newdirfd, newpath);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("symlinkat", end);
        } else {
                rval = fn(oldpath, newdirfd, newpath);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2945,7 +2945,7 @@ symlink (const char *oldpath, const char *newpath)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "symlink");
        if (fn == NULL){
@@ -2955,16 +2955,16 @@ symlink (const char *oldpath, const char *newpath)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(oldpath, newpath);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("symlink", end);
        } else {
                rval = fn(oldpath, newpath);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -2973,7 +2973,7 @@ syslog (int type, char *bufp, int len)
 {
        struct timespec start, end;
        static int  (*fn)(int , char *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "syslog");
        if (fn == NULL){
@@ -2983,16 +2983,16 @@ syslog (int type, char *bufp, int len)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(type, bufp, len);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("syslog", end);
        } else {
                rval = fn(type, bufp, len);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3001,7 +3001,7 @@ truncate (const char *path, off_t length)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, off_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "truncate");
        if (fn == NULL){
@@ -3011,16 +3011,16 @@ truncate (const char *path, off_t length)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(path, length);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("truncate", end);
        } else {
                rval = fn(path, length);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3029,7 +3029,7 @@ ungetc (int c, FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(int , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ungetc");
        if (fn == NULL){
@@ -3039,16 +3039,16 @@ ungetc (int c, FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(c, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ungetc", end);
        } else {
                rval = fn(c, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3057,7 +3057,7 @@ unlinkat (int dirfd, const char *pathname, int flags)
 {
        struct timespec start, end;
        static int  (*fn)(int , const char *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "unlinkat");
        if (fn == NULL){
@@ -3067,16 +3067,16 @@ unlinkat (int dirfd, const char *pathname, int flags)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dirfd, pathname, flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("unlinkat", end);
        } else {
                rval = fn(dirfd, pathname, flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3085,7 +3085,7 @@ unlink (const char *pathname)
 {
        struct timespec start, end;
        static int  (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "unlink");
        if (fn == NULL){
@@ -3095,16 +3095,16 @@ unlink (const char *pathname)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pathname);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("unlink", end);
        } else {
                rval = fn(pathname);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3113,7 +3113,7 @@ vdprintf (int fd, const char *format, va_list ap)
 {
        struct timespec start, end;
        static int  (*fn)(int , const char *, va_list );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "vdprintf");
        if (fn == NULL){
@@ -3123,16 +3123,16 @@ vdprintf (int fd, const char *format, va_list ap)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, format, ap);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("vdprintf", end);
        } else {
                rval = fn(fd, format, ap);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3141,7 +3141,7 @@ vfprintf (FILE *stream, const char *format, va_list ap)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *, const char *, va_list );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "vfprintf");
        if (fn == NULL){
@@ -3151,16 +3151,16 @@ vfprintf (FILE *stream, const char *format, va_list ap)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream, format, ap);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("vfprintf", end);
        } else {
                rval = fn(stream, format, ap);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3169,7 +3169,7 @@ vfscanf (FILE *stream, const char *format, va_list ap)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *, const char *, va_list );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "vfscanf");
        if (fn == NULL){
@@ -3179,16 +3179,16 @@ vfscanf (FILE *stream, const char *format, va_list ap)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream, format, ap);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("vfscanf", end);
        } else {
                rval = fn(stream, format, ap);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3197,7 +3197,7 @@ vfwprintf (FILE *stream, const wchar_t *format, va_list args)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *, const wchar_t *, va_list );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "vfwprintf");
        if (fn == NULL){
@@ -3207,16 +3207,16 @@ vfwprintf (FILE *stream, const wchar_t *format, va_list args)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream, format, args);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("vfwprintf", end);
        } else {
                rval = fn(stream, format, args);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3225,7 +3225,7 @@ vprintf (const char *format, va_list ap)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, va_list );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "vprintf");
        if (fn == NULL){
@@ -3235,16 +3235,16 @@ vprintf (const char *format, va_list ap)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(format, ap);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("vprintf", end);
        } else {
                rval = fn(format, ap);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3253,7 +3253,7 @@ vscanf (const char *format, va_list ap)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, va_list );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "vscanf");
        if (fn == NULL){
@@ -3263,16 +3263,16 @@ vscanf (const char *format, va_list ap)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(format, ap);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("vscanf", end);
        } else {
                rval = fn(format, ap);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3281,7 +3281,7 @@ vwprintf (const wchar_t *format, va_list args)
 {
        struct timespec start, end;
        static int  (*fn)(const wchar_t *, va_list );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "vwprintf");
        if (fn == NULL){
@@ -3291,16 +3291,16 @@ vwprintf (const wchar_t *format, va_list args)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(format, args);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("vwprintf", end);
        } else {
                rval = fn(format, args);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3309,7 +3309,7 @@ fpathconf (int fd, int name)
 {
        struct timespec start, end;
        static long  (*fn)(int , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fpathconf");
        if (fn == NULL){
@@ -3319,16 +3319,16 @@ fpathconf (int fd, int name)
        long  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, name);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fpathconf", end);
        } else {
                rval = fn(fd, name);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3337,7 +3337,7 @@ ftell (FILE *stream)
 {
        struct timespec start, end;
        static long  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ftell");
        if (fn == NULL){
@@ -3347,16 +3347,16 @@ ftell (FILE *stream)
        long  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ftell", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3365,7 +3365,7 @@ telldir (DIR *dirp)
 {
        struct timespec start, end;
        static long  (*fn)(DIR *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "telldir");
        if (fn == NULL){
@@ -3375,16 +3375,16 @@ telldir (DIR *dirp)
        long  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dirp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("telldir", end);
        } else {
                rval = fn(dirp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3393,7 +3393,7 @@ catopen (const char *name, int flag)
 {
        struct timespec start, end;
        static nl_catd  (*fn)(const char *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "catopen");
        if (fn == NULL){
@@ -3403,16 +3403,16 @@ catopen (const char *name, int flag)
        nl_catd  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name, flag);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("catopen", end);
        } else {
                rval = fn(name, flag);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3421,7 +3421,7 @@ ftello (FILE *stream)
 {
        struct timespec start, end;
        static off_t  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ftello");
        if (fn == NULL){
@@ -3431,16 +3431,16 @@ ftello (FILE *stream)
        off_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ftello", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3449,7 +3449,7 @@ lseek (int fd, off_t offset, int whence)
 {
        struct timespec start, end;
        static off_t  (*fn)(int , off_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "lseek");
        if (fn == NULL){
@@ -3459,16 +3459,16 @@ lseek (int fd, off_t offset, int whence)
        off_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, offset, whence);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("lseek", end);
        } else {
                rval = fn(fd, offset, whence);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3477,7 +3477,7 @@ tcgetpgrp (int fd)
 {
        struct timespec start, end;
        static pid_t  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "tcgetpgrp");
        if (fn == NULL){
@@ -3487,16 +3487,16 @@ tcgetpgrp (int fd)
        pid_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("tcgetpgrp", end);
        } else {
                rval = fn(fd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 size_t 
@@ -3504,7 +3504,7 @@ fread_unlocked (void *ptr, size_t size, size_t n, FILE *stream)
 {
        struct timespec start, end;
        static size_t  (*fn)(void *, size_t , size_t , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fread_unlocked");
        if (fn == NULL){
@@ -3514,16 +3514,16 @@ fread_unlocked (void *ptr, size_t size, size_t n, FILE *stream)
        size_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ptr, size, n, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fread_unlocked", end);
        } else {
                rval = fn(ptr, size, n, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3532,7 +3532,7 @@ fread (void *ptr, size_t size, size_t nmemb, FILE *stream)
 {
        struct timespec start, end;
        static size_t  (*fn)(void *, size_t , size_t , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fread");
        if (fn == NULL){
@@ -3542,16 +3542,16 @@ fread (void *ptr, size_t size, size_t nmemb, FILE *stream)
        size_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ptr, size, nmemb, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fread", end);
        } else {
                rval = fn(ptr, size, nmemb, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3560,7 +3560,7 @@ fwrite_unlocked (const void *ptr, size_t size, size_t n, FILE *stream)
 {
        struct timespec start, end;
        static size_t  (*fn)(const void *, size_t , size_t , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fwrite_unlocked");
        if (fn == NULL){
@@ -3570,16 +3570,16 @@ fwrite_unlocked (const void *ptr, size_t size, size_t n, FILE *stream)
        size_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ptr, size, n, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fwrite_unlocked", end);
        } else {
                rval = fn(ptr, size, n, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3588,7 +3588,7 @@ fwrite (const void *ptr, size_t size, size_t nmemb, FILE *stream)
 {
        struct timespec start, end;
        static size_t  (*fn)(const void *, size_t , size_t , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fwrite");
        if (fn == NULL){
@@ -3598,16 +3598,16 @@ fwrite (const void *ptr, size_t size, size_t nmemb, FILE *stream)
        size_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ptr, size, nmemb, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fwrite", end);
        } else {
                rval = fn(ptr, size, nmemb, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3616,7 +3616,7 @@ aio_return (struct aiocb *aiocbp)
 {
        struct timespec start, end;
        static ssize_t  (*fn)(struct aiocb *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "aio_return");
        if (fn == NULL){
@@ -3626,16 +3626,16 @@ aio_return (struct aiocb *aiocbp)
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(aiocbp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("aio_return", end);
        } else {
                rval = fn(aiocbp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3644,7 +3644,7 @@ getdelim (char **lineptr, size_t *n, int delim, FILE *stream)
 {
        struct timespec start, end;
        static ssize_t  (*fn)(char **, size_t *, int , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getdelim");
        if (fn == NULL){
@@ -3654,16 +3654,16 @@ getdelim (char **lineptr, size_t *n, int delim, FILE *stream)
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(lineptr, n, delim, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getdelim", end);
        } else {
                rval = fn(lineptr, n, delim, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3672,7 +3672,7 @@ getline (char **lineptr, size_t *n, FILE *stream)
 {
        struct timespec start, end;
        static ssize_t  (*fn)(char **, size_t *, FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getline");
        if (fn == NULL){
@@ -3682,16 +3682,16 @@ getline (char **lineptr, size_t *n, FILE *stream)
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(lineptr, n, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getline", end);
        } else {
                rval = fn(lineptr, n, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3700,7 +3700,7 @@ pread (int fd, void *buf, size_t count, off_t offset)
 {
        struct timespec start, end;
        static ssize_t  (*fn)(int , void *, size_t , off_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pread");
        if (fn == NULL){
@@ -3710,16 +3710,16 @@ pread (int fd, void *buf, size_t count, off_t offset)
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, buf, count, offset);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pread", end);
        } else {
                rval = fn(fd, buf, count, offset);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3728,7 +3728,7 @@ pwrite (int fd, const void *buf, size_t count, off_t offset)
 {
        struct timespec start, end;
        static ssize_t  (*fn)(int , const void *, size_t , off_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pwrite");
        if (fn == NULL){
@@ -3738,16 +3738,16 @@ pwrite (int fd, const void *buf, size_t count, off_t offset)
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, buf, count, offset);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pwrite", end);
        } else {
                rval = fn(fd, buf, count, offset);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3756,7 +3756,7 @@ readlink (const char *path, char *buf, size_t bufsiz)
 {
        struct timespec start, end;
        static ssize_t  (*fn)(const char *, char *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "readlink");
        if (fn == NULL){
@@ -3766,16 +3766,16 @@ readlink (const char *path, char *buf, size_t bufsiz)
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(path, buf, bufsiz);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("readlink", end);
        } else {
                rval = fn(path, buf, bufsiz);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3784,7 +3784,7 @@ readv (int fd, const struct iovec *iov, int iovcnt)
 {
        struct timespec start, end;
        static ssize_t  (*fn)(int , const struct iovec *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "readv");
        if (fn == NULL){
@@ -3794,16 +3794,16 @@ readv (int fd, const struct iovec *iov, int iovcnt)
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, iov, iovcnt);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("readv", end);
        } else {
                rval = fn(fd, iov, iovcnt);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3812,7 +3812,7 @@ writev (int fd, const struct iovec *iov, int iovcnt)
 {
        struct timespec start, end;
        static ssize_t  (*fn)(int , const struct iovec *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "writev");
        if (fn == NULL){
@@ -3822,16 +3822,16 @@ writev (int fd, const struct iovec *iov, int iovcnt)
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, iov, iovcnt);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("writev", end);
        } else {
                rval = fn(fd, iov, iovcnt);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3840,7 +3840,7 @@ readdir (DIR *dirp)
 {
        struct timespec start, end;
        static struct dirent * (*fn)(DIR *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "readdir");
        if (fn == NULL){
@@ -3850,16 +3850,16 @@ readdir (DIR *dirp)
        struct dirent * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dirp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("readdir", end);
        } else {
                rval = fn(dirp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3868,7 +3868,7 @@ pututline (struct utmp *ut)
 {
        struct timespec start, end;
        static struct utmp * (*fn)(struct utmp *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pututline");
        if (fn == NULL){
@@ -3878,16 +3878,16 @@ pututline (struct utmp *ut)
        struct utmp * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ut);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pututline", end);
        } else {
                rval = fn(ut);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3896,7 +3896,7 @@ aligned_alloc (size_t alignment, size_t size)
 {
        struct timespec start, end;
        static void * (*fn)(size_t , size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "aligned_alloc");
        if (fn == NULL){
@@ -3906,16 +3906,16 @@ aligned_alloc (size_t alignment, size_t size)
        void * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(alignment, size);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("aligned_alloc", end);
        } else {
                rval = fn(alignment, size);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -3924,7 +3924,7 @@ clearerr (FILE *stream)
 {
        struct timespec start, end;
        static void  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "clearerr");
        if (fn == NULL){
@@ -3933,16 +3933,16 @@ clearerr (FILE *stream)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("clearerr", end);
        } else {
                fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -3950,7 +3950,7 @@ clearerr_unlocked (FILE *stream)
 {
        struct timespec start, end;
        static void  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "clearerr_unlocked");
        if (fn == NULL){
@@ -3959,16 +3959,16 @@ clearerr_unlocked (FILE *stream)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("clearerr_unlocked", end);
        } else {
                fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -3976,7 +3976,7 @@ closelog (void)
 {
        struct timespec start, end;
        static void  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "closelog");
        if (fn == NULL){
@@ -3985,16 +3985,16 @@ closelog (void)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("closelog", end);
        } else {
                fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -4002,7 +4002,7 @@ flockfile (FILE *filehandle)
 {
        struct timespec start, end;
        static void  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "flockfile");
        if (fn == NULL){
@@ -4011,16 +4011,16 @@ flockfile (FILE *filehandle)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(filehandle);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("flockfile", end);
        } else {
                fn(filehandle);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -4028,7 +4028,7 @@ funlockfile (FILE *filehandle)
 {
        struct timespec start, end;
        static void  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "funlockfile");
        if (fn == NULL){
@@ -4037,16 +4037,16 @@ funlockfile (FILE *filehandle)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(filehandle);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("funlockfile", end);
        } else {
                fn(filehandle);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -4054,7 +4054,7 @@ openlog (const char *ident, int option, int facility)
 {
        struct timespec start, end;
        static void  (*fn)(const char *, int , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "openlog");
        if (fn == NULL){
@@ -4063,16 +4063,16 @@ openlog (const char *ident, int option, int facility)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(ident, option, facility);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("openlog", end);
        } else {
                fn(ident, option, facility);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -4080,7 +4080,7 @@ perror (const char *s)
 {
        struct timespec start, end;
        static void  (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "perror");
        if (fn == NULL){
@@ -4089,16 +4089,16 @@ perror (const char *s)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(s);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("perror", end);
        } else {
                fn(s);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -4106,7 +4106,7 @@ rewinddir (DIR *dirp)
 {
        struct timespec start, end;
        static void  (*fn)(DIR *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "rewinddir");
        if (fn == NULL){
@@ -4115,16 +4115,16 @@ rewinddir (DIR *dirp)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(dirp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("rewinddir", end);
        } else {
                fn(dirp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -4132,7 +4132,7 @@ rewind (FILE *stream)
 {
        struct timespec start, end;
        static void  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "rewind");
        if (fn == NULL){
@@ -4141,16 +4141,16 @@ rewind (FILE *stream)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("rewind", end);
        } else {
                fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -4158,7 +4158,7 @@ seekdir (DIR *dirp, long offset)
 {
        struct timespec start, end;
        static void  (*fn)(DIR *, long );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "seekdir");
        if (fn == NULL){
@@ -4167,16 +4167,16 @@ seekdir (DIR *dirp, long offset)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(dirp, offset);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("seekdir", end);
        } else {
                fn(dirp, offset);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -4184,7 +4184,7 @@ setbuffer (FILE *stream, char *buf, size_t size)
 {
        struct timespec start, end;
        static void  (*fn)(FILE *, char *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setbuffer");
        if (fn == NULL){
@@ -4193,16 +4193,16 @@ setbuffer (FILE *stream, char *buf, size_t size)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(stream, buf, size);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setbuffer", end);
        } else {
                fn(stream, buf, size);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -4210,7 +4210,7 @@ setbuf (FILE *stream, char *buf)
 {
        struct timespec start, end;
        static void  (*fn)(FILE *, char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setbuf");
        if (fn == NULL){
@@ -4219,16 +4219,16 @@ setbuf (FILE *stream, char *buf)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(stream, buf);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setbuf", end);
        } else {
                fn(stream, buf);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 
@@ -4237,7 +4237,7 @@ sync (void)
 {
        struct timespec start, end;
        static void  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sync");
        if (fn == NULL){
@@ -4246,16 +4246,16 @@ sync (void)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sync", end);
        } else {
                fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 wchar_t *
@@ -4263,7 +4263,7 @@ fgetws_unlocked (wchar_t *ws, int n, FILE *stream)
 {
        struct timespec start, end;
        static wchar_t * (*fn)(wchar_t *, int , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fgetws_unlocked");
        if (fn == NULL){
@@ -4273,16 +4273,16 @@ fgetws_unlocked (wchar_t *ws, int n, FILE *stream)
        wchar_t * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ws, n, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fgetws_unlocked", end);
        } else {
                rval = fn(ws, n, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -4291,7 +4291,7 @@ fgetws (wchar_t *ws, int n, FILE *stream)
 {
        struct timespec start, end;
        static wchar_t * (*fn)(wchar_t *, int , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fgetws");
        if (fn == NULL){
@@ -4301,16 +4301,16 @@ fgetws (wchar_t *ws, int n, FILE *stream)
        wchar_t * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ws, n, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fgetws", end);
        } else {
                rval = fn(ws, n, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -4319,7 +4319,7 @@ fgetwc (FILE *stream)
 {
        struct timespec start, end;
        static wint_t  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fgetwc");
        if (fn == NULL){
@@ -4329,16 +4329,16 @@ fgetwc (FILE *stream)
        wint_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fgetwc", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -4347,7 +4347,7 @@ fgetwc_unlocked (FILE *stream)
 {
        struct timespec start, end;
        static wint_t  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fgetwc_unlocked");
        if (fn == NULL){
@@ -4357,16 +4357,16 @@ fgetwc_unlocked (FILE *stream)
        wint_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fgetwc_unlocked", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -4375,7 +4375,7 @@ fputwc_unlocked (wchar_t wc, FILE *stream)
 {
        struct timespec start, end;
        static wint_t  (*fn)(wchar_t , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fputwc_unlocked");
        if (fn == NULL){
@@ -4385,16 +4385,16 @@ fputwc_unlocked (wchar_t wc, FILE *stream)
        wint_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(wc, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fputwc_unlocked", end);
        } else {
                rval = fn(wc, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -4403,7 +4403,7 @@ fputwc (wchar_t wc, FILE *stream)
 {
        struct timespec start, end;
        static wint_t  (*fn)(wchar_t , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fputwc");
        if (fn == NULL){
@@ -4413,16 +4413,16 @@ fputwc (wchar_t wc, FILE *stream)
        wint_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(wc, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fputwc", end);
        } else {
                rval = fn(wc, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -4431,7 +4431,7 @@ getwc (FILE *stream)
 {
        struct timespec start, end;
        static wint_t  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getwc");
        if (fn == NULL){
@@ -4441,16 +4441,16 @@ getwc (FILE *stream)
        wint_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getwc", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -4459,7 +4459,7 @@ getwchar_unlocked (void)
 {
        struct timespec start, end;
        static wint_t  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getwchar_unlocked");
        if (fn == NULL){
@@ -4469,16 +4469,16 @@ getwchar_unlocked (void)
        wint_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getwchar_unlocked", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -4487,7 +4487,7 @@ getwchar (void)
 {
        struct timespec start, end;
        static wint_t  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getwchar");
        if (fn == NULL){
@@ -4497,16 +4497,16 @@ getwchar (void)
        wint_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getwchar", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -4515,7 +4515,7 @@ getwc_unlocked (FILE *stream)
 {
        struct timespec start, end;
        static wint_t  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getwc_unlocked");
        if (fn == NULL){
@@ -4525,16 +4525,16 @@ getwc_unlocked (FILE *stream)
        wint_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getwc_unlocked", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -4543,7 +4543,7 @@ putwchar_unlocked (wchar_t wc)
 {
        struct timespec start, end;
        static wint_t  (*fn)(wchar_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "putwchar_unlocked");
        if (fn == NULL){
@@ -4553,16 +4553,16 @@ putwchar_unlocked (wchar_t wc)
        wint_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(wc);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("putwchar_unlocked", end);
        } else {
                rval = fn(wc);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -4571,7 +4571,7 @@ putwchar (wchar_t wc)
 {
        struct timespec start, end;
        static wint_t  (*fn)(wchar_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "putwchar");
        if (fn == NULL){
@@ -4581,16 +4581,16 @@ putwchar (wchar_t wc)
        wint_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(wc);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("putwchar", end);
        } else {
                rval = fn(wc);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -4599,7 +4599,7 @@ putwc_unlocked (wchar_t wc, FILE *stream)
 {
        struct timespec start, end;
        static wint_t  (*fn)(wchar_t , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "putwc_unlocked");
        if (fn == NULL){
@@ -4609,16 +4609,16 @@ putwc_unlocked (wchar_t wc, FILE *stream)
        wint_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(wc, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("putwc_unlocked", end);
        } else {
                rval = fn(wc, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -4627,7 +4627,7 @@ putwc (wchar_t wc, FILE *stream)
 {
        struct timespec start, end;
        static wint_t  (*fn)(wchar_t , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "putwc");
        if (fn == NULL){
@@ -4637,16 +4637,16 @@ putwc (wchar_t wc, FILE *stream)
        wint_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(wc, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("putwc", end);
        } else {
                rval = fn(wc, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -4655,7 +4655,7 @@ ungetwc (wint_t wc, FILE *stream)
 {
        struct timespec start, end;
        static wint_t  (*fn)(wint_t , FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ungetwc");
        if (fn == NULL){
@@ -4665,16 +4665,16 @@ ungetwc (wint_t wc, FILE *stream)
        wint_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(wc, stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ungetwc", end);
        } else {
                rval = fn(wc, stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 /*
@@ -16,9 +16,9 @@ dup3 (int oldfd, int newfd, int flags)
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn(oldfd, newfd, flags);
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("dup3", end);
 out:
@@ -44,9 +44,9 @@ getopt_long (int argc, char * const argv[],
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn(argc, argv, optstring, longopts, longindex);
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("getopt_long", end);
 out:
@@ -68,9 +68,9 @@ wait3 (int *status, int options, struct rusage *rusage)
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn(status, options, rusage);
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("wait3", end);
 out:
@@ -92,9 +92,9 @@ wait4 (pid_t pid, int *status, int options, struct rusage *rusage)
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn(pid, status, options, rusage);
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("wait4", end);
 out:
@@ -116,9 +116,9 @@ argvccept4 (int sockfd, struct sockaddr *addr, socklen_t *addrlen, int flagss)
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn(sockfd, addr, addrlen, flagss);
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("argvccept4", end);
 out:
@@ -141,9 +141,9 @@ mallinfo (void)
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("mallinfo", end);
 out:
@@ -165,9 +165,9 @@ pipe2 (int pipefd[2], int flags)
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn(pipefd, flags);
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("pipe2", end);
 out:
@@ -190,9 +190,9 @@ fcloseall (void)
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("fcloseall", end);
 out:
@@ -215,9 +215,9 @@ execvpe (const char *file, char *const argv[], char *const envp[])
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn(file, argv, envp);
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("execvpe", end);
 out:
@@ -245,9 +245,9 @@ ppoll (struct pollfd *fds,
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn(fds, nfds, timeout_ts, sigmask);
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("ppoll", end);
 out:
@@ -269,9 +269,9 @@ clone (int (*func)(void *), void *child_stack, int flags, void *arg, ...)
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn(func, child_stack, flags, arg);
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("clone", end);
 out:
@@ -294,9 +294,9 @@ mallopt (int param, int value)
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn(param, value);
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("mallopt", end);
 out:
@@ -319,9 +319,9 @@ mkostemp (char *template, int suffixlen)
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn(template, suffixlen);
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("mkostemp", end);
 out:
@@ -344,9 +344,9 @@ mempcpy (void *dest, const void *src, size_t n)
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn(dest, src, n);
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("mempcpy", end);
 out:
@@ -369,9 +369,9 @@ cacheflush (char *cacheflushaddr, int nbytes, int cache)
 		goto out;
 	}
 	_backtrace();
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	_gettime(&start);
 	rval = fn(cacheflushaddr, nbytes, cache);
-	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+	_gettime(&end);
 	_timespec_sub(&end, &start);
 	_logtime("cacheflush", end);
 out:
@@ -6,7 +6,7 @@ shmctl (int shmid, int cmd, struct shmid_ds *buf)
 {
        struct timespec start, end;
        static int  (*fn)(int , int , struct shmid_ds *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "shmctl");
        if (fn == NULL){
@@ -16,16 +16,16 @@ shmctl (int shmid, int cmd, struct shmid_ds *buf)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(shmid, cmd, buf);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("shmctl", end);
        } else {
                rval = fn(shmid, cmd, buf);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -34,7 +34,7 @@ shmat (int shmid, const void *shmaddr, int shmflg)
 {
        struct timespec start, end;
        static void * (*fn)(int , const void *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "shmat");
        if (fn == NULL){
@@ -44,16 +44,16 @@ shmat (int shmid, const void *shmaddr, int shmflg)
        void * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(shmid, shmaddr, shmflg);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("shmat", end);
        } else {
                rval = fn(shmid, shmaddr, shmflg);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -62,7 +62,7 @@ shmdt (const void *shmaddr)
 {
        struct timespec start, end;
        static int  (*fn)(const void *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "shmdt");
        if (fn == NULL){
@@ -72,16 +72,16 @@ shmdt (const void *shmaddr)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(shmaddr);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("shmdt", end);
        } else {
                rval = fn(shmaddr);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -90,7 +90,7 @@ shmget (key_t key, size_t size, int shmflg)
 {
        struct timespec start, end;
        static int  (*fn)(key_t , size_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "shmget");
        if (fn == NULL){
@@ -100,16 +100,16 @@ shmget (key_t key, size_t size, int shmflg)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(key, size, shmflg);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("shmget", end);
        } else {
                rval = fn(key, size, shmflg);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -118,7 +118,7 @@ shm_open (const char *name, int oflag, mode_t mode)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, int , mode_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "shm_open");
        if (fn == NULL){
@@ -128,16 +128,16 @@ shm_open (const char *name, int oflag, mode_t mode)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name, oflag, mode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("shm_open", end);
        } else {
                rval = fn(name, oflag, mode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -146,7 +146,7 @@ shm_unlink (const char *name)
 {
        struct timespec start, end;
        static int  (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "shm_unlink");
        if (fn == NULL){
@@ -156,16 +156,16 @@ shm_unlink (const char *name)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("shm_unlink", end);
        } else {
                rval = fn(name);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -174,7 +174,7 @@ pipe (int pipefd[2])
 {
        struct timespec start, end;
        static int  (*fn)(int pipefd[2]);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pipe");
        if (fn == NULL){
@@ -184,16 +184,16 @@ pipe (int pipefd[2])
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pipefd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pipe", end);
        } else {
                rval = fn(pipefd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -202,7 +202,7 @@ sem_close (sem_t *sem)
 {
        struct timespec start, end;
        static int  (*fn)(sem_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sem_close");
        if (fn == NULL){
@@ -212,16 +212,16 @@ sem_close (sem_t *sem)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sem);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sem_close", end);
        } else {
                rval = fn(sem);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -230,7 +230,7 @@ sem_destroy (sem_t *sem)
 {
        struct timespec start, end;
        static int  (*fn)(sem_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sem_destroy");
        if (fn == NULL){
@@ -240,16 +240,16 @@ sem_destroy (sem_t *sem)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sem);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sem_destroy", end);
        } else {
                rval = fn(sem);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -258,7 +258,7 @@ semget (key_t key, int nsems, int semflg)
 {
        struct timespec start, end;
        static int  (*fn)(key_t , int , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "semget");
        if (fn == NULL){
@@ -268,16 +268,16 @@ semget (key_t key, int nsems, int semflg)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(key, nsems, semflg);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("semget", end);
        } else {
                rval = fn(key, nsems, semflg);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -286,7 +286,7 @@ sem_getvalue (sem_t *sem, int *sval)
 {
        struct timespec start, end;
        static int  (*fn)(sem_t *, int *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sem_getvalue");
        if (fn == NULL){
@@ -296,16 +296,16 @@ sem_getvalue (sem_t *sem, int *sval)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sem, sval);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sem_getvalue", end);
        } else {
                rval = fn(sem, sval);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -314,7 +314,7 @@ sem_init (sem_t *sem, int pshared, unsigned int value)
 {
        struct timespec start, end;
        static int  (*fn)(sem_t *, int , unsigned int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sem_init");
        if (fn == NULL){
@@ -324,16 +324,16 @@ sem_init (sem_t *sem, int pshared, unsigned int value)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sem, pshared, value);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sem_init", end);
        } else {
                rval = fn(sem, pshared, value);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -342,7 +342,7 @@ semop (int semid, struct sembuf *sops, unsigned nsops)
 {
        struct timespec start, end;
        static int  (*fn)(int , struct sembuf *, unsigned );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "semop");
        if (fn == NULL){
@@ -352,16 +352,16 @@ semop (int semid, struct sembuf *sops, unsigned nsops)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(semid, sops, nsops);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("semop", end);
        } else {
                rval = fn(semid, sops, nsops);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -370,7 +370,7 @@ sem_post (sem_t *sem)
 {
        struct timespec start, end;
        static int  (*fn)(sem_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sem_post");
        if (fn == NULL){
@@ -380,16 +380,16 @@ sem_post (sem_t *sem)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sem);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sem_post", end);
        } else {
                rval = fn(sem);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -398,7 +398,7 @@ semtimedop (int semid, struct sembuf *sops, unsigned nsops, struct timespec *tim
 {
        struct timespec start, end;
        static int  (*fn)(int , struct sembuf *, unsigned , struct timespec *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "semtimedop");
        if (fn == NULL){
@@ -408,16 +408,16 @@ semtimedop (int semid, struct sembuf *sops, unsigned nsops, struct timespec *tim
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(semid, sops, nsops, timeout);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("semtimedop", end);
        } else {
                rval = fn(semid, sops, nsops, timeout);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -426,7 +426,7 @@ sem_timedwait (sem_t *sem, const struct timespec *abs_timeout)
 {
        struct timespec start, end;
        static int  (*fn)(sem_t *, const struct timespec *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sem_timedwait");
        if (fn == NULL){
@@ -436,16 +436,16 @@ sem_timedwait (sem_t *sem, const struct timespec *abs_timeout)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sem, abs_timeout);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sem_timedwait", end);
        } else {
                rval = fn(sem, abs_timeout);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -454,7 +454,7 @@ sem_trywait (sem_t *sem)
 {
        struct timespec start, end;
        static int  (*fn)(sem_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sem_trywait");
        if (fn == NULL){
@@ -464,16 +464,16 @@ sem_trywait (sem_t *sem)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sem);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sem_trywait", end);
        } else {
                rval = fn(sem);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -482,7 +482,7 @@ sem_unlink (const char *name)
 {
        struct timespec start, end;
        static int  (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sem_unlink");
        if (fn == NULL){
@@ -492,16 +492,16 @@ sem_unlink (const char *name)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sem_unlink", end);
        } else {
                rval = fn(name);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -510,7 +510,7 @@ mq_close (mqd_t mqdes)
 {
        struct timespec start, end;
        static int  (*fn)(mqd_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mq_close");
        if (fn == NULL){
@@ -520,16 +520,16 @@ mq_close (mqd_t mqdes)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(mqdes);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mq_close", end);
        } else {
                rval = fn(mqdes);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -538,7 +538,7 @@ mq_getattr (mqd_t mqdes, struct mq_attr *attr)
 {
        struct timespec start, end;
        static int  (*fn)(mqd_t , struct mq_attr *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mq_getattr");
        if (fn == NULL){
@@ -548,16 +548,16 @@ mq_getattr (mqd_t mqdes, struct mq_attr *attr)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(mqdes, attr);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mq_getattr", end);
        } else {
                rval = fn(mqdes, attr);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -566,7 +566,7 @@ mq_notify (mqd_t mqdes, const struct sigevent *sevp)
 {
        struct timespec start, end;
        static int  (*fn)(mqd_t , const struct sigevent *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mq_notify");
        if (fn == NULL){
@@ -576,16 +576,16 @@ mq_notify (mqd_t mqdes, const struct sigevent *sevp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(mqdes, sevp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mq_notify", end);
        } else {
                rval = fn(mqdes, sevp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -594,7 +594,7 @@ mq_send (mqd_t mqdes, const char *msg_ptr, size_t msg_len, unsigned msg_prio)
 {
        struct timespec start, end;
        static int  (*fn)(mqd_t , const char *, size_t , unsigned );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mq_send");
        if (fn == NULL){
@@ -604,16 +604,16 @@ mq_send (mqd_t mqdes, const char *msg_ptr, size_t msg_len, unsigned msg_prio)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(mqdes, msg_ptr, msg_len, msg_prio);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mq_send", end);
        } else {
                rval = fn(mqdes, msg_ptr, msg_len, msg_prio);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -622,7 +622,7 @@ mq_timedsend (mqd_t mqdes, const char *msg_ptr, size_t msg_len, unsigned msg_pri
 {
        struct timespec start, end;
        static int  (*fn)(mqd_t , const char *, size_t , unsigned ,  const struct timespec *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mq_timedsend");
        if (fn == NULL){
@@ -632,16 +632,16 @@ mq_timedsend (mqd_t mqdes, const char *msg_ptr, size_t msg_len, unsigned msg_pri
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(mqdes, msg_ptr, msg_len, msg_prio, abs_timeout);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mq_timedsend", end);
        } else {
                rval = fn(mqdes, msg_ptr, msg_len, msg_prio, abs_timeout);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -650,7 +650,7 @@ mq_unlink (const char *name)
 {
        struct timespec start, end;
        static int  (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mq_unlink");
        if (fn == NULL){
@@ -660,16 +660,16 @@ mq_unlink (const char *name)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mq_unlink", end);
        } else {
                rval = fn(name);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -678,7 +678,7 @@ msgctl (int msqid, int cmd, struct msqid_ds *buf)
 {
        struct timespec start, end;
        static int  (*fn)(int , int , struct msqid_ds *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "msgctl");
        if (fn == NULL){
@@ -688,16 +688,16 @@ msgctl (int msqid, int cmd, struct msqid_ds *buf)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(msqid, cmd, buf);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("msgctl", end);
        } else {
                rval = fn(msqid, cmd, buf);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -706,7 +706,7 @@ msgget (key_t key, int msgflg)
 {
        struct timespec start, end;
        static int  (*fn)(key_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "msgget");
        if (fn == NULL){
@@ -716,16 +716,16 @@ msgget (key_t key, int msgflg)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(key, msgflg);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("msgget", end);
        } else {
                rval = fn(key, msgflg);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -734,7 +734,7 @@ msgsnd (int msqid, const void *msgp, size_t msgsz, int msgflg)
 {
        struct timespec start, end;
        static int  (*fn)(int , const void *, size_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "msgsnd");
        if (fn == NULL){
@@ -744,16 +744,16 @@ msgsnd (int msqid, const void *msgp, size_t msgsz, int msgflg)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(msqid, msgp, msgsz, msgflg);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("msgsnd", end);
        } else {
                rval = fn(msqid, msgp, msgsz, msgflg);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -762,7 +762,7 @@ mq_receive (mqd_t mqdes, char *msg_ptr,  size_t msg_len, unsigned *msg_prio)
 {
        struct timespec start, end;
        static ssize_t  (*fn)(mqd_t , char *,  size_t , unsigned *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mq_receive");
        if (fn == NULL){
@@ -772,16 +772,16 @@ mq_receive (mqd_t mqdes, char *msg_ptr,  size_t msg_len, unsigned *msg_prio)
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(mqdes, msg_ptr, msg_len, msg_prio);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mq_receive", end);
        } else {
                rval = fn(mqdes, msg_ptr, msg_len, msg_prio);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -790,7 +790,7 @@ mq_timedreceive (mqd_t mqdes, char *msg_ptr, size_t msg_len, unsigned *msg_prio,
 {
        struct timespec start, end;
        static ssize_t  (*fn)(mqd_t , char *, size_t , unsigned *, const struct timespec *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mq_timedreceive");
        if (fn == NULL){
@@ -800,16 +800,16 @@ mq_timedreceive (mqd_t mqdes, char *msg_ptr, size_t msg_len, unsigned *msg_prio,
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(mqdes, msg_ptr, msg_len, msg_prio, abs_timeout);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mq_timedreceive", end);
        } else {
                rval = fn(mqdes, msg_ptr, msg_len, msg_prio, abs_timeout);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -818,7 +818,7 @@ msgrcv (int msqid, void *msgp, size_t msgsz, long msgtyp, int msgflg)
 {
        struct timespec start, end;
        static ssize_t  (*fn)(int , void *, size_t , long , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "msgrcv");
        if (fn == NULL){
@@ -828,16 +828,16 @@ msgrcv (int msqid, void *msgp, size_t msgsz, long msgtyp, int msgflg)
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(msqid, msgp, msgsz, msgtyp, msgflg);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("msgrcv", end);
        } else {
                rval = fn(msqid, msgp, msgsz, msgtyp, msgflg);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 /*
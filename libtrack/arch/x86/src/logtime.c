@@ -31,6 +31,165 @@ char fd_type(int fd)
 	return '?';
 }
 
+/*
+ * Timestamps for timed calls (the clock arithmetic is shared with
+ * libtrack's wrap_time.c, see include/wtime_clock.h).
+ *
+ * clock_gettime(CLOCK_THREAD_CPUTIME_ID) is a real system call, and paying
+ * two of them per wrapped call swamped the cost of short calls. By default
+ * we now read the TSC (converted to ns with the kernel's own mult/shift
+ * from the perf mmap page, or a quick calibration). TRACE_CLOCK=thread
+ * selects thread CPU time: a per-thread reference-cycles perf counter
+ * read in user space with rdpmc, falling back to the old system call
+ * if the counter can't be opened.
+ */
+#define GT_CLOCK_MONO   0
+#define GT_CLOCK_TSC    1
+#define GT_CLOCK_THREAD 2
+
+static int _gt_clock = GT_CLOCK_MONO;
+static uint32_t _gt_mult, _gt_shift;
+
+/* per-thread perf counter: 0 = untried, 1 = open, -1 = use the syscall */
+static __thread int _gt_state __hot_tls = 0;
+static __thread struct perf_event_mmap_page *_gt_pc __hot_tls;
+static __thread uint64_t _gt_base_ns __hot_tls, _gt_base_cyc __hot_tls;
+
+static uint64_t
+_mono_ns (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return wtime_ts2ns(&ts);
+}
+
+static long
+_perf_open (struct perf_event_attr *attr)
+{
+	return syscall(SYS_perf_event_open, attr, 0, -1, -1, 0);
+}
+
+static int
+_tsc_params (void)
+{
+	struct perf_event_attr attr;
+	struct perf_event_mmap_page *pc;
+	int fd, ret = -1;
+
+	bzero(&attr, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_SOFTWARE;
+	attr.config = PERF_COUNT_SW_TASK_CLOCK;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+
+	fd = (int)_perf_open(&attr);
+	if (fd >= 0) {
+		pc = mmap(NULL, getpagesize(), PROT_READ, MAP_SHARED, fd, 0);
+		if (pc != MAP_FAILED) {
+			ret = wtime_perf_params(pc, &_gt_mult, &_gt_shift);
+			munmap(pc, getpagesize());
+		}
+		close(fd);
+		if (ret == 0)
+			return 0;
+	}
+
+	/* no help from the kernel: calibrate against CLOCK_MONOTONIC */
+	_gt_mult = wtime_calibrate(_mono_ns);
+	if (!_gt_mult)
+		return -1;
+	_gt_shift = WTIME_SHIFT;
+	return 0;
+}
+
+static void __attribute__((constructor))
+_init_gettime (void)
+{
+	const char *clk;
+
+	entered++;
+	if (wtime_tsc_invariant() && _tsc_params() == 0)
+		_gt_clock = GT_CLOCK_TSC;
+	clk = getenv("TRACE_CLOCK");
+	if (clk && strcmp(clk, "thread") == 0)
+		_gt_clock = GT_CLOCK_THREAD;
+	entered--;
+}
+
+static void
+_open_thread_clock (void)
+{
+	struct perf_event_attr attr;
+	struct perf_event_mmap_page *pc;
+	struct timespec ts;
+	int fd;
+
+	_gt_state = -1;
+	if (!_gt_mult)
+		return;
+
+	bzero(&attr, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = PERF_COUNT_HW_REF_CPU_CYCLES;
+	attr.exclude_hv = 1;
+
+	fd = (int)_perf_open(&attr);
+	if (fd < 0) {
+		attr.exclude_kernel = 1;
+		fd = (int)_perf_open(&attr);
+		if (fd < 0)
+			return;
+	}
+	pc = mmap(NULL, getpagesize(), PROT_READ, MAP_SHARED, fd, 0);
+	/* the mapping keeps the event alive */
+	close(fd);
+	if (pc == MAP_FAILED)
+		return;
+	if (!pc->cap_user_rdpmc || wtime_perf_read(pc, &_gt_base_cyc) < 0) {
+		munmap(pc, getpagesize());
+		return;
+	}
+	/* anchor the counter to the syscall clock so fallbacks line up */
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	_gt_base_ns = wtime_ts2ns(&ts);
+	_gt_pc = pc;
+	_gt_state = 1;
+}
+
+/*
+ * Drop-in replacement for clock_gettime(CLOCK_THREAD_CPUTIME_ID, ts)
+ * around wrapped calls: only differences between two values matter.
+ */
+void
+_gettime (struct timespec *ts)
+{
+	uint64_t ns, cyc;
+
+	if (_gt_clock == GT_CLOCK_TSC) {
+		ns = __wtime_cyc2ns(wtime_cycles(), _gt_mult, _gt_shift);
+		goto out;
+	}
+	if (_gt_clock == GT_CLOCK_THREAD) {
+		if (!_gt_state)
+			_open_thread_clock();
+		if (_gt_state > 0 && wtime_perf_read(_gt_pc, &cyc) == 0) {
+			ns = _gt_base_ns + __wtime_cyc2ns(cyc - _gt_base_cyc,
+							  _gt_mult, _gt_shift);
+			goto out;
+		}
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, ts);
+		return;
+	}
+	clock_gettime(CLOCK_MONOTONIC, ts);
+	return;
+out:
+	ts->tv_sec = ns / 1000000000ULL;
+	ts->tv_nsec = ns % 1000000000ULL;
+}
+
 /*
  * Helper function calculating time elapsed from timestamp a
  * to timestamp b and store it to b.
@@ -54,7 +213,10 @@ _logtime (char *funcname, struct timespec end)
 {
 	char line[LINE_LEN];
 	
-	pid_t (*libc_getpid)(void);
+	if (!(trace_mode & TRACE_TIME))
+		return;
+
+	static pid_t (*libc_getpid)(void);
 	if (libc_getpid == NULL) {
 		*(void **)(&libc_getpid) = dlsym(RTLD_NEXT, "getpid");
 		if (libc_getpid == NULL){
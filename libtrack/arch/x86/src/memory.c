@@ -6,7 +6,7 @@ wmemcpy (wchar_t *dest, const wchar_t *src, size_t n)
 {
        struct timespec start, end;
        static wchar_t * (*fn)(wchar_t *, const wchar_t *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "wmemcpy");
        if (fn == NULL){
@@ -16,16 +16,16 @@ wmemcpy (wchar_t *dest, const wchar_t *src, size_t n)
        wchar_t * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dest, src, n);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("wmemcpy", end);
        } else {
                rval = fn(dest, src, n);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -34,7 +34,7 @@ wmemmove (wchar_t *dest, const wchar_t *src, size_t n)
 {
        struct timespec start, end;
        static wchar_t * (*fn)(wchar_t *, const wchar_t *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "wmemmove");
        if (fn == NULL){
@@ -44,16 +44,16 @@ wmemmove (wchar_t *dest, const wchar_t *src, size_t n)
        wchar_t * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dest, src, n);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("wmemmove", end);
        } else {
                rval = fn(dest, src, n);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -62,7 +62,7 @@ wmemset (wchar_t *wcs, wchar_t wc, size_t n)
 {
        struct timespec start, end;
        static wchar_t * (*fn)(wchar_t *, wchar_t , size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "wmemset");
        if (fn == NULL){
@@ -72,16 +72,16 @@ wmemset (wchar_t *wcs, wchar_t wc, size_t n)
        wchar_t * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(wcs, wc, n);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("wmemset", end);
        } else {
                rval = fn(wcs, wc, n);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -90,7 +90,7 @@ swab (const void *from, void *to, ssize_t n)
 {
        struct timespec start, end;
        static void  (*fn)(const void *, void *, ssize_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "swab");
        if (fn == NULL){
@@ -99,16 +99,16 @@ swab (const void *from, void *to, ssize_t n)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(from, to, n);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("swab", end);
        } else {
                fn(from, to, n);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 int 
@@ -116,7 +116,7 @@ mlockall (int flags)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mlockall");
        if (fn == NULL){
@@ -126,16 +126,16 @@ mlockall (int flags)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mlockall", end);
        } else {
                rval = fn(flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -144,7 +144,7 @@ mlock (const void *addr, size_t len)
 {
        struct timespec start, end;
        static int  (*fn)(const void *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mlock");
        if (fn == NULL){
@@ -154,16 +154,16 @@ mlock (const void *addr, size_t len)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(addr, len);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mlock", end);
        } else {
                rval = fn(addr, len);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -172,7 +172,7 @@ msync (void *addr, size_t length, int flags)
 {
        struct timespec start, end;
        static int  (*fn)(void *, size_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "msync");
        if (fn == NULL){
@@ -182,16 +182,16 @@ msync (void *addr, size_t length, int flags)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(addr, length, flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("msync", end);
        } else {
                rval = fn(addr, length, flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -200,7 +200,7 @@ munlockall (void)
 {
        struct timespec start, end;
        static int  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "munlockall");
        if (fn == NULL){
@@ -210,16 +210,16 @@ munlockall (void)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("munlockall", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -228,7 +228,7 @@ munlock (const void *addr, size_t len)
 {
        struct timespec start, end;
        static int  (*fn)(const void *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "munlock");
        if (fn == NULL){
@@ -238,16 +238,16 @@ munlock (const void *addr, size_t len)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(addr, len);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("munlock", end);
        } else {
                rval = fn(addr, len);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -256,7 +256,7 @@ munmap (void *addr, size_t length)
 {
        struct timespec start, end;
        static int  (*fn)(void *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "munmap");
        if (fn == NULL){
@@ -266,16 +266,16 @@ munmap (void *addr, size_t length)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(addr, length);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("munmap", end);
        } else {
                rval = fn(addr, length);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -284,7 +284,7 @@ memccpy (void *dest, const void *src, int c, size_t n)
 {
        struct timespec start, end;
        static void * (*fn)(void *, const void *, int , size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "memccpy");
        if (fn == NULL){
@@ -294,16 +294,16 @@ memccpy (void *dest, const void *src, int c, size_t n)
        void * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dest, src, c, n);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("memccpy", end);
        } else {
                rval = fn(dest, src, c, n);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -312,7 +312,7 @@ memchr (const void *s, int c, size_t n)
 {
        struct timespec start, end;
        static void * (*fn)(const void *, int , size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "memchr");
        if (fn == NULL){
@@ -322,16 +322,16 @@ memchr (const void *s, int c, size_t n)
        void * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(s, c, n);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("memchr", end);
        } else {
                rval = fn(s, c, n);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -340,7 +340,7 @@ memmove (void *dest, const void *src, size_t n)
 {
        struct timespec start, end;
        static void * (*fn)(void *, const void *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "memmove");
        if (fn == NULL){
@@ -350,16 +350,16 @@ memmove (void *dest, const void *src, size_t n)
        void * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dest, src, n);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("memmove", end);
        } else {
                rval = fn(dest, src, n);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -368,7 +368,7 @@ memrchr (const void *s, int c, size_t n)
 {
        struct timespec start, end;
        static void * (*fn)(const void *, int , size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "memrchr");
        if (fn == NULL){
@@ -378,16 +378,16 @@ memrchr (const void *s, int c, size_t n)
        void * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(s, c, n);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("memrchr", end);
        } else {
                rval = fn(s, c, n);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -396,7 +396,7 @@ mmap (void *addr, size_t length, int prot, int flags, int fd, off_t offset)
 {
        struct timespec start, end;
        static void * (*fn)(void *, size_t , int , int , int , off_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "mmap");
        if (fn == NULL){
@@ -406,16 +406,16 @@ mmap (void *addr, size_t length, int prot, int flags, int fd, off_t offset)
        void * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(addr, length, prot, flags, fd, offset);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("mmap", end);
        } else {
                rval = fn(addr, length, prot, flags, fd, offset);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -424,7 +424,7 @@ memcmp (const void *s1, const void *s2, size_t n)
 {
        struct timespec start, end;
        static int  (*fn)(const void *, const void *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "memcmp");
        if (fn == NULL){
@@ -434,16 +434,16 @@ memcmp (const void *s1, const void *s2, size_t n)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(s1, s2, n);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("memcmp", end);
        } else {
                rval = fn(s1, s2, n);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -452,7 +452,7 @@ pvalloc (size_t size)
 {
        struct timespec start, end;
        static void * (*fn)(size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pvalloc");
        if (fn == NULL){
@@ -462,16 +462,16 @@ pvalloc (size_t size)
        void * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(size);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pvalloc", end);
        } else {
                rval = fn(size);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -480,7 +480,7 @@ posix_memalign (void **memptr, size_t alignment, size_t size)
 {
        struct timespec start, end;
        static int  (*fn)(void **, size_t , size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "posix_memalign");
        if (fn == NULL){
@@ -490,16 +490,16 @@ posix_memalign (void **memptr, size_t alignment, size_t size)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(memptr, alignment, size);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("posix_memalign", end);
        } else {
                rval = fn(memptr, alignment, size);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -508,7 +508,7 @@ memcpy (void *dest, const void *src, size_t n)
 {
        struct timespec start, end;
        static void * (*fn)(void *, const void *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "memcpy");
        if (fn == NULL){
@@ -518,16 +518,16 @@ memcpy (void *dest, const void *src, size_t n)
        void * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dest, src, n);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("memcpy", end);
        } else {
                rval = fn(dest, src, n);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 /*
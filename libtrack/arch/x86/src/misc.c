@@ -6,7 +6,7 @@ encrypt (char block[64], int edflag)
 {
        struct timespec start, end;
        static void  (*fn)(char block[64], int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "encrypt");
        if (fn == NULL){
@@ -15,16 +15,16 @@ encrypt (char block[64], int edflag)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(block, edflag);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("encrypt", end);
        } else {
                fn(block, edflag);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -32,7 +32,7 @@ encrypt_r (char *block, int edflag, struct crypt_data *data)
 {
        struct timespec start, end;
        static void  (*fn)(char *, int , struct crypt_data *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "encrypt_r");
        if (fn == NULL){
@@ -41,16 +41,16 @@ encrypt_r (char *block, int edflag, struct crypt_data *data)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(block, edflag, data);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("encrypt_r", end);
        } else {
                fn(block, edflag, data);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 
@@ -59,7 +59,7 @@ localeconv (void)
 {
        struct timespec start, end;
        static struct lconv * (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "localeconv");
        if (fn == NULL){
@@ -69,16 +69,16 @@ localeconv (void)
        struct lconv * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("localeconv", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -87,7 +87,7 @@ confstr (int name, char *buf, size_t len)
 {
        struct timespec start, end;
        static size_t  (*fn)(int , char *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "confstr");
        if (fn == NULL){
@@ -97,16 +97,16 @@ confstr (int name, char *buf, size_t len)
        size_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name, buf, len);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("confstr", end);
        } else {
                rval = fn(name, buf, len);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -115,7 +115,7 @@ sysconf (int name)
 {
        struct timespec start, end;
        static long  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sysconf");
        if (fn == NULL){
@@ -125,16 +125,16 @@ sysconf (int name)
        long  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sysconf", end);
        } else {
                rval = fn(name);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -143,7 +143,7 @@ setlogmask (int mask)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setlogmask");
        if (fn == NULL){
@@ -153,16 +153,16 @@ setlogmask (int mask)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(mask);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setlogmask", end);
        } else {
                rval = fn(mask);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -172,7 +172,7 @@ feclearexcept (int excepts)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "feclearexcept");
        if (fn == NULL){
@@ -182,16 +182,16 @@ feclearexcept (int excepts)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(excepts);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("feclearexcept", end);
        } else {
                rval = fn(excepts);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -200,7 +200,7 @@ fegetenv (fenv_t *envp)
 {
        struct timespec start, end;
        static int  (*fn)(fenv_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fegetenv");
        if (fn == NULL){
@@ -210,16 +210,16 @@ fegetenv (fenv_t *envp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(envp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fegetenv", end);
        } else {
                rval = fn(envp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -228,7 +228,7 @@ fegetexceptflag (fexcept_t *flagp, int excepts)
 {
        struct timespec start, end;
        static int  (*fn)(fexcept_t *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fegetexceptflag");
        if (fn == NULL){
@@ -238,16 +238,16 @@ fegetexceptflag (fexcept_t *flagp, int excepts)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(flagp, excepts);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fegetexceptflag", end);
        } else {
                rval = fn(flagp, excepts);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -256,7 +256,7 @@ fegetround (void)
 {
        struct timespec start, end;
        static int  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fegetround");
        if (fn == NULL){
@@ -266,16 +266,16 @@ fegetround (void)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fegetround", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -284,7 +284,7 @@ feholdexcept (fenv_t *envp)
 {
        struct timespec start, end;
        static int  (*fn)(fenv_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "feholdexcept");
        if (fn == NULL){
@@ -294,16 +294,16 @@ feholdexcept (fenv_t *envp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(envp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("feholdexcept", end);
        } else {
                rval = fn(envp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -313,7 +313,7 @@ feraiseexcept (int excepts)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "feraiseexcept");
        if (fn == NULL){
@@ -323,16 +323,16 @@ feraiseexcept (int excepts)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(excepts);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("feraiseexcept", end);
        } else {
                rval = fn(excepts);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -341,7 +341,7 @@ ferror (FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ferror");
        if (fn == NULL){
@@ -351,16 +351,16 @@ ferror (FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ferror", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -369,7 +369,7 @@ ferror_unlocked (FILE *stream)
 {
        struct timespec start, end;
        static int  (*fn)(FILE *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ferror_unlocked");
        if (fn == NULL){
@@ -379,16 +379,16 @@ ferror_unlocked (FILE *stream)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(stream);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ferror_unlocked", end);
        } else {
                rval = fn(stream);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -397,7 +397,7 @@ fesetenv (const fenv_t *envp)
 {
        struct timespec start, end;
        static int  (*fn)(const fenv_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fesetenv");
        if (fn == NULL){
@@ -407,16 +407,16 @@ fesetenv (const fenv_t *envp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(envp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fesetenv", end);
        } else {
                rval = fn(envp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -425,7 +425,7 @@ fesetexceptflag (const fexcept_t *flagp, int excepts)
 {
        struct timespec start, end;
        static int  (*fn)(const fexcept_t *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fesetexceptflag");
        if (fn == NULL){
@@ -435,16 +435,16 @@ fesetexceptflag (const fexcept_t *flagp, int excepts)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(flagp, excepts);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fesetexceptflag", end);
        } else {
                rval = fn(flagp, excepts);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -453,7 +453,7 @@ fesetround (int rounding_mode)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fesetround");
        if (fn == NULL){
@@ -463,16 +463,16 @@ fesetround (int rounding_mode)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(rounding_mode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fesetround", end);
        } else {
                rval = fn(rounding_mode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -481,7 +481,7 @@ fetestexcept (int excepts)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fetestexcept");
        if (fn == NULL){
@@ -491,16 +491,16 @@ fetestexcept (int excepts)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(excepts);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fetestexcept", end);
        } else {
                rval = fn(excepts);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -509,7 +509,7 @@ feupdateenv (const fenv_t *envp)
 {
        struct timespec start, end;
        static int  (*fn)(const fenv_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "feupdateenv");
        if (fn == NULL){
@@ -519,16 +519,16 @@ feupdateenv (const fenv_t *envp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(envp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("feupdateenv", end);
        } else {
                rval = fn(envp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -537,7 +537,7 @@ fexecve (int fd, char *const argv[], char *const envp[])
 {
        struct timespec start, end;
        static int  (*fn)(int , char *const , char *const );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fexecve");
        if (fn == NULL){
@@ -547,7 +547,7 @@ fexecve (int fd, char *const argv[], char *const envp[])
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(fd, argv, envp);
 }
 
@@ -557,7 +557,7 @@ open_memstream (char **ptr, size_t *sizeloc)
 {
        struct timespec start, end;
        static FILE * (*fn)(char **, size_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "open_memstream");
        if (fn == NULL){
@@ -567,16 +567,16 @@ open_memstream (char **ptr, size_t *sizeloc)
        FILE * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ptr, sizeloc);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("open_memstream", end);
        } else {
                rval = fn(ptr, sizeloc);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -585,7 +585,7 @@ open_wmemstream (wchar_t **ptr, size_t *sizeloc)
 {
        struct timespec start, end;
        static FILE * (*fn)(wchar_t **, size_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "open_wmemstream");
        if (fn == NULL){
@@ -595,16 +595,16 @@ open_wmemstream (wchar_t **ptr, size_t *sizeloc)
        FILE * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ptr, sizeloc);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("open_wmemstream", end);
        } else {
                rval = fn(ptr, sizeloc);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -613,7 +613,7 @@ crypt (const char *key, const char *salt)
 {
        struct timespec start, end;
        static char * (*fn)(const char *, const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "crypt");
        if (fn == NULL){
@@ -623,16 +623,16 @@ crypt (const char *key, const char *salt)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(key, salt);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("crypt", end);
        } else {
                rval = fn(key, salt);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -641,7 +641,7 @@ crypt_r (const char *key, const char *salt, struct crypt_data *data)
 {
        struct timespec start, end;
        static char * (*fn)(const char *, const char *, struct crypt_data *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "crypt_r");
        if (fn == NULL){
@@ -651,16 +651,16 @@ crypt_r (const char *key, const char *salt, struct crypt_data *data)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(key, salt, data);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("crypt_r", end);
        } else {
                rval = fn(key, salt, data);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -669,7 +669,7 @@ cuserid (char *string)
 {
        struct timespec start, end;
        static char * (*fn)(char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "cuserid");
        if (fn == NULL){
@@ -679,16 +679,16 @@ cuserid (char *string)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(string);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("cuserid", end);
        } else {
                rval = fn(string);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 /*
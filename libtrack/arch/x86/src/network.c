@@ -6,7 +6,7 @@ inet_ntoa (struct in_addr in)
 {
        struct timespec start, end;
        static char * (*fn)(struct in_addr );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "inet_ntoa");
        if (fn == NULL){
@@ -16,16 +16,16 @@ inet_ntoa (struct in_addr in)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(in);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("inet_ntoa", end);
        } else {
                rval = fn(in);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -34,7 +34,7 @@ endhostent (void)
 {
        struct timespec start, end;
        static void  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "endhostent");
        if (fn == NULL){
@@ -43,16 +43,16 @@ endhostent (void)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("endhostent", end);
        } else {
                fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -60,7 +60,7 @@ endnetent (void)
 {
        struct timespec start, end;
        static void  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "endnetent");
        if (fn == NULL){
@@ -69,16 +69,16 @@ endnetent (void)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("endnetent", end);
        } else {
                fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -86,7 +86,7 @@ endprotoent (void)
 {
        struct timespec start, end;
        static void  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "endprotoent");
        if (fn == NULL){
@@ -95,16 +95,16 @@ endprotoent (void)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("endprotoent", end);
        } else {
                fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -112,7 +112,7 @@ endpwent (void)
 {
        struct timespec start, end;
        static void  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "endpwent");
        if (fn == NULL){
@@ -121,16 +121,16 @@ endpwent (void)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("endpwent", end);
        } else {
                fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -138,7 +138,7 @@ endservent (void)
 {
        struct timespec start, end;
        static void  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "endservent");
        if (fn == NULL){
@@ -147,16 +147,16 @@ endservent (void)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("endservent", end);
        } else {
                fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -164,7 +164,7 @@ endutent (void)
 {
        struct timespec start, end;
        static void  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "endutent");
        if (fn == NULL){
@@ -173,16 +173,16 @@ endutent (void)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("endutent", end);
        } else {
                fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 int 
@@ -190,7 +190,7 @@ shutdown (int sockfd, int how)
 {
        struct timespec start, end;
        static int  (*fn)(int , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "shutdown");
        if (fn == NULL){
@@ -200,16 +200,16 @@ shutdown (int sockfd, int how)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, how);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("shutdown", end);
        } else {
                rval = fn(sockfd, how);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -218,7 +218,7 @@ sockatmark (int sockfd)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sockatmark");
        if (fn == NULL){
@@ -228,16 +228,16 @@ sockatmark (int sockfd)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sockatmark", end);
        } else {
                rval = fn(sockfd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -246,7 +246,7 @@ socket (int domain, int type, int protocol)
 {
        struct timespec start, end;
        static int  (*fn)(int , int , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "socket");
        if (fn == NULL){
@@ -256,16 +256,16 @@ socket (int domain, int type, int protocol)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(domain, type, protocol);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("socket", end);
        } else {
                rval = fn(domain, type, protocol);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -274,7 +274,7 @@ socketpair (int domain, int type, int protocol, int sv[2])
 {
        struct timespec start, end;
        static int  (*fn)(int , int , int , int sv[2]);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "socketpair");
        if (fn == NULL){
@@ -284,16 +284,16 @@ socketpair (int domain, int type, int protocol, int sv[2])
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(domain, type, protocol, sv);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("socketpair", end);
        } else {
                rval = fn(domain, type, protocol, sv);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -302,7 +302,7 @@ setsockopt (int sockfd, int level, int optname, const void *optval, socklen_t op
 {
        struct timespec start, end;
        static int  (*fn)(int , int , int , const void *, socklen_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setsockopt");
        if (fn == NULL){
@@ -312,16 +312,16 @@ setsockopt (int sockfd, int level, int optname, const void *optval, socklen_t op
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, level, optname, optval, optlen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setsockopt", end);
        } else {
                rval = fn(sockfd, level, optname, optval, optlen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -330,7 +330,7 @@ select (int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct t
 {
        struct timespec start, end;
        static int  (*fn)(int , fd_set *, fd_set *, fd_set *, struct timeval *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "select");
        if (fn == NULL){
@@ -340,16 +340,16 @@ select (int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct t
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(nfds, readfds, writefds, exceptfds, timeout);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
 	       _logtime("select", end);
        } else {
                rval = fn(nfds, readfds, writefds, exceptfds, timeout);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -358,7 +358,7 @@ recvfrom (int sockfd, void *buf, size_t len, int flags, struct sockaddr *src_add
 {
        struct timespec start, end;
        static ssize_t  (*fn)(int , void *, size_t , int , struct sockaddr *, socklen_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "recvfrom");
        if (fn == NULL){
@@ -368,9 +368,9 @@ recvfrom (int sockfd, void *buf, size_t len, int flags, struct sockaddr *src_add
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, buf, len, flags, src_addr, addrlen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                char name[] = "recvfrom_?";
                name[9] = fd_type(sockfd);
@@ -379,7 +379,7 @@ recvfrom (int sockfd, void *buf, size_t len, int flags, struct sockaddr *src_add
                rval = fn(sockfd, buf, len, flags, src_addr, addrlen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -388,7 +388,7 @@ recv (int sockfd, void *buf, size_t len, int flags)
 {
        struct timespec start, end;
        static ssize_t  (*fn)(int , void *, size_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "recv");
        if (fn == NULL){
@@ -398,9 +398,9 @@ recv (int sockfd, void *buf, size_t len, int flags)
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, buf, len, flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
 		char name[] = "recv_?";
 		name[5] = fd_type(sockfd);
@@ -409,7 +409,7 @@ recv (int sockfd, void *buf, size_t len, int flags)
                rval = fn(sockfd, buf, len, flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -418,7 +418,7 @@ recvmsg (int sockfd, struct msghdr *msg, int flags)
 {
        struct timespec start, end;
        static ssize_t  (*fn)(int , struct msghdr *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "recvmsg");
        if (fn == NULL){
@@ -428,9 +428,9 @@ recvmsg (int sockfd, struct msghdr *msg, int flags)
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, msg, flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                char name[] = "recvmsg_?";
                name[8] = fd_type(sockfd);
                _timespec_sub(&end, &start);
@@ -439,7 +439,7 @@ recvmsg (int sockfd, struct msghdr *msg, int flags)
                rval = fn(sockfd, msg, flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -448,7 +448,7 @@ send (int sockfd, const void *buf, size_t len, int flags)
 {
        struct timespec start, end;
        static ssize_t  (*fn)(int , const void *, size_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "send");
        if (fn == NULL){
@@ -458,9 +458,9 @@ send (int sockfd, const void *buf, size_t len, int flags)
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, buf, len, flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
 		char name[] = "send_?";
 		name[5] = fd_type(sockfd); 
@@ -469,7 +469,7 @@ send (int sockfd, const void *buf, size_t len, int flags)
                rval = fn(sockfd, buf, len, flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -478,7 +478,7 @@ sendmsg (int sockfd, const struct msghdr *msg, int flags)
 {
        struct timespec start, end;
        static ssize_t  (*fn)(int , const struct msghdr *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sendmsg");
        if (fn == NULL){
@@ -488,9 +488,9 @@ sendmsg (int sockfd, const struct msghdr *msg, int flags)
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, msg, flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                char name[] = "sendmsg_?";
                name[8] = fd_type(sockfd);
                _timespec_sub(&end, &start);
@@ -499,7 +499,7 @@ sendmsg (int sockfd, const struct msghdr *msg, int flags)
                rval = fn(sockfd, msg, flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -508,7 +508,7 @@ sendto (int sockfd, const void *buf, size_t len, int flags, const struct sockadd
 {
        struct timespec start, end;
        static ssize_t  (*fn)(int , const void *, size_t , int , const struct sockaddr *, socklen_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sendto");
        if (fn == NULL){
@@ -518,9 +518,9 @@ sendto (int sockfd, const void *buf, size_t len, int flags, const struct sockadd
        ssize_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, buf, len, flags, dest_addr, addrlen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                char name[] = "sendto_?";
                name[7] = fd_type(sockfd);
@@ -529,7 +529,7 @@ sendto (int sockfd, const void *buf, size_t len, int flags, const struct sockadd
                rval = fn(sockfd, buf, len, flags, dest_addr, addrlen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -538,7 +538,7 @@ listen (int sockfd, int backlog)
 {
        struct timespec start, end;
        static int  (*fn)(int , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "listen");
        if (fn == NULL){
@@ -548,16 +548,16 @@ listen (int sockfd, int backlog)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, backlog);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("listen", end);
        } else {
                rval = fn(sockfd, backlog);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -566,7 +566,7 @@ getprotobyname (const char *name)
 {
        struct timespec start, end;
        static struct protoent * (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getprotobyname");
        if (fn == NULL){
@@ -576,16 +576,16 @@ getprotobyname (const char *name)
        struct protoent * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getprotobyname", end);
        } else {
                rval = fn(name);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -594,7 +594,7 @@ getprotobynumber (int proto)
 {
        struct timespec start, end;
        static struct protoent * (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getprotobynumber");
        if (fn == NULL){
@@ -604,16 +604,16 @@ getprotobynumber (int proto)
        struct protoent * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(proto);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getprotobynumber", end);
        } else {
                rval = fn(proto);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -622,7 +622,7 @@ getprotoent (void)
 {
        struct timespec start, end;
        static struct protoent * (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getprotoent");
        if (fn == NULL){
@@ -632,16 +632,16 @@ getprotoent (void)
        struct protoent * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getprotoent", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -650,7 +650,7 @@ getservbyname (const char *name, const char *proto)
 {
        struct timespec start, end;
        static struct servent * (*fn)(const char *, const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getservbyname");
        if (fn == NULL){
@@ -660,16 +660,16 @@ getservbyname (const char *name, const char *proto)
        struct servent * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name, proto);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getservbyname", end);
        } else {
                rval = fn(name, proto);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -678,7 +678,7 @@ getservbyport (int port, const char *proto)
 {
        struct timespec start, end;
        static struct servent * (*fn)(int , const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getservbyport");
        if (fn == NULL){
@@ -688,16 +688,16 @@ getservbyport (int port, const char *proto)
        struct servent * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(port, proto);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getservbyport", end);
        } else {
                rval = fn(port, proto);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -706,7 +706,7 @@ getservent (void)
 {
        struct timespec start, end;
        static struct servent * (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getservent");
        if (fn == NULL){
@@ -716,16 +716,16 @@ getservent (void)
        struct servent * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getservent", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -734,7 +734,7 @@ getpeername (int sockfd, struct sockaddr *addr, socklen_t *addrlen)
 {
        struct timespec start, end;
        static int  (*fn)(int , struct sockaddr *, socklen_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getpeername");
        if (fn == NULL){
@@ -744,16 +744,16 @@ getpeername (int sockfd, struct sockaddr *addr, socklen_t *addrlen)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, addr, addrlen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getpeername", end);
        } else {
                rval = fn(sockfd, addr, addrlen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -762,7 +762,7 @@ getsockname (int sockfd, struct sockaddr *addr, socklen_t *addrlen)
 {
        struct timespec start, end;
        static int  (*fn)(int , struct sockaddr *, socklen_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getsockname");
        if (fn == NULL){
@@ -772,16 +772,16 @@ getsockname (int sockfd, struct sockaddr *addr, socklen_t *addrlen)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, addr, addrlen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getsockname", end);
        } else {
                rval = fn(sockfd, addr, addrlen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -790,7 +790,7 @@ getsockopt (int sockfd, int level, int optname, void *optval, socklen_t *optlen)
 {
        struct timespec start, end;
        static int  (*fn)(int , int , int , void *, socklen_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getsockopt");
        if (fn == NULL){
@@ -800,16 +800,16 @@ getsockopt (int sockfd, int level, int optname, void *optval, socklen_t *optlen)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, level, optname, optval, optlen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getsockopt", end);
        } else {
                rval = fn(sockfd, level, optname, optval, optlen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -818,7 +818,7 @@ inet_aton (const char *cp, struct in_addr *inp)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, struct in_addr *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "inet_aton");
        if (fn == NULL){
@@ -828,16 +828,16 @@ inet_aton (const char *cp, struct in_addr *inp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(cp, inp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("inet_aton", end);
        } else {
                rval = fn(cp, inp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -846,7 +846,7 @@ inet_pton (int af, const char *src, void *dst)
 {
        struct timespec start, end;
        static int  (*fn)(int , const char *, void *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "inet_pton");
        if (fn == NULL){
@@ -856,16 +856,16 @@ inet_pton (int af, const char *src, void *dst)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(af, src, dst);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("inet_pton", end);
        } else {
                rval = fn(af, src, dst);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -874,7 +874,7 @@ getnameinfo (const struct sockaddr *sa, socklen_t salen, char *host, size_t host
 {
        struct timespec start, end;
        static int  (*fn)(const struct sockaddr *, socklen_t , char *, size_t , char *, size_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getnameinfo");
        if (fn == NULL){
@@ -884,16 +884,16 @@ getnameinfo (const struct sockaddr *sa, socklen_t salen, char *host, size_t host
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sa, salen, host, hostlen, serv, servlen, flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getnameinfo", end);
        } else {
                rval = fn(sa, salen, host, hostlen, serv, servlen, flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -902,7 +902,7 @@ gethostbyaddr_r (const void *addr, socklen_t len, int type, struct hostent *ret,
 {
        struct timespec start, end;
        static int  (*fn)(const void *, socklen_t , int , struct hostent *, char *, size_t , struct hostent **, int *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "gethostbyaddr_r");
        if (fn == NULL){
@@ -912,16 +912,16 @@ gethostbyaddr_r (const void *addr, socklen_t len, int type, struct hostent *ret,
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(addr, len, type, ret, buf, buflen, result, h_errnop);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("gethostbyaddr_r", end);
        } else {
                rval = fn(addr, len, type, ret, buf, buflen, result, h_errnop);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -930,7 +930,7 @@ gethostbyname2_r (const char *name, int af, struct hostent *ret, char *buf, size
 {
        struct timespec start, end;
        static int  (*fn)(const char *, int , struct hostent *, char *, size_t , struct hostent **, int *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "gethostbyname2_r");
        if (fn == NULL){
@@ -940,16 +940,16 @@ gethostbyname2_r (const char *name, int af, struct hostent *ret, char *buf, size
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name, af, ret, buf, buflen, result, h_errnop);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("gethostbyname2_r", end);
        } else {
                rval = fn(name, af, ret, buf, buflen, result, h_errnop);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -958,7 +958,7 @@ gethostbyname_r (const char *name, struct hostent *ret, char *buf, size_t buflen
 {
        struct timespec start, end;
        static int  (*fn)(const char *, struct hostent *, char *, size_t , struct hostent **, int *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "gethostbyname_r");
        if (fn == NULL){
@@ -968,16 +968,16 @@ gethostbyname_r (const char *name, struct hostent *ret, char *buf, size_t buflen
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name, ret, buf, buflen, result, h_errnop);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("gethostbyname_r", end);
        } else {
                rval = fn(name, ret, buf, buflen, result, h_errnop);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -986,7 +986,7 @@ gethostent_r (struct hostent *ret, char *buf, size_t buflen, struct hostent **re
 {
        struct timespec start, end;
        static int  (*fn)(struct hostent *, char *, size_t , struct hostent **, int *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "gethostent_r");
        if (fn == NULL){
@@ -996,16 +996,16 @@ gethostent_r (struct hostent *ret, char *buf, size_t buflen, struct hostent **re
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ret, buf, buflen, result, h_errnop);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("gethostent_r", end);
        } else {
                rval = fn(ret, buf, buflen, result, h_errnop);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1014,7 +1014,7 @@ gethostname (char *name, size_t len)
 {
        struct timespec start, end;
        static int  (*fn)(char *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "gethostname");
        if (fn == NULL){
@@ -1024,16 +1024,16 @@ gethostname (char *name, size_t len)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name, len);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("gethostname", end);
        } else {
                rval = fn(name, len);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1042,7 +1042,7 @@ getaddrinfo (const char *node, const char *service, const struct addrinfo *hints
 {
        struct timespec start, end;
        static int  (*fn)(const char *, const char *, const struct addrinfo *, struct addrinfo **);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getaddrinfo");
        if (fn == NULL){
@@ -1052,16 +1052,16 @@ getaddrinfo (const char *node, const char *service, const struct addrinfo *hints
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(node, service, hints, res);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getaddrinfo", end);
        } else {
                rval = fn(node, service, hints, res);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1070,7 +1070,7 @@ gai_strerror (int errcode)
 {
        struct timespec start, end;
        static const char * (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "gai_strerror");
        if (fn == NULL){
@@ -1080,16 +1080,16 @@ gai_strerror (int errcode)
        const char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(errcode);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("gai_strerror", end);
        } else {
                rval = fn(errcode);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1098,7 +1098,7 @@ connect (int sockfd, const struct sockaddr *addr, socklen_t addrlen)
 {
        struct timespec start, end;
        static int  (*fn)(int , const struct sockaddr *, socklen_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "connect");
        if (fn == NULL){
@@ -1108,16 +1108,16 @@ connect (int sockfd, const struct sockaddr *addr, socklen_t addrlen)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, addr, addrlen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("connect", end);
        } else {
                rval = fn(sockfd, addr, addrlen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1126,7 +1126,7 @@ freeaddrinfo (struct addrinfo *res)
 {
        struct timespec start, end;
        static void  (*fn)(struct addrinfo *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "freeaddrinfo");
        if (fn == NULL){
@@ -1135,16 +1135,16 @@ freeaddrinfo (struct addrinfo *res)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(res);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("freeaddrinfo", end);
        } else {
                fn(res);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 int 
@@ -1152,7 +1152,7 @@ bind (int sockfd, const struct sockaddr *addr, socklen_t addrlen)
 {
        struct timespec start, end;
        static int  (*fn)(int , const struct sockaddr *, socklen_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "bind");
        if (fn == NULL){
@@ -1162,16 +1162,16 @@ bind (int sockfd, const struct sockaddr *addr, socklen_t addrlen)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, addr, addrlen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("bind", end);
        } else {
                rval = fn(sockfd, addr, addrlen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1180,7 +1180,7 @@ accept (int sockfd, struct sockaddr *addr, socklen_t *addrlen)
 {
        struct timespec start, end;
        static int  (*fn)(int , struct sockaddr *, socklen_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "accept");
        if (fn == NULL){
@@ -1190,16 +1190,16 @@ accept (int sockfd, struct sockaddr *addr, socklen_t *addrlen)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sockfd, addr, addrlen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("accept", end);
        } else {
                rval = fn(sockfd, addr, addrlen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1208,7 +1208,7 @@ inet_ntop (int af, const void *src, char *dst, socklen_t size)
 {
        struct timespec start, end;
        static const char * (*fn)(int , const void *, char *, socklen_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "inet_ntop");
        if (fn == NULL){
@@ -1218,16 +1218,16 @@ inet_ntop (int af, const void *src, char *dst, socklen_t size)
        const char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(af, src, dst, size);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("inet_ntop", end);
        } else {
                rval = fn(af, src, dst, size);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1236,7 +1236,7 @@ inet_addr (const char *cp)
 {
        struct timespec start, end;
        static in_addr_t  (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "inet_addr");
        if (fn == NULL){
@@ -1246,16 +1246,16 @@ inet_addr (const char *cp)
        in_addr_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(cp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("inet_addr", end);
        } else {
                rval = fn(cp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1264,7 +1264,7 @@ inet_lnaof (struct in_addr in)
 {
        struct timespec start, end;
        static in_addr_t  (*fn)(struct in_addr );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "inet_lnaof");
        if (fn == NULL){
@@ -1274,16 +1274,16 @@ inet_lnaof (struct in_addr in)
        in_addr_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(in);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("inet_lnaof", end);
        } else {
                rval = fn(in);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1292,7 +1292,7 @@ inet_netof (struct in_addr in)
 {
        struct timespec start, end;
        static in_addr_t  (*fn)(struct in_addr );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "inet_netof");
        if (fn == NULL){
@@ -1302,16 +1302,16 @@ inet_netof (struct in_addr in)
        in_addr_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(in);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("inet_netof", end);
        } else {
                rval = fn(in);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1320,7 +1320,7 @@ inet_network (const char *cp)
 {
        struct timespec start, end;
        static in_addr_t  (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "inet_network");
        if (fn == NULL){
@@ -1330,16 +1330,16 @@ inet_network (const char *cp)
        in_addr_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(cp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("inet_network", end);
        } else {
                rval = fn(cp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1348,7 +1348,7 @@ gethostid (void)
 {
        struct timespec start, end;
        static long  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "gethostid");
        if (fn == NULL){
@@ -1358,16 +1358,16 @@ gethostid (void)
        long  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("gethostid", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -1376,7 +1376,7 @@ gethostbyaddr (const void *addr, socklen_t len, int type)
 {
        struct timespec start, end;
        static struct hostent * (*fn)(const void *, socklen_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "gethostbyaddr");
        if (fn == NULL){
@@ -1386,16 +1386,16 @@ gethostbyaddr (const void *addr, socklen_t len, int type)
        struct hostent * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(addr, len, type);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("gethostbyaddr", end);
        } else {
                rval = fn(addr, len, type);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1404,7 +1404,7 @@ gethostbyname (const char *name)
 {
        struct timespec start, end;
        static struct hostent * (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "gethostbyname");
        if (fn == NULL){
@@ -1414,16 +1414,16 @@ gethostbyname (const char *name)
        struct hostent * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("gethostbyname", end);
        } else {
                rval = fn(name);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1432,7 +1432,7 @@ gethostent (void)
 {
        struct timespec start, end;
        static struct hostent * (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "gethostent");
        if (fn == NULL){
@@ -1442,16 +1442,16 @@ gethostent (void)
        struct hostent * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("gethostent", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -1460,7 +1460,7 @@ getnetbyaddr (uint32_t net, int type)
 {
        struct timespec start, end;
        static struct netent * (*fn)(uint32_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getnetbyaddr");
        if (fn == NULL){
@@ -1470,16 +1470,16 @@ getnetbyaddr (uint32_t net, int type)
        struct netent * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(net, type);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getnetbyaddr", end);
        } else {
                rval = fn(net, type);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1488,7 +1488,7 @@ getnetbyname (const char *name)
 {
        struct timespec start, end;
        static struct netent * (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getnetbyname");
        if (fn == NULL){
@@ -1498,16 +1498,16 @@ getnetbyname (const char *name)
        struct netent * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getnetbyname", end);
        } else {
                rval = fn(name);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1516,7 +1516,7 @@ getnetent (void)
 {
        struct timespec start, end;
        static struct netent * (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getnetent");
        if (fn == NULL){
@@ -1526,16 +1526,16 @@ getnetent (void)
        struct netent * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getnetent", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -1544,7 +1544,7 @@ htons (uint16_t hostshort)
 {
        struct timespec start, end;
        static uint16_t  (*fn)(uint16_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "htons");
        if (fn == NULL){
@@ -1554,16 +1554,16 @@ htons (uint16_t hostshort)
        uint16_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(hostshort);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("htons", end);
        } else {
                rval = fn(hostshort);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1572,7 +1572,7 @@ ntohs (uint16_t netshort)
 {
        struct timespec start, end;
        static uint16_t  (*fn)(uint16_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ntohs");
        if (fn == NULL){
@@ -1582,16 +1582,16 @@ ntohs (uint16_t netshort)
        uint16_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(netshort);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ntohs", end);
        } else {
                rval = fn(netshort);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1600,7 +1600,7 @@ htonl (uint32_t hostlong)
 {
        struct timespec start, end;
        static uint32_t  (*fn)(uint32_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "htonl");
        if (fn == NULL){
@@ -1610,16 +1610,16 @@ htonl (uint32_t hostlong)
        uint32_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(hostlong);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("htonl", end);
        } else {
                rval = fn(hostlong);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1628,7 +1628,7 @@ ntohl (uint32_t netlong)
 {
        struct timespec start, end;
        static uint32_t  (*fn)(uint32_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ntohl");
        if (fn == NULL){
@@ -1638,16 +1638,16 @@ ntohl (uint32_t netlong)
        uint32_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(netlong);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ntohl", end);
        } else {
                rval = fn(netlong);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1656,7 +1656,7 @@ sethostent (int stayopen)
 {
        struct timespec start, end;
        static void  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sethostent");
        if (fn == NULL){
@@ -1665,16 +1665,16 @@ sethostent (int stayopen)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(stayopen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sethostent", end);
        } else {
                fn(stayopen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -1682,7 +1682,7 @@ setnetent (int stayopen)
 {
        struct timespec start, end;
        static void  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setnetent");
        if (fn == NULL){
@@ -1691,16 +1691,16 @@ setnetent (int stayopen)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(stayopen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setnetent", end);
        } else {
                fn(stayopen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -1708,7 +1708,7 @@ setprotoent (int stayopen)
 {
        struct timespec start, end;
        static void  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setprotoent");
        if (fn == NULL){
@@ -1717,16 +1717,16 @@ setprotoent (int stayopen)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(stayopen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setprotoent", end);
        } else {
                fn(stayopen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -1734,7 +1734,7 @@ setservent (int stayopen)
 {
        struct timespec start, end;
        static void  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setservent");
        if (fn == NULL){
@@ -1743,16 +1743,16 @@ setservent (int stayopen)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(stayopen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setservent", end);
        } else {
                fn(stayopen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 /*
  * End of Network
@@ -6,7 +6,7 @@ signal(int signum, sighandler_t handler)
 {
        struct timespec start, end;
        static sighandler_t  (*fn)(int , sighandler_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "signal");
        if (fn == NULL){
@@ -16,16 +16,16 @@ signal(int signum, sighandler_t handler)
        sighandler_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(signum, handler);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("signal", end);
        } else {
                rval = fn(signum, handler);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -34,7 +34,7 @@ sigset (int sig, sighandler_t disp)
 {
        struct timespec start, end;
        static sighandler_t  (*fn)(int , sighandler_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigset");
        if (fn == NULL){
@@ -44,16 +44,16 @@ sigset (int sig, sighandler_t disp)
        sighandler_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sig, disp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sigset", end);
        } else {
                rval = fn(sig, disp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -62,7 +62,7 @@ ulimit (int cmd, long newlimit)
 {
        struct timespec start, end;
        static long  (*fn)(int , long );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ulimit");
        if (fn == NULL){
@@ -72,16 +72,16 @@ ulimit (int cmd, long newlimit)
        long  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(cmd, newlimit);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ulimit", end);
        } else {
                rval = fn(cmd, newlimit);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -90,7 +90,7 @@ umask (mode_t mask)
 {
        struct timespec start, end;
        static mode_t  (*fn)(mode_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "umask");
        if (fn == NULL){
@@ -100,16 +100,16 @@ umask (mode_t mask)
        mode_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(mask);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("umask", end);
        } else {
                rval = fn(mask);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -118,7 +118,7 @@ system (const char *command)
 {
        struct timespec start, end;
        static int  (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "system");
        if (fn == NULL){
@@ -128,16 +128,16 @@ system (const char *command)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(command);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("system", end);
        } else {
                rval = fn(command);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -146,7 +146,7 @@ sigaction (int signum, const struct sigaction *act,  struct sigaction *oldact)
 {
        struct timespec start, end;
        static int  (*fn)(int , const struct sigaction *,  struct sigaction *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigaction");
        if (fn == NULL){
@@ -156,16 +156,16 @@ sigaction (int signum, const struct sigaction *act,  struct sigaction *oldact)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(signum, act, oldact);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sigaction", end);
        } else {
                rval = fn(signum, act, oldact);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -174,7 +174,7 @@ sigaddset (sigset_t *set, int signum)
 {
        struct timespec start, end;
        static int  (*fn)(sigset_t *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigaddset");
        if (fn == NULL){
@@ -184,16 +184,16 @@ sigaddset (sigset_t *set, int signum)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(set, signum);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sigaddset", end);
        } else {
                rval = fn(set, signum);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -202,7 +202,7 @@ sigaltstack (const stack_t *ss, stack_t *oss)
 {
        struct timespec start, end;
        static int  (*fn)(const stack_t *, stack_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigaltstack");
        if (fn == NULL){
@@ -212,16 +212,16 @@ sigaltstack (const stack_t *ss, stack_t *oss)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ss, oss);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sigaltstack", end);
        } else {
                rval = fn(ss, oss);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -230,7 +230,7 @@ sigdelset (sigset_t *set, int signum)
 {
        struct timespec start, end;
        static int  (*fn)(sigset_t *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigdelset");
        if (fn == NULL){
@@ -240,16 +240,16 @@ sigdelset (sigset_t *set, int signum)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(set, signum);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sigdelset", end);
        } else {
                rval = fn(set, signum);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -258,7 +258,7 @@ sigemptyset (sigset_t *set)
 {
        struct timespec start, end;
        static int  (*fn)(sigset_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigemptyset");
        if (fn == NULL){
@@ -268,16 +268,16 @@ sigemptyset (sigset_t *set)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(set);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sigemptyset", end);
        } else {
                rval = fn(set);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -286,7 +286,7 @@ sigfillset (sigset_t *set)
 {
        struct timespec start, end;
        static int  (*fn)(sigset_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigfillset");
        if (fn == NULL){
@@ -296,16 +296,16 @@ sigfillset (sigset_t *set)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(set);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sigfillset", end);
        } else {
                rval = fn(set);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -314,7 +314,7 @@ sighold (int sig)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sighold");
        if (fn == NULL){
@@ -324,16 +324,16 @@ sighold (int sig)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sig);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sighold", end);
        } else {
                rval = fn(sig);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -342,7 +342,7 @@ sigignore (int sig)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigignore");
        if (fn == NULL){
@@ -352,16 +352,16 @@ sigignore (int sig)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sig);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sigignore", end);
        } else {
                rval = fn(sig);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -370,7 +370,7 @@ siginterrupt (int sig, int flag)
 {
        struct timespec start, end;
        static int  (*fn)(int , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "siginterrupt");
        if (fn == NULL){
@@ -380,16 +380,16 @@ siginterrupt (int sig, int flag)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sig, flag);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("siginterrupt", end);
        } else {
                rval = fn(sig, flag);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -398,7 +398,7 @@ sigismember (const sigset_t *set, int signum)
 {
        struct timespec start, end;
        static int  (*fn)(const sigset_t *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigismember");
        if (fn == NULL){
@@ -408,16 +408,16 @@ sigismember (const sigset_t *set, int signum)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(set, signum);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sigismember", end);
        } else {
                rval = fn(set, signum);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -426,7 +426,7 @@ sigpending (sigset_t *set)
 {
        struct timespec start, end;
        static int  (*fn)(sigset_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigpending");
        if (fn == NULL){
@@ -436,16 +436,16 @@ sigpending (sigset_t *set)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(set);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sigpending", end);
        } else {
                rval = fn(set);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -454,7 +454,7 @@ sigprocmask (int how, const sigset_t *set, sigset_t *oldset)
 {
        struct timespec start, end;
        static int  (*fn)(int , const sigset_t *, sigset_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigprocmask");
        if (fn == NULL){
@@ -464,16 +464,16 @@ sigprocmask (int how, const sigset_t *set, sigset_t *oldset)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(how, set, oldset);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sigprocmask", end);
        } else {
                rval = fn(how, set, oldset);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -482,7 +482,7 @@ sigqueue (pid_t pid, int sig, const union sigval value)
 {
        struct timespec start, end;
        static int  (*fn)(pid_t , int , const union sigval );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigqueue");
        if (fn == NULL){
@@ -492,16 +492,16 @@ sigqueue (pid_t pid, int sig, const union sigval value)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pid, sig, value);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sigqueue", end);
        } else {
                rval = fn(pid, sig, value);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -510,7 +510,7 @@ sigrelse (int sig)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigrelse");
        if (fn == NULL){
@@ -520,16 +520,16 @@ sigrelse (int sig)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sig);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sigrelse", end);
        } else {
                rval = fn(sig);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -538,7 +538,7 @@ setuid (uid_t uid)
 {
        struct timespec start, end;
        static int  (*fn)(uid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setuid");
        if (fn == NULL){
@@ -548,16 +548,16 @@ setuid (uid_t uid)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(uid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setuid", end);
        } else {
                rval = fn(uid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -566,7 +566,7 @@ seteuid (uid_t euid)
 {
        struct timespec start, end;
        static int  (*fn)(uid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "seteuid");
        if (fn == NULL){
@@ -576,16 +576,16 @@ seteuid (uid_t euid)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(euid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("seteuid", end);
        } else {
                rval = fn(euid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -594,7 +594,7 @@ setegid (gid_t egid)
 {
        struct timespec start, end;
        static int  (*fn)(gid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setegid");
        if (fn == NULL){
@@ -604,16 +604,16 @@ setegid (gid_t egid)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(egid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setegid", end);
        } else {
                rval = fn(egid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -622,7 +622,7 @@ sched_getparam (pid_t pid, struct sched_param *param)
 {
        struct timespec start, end;
        static int  (*fn)(pid_t , struct sched_param *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sched_getparam");
        if (fn == NULL){
@@ -632,16 +632,16 @@ sched_getparam (pid_t pid, struct sched_param *param)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pid, param);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sched_getparam", end);
        } else {
                rval = fn(pid, param);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -650,7 +650,7 @@ sched_get_priority_max (int policy)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sched_get_priority_max");
        if (fn == NULL){
@@ -660,16 +660,16 @@ sched_get_priority_max (int policy)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(policy);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sched_get_priority_max", end);
        } else {
                rval = fn(policy);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -678,7 +678,7 @@ sched_get_priority_min (int policy)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sched_get_priority_min");
        if (fn == NULL){
@@ -688,16 +688,16 @@ sched_get_priority_min (int policy)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(policy);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sched_get_priority_min", end);
        } else {
                rval = fn(policy);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -706,7 +706,7 @@ sched_getscheduler (pid_t pid)
 {
        struct timespec start, end;
        static int  (*fn)(pid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sched_getscheduler");
        if (fn == NULL){
@@ -716,16 +716,16 @@ sched_getscheduler (pid_t pid)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sched_getscheduler", end);
        } else {
                rval = fn(pid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -734,7 +734,7 @@ sched_rr_get_interval (pid_t pid, struct timespec * tp)
 {
        struct timespec start, end;
        static int  (*fn)(pid_t , struct timespec * );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sched_rr_get_interval");
        if (fn == NULL){
@@ -744,16 +744,16 @@ sched_rr_get_interval (pid_t pid, struct timespec * tp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pid, tp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sched_rr_get_interval", end);
        } else {
                rval = fn(pid, tp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -762,7 +762,7 @@ sched_setparam (pid_t pid, const struct sched_param *param)
 {
        struct timespec start, end;
        static int  (*fn)(pid_t , const struct sched_param *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sched_setparam");
        if (fn == NULL){
@@ -772,16 +772,16 @@ sched_setparam (pid_t pid, const struct sched_param *param)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pid, param);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sched_setparam", end);
        } else {
                rval = fn(pid, param);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -790,7 +790,7 @@ sched_setscheduler (pid_t pid, int policy, const struct sched_param *param)
 {
        struct timespec start, end;
        static int  (*fn)(pid_t , int , const struct sched_param *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sched_setscheduler");
        if (fn == NULL){
@@ -800,16 +800,16 @@ sched_setscheduler (pid_t pid, int policy, const struct sched_param *param)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pid, policy, param);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("sched_setscheduler", end);
        } else {
                rval = fn(pid, policy, param);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -818,7 +818,7 @@ psiginfo (const siginfo_t *pinfo, const char *s)
 {
        struct timespec start, end;
        static void  (*fn)(const siginfo_t *, const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "psiginfo");
        if (fn == NULL){
@@ -827,16 +827,16 @@ psiginfo (const siginfo_t *pinfo, const char *s)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(pinfo, s);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("psiginfo", end);
        } else {
                fn(pinfo, s);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -844,7 +844,7 @@ psignal (int sig, const char *s)
 {
        struct timespec start, end;
        static void  (*fn)(int , const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "psignal");
        if (fn == NULL){
@@ -853,16 +853,16 @@ psignal (int sig, const char *s)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(sig, s);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("psignal", end);
        } else {
                fn(sig, s);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 int 
@@ -870,7 +870,7 @@ nice (int inc)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "nice");
        if (fn == NULL){
@@ -880,16 +880,16 @@ nice (int inc)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(inc);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("nice", end);
        } else {
                rval = fn(inc);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -898,7 +898,7 @@ killpg (int pgrp, int sig)
 {
        struct timespec start, end;
        static int  (*fn)(int , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "killpg");
        if (fn == NULL){
@@ -908,16 +908,16 @@ killpg (int pgrp, int sig)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pgrp, sig);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("killpg", end);
        } else {
                rval = fn(pgrp, sig);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -926,7 +926,7 @@ kill (pid_t pid, int sig)
 {
        struct timespec start, end;
        static int  (*fn)(pid_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "kill");
        if (fn == NULL){
@@ -936,16 +936,16 @@ kill (pid_t pid, int sig)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pid, sig);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("kill", end);
        } else {
                rval = fn(pid, sig);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -954,7 +954,7 @@ getrusage (int who, struct rusage *usage)
 {
        struct timespec start, end;
        static int  (*fn)(int , struct rusage *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getrusage");
        if (fn == NULL){
@@ -964,16 +964,16 @@ getrusage (int who, struct rusage *usage)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(who, usage);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getrusage", end);
        } else {
                rval = fn(who, usage);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -982,7 +982,7 @@ raise (int sig)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "raise");
        if (fn == NULL){
@@ -992,16 +992,16 @@ raise (int sig)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(sig);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("raise", end);
        } else {
                rval = fn(sig);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1010,7 +1010,7 @@ setpgid (pid_t pid, pid_t pgid)
 {
        struct timespec start, end;
        static int  (*fn)(pid_t , pid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setpgid");
        if (fn == NULL){
@@ -1020,16 +1020,16 @@ setpgid (pid_t pid, pid_t pgid)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pid, pgid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setpgid", end);
        } else {
                rval = fn(pid, pgid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1038,7 +1038,7 @@ setpgrp (void)
 {
        struct timespec start, end;
        static int  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setpgrp");
        if (fn == NULL){
@@ -1048,16 +1048,16 @@ setpgrp (void)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setpgrp", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -1067,7 +1067,7 @@ setregid (gid_t rgid, gid_t egid)
 {
        struct timespec start, end;
        static int  (*fn)(gid_t , gid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setregid");
        if (fn == NULL){
@@ -1077,16 +1077,16 @@ setregid (gid_t rgid, gid_t egid)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(rgid, egid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setregid", end);
        } else {
                rval = fn(rgid, egid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1095,7 +1095,7 @@ setreuid (uid_t ruid, uid_t euid)
 {
        struct timespec start, end;
        static int  (*fn)(uid_t , uid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setreuid");
        if (fn == NULL){
@@ -1105,16 +1105,16 @@ setreuid (uid_t ruid, uid_t euid)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ruid, euid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setreuid", end);
        } else {
                rval = fn(ruid, euid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1123,7 +1123,7 @@ alarm (unsigned int seconds)
 {
        struct timespec start, end;
        static unsigned int  (*fn)(unsigned int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "alarm");
        if (fn == NULL){
@@ -1133,16 +1133,16 @@ alarm (unsigned int seconds)
        unsigned int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(seconds);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("alarm", end);
        } else {
                rval = fn(seconds);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 /*
@@ -25,7 +25,7 @@
 //pthread_mutex_lock(pthread_mutex_t *mutex)
 //{
 //       static int  (*fn)(pthread_mutex_t *);
-//       __sync_fetch_and_add(&entered, 1);
+//       entered++;
 //       if (fn == NULL)
 //           *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_mutex_lock");
 //       if (fn == NULL){
@@ -36,7 +36,7 @@
 //       if (entered == 1)
 //               _backtrace();
 //out:
-//       __sync_fetch_and_sub(&entered, 1);
+//       entered--;
 //       return fn(mutex);
 //}
 //
@@ -44,7 +44,7 @@
 //pthread_mutex_unlock(pthread_mutex_t *mutex)
 //{
 //       static int  (*fn)(pthread_mutex_t *);
-//       __sync_fetch_and_add(&entered, 1);
+//       entered++;
 //       if (fn == NULL)
 //           *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_mutex_unlock");
 //       if (fn == NULL){
@@ -55,7 +55,7 @@
 //       if (entered == 1)
 //               _backtrace();
 //out:
-//       __sync_fetch_and_sub(&entered, 1);
+//       entered--;
 //       return fn(mutex);
 //}
 //pthread_t
@@ -63,7 +63,7 @@
 //{
 //       struct timespec start, end;
 //       static int  (*fn)(void);
-//       __sync_fetch_and_add(&entered, 1);
+//       entered++;
 //       if (fn == NULL)
 //           *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_self");
 //       if (fn == NULL){
@@ -73,16 +73,16 @@
 //       pthread_t  rval;
 //       if (entered == 1) {
 //               _backtrace();
-//               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+//               _gettime(&start);
 //               rval = fn();
-//               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+//               _gettime(&end);
 //               _timespec_sub(&end, &start);
 //               _logtime("pthread_self", end);
 //       } else {
 //               rval = fn();
 //       }
 //out:
-//       __sync_fetch_and_sub(&entered, 1);
+//       entered--;
 //       return rval;
 //}
 
@@ -91,7 +91,7 @@ pthread_cond_signal(pthread_cond_t *cond)
 {
 	struct timespec start, end;
        static int  (*fn)(pthread_cond_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_cond_signal");
        if (fn == NULL){
@@ -101,16 +101,16 @@ pthread_cond_signal(pthread_cond_t *cond)
        int rval;
        if (entered == 1) {
 		_backtrace();
-		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+		_gettime(&start);
 		rval = fn(cond);
-		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+		_gettime(&end);
 		_timespec_sub(&end, &start);
                _logtime("pthread_cond_signal", end);
        } else {
                rval = fn(cond);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -119,7 +119,7 @@ pthread_cond_init(pthread_cond_t *cond, const pthread_condattr_t *attr)
 {
 	struct timespec start, end;
        static int  (*fn)(pthread_cond_t *, const pthread_condattr_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_cond_init");
        if (fn == NULL){
@@ -129,16 +129,16 @@ pthread_cond_init(pthread_cond_t *cond, const pthread_condattr_t *attr)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(cond, attr);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_cond_init", end);
        } else {
                rval = fn(cond, attr);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -147,7 +147,7 @@ pthread_cond_destroy(pthread_cond_t *cond)
 {
 	struct timespec start, end;
        static int  (*fn)(pthread_cond_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_cond_destroy");
        if (fn == NULL){
@@ -157,16 +157,16 @@ pthread_cond_destroy(pthread_cond_t *cond)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(cond);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_cond_destroy", end);
        } else {
 		rval = fn(cond);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -175,7 +175,7 @@ pthread_cond_broadcast(pthread_cond_t *cond)
 {
 	struct timespec start, end;
        static int  (*fn)(pthread_cond_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_cond_broadcast");
        if (fn == NULL){
@@ -185,16 +185,16 @@ pthread_cond_broadcast(pthread_cond_t *cond)
        int rval;
        if (entered == 1) {
             _backtrace();
-	    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	    _gettime(&start);
             rval = fn(cond);
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+            _gettime(&end);
             _timespec_sub(&end, &start);
             _logtime("pthread_cond_broadcast", end);
 	} else {
 		rval = fn(cond);
         }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -202,7 +202,7 @@ int
 pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex)
 {
        static int  (*fn)(pthread_cond_t *, pthread_mutex_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_cond_wait");
        if (fn == NULL){
@@ -213,7 +213,7 @@ pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(cond, mutex);
 }
 
@@ -221,7 +221,7 @@ int
 pthread_cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *abstime)
 {
        static int  (*fn)(pthread_cond_t *, pthread_mutex_t *, const struct timespec *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_cond_timedwait");
        if (fn == NULL){
@@ -231,7 +231,7 @@ pthread_cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struc
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(cond, mutex, abstime);
 }
 
@@ -242,7 +242,7 @@ pthread_create (pthread_t *thread, const pthread_attr_t *attr, void *(*start_rou
         static  int (*fn)(pthread_t *, const pthread_attr_t *,
                   void *(*s)(void *), void *);
 
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         if (fn == NULL)
             *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_create");
         if (fn == NULL) {
@@ -253,16 +253,16 @@ pthread_create (pthread_t *thread, const pthread_attr_t *attr, void *(*start_rou
 	int rval;
         if (entered == 1) {
             _backtrace();
-	    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+	    _gettime(&start);
             rval = fn(thread, attr, start_routine, arg);
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+            _gettime(&end);
             _timespec_sub(&end, &start);
             _logtime("pthread_create", end);
 	} else {
             rval = fn(thread, attr, start_routine, arg);
 	}
 out:
-        __sync_fetch_and_sub(&entered, 1);
+        entered--;
         return rval;
 }
 
@@ -271,7 +271,7 @@ pthread_attr_destroy (pthread_attr_t *attr)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_attr_destroy");
        if (fn == NULL){
@@ -281,16 +281,16 @@ pthread_attr_destroy (pthread_attr_t *attr)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_destroy", end);
        } else {
                rval = fn(attr);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -299,7 +299,7 @@ pthread_attr_getdetachstate (pthread_attr_t *attr, int *detachstate)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, int *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_attr_getdetachstate");
        if (fn == NULL){
@@ -309,16 +309,16 @@ pthread_attr_getdetachstate (pthread_attr_t *attr, int *detachstate)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, detachstate);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_getdetachstate", end);
        } else {
                rval = fn(attr, detachstate);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -327,7 +327,7 @@ pthread_attr_getguardsize (pthread_attr_t *attr, size_t *guardsize)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, size_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_attr_getguardsize");
        if (fn == NULL){
@@ -337,16 +337,16 @@ pthread_attr_getguardsize (pthread_attr_t *attr, size_t *guardsize)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, guardsize);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_getguardsize", end);
        } else {
                rval = fn(attr, guardsize);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -355,7 +355,7 @@ pthread_attr_getinheritsched (pthread_attr_t *attr, int inheritsched)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_attr_getinheritsched");
        if (fn == NULL){
@@ -365,16 +365,16 @@ pthread_attr_getinheritsched (pthread_attr_t *attr, int inheritsched)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, inheritsched);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_getinheritsched", end);
        } else {
                rval = fn(attr, inheritsched);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -383,7 +383,7 @@ pthread_attr_getschedparam (pthread_attr_t *attr, struct sched_param *param)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, struct sched_param *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_attr_getschedparam");
        if (fn == NULL){
@@ -393,16 +393,16 @@ pthread_attr_getschedparam (pthread_attr_t *attr, struct sched_param *param)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, param);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_getschedparam", end);
        } else {
                rval = fn(attr, param);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -411,7 +411,7 @@ pthread_attr_getschedpolicy (pthread_attr_t *attr, int *policy)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, int *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_attr_getschedpolicy");
        if (fn == NULL){
@@ -421,16 +421,16 @@ pthread_attr_getschedpolicy (pthread_attr_t *attr, int *policy)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, policy);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_getschedpolicy", end);
        } else {
                rval = fn(attr, policy);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -439,7 +439,7 @@ pthread_attr_getscope (pthread_attr_t *attr, int *scope)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, int *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_attr_getscope");
        if (fn == NULL){
@@ -449,16 +449,16 @@ pthread_attr_getscope (pthread_attr_t *attr, int *scope)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, scope);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_getscope", end);
        } else {
                rval = fn(attr, scope);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -467,7 +467,7 @@ pthread_attr_getstack (pthread_attr_t *attr, void **stackaddr, size_t *stacksize
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, void **, size_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_attr_getstack");
        if (fn == NULL){
@@ -477,16 +477,16 @@ pthread_attr_getstack (pthread_attr_t *attr, void **stackaddr, size_t *stacksize
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, stackaddr, stacksize);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_getstack", end);
        } else {
                rval = fn(attr, stackaddr, stacksize);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -495,7 +495,7 @@ pthread_attr_getstacksize (pthread_attr_t *attr, size_t *stacksize)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, size_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_attr_getstacksize");
        if (fn == NULL){
@@ -505,16 +505,16 @@ pthread_attr_getstacksize (pthread_attr_t *attr, size_t *stacksize)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, stacksize);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_getstacksize", end);
        } else {
                rval = fn(attr, stacksize);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -523,7 +523,7 @@ pthread_attr_init (pthread_attr_t *attr)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_attr_init");
        if (fn == NULL){
@@ -533,16 +533,16 @@ pthread_attr_init (pthread_attr_t *attr)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_init", end);
        } else {
                rval = fn(attr);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -551,7 +551,7 @@ pthread_attr_setdetachstate (pthread_attr_t *attr, int detachstate)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_attr_setdetachstate");
        if (fn == NULL){
@@ -561,16 +561,16 @@ pthread_attr_setdetachstate (pthread_attr_t *attr, int detachstate)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, detachstate);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_setdetachstate", end);
        } else {
                rval = fn(attr, detachstate);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -579,7 +579,7 @@ pthread_attr_setguardsize (pthread_attr_t *attr, size_t guardsize)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_attr_setguardsize");
        if (fn == NULL){
@@ -589,16 +589,16 @@ pthread_attr_setguardsize (pthread_attr_t *attr, size_t guardsize)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, guardsize);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_setguardsize", end);
        } else {
                rval = fn(attr, guardsize);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -607,7 +607,7 @@ pthread_attr_setinheritsched (pthread_attr_t *attr, int *inheritsched)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, int *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_attr_setinheritsched");
        if (fn == NULL){
@@ -617,16 +617,16 @@ pthread_attr_setinheritsched (pthread_attr_t *attr, int *inheritsched)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, inheritsched);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_setinheritsched", end);
        } else {
                rval = fn(attr, inheritsched);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -635,7 +635,7 @@ pthread_attr_setschedparam (pthread_attr_t *attr, const struct sched_param *para
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, const struct sched_param *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_attr_setschedparam");
        if (fn == NULL){
@@ -645,16 +645,16 @@ pthread_attr_setschedparam (pthread_attr_t *attr, const struct sched_param *para
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, param);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_setschedparam", end);
        } else {
                rval = fn(attr, param);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -663,7 +663,7 @@ pthread_attr_setschedpolicy (pthread_attr_t *attr, int policy)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_attr_setschedpolicy");
        if (fn == NULL){
@@ -673,16 +673,16 @@ pthread_attr_setschedpolicy (pthread_attr_t *attr, int policy)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, policy);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_setschedpolicy", end);
        } else {
                rval = fn(attr, policy);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -691,7 +691,7 @@ pthread_attr_setscope (pthread_attr_t *attr, int scope)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_attr_setscope");
        if (fn == NULL){
@@ -701,16 +701,16 @@ pthread_attr_setscope (pthread_attr_t *attr, int scope)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, scope);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_setscope", end);
        } else {
                rval = fn(attr, scope);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -719,7 +719,7 @@ pthread_attr_setstack (pthread_attr_t *attr, void *stackaddr, size_t stacksize)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, void *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_attr_setstack");
        if (fn == NULL){
@@ -729,16 +729,16 @@ pthread_attr_setstack (pthread_attr_t *attr, void *stackaddr, size_t stacksize)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, stackaddr, stacksize);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_setstack", end);
        } else {
                rval = fn(attr, stackaddr, stacksize);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -747,7 +747,7 @@ pthread_attr_setstacksize (pthread_attr_t *attr, size_t stacksize)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_attr_t *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_attr_setstacksize");
        if (fn == NULL){
@@ -757,16 +757,16 @@ pthread_attr_setstacksize (pthread_attr_t *attr, size_t stacksize)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(attr, stacksize);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_attr_setstacksize", end);
        } else {
                rval = fn(attr, stacksize);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -775,7 +775,7 @@ pthread_cancel (pthread_t thread)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_cancel");
        if (fn == NULL){
@@ -785,16 +785,16 @@ pthread_cancel (pthread_t thread)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(thread);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_cancel", end);
        } else {
                rval = fn(thread);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -803,7 +803,7 @@ pthread_detach (pthread_t thread)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_detach");
        if (fn == NULL){
@@ -813,16 +813,16 @@ pthread_detach (pthread_t thread)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(thread);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_detach", end);
        } else {
                rval = fn(thread);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -831,7 +831,7 @@ pthread_equal (pthread_t t1, pthread_t t2)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_t , pthread_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_equal");
        if (fn == NULL){
@@ -841,16 +841,16 @@ pthread_equal (pthread_t t1, pthread_t t2)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(t1, t2);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_equal", end);
        } else {
                rval = fn(t1, t2);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -859,7 +859,7 @@ pthread_getconcurrency (void)
 {
        struct timespec start, end;
        static int  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_getconcurrency");
        if (fn == NULL){
@@ -869,16 +869,16 @@ pthread_getconcurrency (void)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_getconcurrency", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -887,7 +887,7 @@ pthread_getcpuclockid (pthread_t thread, clockid_t *clock_id)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_t , clockid_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_getcpuclockid");
        if (fn == NULL){
@@ -897,16 +897,16 @@ pthread_getcpuclockid (pthread_t thread, clockid_t *clock_id)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(thread, clock_id);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_getcpuclockid", end);
        } else {
                rval = fn(thread, clock_id);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -915,7 +915,7 @@ pthread_getschedparam (pthread_t thread, int *policy,  const struct sched_param
 {
        struct timespec start, end;
        static int  (*fn)(pthread_t , int *,  const struct sched_param *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_getschedparam");
        if (fn == NULL){
@@ -925,16 +925,16 @@ pthread_getschedparam (pthread_t thread, int *policy,  const struct sched_param
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(thread, policy, param);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_getschedparam", end);
        } else {
                rval = fn(thread, policy, param);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -943,7 +943,7 @@ pthread_join (pthread_t thread, void **retval)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_t , void **);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_join");
        if (fn == NULL){
@@ -953,16 +953,16 @@ pthread_join (pthread_t thread, void **retval)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(thread, retval);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_join", end);
        } else {
                rval = fn(thread, retval);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -971,7 +971,7 @@ pthread_kill (pthread_t thread, int sig)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_kill");
        if (fn == NULL){
@@ -981,16 +981,16 @@ pthread_kill (pthread_t thread, int sig)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(thread, sig);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_kill", end);
        } else {
                rval = fn(thread, sig);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -999,7 +999,7 @@ pthread_setcancelstate (int state, int *oldstate)
 {
        struct timespec start, end;
        static int  (*fn)(int , int *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_setcancelstate");
        if (fn == NULL){
@@ -1009,16 +1009,16 @@ pthread_setcancelstate (int state, int *oldstate)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(state, oldstate);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_setcancelstate", end);
        } else {
                rval = fn(state, oldstate);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1027,7 +1027,7 @@ pthread_setcanceltype (int type, int *oldtype)
 {
        struct timespec start, end;
        static int  (*fn)(int , int *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_setcanceltype");
        if (fn == NULL){
@@ -1037,16 +1037,16 @@ pthread_setcanceltype (int type, int *oldtype)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(type, oldtype);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_setcanceltype", end);
        } else {
                rval = fn(type, oldtype);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1055,7 +1055,7 @@ pthread_setconcurrency (int new_level)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_setconcurrency");
        if (fn == NULL){
@@ -1065,16 +1065,16 @@ pthread_setconcurrency (int new_level)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(new_level);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_setconcurrency", end);
        } else {
                rval = fn(new_level);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1083,7 +1083,7 @@ pthread_setschedparam (pthread_t thread, int policy, struct sched_param *param)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_t , int , struct sched_param *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_setschedparam");
        if (fn == NULL){
@@ -1093,16 +1093,16 @@ pthread_setschedparam (pthread_t thread, int policy, struct sched_param *param)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(thread, policy, param);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_setschedparam", end);
        } else {
                rval = fn(thread, policy, param);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1111,7 +1111,7 @@ pthread_setschedprio (pthread_t thread, int prio)
 {
        struct timespec start, end;
        static int  (*fn)(pthread_t , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_setschedprio");
        if (fn == NULL){
@@ -1121,16 +1121,16 @@ pthread_setschedprio (pthread_t thread, int prio)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(thread, prio);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_setschedprio", end);
        } else {
                rval = fn(thread, prio);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1139,7 +1139,7 @@ pthread_sigmask (int how, const sigset_t *set, sigset_t *oldset)
 {
        struct timespec start, end;
        static int  (*fn)(int , const sigset_t *, sigset_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_sigmask");
        if (fn == NULL){
@@ -1149,16 +1149,16 @@ pthread_sigmask (int how, const sigset_t *set, sigset_t *oldset)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(how, set, oldset);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_sigmask", end);
        } else {
                rval = fn(how, set, oldset);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -1167,7 +1167,7 @@ pthread_cleanup_pop (int execute)
 {
        struct timespec start, end;
        static void  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_cleanup_pop");
        if (fn == NULL){
@@ -1176,16 +1176,16 @@ pthread_cleanup_pop (int execute)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(execute);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_cleanup_pop", end);
        } else {
                fn(execute);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -1193,7 +1193,7 @@ pthread_exit (void *retval)
 {
        struct timespec start, end;
        static void  (*fn)(void *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(dlopen("/lib/x86_64-linux-gnu/libc.so.6",RTLD_LAZY), "pthread_exit");
        if (fn == NULL){
@@ -1202,16 +1202,16 @@ pthread_exit (void *retval)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(retval);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_exit", end);
        } else {
                fn(retval);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 void 
@@ -1219,7 +1219,7 @@ pthread_testcancel (void)
 {
        struct timespec start, end;
        static void  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pthread_testcancel");
        if (fn == NULL){
@@ -1228,16 +1228,16 @@ pthread_testcancel (void)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("pthread_testcancel", end);
        } else {
                fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 /*
  * End of Pthreads
@@ -9,7 +9,7 @@ ioctl (int d, int request, ...)
         struct timespec start, end;
         static int (*fn)(int, int, ...);
 
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         va_start(ap, request);
         if (fn == NULL)
              fn = dlsym(RTLD_NEXT, "ioctl");
@@ -19,9 +19,9 @@ ioctl (int d, int request, ...)
         }
         if (entered == 1) {
              _backtrace();
-             clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+             _gettime(&start);
              rval = fn(d, request, ap);
-             clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+             _gettime(&end);
              _timespec_sub(&end, &start);
              _logtime("ioctl", end);
         } else {
@@ -29,7 +29,7 @@ ioctl (int d, int request, ...)
         }
 out:
        va_end(ap);
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -40,7 +40,7 @@ memset (void *s, int c, size_t n)
         void *rval;
 	static void * (*fn)(void *, int, size_t);
 
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
 	if (fn == NULL)
 		 *(void **)(&fn) = dlsym(RTLD_NEXT, "memset");
 	if (fn == NULL) {
@@ -50,16 +50,16 @@ memset (void *s, int c, size_t n)
         }
         if (entered == 1) {
                 _backtrace();
-                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+                _gettime(&start);
                 rval = fn(s, c, n);
-                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+                _gettime(&end);
                 _timespec_sub(&end, &start);
                 _logtime("memset", end);
         } else {
                 rval = fn(s, c, n);
         }
 out:
-        __sync_fetch_and_sub(&entered, 1);
+        entered--;
         return rval;
 }
 
@@ -71,7 +71,7 @@ read (int fd, void *buf, size_t count)
 {
         struct timespec start, end;
         static ssize_t  (*fn)(int , void *, size_t );
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         if (fn == NULL)
                 *(void **)(&fn) = dlsym(RTLD_NEXT, "read");
         if (fn == NULL){
@@ -81,9 +81,9 @@ read (int fd, void *buf, size_t count)
         ssize_t  rval;
         if (entered == 1) {
                 _backtrace();
-                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+                _gettime(&start);
                 rval = fn(fd, buf, count);
-                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+                _gettime(&end);
                 _timespec_sub(&end, &start);
 		char name[] = "read_?";
 		name[5] = fd_type(fd);
@@ -92,7 +92,7 @@ read (int fd, void *buf, size_t count)
                 rval = fn(fd, buf, count);
         }
 out:
-        __sync_fetch_and_sub(&entered, 1);
+        entered--;
         return rval;
 }
 
@@ -101,7 +101,7 @@ write (int fd, const void *buf, size_t count)
 {
         struct timespec start, end;
         static ssize_t  (*fn)(int , const void *, size_t );
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         if (fn == NULL)
                *(void **)(&fn) = dlsym(RTLD_NEXT, "write");
         if (fn == NULL){
@@ -111,9 +111,9 @@ write (int fd, const void *buf, size_t count)
         ssize_t  rval;
         if (entered == 1) {
                 _backtrace();
-                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+                _gettime(&start);
                 rval = fn(fd, buf, count);
-                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+                _gettime(&end);
                 _timespec_sub(&end, &start);
 		char name[] = "write_?";
 		name[6] = fd_type(fd);
@@ -122,7 +122,7 @@ write (int fd, const void *buf, size_t count)
                rval = fn(fd, buf, count);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -134,7 +134,7 @@ nanosleep (const struct timespec *req, struct timespec *rem)
 {
        struct timespec start, end;
        static int  (*fn)(const struct timespec *, struct timespec *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "nanosleep");
        if (fn == NULL){
@@ -144,7 +144,7 @@ nanosleep (const struct timespec *req, struct timespec *rem)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(req, rem);
 }
 
@@ -153,7 +153,7 @@ clock_nanosleep (clockid_t clock_id, int flags, const struct timespec *request,
 {
        struct timespec start, end;
        static int  (*fn)(clockid_t , int , const struct timespec *, struct timespec *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "clock_nanosleep");
        if (fn == NULL){
@@ -163,7 +163,7 @@ clock_nanosleep (clockid_t clock_id, int flags, const struct timespec *request,
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 	return fn(clock_id, flags, request, remain);
 }
 
@@ -177,7 +177,7 @@ realloc (void *ptr, size_t size)
         struct timespec start, end;
         static void * (*fn)(void *, size_t);
 
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "realloc");
         if (fn == NULL) {
@@ -187,16 +187,16 @@ realloc (void *ptr, size_t size)
         }
         if (entered == 1) {
             _backtrace();
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+            _gettime(&start);
             rval = fn(ptr, size);
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+            _gettime(&end);
             _timespec_sub(&end, &start);
             _logtime("realloc", end);
         } else {
             rval = fn(ptr, size);
         }
 out:
-        __sync_fetch_and_sub(&entered, 1);
+        entered--;
         return rval;
 }
 
@@ -208,7 +208,7 @@ malloc (size_t size)
         struct timespec start, end;
         void * rval;
 
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         static void * (*fn)(size_t );
         if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "malloc");
@@ -219,16 +219,16 @@ malloc (size_t size)
         }
         if (entered == 1) {
             _backtrace();
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+            _gettime(&start);
             rval = fn(size);
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+            _gettime(&end);
             _timespec_sub(&end, &start);
             _logtime("malloc", end);
         } else {
             rval = fn(size);
         }
 out:
-        __sync_fetch_and_sub(&entered, 1);
+        entered--;
         return rval;
 }
 
@@ -239,7 +239,7 @@ memalign (size_t alignment, size_t size)
         static void * (*fn)(size_t, size_t);
         void * rval;
 
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "memalign");
         if (fn == NULL) {
@@ -249,36 +249,56 @@ memalign (size_t alignment, size_t size)
         }
         if (entered == 1) {
             _backtrace();
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+            _gettime(&start);
             rval = fn(alignment, size);
-            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+            _gettime(&end);
             _timespec_sub(&end, &start);
             _logtime("memalign", end);
         } else {
             rval = fn(alignment, size);
         }
 out:
-        __sync_fetch_and_sub(&entered, 1);
+        entered--;
         return rval;
 }
 
+/*
+ * dlsym() allocates before we know where the real calloc lives: serve those
+ * requests from a private, process-wide mmap'd arena so that bootstrapping
+ * never touches the traced heap (and doesn't cost every thread an 8k TLS
+ * buffer). Anonymous mappings are already zeroed.
+ */
+static char *boot_arena;
+static unsigned long boot_pos;
+
+static inline int is_boot_mem(void *ptr)
+{
+    return boot_arena && (char *)ptr >= boot_arena
+           && (char *)ptr < boot_arena + BOOT_ARENA_LEN;
+}
+
 void* dummy_malloc(size_t size)
 {
-    if (tmppos + size >= sizeof(tmpbuf))
+    unsigned long pos;
+
+    if (!boot_arena) {
+        char *arena = mmap(NULL, BOOT_ARENA_LEN, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (arena == MAP_FAILED)
+            exit(1);
+        if (!__sync_bool_compare_and_swap(&boot_arena, NULL, arena))
+            munmap(arena, BOOT_ARENA_LEN);
+    }
+    size = (size + 15) & ~15UL;
+    pos = __sync_fetch_and_add(&boot_pos, size);
+    if (pos + size > BOOT_ARENA_LEN)
         exit(1);
-    void *retptr = tmpbuf + tmppos;
-    tmppos += size;
-    ++tmpallocs;
-    return retptr;
+    return boot_arena + pos;
 }
 
 void* dummy_calloc(size_t nmemb, size_t size)
 {
-    void *ptr = dummy_malloc(nmemb * size);
-    unsigned int i = 0;
-    for (; i < nmemb * size; ++i)
-        *((char*)(ptr + i)) = '\0';
-    return ptr;
+    return dummy_malloc(nmemb * size);
 }
 
 void dummy_free(void *ptr)
@@ -292,26 +312,26 @@ calloc(size_t nmemb, size_t size)
         struct timespec start, end;
         void * rval;
 
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         if (libc_calloc == NULL){
             libc_calloc = dummy_calloc;
             *(void **)(&temp_calloc) = dlsym(RTLD_NEXT, "calloc");
             libc_calloc = temp_calloc;
-            __sync_fetch_and_sub(&entered, 1);
+            entered--;
             return libc_calloc(nmemb, size);
         }
         void * (*fn)(size_t, size_t) = libc_calloc;
         if (entered == 1) {
                 _backtrace();
-                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+                _gettime(&start);
                 rval = fn(nmemb, size);
-                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+                _gettime(&end);
                 _timespec_sub(&end, &start);
                 _logtime("calloc", end);
         } else {
                 rval = fn(nmemb, size);
         }
-        __sync_fetch_and_sub(&entered, 1);
+        entered--;
         return rval;
 }
 
@@ -320,27 +340,32 @@ free (void *ptr)
 {
         struct timespec start, end;
 
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         if (libc_free == NULL) {
             libc_free = dummy_free;
             *(void **)(&temp_free) = dlsym(RTLD_NEXT, "free");
             libc_free = temp_free;
-            libc_free(ptr);
-            __sync_fetch_and_sub(&entered, 1);
+            if (!is_boot_mem(ptr))
+                libc_free(ptr);
+            entered--;
             return;
         }
         void  (*fn)(void *) = libc_free;
+        if (is_boot_mem(ptr)) {
+            entered--;
+            return;
+        }
         if (entered == 1) {
                 _backtrace();
-                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+                _gettime(&start);
                 fn(ptr);
-                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+                _gettime(&end);
                 _timespec_sub(&end, &start);
                 _logtime("free", end);
         } else {
             fn(ptr);
         }
-        __sync_fetch_and_sub(&entered, 1);
+        entered--;
         return;
 }
 
@@ -356,7 +381,7 @@ setjmp (jmp_buf env)
 {
        struct timespec start, end;
        static int  (*fn)(jmp_buf );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setjmp");
        if (fn == NULL){
@@ -366,7 +391,7 @@ setjmp (jmp_buf env)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(env);
 }
 
@@ -374,7 +399,7 @@ void
 siglongjmp (sigjmp_buf env, int val)
 {
        static void  (*fn)(jmp_buf , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "siglongjmp");
        if (fn == NULL){
@@ -384,7 +409,7 @@ siglongjmp (sigjmp_buf env, int val)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 	fn(env, val);
 }
 
@@ -392,7 +417,7 @@ void
 longjmp (jmp_buf env, int val)
 {
        static void  (*fn)(jmp_buf , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "longjmp");
        if (fn == NULL){
@@ -402,7 +427,7 @@ longjmp (jmp_buf env, int val)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        fn(env, val);
 }
 
@@ -414,7 +439,7 @@ execv (const char *path, char *const argv[])
 {
        struct timespec start, end;
        static int  (*fn)(const char *, char *const );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "execv");
        if (fn == NULL){
@@ -425,7 +450,7 @@ execv (const char *path, char *const argv[])
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(path, argv);
 }
 
@@ -434,7 +459,7 @@ execve (const char *filename, char *const argv[], char *const envp[])
 {
        struct timespec start, end;
        static int  (*fn)(const char *, char *const , char *const );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "execve");
        if (fn == NULL){
@@ -444,7 +469,7 @@ execve (const char *filename, char *const argv[], char *const envp[])
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(filename, argv, envp);
 }
 
@@ -453,7 +478,7 @@ execvp (const char *file, char *const argv[])
 {
        struct timespec start, end;
        static int  (*fn)(const char *, char *const );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "execvp");
        if (fn == NULL){
@@ -463,7 +488,7 @@ execvp (const char *file, char *const argv[])
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return  fn(file, argv);
 }
 
@@ -471,7 +496,7 @@ pid_t
 fork (void)
 {
         static pid_t  (*fn)(void);
-        __sync_fetch_and_add(&entered, 1);
+        entered++;
         if (fn == NULL)
                *(void **)(&fn) = dlsym(RTLD_NEXT, "fork");
         if (fn == NULL){
@@ -481,7 +506,7 @@ fork (void)
         if (entered == 1)
                 _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return  fn();
 }
 
@@ -490,7 +515,7 @@ gettimeofday (struct timeval *tv, struct timezone *tz)
 {
        struct timespec start, end;
        static int  (*fn)(struct timeval *, struct timezone *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "gettimeofday");
        if (fn == NULL){
@@ -500,7 +525,7 @@ gettimeofday (struct timeval *tv, struct timezone *tz)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(tv, tz);
 }
 
@@ -509,7 +534,7 @@ waitid (idtype_t idtype, id_t id, siginfo_t *infop, int options)
 {
        struct timespec start, end;
        static int  (*fn)(idtype_t , id_t , siginfo_t *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "waitid");
        if (fn == NULL){
@@ -519,7 +544,7 @@ waitid (idtype_t idtype, id_t id, siginfo_t *infop, int options)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(idtype, id, infop, options);
 }
 
@@ -528,7 +553,7 @@ wait (int *status)
 {
        struct timespec start, end;
        static pid_t  (*fn)(int *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "wait");
        if (fn == NULL){
@@ -538,16 +563,16 @@ wait (int *status)
        pid_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(status);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("wait", end);
        } else {
                rval = fn(status);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -556,7 +581,7 @@ waitpid (pid_t pid, int *status, int options)
 {
        struct timespec start, end;
        static pid_t  (*fn)(pid_t , int *, int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "waitpid");
        if (fn == NULL){
@@ -574,7 +599,7 @@ sleep (unsigned int seconds)
 {
        struct timespec start, end;
        static unsigned int  (*fn)(unsigned int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sleep");
        if (fn == NULL){
@@ -584,7 +609,7 @@ sleep (unsigned int seconds)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(seconds);
 }
 
@@ -593,7 +618,7 @@ abort (void)
 {
        struct timespec start, end;
        static void  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "abort");
        if (fn == NULL){
@@ -603,7 +628,7 @@ abort (void)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 	fn();
 }
 
@@ -612,7 +637,7 @@ sigpause (int sigmask)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigpause");
        if (fn == NULL){
@@ -622,7 +647,7 @@ sigpause (int sigmask)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(sigmask);
 }
 
@@ -631,7 +656,7 @@ sigsuspend (const sigset_t *mask)
 {
        struct timespec start, end;
        static int  (*fn)(const sigset_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigsuspend");
        if (fn == NULL){
@@ -641,7 +666,7 @@ sigsuspend (const sigset_t *mask)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(mask);
 }
 
@@ -650,7 +675,7 @@ sigtimedwait (const sigset_t *set, siginfo_t *info, const struct timespec *timeo
 {
        struct timespec start, end;
        static int  (*fn)(const sigset_t *, siginfo_t *, const struct timespec *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigtimedwait");
        if (fn == NULL){
@@ -660,7 +685,7 @@ sigtimedwait (const sigset_t *set, siginfo_t *info, const struct timespec *timeo
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(set, info, timeout);
 }
 
@@ -669,7 +694,7 @@ sigwait (const sigset_t *set, int *sig)
 {
        struct timespec start, end;
        static int  (*fn)(const sigset_t *, int *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigwait");
        if (fn == NULL){
@@ -679,7 +704,7 @@ sigwait (const sigset_t *set, int *sig)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(set, sig);
 }
 
@@ -688,7 +713,7 @@ sigwaitinfo (const sigset_t *set, siginfo_t *info)
 {
        struct timespec start, end;
        static int  (*fn)(const sigset_t *, siginfo_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sigwaitinfo");
        if (fn == NULL){
@@ -698,7 +723,7 @@ sigwaitinfo (const sigset_t *set, siginfo_t *info)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(set, info);
 }
 
@@ -707,7 +732,7 @@ sched_yield (void)
 {
        struct timespec start, end;
        static int  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sched_yield");
        if (fn == NULL){
@@ -717,7 +742,7 @@ sched_yield (void)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return fn();
 }
 
@@ -727,7 +752,7 @@ pause (void)
 {
        struct timespec start, end;
        static int  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "pause");
        if (fn == NULL){
@@ -737,7 +762,7 @@ pause (void)
        if (entered == 1)
                _backtrace();
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return fn();
 }
 
@@ -746,7 +771,7 @@ sem_wait (sem_t *sem)
 {
        struct timespec start, end;
        static int  (*fn)(sem_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "sem_wait");
        if (fn == NULL){
@@ -757,6 +782,6 @@ sem_wait (sem_t *sem)
                _backtrace();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return fn(sem);
 }
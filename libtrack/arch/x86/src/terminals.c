@@ -6,7 +6,7 @@ cfsetispeed (struct termios *termios_p, speed_t speed)
 {
        struct timespec start, end;
        static int  (*fn)(struct termios *, speed_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "cfsetispeed");
        if (fn == NULL){
@@ -16,16 +16,16 @@ cfsetispeed (struct termios *termios_p, speed_t speed)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(termios_p, speed);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("cfsetispeed", end);
        } else {
                rval = fn(termios_p, speed);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -34,7 +34,7 @@ cfsetospeed (struct termios *termios_p, speed_t speed)
 {
        struct timespec start, end;
        static int  (*fn)(struct termios *, speed_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "cfsetospeed");
        if (fn == NULL){
@@ -44,16 +44,16 @@ cfsetospeed (struct termios *termios_p, speed_t speed)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(termios_p, speed);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("cfsetospeed", end);
        } else {
                rval = fn(termios_p, speed);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -62,7 +62,7 @@ cfsetspeed (struct termios *termios_p, speed_t speed)
 {
        struct timespec start, end;
        static int  (*fn)(struct termios *, speed_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "cfsetspeed");
        if (fn == NULL){
@@ -72,16 +72,16 @@ cfsetspeed (struct termios *termios_p, speed_t speed)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(termios_p, speed);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("cfsetspeed", end);
        } else {
                rval = fn(termios_p, speed);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -90,7 +90,7 @@ ttyname_r (int fd, char *buf, size_t buflen)
 {
        struct timespec start, end;
        static int  (*fn)(int , char *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ttyname_r");
        if (fn == NULL){
@@ -100,16 +100,16 @@ ttyname_r (int fd, char *buf, size_t buflen)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, buf, buflen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ttyname_r", end);
        } else {
                rval = fn(fd, buf, buflen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -118,7 +118,7 @@ tcgetsid (int fd)
 {
        struct timespec start, end;
        static pid_t  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "tcgetsid");
        if (fn == NULL){
@@ -128,16 +128,16 @@ tcgetsid (int fd)
        pid_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("tcgetsid", end);
        } else {
                rval = fn(fd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -146,7 +146,7 @@ cfmakeraw (struct termios *termios_p)
 {
        struct timespec start, end;
        static void  (*fn)(struct termios *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "cfmakeraw");
        if (fn == NULL){
@@ -155,16 +155,16 @@ cfmakeraw (struct termios *termios_p)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn(termios_p);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("cfmakeraw", end);
        } else {
                fn(termios_p);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 int 
@@ -172,7 +172,7 @@ unlockpt (int fd)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "unlockpt");
        if (fn == NULL){
@@ -182,16 +182,16 @@ unlockpt (int fd)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("unlockpt", end);
        } else {
                rval = fn(fd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -200,7 +200,7 @@ ttyname (int fd)
 {
        struct timespec start, end;
        static char * (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ttyname");
        if (fn == NULL){
@@ -210,16 +210,16 @@ ttyname (int fd)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ttyname", end);
        } else {
                rval = fn(fd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -227,7 +227,7 @@ tcdrain (int fd)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "tcdrain");
        if (fn == NULL){
@@ -237,16 +237,16 @@ tcdrain (int fd)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("tcdrain", end);
        } else {
                rval = fn(fd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -255,7 +255,7 @@ tcflow (int fd, int action)
 {
        struct timespec start, end;
        static int  (*fn)(int , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "tcflow");
        if (fn == NULL){
@@ -265,16 +265,16 @@ tcflow (int fd, int action)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, action);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("tcflow", end);
        } else {
                rval = fn(fd, action);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -283,7 +283,7 @@ tcflush (int fd, int queue_selector)
 {
        struct timespec start, end;
        static int  (*fn)(int , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "tcflush");
        if (fn == NULL){
@@ -293,16 +293,16 @@ tcflush (int fd, int queue_selector)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, queue_selector);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("tcflush", end);
        } else {
                rval = fn(fd, queue_selector);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -311,7 +311,7 @@ tcgetattr (int fd, struct termios *termios_p)
 {
        struct timespec start, end;
        static int  (*fn)(int , struct termios *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "tcgetattr");
        if (fn == NULL){
@@ -321,16 +321,16 @@ tcgetattr (int fd, struct termios *termios_p)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, termios_p);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("tcgetattr", end);
        } else {
                rval = fn(fd, termios_p);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -339,7 +339,7 @@ tcsendbreak (int fd, int duration)
 {
        struct timespec start, end;
        static int  (*fn)(int , int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "tcsendbreak");
        if (fn == NULL){
@@ -349,16 +349,16 @@ tcsendbreak (int fd, int duration)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, duration);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("tcsendbreak", end);
        } else {
                rval = fn(fd, duration);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -367,7 +367,7 @@ tcsetattr (int fd, int optional_actions,  const struct termios *termios_p)
 {
        struct timespec start, end;
        static int  (*fn)(int , int ,  const struct termios *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "tcsetattr");
        if (fn == NULL){
@@ -377,16 +377,16 @@ tcsetattr (int fd, int optional_actions,  const struct termios *termios_p)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, optional_actions, termios_p);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("tcsetattr", end);
        } else {
                rval = fn(fd, optional_actions, termios_p);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -395,7 +395,7 @@ tcsetpgrp (int fd, pid_t pgrp)
 {
        struct timespec start, end;
        static int  (*fn)(int , pid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "tcsetpgrp");
        if (fn == NULL){
@@ -405,16 +405,16 @@ tcsetpgrp (int fd, pid_t pgrp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, pgrp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("tcsetpgrp", end);
        } else {
                rval = fn(fd, pgrp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -424,7 +424,7 @@ ptsname (int fd)
 {
        struct timespec start, end;
        static char * (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ptsname");
        if (fn == NULL){
@@ -434,16 +434,16 @@ ptsname (int fd)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ptsname", end);
        } else {
                rval = fn(fd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -452,7 +452,7 @@ posix_openpt (int flags)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "posix_openpt");
        if (fn == NULL){
@@ -462,16 +462,16 @@ posix_openpt (int flags)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("posix_openpt", end);
        } else {
                rval = fn(flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -480,7 +480,7 @@ ptsname_r (int fd, char *buf, size_t buflen)
 {
        struct timespec start, end;
        static int  (*fn)(int , char *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ptsname_r");
        if (fn == NULL){
@@ -490,16 +490,16 @@ ptsname_r (int fd, char *buf, size_t buflen)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd, buf, buflen);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ptsname_r", end);
        } else {
                rval = fn(fd, buf, buflen);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -508,7 +508,7 @@ grantpt (int fd)
 {
        struct timespec start, end;
        static int  (*fn)(int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "grantpt");
        if (fn == NULL){
@@ -518,16 +518,16 @@ grantpt (int fd)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(fd);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("grantpt", end);
        } else {
                rval = fn(fd);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -536,7 +536,7 @@ fmtmsg (long classification, const char *label, int severity, const char *text,
 {
        struct timespec start, end;
        static int  (*fn)(long , const char *, int , const char *, const char *, const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "fmtmsg");
        if (fn == NULL){
@@ -546,16 +546,16 @@ fmtmsg (long classification, const char *label, int severity, const char *text,
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(classification, label, severity, text, action, tag);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("fmtmsg", end);
        } else {
                rval = fn(classification, label, severity, text, action, tag);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -564,7 +564,7 @@ cfgetispeed (const struct termios *termios_p)
 {
        struct timespec start, end;
        static speed_t  (*fn)(const struct termios *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "cfgetispeed");
        if (fn == NULL){
@@ -574,16 +574,16 @@ cfgetispeed (const struct termios *termios_p)
        speed_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(termios_p);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("cfgetispeed", end);
        } else {
                rval = fn(termios_p);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -592,7 +592,7 @@ cfgetospeed (const struct termios *termios_p)
 {
        struct timespec start, end;
        static speed_t  (*fn)(const struct termios *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "cfgetospeed");
        if (fn == NULL){
@@ -602,16 +602,16 @@ cfgetospeed (const struct termios *termios_p)
        speed_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(termios_p);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("cfgetospeed", end);
        } else {
                rval = fn(termios_p);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 /*
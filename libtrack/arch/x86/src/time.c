@@ -6,7 +6,7 @@ utime (const char *filename, const struct utimbuf *times)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, const struct utimbuf *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "utime");
        if (fn == NULL){
@@ -16,16 +16,16 @@ utime (const char *filename, const struct utimbuf *times)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(filename, times);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("utime", end);
        } else {
                rval = fn(filename, times);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -34,7 +34,7 @@ utimensat (int dirfd, const char *pathname, const struct timespec times[2], int
 {
        struct timespec start, end;
        static int  (*fn)(int , const char *, const struct timespec times[2], int );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "utimensat");
        if (fn == NULL){
@@ -44,16 +44,16 @@ utimensat (int dirfd, const char *pathname, const struct timespec times[2], int
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(dirfd, pathname, times, flags);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("utimensat", end);
        } else {
                rval = fn(dirfd, pathname, times, flags);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -62,7 +62,7 @@ utimes (const char *filename, const struct timeval times[2])
 {
        struct timespec start, end;
        static int  (*fn)(const char *, const struct timeval times[2]);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "utimes");
        if (fn == NULL){
@@ -72,16 +72,16 @@ utimes (const char *filename, const struct timeval times[2])
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(filename, times);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("utimes", end);
        } else {
                rval = fn(filename, times);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -90,7 +90,7 @@ ctime (const time_t *timep)
 {
        struct timespec start, end;
        static char * (*fn)(const time_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ctime");
        if (fn == NULL){
@@ -100,16 +100,16 @@ ctime (const time_t *timep)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(timep);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ctime", end);
        } else {
                rval = fn(timep);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -118,7 +118,7 @@ ctime_r (const time_t *timep, char *buf)
 {
        struct timespec start, end;
        static char * (*fn)(const time_t *, char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "ctime_r");
        if (fn == NULL){
@@ -128,16 +128,16 @@ ctime_r (const time_t *timep, char *buf)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(timep, buf);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("ctime_r", end);
        } else {
                rval = fn(timep, buf);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -146,7 +146,7 @@ timer_create (clockid_t clockid, struct sigevent *sevp, timer_t *timerid)
 {
        struct timespec start, end;
        static int  (*fn)(clockid_t , struct sigevent *, timer_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "timer_create");
        if (fn == NULL){
@@ -156,16 +156,16 @@ timer_create (clockid_t clockid, struct sigevent *sevp, timer_t *timerid)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(clockid, sevp, timerid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("timer_create", end);
        } else {
                rval = fn(clockid, sevp, timerid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -174,7 +174,7 @@ timer_delete (timer_t timerid)
 {
        struct timespec start, end;
        static int  (*fn)(timer_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "timer_delete");
        if (fn == NULL){
@@ -184,16 +184,16 @@ timer_delete (timer_t timerid)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(timerid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("timer_delete", end);
        } else {
                rval = fn(timerid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -202,7 +202,7 @@ timer_getoverrun (timer_t timerid)
 {
        struct timespec start, end;
        static int  (*fn)(timer_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "timer_getoverrun");
        if (fn == NULL){
@@ -212,16 +212,16 @@ timer_getoverrun (timer_t timerid)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(timerid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("timer_getoverrun", end);
        } else {
                rval = fn(timerid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -230,7 +230,7 @@ setitimer (int which, const struct itimerval *new_value, struct itimerval *old_v
 {
        struct timespec start, end;
        static int  (*fn)(int , const struct itimerval *, struct itimerval *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setitimer");
        if (fn == NULL){
@@ -240,16 +240,16 @@ setitimer (int which, const struct itimerval *new_value, struct itimerval *old_v
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(which, new_value, old_value);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setitimer", end);
        } else {
                rval = fn(which, new_value, old_value);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -258,7 +258,7 @@ getitimer (int which, struct itimerval *curr_value)
 {
        struct timespec start, end;
        static int  (*fn)(int , struct itimerval *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getitimer");
        if (fn == NULL){
@@ -268,16 +268,16 @@ getitimer (int which, struct itimerval *curr_value)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(which, curr_value);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getitimer", end);
        } else {
                rval = fn(which, curr_value);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -286,7 +286,7 @@ getdate_r (const char *string, struct tm *res)
 {
        struct timespec start, end;
        static int  (*fn)(const char *, struct tm *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getdate_r");
        if (fn == NULL){
@@ -296,16 +296,16 @@ getdate_r (const char *string, struct tm *res)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(string, res);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getdate_r", end);
        } else {
                rval = fn(string, res);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -315,7 +315,7 @@ clock_getcpuclockid (pid_t pid, clockid_t *clock_id)
 {
        struct timespec start, end;
        static int  (*fn)(pid_t , clockid_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "clock_getcpuclockid");
        if (fn == NULL){
@@ -325,16 +325,16 @@ clock_getcpuclockid (pid_t pid, clockid_t *clock_id)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pid, clock_id);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("clock_getcpuclockid", end);
        } else {
                rval = fn(pid, clock_id);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -343,7 +343,7 @@ clock_getres (clockid_t clk_id, struct timespec *res)
 {
        struct timespec start, end;
        static int  (*fn)(clockid_t , struct timespec *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "clock_getres");
        if (fn == NULL){
@@ -353,16 +353,16 @@ clock_getres (clockid_t clk_id, struct timespec *res)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(clk_id, res);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("clock_getres", end);
        } else {
                rval = fn(clk_id, res);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -371,7 +371,7 @@ clock (void)
 {
        struct timespec start, end;
        static clock_t  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "clock");
        if (fn == NULL){
@@ -381,16 +381,16 @@ clock (void)
        clock_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("clock", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -399,7 +399,7 @@ times (struct tms *buf)
 {
        struct timespec start, end;
        static clock_t  (*fn)(struct tms *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "times");
        if (fn == NULL){
@@ -409,16 +409,16 @@ times (struct tms *buf)
        clock_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(buf);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("times", end);
        } else {
                rval = fn(buf);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -427,7 +427,7 @@ getdate (const char *string)
 {
        struct timespec start, end;
        static struct tm * (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getdate");
        if (fn == NULL){
@@ -437,16 +437,16 @@ getdate (const char *string)
        struct tm * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(string);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getdate", end);
        } else {
                rval = fn(string);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -455,7 +455,7 @@ gmtime (const time_t *timep)
 {
        struct timespec start, end;
        static struct tm * (*fn)(const time_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "gmtime");
        if (fn == NULL){
@@ -465,16 +465,16 @@ gmtime (const time_t *timep)
        struct tm * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(timep);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("gmtime", end);
        } else {
                rval = fn(timep);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -483,7 +483,7 @@ gmtime_r (const time_t *timep, struct tm *result)
 {
        struct timespec start, end;
        static struct tm * (*fn)(const time_t *, struct tm *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "gmtime_r");
        if (fn == NULL){
@@ -493,16 +493,16 @@ gmtime_r (const time_t *timep, struct tm *result)
        struct tm * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(timep, result);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("gmtime_r", end);
        } else {
                rval = fn(timep, result);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -511,7 +511,7 @@ localtime (const time_t *timep)
 {
        struct timespec start, end;
        static struct tm * (*fn)(const time_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "localtime");
        if (fn == NULL){
@@ -521,16 +521,16 @@ localtime (const time_t *timep)
        struct tm * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(timep);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("localtime", end);
        } else {
                rval = fn(timep);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -539,7 +539,7 @@ localtime_r (const time_t *timep, struct tm *result)
 {
        struct timespec start, end;
        static struct tm * (*fn)(const time_t *, struct tm *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "localtime_r");
        if (fn == NULL){
@@ -549,16 +549,16 @@ localtime_r (const time_t *timep, struct tm *result)
        struct tm * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(timep, result);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("localtime_r", end);
        } else {
                rval = fn(timep, result);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -567,7 +567,7 @@ time (time_t *t)
 {
        struct timespec start, end;
        static time_t  (*fn)(time_t *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "time");
        if (fn == NULL){
@@ -577,16 +577,16 @@ time (time_t *t)
        time_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(t);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("time", end);
        } else {
                rval = fn(t);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -595,7 +595,7 @@ clock_settime (clockid_t clk_id, const struct timespec *tp)
 {
        struct timespec start, end;
        static int  (*fn)(clockid_t , const struct timespec *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "clock_settime");
        if (fn == NULL){
@@ -605,16 +605,16 @@ clock_settime (clockid_t clk_id, const struct timespec *tp)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(clk_id, tp);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("clock_settime", end);
        } else {
                rval = fn(clk_id, tp);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -623,7 +623,7 @@ difftime (time_t time1, time_t time0)
 {
        struct timespec start, end;
        static double  (*fn)(time_t , time_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "difftime");
        if (fn == NULL){
@@ -633,16 +633,16 @@ difftime (time_t time1, time_t time0)
        double  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(time1, time0);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("difftime", end);
        } else {
                rval = fn(time1, time0);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -651,7 +651,7 @@ timer_gettime (timer_t timerid, struct itimerspec *curr_value)
 {
        struct timespec start, end;
        static int  (*fn)(timer_t , struct itimerspec *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "timer_gettime");
        if (fn == NULL){
@@ -661,16 +661,16 @@ timer_gettime (timer_t timerid, struct itimerspec *curr_value)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(timerid, curr_value);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("timer_gettime", end);
        } else {
                rval = fn(timerid, curr_value);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -679,7 +679,7 @@ timer_settime (timer_t timerid, int flags, const struct itimerspec *new_value, s
 {
        struct timespec start, end;
        static int  (*fn)(timer_t , int , const struct itimerspec *, struct itimerspec * );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "timer_settime");
        if (fn == NULL){
@@ -689,16 +689,16 @@ timer_settime (timer_t timerid, int flags, const struct itimerspec *new_value, s
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(timerid, flags, new_value, old_value);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("timer_settime", end);
        } else {
                rval = fn(timerid, flags, new_value, old_value);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -707,7 +707,7 @@ asctime (const struct tm *tm)
 {
        struct timespec start, end;
        static char * (*fn)(const struct tm *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "asctime");
        if (fn == NULL){
@@ -717,16 +717,16 @@ asctime (const struct tm *tm)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(tm);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("asctime", end);
        } else {
                rval = fn(tm);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -735,7 +735,7 @@ asctime_r (const struct tm *tm, char *buf)
 {
        struct timespec start, end;
        static char * (*fn)(const struct tm *, char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "asctime_r");
        if (fn == NULL){
@@ -745,16 +745,16 @@ asctime_r (const struct tm *tm, char *buf)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(tm, buf);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("asctime_r", end);
        } else {
                rval = fn(tm, buf);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 /* 
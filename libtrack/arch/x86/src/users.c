@@ -6,7 +6,7 @@ setpwent (void)
 {
        struct timespec start, end;
        static void  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setpwent");
        if (fn == NULL){
@@ -15,16 +15,16 @@ setpwent (void)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setpwent", end);
        } else {
                fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 int 
@@ -32,7 +32,7 @@ setgid (gid_t gid)
 {
        struct timespec start, end;
        static int  (*fn)(gid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setgid");
        if (fn == NULL){
@@ -42,16 +42,16 @@ setgid (gid_t gid)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(gid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setgid", end);
        } else {
                rval = fn(gid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -60,7 +60,7 @@ setgrent (void)
 {
        struct timespec start, end;
        static void  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setgrent");
        if (fn == NULL){
@@ -69,16 +69,16 @@ setgrent (void)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setgrent", end);
        } else {
                fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 
 struct utmp *
@@ -86,7 +86,7 @@ getutent (void)
 {
        struct timespec start, end;
        static struct utmp * (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getutent");
        if (fn == NULL){
@@ -96,16 +96,16 @@ getutent (void)
        struct utmp * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getutent", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -114,7 +114,7 @@ getutid (struct utmp *ut)
 {
        struct timespec start, end;
        static struct utmp * (*fn)(struct utmp *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getutid");
        if (fn == NULL){
@@ -124,16 +124,16 @@ getutid (struct utmp *ut)
        struct utmp * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ut);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getutid", end);
        } else {
                rval = fn(ut);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -142,7 +142,7 @@ getutline (struct utmp *ut)
 {
        struct timespec start, end;
        static struct utmp * (*fn)(struct utmp *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getutline");
        if (fn == NULL){
@@ -152,16 +152,16 @@ getutline (struct utmp *ut)
        struct utmp * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(ut);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getutline", end);
        } else {
                rval = fn(ut);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -170,7 +170,7 @@ getpgid (pid_t pid)
 {
        struct timespec start, end;
        static pid_t  (*fn)(pid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getpgid");
        if (fn == NULL){
@@ -180,16 +180,16 @@ getpgid (pid_t pid)
        pid_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getpgid", end);
        } else {
                rval = fn(pid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -198,7 +198,7 @@ getuid (void)
 {
        struct timespec start, end;
        static uid_t  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getuid");
        if (fn == NULL){
@@ -208,16 +208,16 @@ getuid (void)
        uid_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getuid", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -226,7 +226,7 @@ getpgrp (void)
 {
        struct timespec start, end;
        static pid_t  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getpgrp");
        if (fn == NULL){
@@ -236,16 +236,16 @@ getpgrp (void)
        pid_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getpgrp", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -254,7 +254,7 @@ getpid (void)
 {
        struct timespec start, end;
        static pid_t  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getpid");
        if (fn == NULL){
@@ -264,16 +264,16 @@ getpid (void)
        pid_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getpid", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -282,7 +282,7 @@ getppid (void)
 {
        struct timespec start, end;
        static pid_t  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getppid");
        if (fn == NULL){
@@ -292,16 +292,16 @@ getppid (void)
        pid_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getppid", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -310,7 +310,7 @@ getsid (pid_t pid)
 {
        struct timespec start, end;
        static pid_t  (*fn)(pid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getsid");
        if (fn == NULL){
@@ -320,16 +320,16 @@ getsid (pid_t pid)
        pid_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(pid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getsid", end);
        } else {
                rval = fn(pid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -338,7 +338,7 @@ setsid (void)
 {
        struct timespec start, end;
        static pid_t  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "setsid");
        if (fn == NULL){
@@ -348,16 +348,16 @@ setsid (void)
        pid_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("setsid", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -366,7 +366,7 @@ getpwnam_r (const char *name, struct passwd *pwd, char *buf, size_t buflen, stru
 {
        struct timespec start, end;
        static int  (*fn)(const char *, struct passwd *, char *, size_t , struct passwd **);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getpwnam_r");
        if (fn == NULL){
@@ -376,16 +376,16 @@ getpwnam_r (const char *name, struct passwd *pwd, char *buf, size_t buflen, stru
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name, pwd, buf, buflen, result);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getpwnam_r", end);
        } else {
                rval = fn(name, pwd, buf, buflen, result);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -394,7 +394,7 @@ getpwuid_r (uid_t uid, struct passwd *pwd, char *buf, size_t buflen, struct pass
 {
        struct timespec start, end;
        static int  (*fn)(uid_t , struct passwd *, char *, size_t , struct passwd **);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getpwuid_r");
        if (fn == NULL){
@@ -404,16 +404,16 @@ getpwuid_r (uid_t uid, struct passwd *pwd, char *buf, size_t buflen, struct pass
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(uid, pwd, buf, buflen, result);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getpwuid_r", end);
        } else {
                rval = fn(uid, pwd, buf, buflen, result);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -422,7 +422,7 @@ getlogin (void)
 {
        struct timespec start, end;
        static char * (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getlogin");
        if (fn == NULL){
@@ -432,16 +432,16 @@ getlogin (void)
        char * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getlogin", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -450,7 +450,7 @@ getgrent (void)
 {
        struct timespec start, end;
        static struct group * (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getgrent");
        if (fn == NULL){
@@ -460,16 +460,16 @@ getgrent (void)
        struct group * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getgrent", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -478,7 +478,7 @@ getgrgid (gid_t gid)
 {
        struct timespec start, end;
        static struct group * (*fn)(gid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getgrgid");
        if (fn == NULL){
@@ -488,16 +488,16 @@ getgrgid (gid_t gid)
        struct group * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(gid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getgrgid", end);
        } else {
                rval = fn(gid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -506,7 +506,7 @@ getgrnam (const char *name)
 {
        struct timespec start, end;
        static struct group * (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getgrnam");
        if (fn == NULL){
@@ -516,16 +516,16 @@ getgrnam (const char *name)
        struct group * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getgrnam", end);
        } else {
                rval = fn(name);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -534,7 +534,7 @@ getgrgid_r (gid_t gid, struct group *grp, char *buf, size_t buflen, struct group
 {
        struct timespec start, end;
        static int  (*fn)(gid_t , struct group *, char *, size_t , struct group **);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getgrgid_r");
        if (fn == NULL){
@@ -544,16 +544,16 @@ getgrgid_r (gid_t gid, struct group *grp, char *buf, size_t buflen, struct group
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(gid, grp, buf, buflen, result);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getgrgid_r", end);
        } else {
                rval = fn(gid, grp, buf, buflen, result);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -562,7 +562,7 @@ getgrnam_r (const char *name, struct group *grp, char *buf, size_t buflen, struc
 {
        struct timespec start, end;
        static int  (*fn)(const char *, struct group *, char *, size_t , struct group **);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getgrnam_r");
        if (fn == NULL){
@@ -572,16 +572,16 @@ getgrnam_r (const char *name, struct group *grp, char *buf, size_t buflen, struc
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name, grp, buf, buflen, result);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getgrnam_r", end);
        } else {
                rval = fn(name, grp, buf, buflen, result);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -590,7 +590,7 @@ getgroups (int size, gid_t list[])
 {
        struct timespec start, end;
        static int  (*fn)(int , gid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getgroups");
        if (fn == NULL){
@@ -600,16 +600,16 @@ getgroups (int size, gid_t list[])
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(size, list);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getgroups", end);
        } else {
                rval = fn(size, list);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -618,7 +618,7 @@ getgid (void)
 {
        struct timespec start, end;
        static gid_t  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getgid");
        if (fn == NULL){
@@ -628,16 +628,16 @@ getgid (void)
        gid_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getgid", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -646,7 +646,7 @@ getegid (void)
 {
        struct timespec start, end;
        static gid_t  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getegid");
        if (fn == NULL){
@@ -656,16 +656,16 @@ getegid (void)
        gid_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getegid", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -674,7 +674,7 @@ getlogin_r (char *buf, size_t bufsize)
 {
        struct timespec start, end;
        static int  (*fn)(char *, size_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getlogin_r");
        if (fn == NULL){
@@ -684,16 +684,16 @@ getlogin_r (char *buf, size_t bufsize)
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(buf, bufsize);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getlogin_r", end);
        } else {
                rval = fn(buf, bufsize);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -702,7 +702,7 @@ getopt_long_only (int argc, char * const argv[], const char *optstring, const st
 {
        struct timespec start, end;
        static int  (*fn)(int , char * const , const char *, const struct option *, int *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getopt_long_only");
        if (fn == NULL){
@@ -712,16 +712,16 @@ getopt_long_only (int argc, char * const argv[], const char *optstring, const st
        int  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(argc, argv, optstring, longopts, longindex);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getopt_long_only", end);
        } else {
                rval = fn(argc, argv, optstring, longopts, longindex);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -730,7 +730,7 @@ getpwent (void)
 {
        struct timespec start, end;
        static struct passwd * (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getpwent");
        if (fn == NULL){
@@ -740,16 +740,16 @@ getpwent (void)
        struct passwd * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getpwent", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -758,7 +758,7 @@ getpwnam (const char *name)
 {
        struct timespec start, end;
        static struct passwd * (*fn)(const char *);
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getpwnam");
        if (fn == NULL){
@@ -768,16 +768,16 @@ getpwnam (const char *name)
        struct passwd * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(name);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getpwnam", end);
        } else {
                rval = fn(name);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -786,7 +786,7 @@ getpwuid (uid_t uid)
 {
        struct timespec start, end;
        static struct passwd * (*fn)(uid_t );
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "getpwuid");
        if (fn == NULL){
@@ -796,16 +796,16 @@ getpwuid (uid_t uid)
        struct passwd * rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn(uid);
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("getpwuid", end);
        } else {
                rval = fn(uid);
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
        return rval;
 }
 
@@ -814,7 +814,7 @@ geteuid (void)
 {
        struct timespec start, end;
        static uid_t  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "geteuid");
        if (fn == NULL){
@@ -824,16 +824,16 @@ geteuid (void)
        uid_t  rval;
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                rval = fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("geteuid", end);
        } else {
                rval = fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
       return rval;
 }
 
@@ -842,7 +842,7 @@ endgrent (void)
 {
        struct timespec start, end;
        static void  (*fn)();
-       __sync_fetch_and_add(&entered, 1);
+       entered++;
        if (fn == NULL)
            *(void **)(&fn) = dlsym(RTLD_NEXT, "endgrent");
        if (fn == NULL){
@@ -851,16 +851,16 @@ endgrent (void)
        }
        if (entered == 1) {
                _backtrace();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+               _gettime(&start);
                fn();
-               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+               _gettime(&end);
                _timespec_sub(&end, &start);
                _logtime("endgrent", end);
        } else {
                fn();
        }
 out:
-       __sync_fetch_and_sub(&entered, 1);
+       entered--;
 }
 /*
  * End users
@@ -15,6 +15,32 @@
 #define MAX_RECURSIVE_DEPTH 1024
 #define MAX_LINE_LEN  256
 
+/*
+ * With -DHAVE_RAW_STACK, nothing is unwound in-process: each backtrace
+ * is a copy of the registers saved by the wrapper, and of up to
+ * RAW_STACK_KB of the stack above the caller's sp, logged as
+ *	BT:RAW:<map gen>:<symbol>:<sp>:<reg>,<reg>,...:<len>:<base64 stack>:
+ * (registers as saved by the wrapper, in hex: r0-r11,lr on ARM). The
+ * module map it needs is logged before it (see wrap_maps.h), and the
+ * parser unwinds it offline (telesphorus/helpers/unwind.py).
+ */
+#ifndef RAW_STACK_KB
+#define RAW_STACK_KB  8
+#endif
+
+/*
+ * With -DHAVE_CALLER_ONLY, nothing is unwound at all: the return address
+ * saved by the wrapper (the caller's lr) is looked up in the module map,
+ * and each call is logged as
+ *	BT:CALLER:<map gen>:<symbol>:<module>:<offset>:
+ * where <module> is the index of the caller's mapping in the map of that
+ * generation (-1 if there is none) and <offset> the file offset of the
+ * return address in it (in hex; the address itself if there's no module).
+ */
+#if defined(HAVE_CALLER_ONLY) && (defined(HAVE_RAW_STACK) || defined(HAVE_CCT))
+#error "caller-only logging can't be used with raw stacks or the calling-context tree"
+#endif
+
 struct bt_frame {
 	void *pc;
 	unsigned long sp;
@@ -72,6 +98,10 @@ extern struct bt_line *bt_cache_fetch(void *sym, struct bt_line_cache **cache_ou
 
 extern void log_backtrace(struct tls_info *tls);
 
+#ifdef HAVE_EAGER_INIT
+extern void bt_prefault(struct tls_info *tls, int nr);
+#endif
+
 #define __bt_logbuf(buf) \
 	((char *)(buf))
 
@@ -42,6 +42,8 @@ __BEGIN_DECLS
 #define Z_FIXED                  4
 #define Z_DEFAULT_STRATEGY       0
 
+#define Z_OK                     0
+
 struct gzFile;
 
 struct zlib_iface {
@@ -54,6 +56,10 @@ struct zlib_iface {
 	int (*gzprintf)(struct gzFile *file, const char *format, ...);
 	int (*gzflush)(struct gzFile *file, int flush);
 	int (*gzclose)(struct gzFile *file);
+
+	/* optional: single-shot compression of trace container chunks */
+	int (*compress2)(void *dest, unsigned long *destLen,
+			 const void *source, unsigned long sourceLen, int level);
 };
 
 extern struct zlib_iface zlib;
@@ -0,0 +1,70 @@
+/*
+ * wrap_alloc.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Private allocator for tracer state.
+ *
+ * Everything the tracer allocates (TLS contexts, log buffers, backtrace
+ * caches, fd tables, ...) comes from mmap'd slabs owned by the tracer,
+ * never from the traced process' malloc: that keeps us from perturbing
+ * the heap we're measuring, and from recursing into wrapped code.
+ *
+ * Known structures get their own slab:
+ *	static struct wslab my_slab = WSLAB_INIT("my_struct", sizeof(struct my_struct));
+ *	p = wslab_alloc(&my_slab);
+ *	wslab_free(&my_slab, p);
+ *
+ * Everything else goes through walloc()/wfree(), which use power-of-two
+ * size classes (or a direct mapping for large requests). The caller has
+ * to pass the size back to wfree(): there are no object headers.
+ *
+ * Memory handed out is NOT zeroed when it is recycled.
+ */
+#ifndef WRAP_ALLOC_H
+#define WRAP_ALLOC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+struct wslab {
+	const char *name;
+	size_t objsz;
+
+	void *freelist;
+	char *chunk;              /* unused tail of the last mapped chunk */
+	size_t chunk_left;
+
+	unsigned long nr_active;  /* objects handed out */
+	unsigned long nr_objs;    /* objects carved from mapped chunks */
+	unsigned long mapped;     /* bytes mapped for this slab */
+
+	struct wslab *next;       /* all slabs with live mappings */
+	int registered;
+};
+
+#define WSLAB_INIT(name, sz) \
+	{ (name), (sz), NULL, NULL, 0, 0, 0, 0, NULL, 0 }
+
+struct walloc_stats {
+	unsigned long mapped;     /* bytes of address space we own */
+	unsigned long active;     /* bytes currently handed out */
+	unsigned long nr_slabs;
+};
+
+extern void *wslab_alloc(struct wslab *slab);
+extern void  wslab_free(struct wslab *slab, void *ptr);
+
+extern void *walloc(size_t size);
+extern void  wfree(void *ptr, size_t size);
+
+extern void walloc_get_stats(struct walloc_stats *st);
+
+/* the allocator lock may have been held by another thread at fork() */
+extern void walloc_init_child(void);
+
+__END_DECLS
+
+#endif /* WRAP_ALLOC_H */
@@ -0,0 +1,85 @@
+/*
+ * wrap_budget.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Bounded disk usage for everything written to LOGFILE_PATH.
+ *
+ * Output files are rotated once they reach LOG_ROTATE_MB, or once they've
+ * been open for LOG_ROTATE_SEC: the trace container moves on to
+ * <pid>.<prog>.<N>.trace, log shards to <pid>.shard<i>.<N>.<lib>... The
+ * whole directory is held to LOG_BUDGET_MB, across processes: files
+ * nobody is writing any more (their process is gone, or its pid now
+ * belongs to a process that started after they were last written), and
+ * segments the checking process has rotated away from, are deleted,
+ * oldest first. Files other running processes may hold open stay, however
+ * idle. If that isn't enough, the trace container stops writing, and
+ * counts what it drops, until space is available again.
+ *
+ * Opening or rotating a file only compares a running total (the last
+ * count of the directory, plus what we wrote since) with the budget. The
+ * directory is counted again, and files deleted, by a thread of its own:
+ * when we're over, and at least every LOG_BUDGET_RESCAN_MS. Deleting
+ * starts with a list of the oldest files that can go, which the count
+ * fills and rotation adds to.
+ *
+ * The optional LOG_BUDGET_CFG_PATH overrides the limits with a line:
+ *	<rotate MB>:<rotate sec>:<budget MB>
+ * where 0 disables a limit, and an empty field keeps the default.
+ *
+ * Bytes written and dropped by this library are reported in the trace
+ * as "LOG:STATS:<written>:<dropped>:" when a file is rotated or closed.
+ */
+#ifndef WRAP_BUDGET_H
+#define WRAP_BUDGET_H
+
+#include <stdint.h>
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+#define LOG_BUDGET_CFG_PATH  LOGFILE_PATH "/budget.conf"
+#define LOG_BUDGET_LOCK_PATH LOGFILE_PATH "/.budget.lock"
+
+#ifndef LOG_ROTATE_MB
+#define LOG_ROTATE_MB        64
+#endif
+#ifndef LOG_ROTATE_SEC
+#define LOG_ROTATE_SEC       3600
+#endif
+#ifndef LOG_BUDGET_MB
+#define LOG_BUDGET_MB        1024
+#endif
+
+#define LOG_BUDGET_CLOCK_SLACK 2   /* sec: process start times are approximate */
+#define LOG_BUDGET_RETRY_MS  5000
+#define LOG_BUDGET_RESCAN_MS 10000
+#define LOG_BUDGET_MAX_OLD   64      /* files listed to be deleted, at most */
+#define LOG_BUDGET_MAX_FDS   1024    /* more open files: ours stay */
+
+struct log_stats {
+	uint64_t written;               /* bytes that made it to a file */
+	uint64_t dropped;               /* bytes we had to throw away */
+};
+
+extern uint64_t log_now_ms(void);
+
+/* non-zero if a file of 'size' bytes, opened at 'opened_ms', is done */
+extern int  log_should_rotate(uint64_t size, uint64_t opened_ms);
+
+/*
+ * 0 if LOGFILE_PATH was within budget the last time it was checked, < 0
+ * if it was still over. Starts a check in the background if needed.
+ */
+extern int  log_budget_enforce(void);
+
+/* we rotated away from 'path' (of 'size' bytes): it can go once closed */
+extern void log_budget_closed(const char *path, uint64_t size);
+
+extern void log_account(uint64_t written, uint64_t dropped);
+extern void log_get_stats(struct log_stats *st);
+
+extern void log_budget_init_child(void);
+
+__END_DECLS
+
+#endif /* WRAP_BUDGET_H */
@@ -0,0 +1,46 @@
+/*
+ * wrap_callers.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Filter traced calls by the library that made them.
+ *
+ * The optional CALLERS_CFG_PATH lists libraries, one per line:
+ *	allow <lib>
+ *	deny <lib>
+ * where <lib> is either the full path of a library, or its file name
+ * (e.g. "libfoo.so"). Once there is an "allow" line, only calls made from
+ * an allowed library are traced, and calls made from a denied one never
+ * are. Code that isn't in any library (e.g. JIT code) counts as matching
+ * no line.
+ *
+ * The return address of each call is looked up in the module map (see
+ * wrap_maps.h), for which the decision is made once per mapping: a
+ * filtered call leaves wrapped_tracer() before anything else is done.
+ * That first look only reads what's already been published; reading the
+ * file (once per process), refreshing the map and deciding for a new one
+ * happen behind the recursion guard, and calls are traced until they're
+ * done.
+ */
+#ifndef WRAP_CALLERS_H
+#define WRAP_CALLERS_H
+
+#include <stdint.h>
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+#define CALLERS_CFG_PATH  LOGFILE_PATH "/callers.conf"
+#define CALLERS_MAX       32
+#define CALLERS_NAME_LEN  128
+
+/*
+ * 1 if the call returning to 'lr' shouldn't be traced, 0 if it should,
+ * -1 if callers_check() has to tell (lock-free: before the guard)
+ */
+extern int callers_skip(uintptr_t lr);
+/* the same, loading what it needs: behind the recursion guard */
+extern int callers_check(uintptr_t lr);
+
+__END_DECLS
+
+#endif /* WRAP_CALLERS_H */
@@ -0,0 +1,54 @@
+/*
+ * wrap_cct.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Optional calling-context tree (build with -DHAVE_CCT).
+ *
+ * Instead of logging a backtrace for every call, each thread keeps a tree
+ * of the call paths it has seen: one node per frame PC, below the frame
+ * that called it, with the wrapped function itself as a leaf. Leaves
+ * count calls and add up the time spent in them (from wrapped_return,
+ * so on ARM only). The tree is logged when the thread's log is closed,
+ * and whenever it reaches CCT_MAX_NODES (it then starts over):
+ *	CCT:START:<nodes>:
+ *	CCT:<id>:<parent>:<F|L>:<calls>:<incl ns>:<excl ns>:<sym>:<lib>:
+ * one line per node, parents first (the root, id 0, isn't logged). F
+ * nodes are frames, L nodes wrapped calls. Inclusive time is the time
+ * spent in wrapped calls anywhere below a node, exclusive time the time
+ * spent in the ones it called directly.
+ */
+#ifndef WRAP_CCT_H
+#define WRAP_CCT_H
+
+#ifdef HAVE_CCT
+
+#ifdef HAVE_RAW_STACK
+#error "the calling-context tree and raw stack snapshots can't be used together"
+#endif
+
+#include <stdint.h>
+
+#define CCT_INIT_NODES  256
+#define CCT_MAX_NODES   (64 * 1024)
+#define CCT_NAMES_SZ    4096
+
+struct bt_state;
+struct tls_info;
+
+extern void cct_enter(struct tls_info *tls, struct bt_state *state);
+/* non-zero if the time of the call was added to the tree */
+extern int  cct_ret(struct tls_info *tls, uint64_t ns);
+extern void cct_dump(struct tls_info *tls);
+extern void cct_thread_release(struct tls_info *tls);
+
+#define cct_watch(tls) 1
+
+#else
+#define cct_enter(tls, state)
+#define cct_ret(tls, ns) 0
+#define cct_dump(tls)
+#define cct_thread_release(tls)
+#define cct_watch(tls) 0
+#endif /* HAVE_CCT */
+
+#endif /* WRAP_CCT_H */
@@ -0,0 +1,109 @@
+/*
+ * wrap_container.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Per-process trace container: LOGFILE_PATH/<pid>.<prog>.trace
+ *
+ * Every wrapped library in a process appends self-describing chunks to the
+ * same file, instead of keeping a set of .log.gz files per library. A
+ * library reserves (fallocate) and maps 1M segments at the end of the file
+ * and copies chunks into them, closing each with a padding chunk; where
+ * that isn't possible, chunks are appended with one O_APPEND write() each.
+ * A chunk holds the output of a single thread:
+ *
+ *	struct wtc_chunk  (64 bytes, little-endian)
+ *	payload           ('len' bytes, raw or zlib compress2() output)
+ *
+ * When a library's tracer finishes (exit/exec) it appends an index chunk
+ * listing the chunks it wrote, followed by a trailer pointing at that
+ * index. Index chunks link to a previous index (the one whose trailer
+ * they were appended after, or else the writer's own), so a reader can
+ * follow them from the end of the file and find every chunk without
+ * reading the payloads. A file that doesn't end in a trailer (or whose
+ * indices don't add up to its size) is read by walking the chunk headers
+ * instead.
+ *
+ * Long-running processes move on to <pid>.<prog>.<N>.trace segments
+ * (see wrap_budget.h): each is a complete container of its own.
+ *
+ * Build with -DNO_TRACE_CONTAINER to go back to per-library log files.
+ */
+#ifndef WRAP_CONTAINER_H
+#define WRAP_CONTAINER_H
+
+#include <stdint.h>
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+#define WTC_MAGIC      "WTC1"
+#define WTC_END_MAGIC  "WTCINDEX"
+
+/* chunk types */
+#define WTC_DATA       1
+#define WTC_INDEX      2
+#define WTC_PAD        3    /* unused end of a mapped segment */
+
+/* chunk codecs */
+#define WTC_RAW        0
+#define WTC_ZLIB       1
+
+#define WTC_LIB_LEN    16
+#define WTC_NO_PREV    ((uint64_t)-1)
+
+struct wtc_chunk {
+	char     magic[4];
+	uint16_t hdr_len;
+	uint8_t  type;
+	uint8_t  codec;
+	uint32_t pid;
+	uint32_t tid;
+	char     lib[WTC_LIB_LEN];   /* wrapped library (_IBNAM_) */
+	uint64_t first_ts;           /* usec: first / last write */
+	uint64_t last_ts;
+	uint32_t len;                /* payload bytes in the file */
+	uint32_t raw_len;            /* payload bytes once decoded */
+	uint64_t prev;               /* index chunks: previous index */
+};
+
+struct wtc_index_ent {
+	uint64_t offset;             /* of the chunk header */
+	uint32_t tid;
+	uint32_t len;                /* header + payload */
+	uint64_t first_ts;
+	uint64_t last_ts;
+};
+
+struct wtc_trailer {
+	char     magic[8];
+	uint64_t index;              /* offset of the index chunk */
+};
+
+#ifndef NO_TRACE_CONTAINER
+struct trace_container;
+struct tls_info;
+
+extern struct trace_container trace_container;
+
+#define is_container(f) \
+	((void *)(f) == (void *)&trace_container)
+
+extern void *container_get(struct tls_info *tls);
+extern void  container_write(void *f, const void *buf, int len);
+extern void  container_printf(void *f, const char *fmt, ...);
+extern void  container_flush(void *f);
+extern void  container_sync(int finish);
+extern void  container_init_child(void);
+#else
+#define is_container(f) 0
+#define container_get(tls) NULL
+#define container_write(f, buf, len)
+#define container_printf(f, fmt, ...)
+#define container_flush(f)
+#define container_sync(finish)
+#define container_init_child()
+#endif
+
+__END_DECLS
+
+#endif /* WRAP_CONTAINER_H */
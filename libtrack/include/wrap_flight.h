@@ -0,0 +1,93 @@
+/*
+ * wrap_flight.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Optional flight recorder (build with -DHAVE_FLIGHT_RECORDER).
+ *
+ * Nothing is written to disk while tracing: every event goes into a ring
+ * belonging to the thread (oldest events are overwritten), and the rings
+ * of all threads (including ones that have exited) are dumped into
+ * LOGFILE_PATH/<pid>.flight<N>.<lib>.<prog>.log[.gz] when a trigger fires:
+ *
+ *	SIGUSR2 (the special signal handler): the dump is made by the
+ *	next traced call, in whichever thread makes it
+ *	a change of the first word of FLIGHT_TRIGGER_PATH, which every
+ *	traced process maps, e.g.:
+ *	    date +%s%N | dd of=/data/trace_logs/flight.trigger bs=8 count=1 \
+ *	       conv=notrunc
+ *	    (don't truncate the file: readers would fault)
+ *	a watched symbol returning a negative value
+ *	a call taking longer than the latency threshold
+ *
+ * The last two need the return path of wrapped calls (ARM). The optional
+ * FLIGHT_CFG_PATH holds a single line:
+ *	<ring kb per thread>:<latency threshold us>:<sym>[,<sym>...]
+ * where any field can be left empty (0 disables the latency trigger).
+ *
+ * Each ring is preceded by "LOG:TID:<tid>:" in a dump, and the thread
+ * that fired the trigger logs "LOG:FLIGHT:<why>:<what>:<suppressed>:"
+ * (triggers within FLIGHT_HOLDOFF_MS of a dump are counted, not dumped).
+ */
+#ifndef WRAP_FLIGHT_H
+#define WRAP_FLIGHT_H
+
+#ifdef HAVE_FLIGHT_RECORDER
+
+#ifdef HAVE_PERCPU_LOG
+#error "the flight recorder and per-CPU logs can't be used together"
+#endif
+
+#include <stdint.h>
+
+#define FLIGHT_CFG_PATH      LOGFILE_PATH "/flight.conf"
+#define FLIGHT_TRIGGER_PATH  LOGFILE_PATH "/flight.trigger"
+
+#define FLIGHT_RING_KB       256
+#define FLIGHT_MIN_RING_KB   16
+#define FLIGHT_MAX_RINGS     64
+#define FLIGHT_MAX_WATCH     16
+#define FLIGHT_HOLDOFF_MS    1000
+
+/* events are handed to the ring one at a time */
+#define FLIGHT_THREAD_LOGBUF_SZ (8 * 1024)
+
+struct flight_log;
+struct flight_ring;
+struct tls_info;
+
+extern struct flight_log flight_log;
+
+#define is_flight(f) \
+	((void *)(f) == (void *)&flight_log)
+
+extern void *flight_get(struct tls_info *tls);
+extern void  flight_write(void *f, const void *buf, int len);
+extern void  flight_printf(void *f, const char *fmt, ...);
+
+/* non-zero if the current call has to come back through wrapped_return */
+extern int   flight_watch(struct tls_info *tls);
+extern void  flight_check(struct tls_info *tls);
+extern void  flight_ret(struct tls_info *tls, const char *sym,
+			uint32_t rval, uint64_t ns);
+extern void  flight_trigger(struct tls_info *tls, const char *why,
+			    const char *what);
+extern void  flight_signal(int sig);
+
+extern void  flight_thread_release(struct tls_info *tls);
+extern void  flight_init_child(void);
+
+#else
+#define is_flight(f) 0
+#define flight_get(tls) NULL
+#define flight_write(f, buf, len)
+#define flight_printf(f, fmt, ...)
+#define flight_watch(tls) 0
+#define flight_check(tls)
+#define flight_ret(tls, sym, rval, ns)
+#define flight_trigger(tls, why, what)
+#define flight_signal(sig)
+#define flight_thread_release(tls)
+#define flight_init_child()
+#endif /* HAVE_FLIGHT_RECORDER */
+
+#endif /* WRAP_FLIGHT_H */
@@ -14,6 +14,7 @@
 #include <dirent.h>
 #include <dlfcn.h>
 #include <pthread.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -23,6 +24,8 @@
 #include <sys/socket.h>
 #include <sys/stat.h>
 
+#include <asm/wrap_lib.h>
+
 __BEGIN_DECLS
 
 /* easily export / hide all non-wrapped functionality */
@@ -35,6 +38,13 @@ __BEGIN_DECLS
 #endif
 
 #include "libz.h"
+#include "wrap_percpu.h"
+#include "wrap_container.h"
+#include "wrap_flight.h"
+#include "wrap_cct.h"
+#include "wrap_budget.h"
+#include "wrap_rt.h"
+#include "wrap_seq.h"
 
 #define ___str(x) #x
 #define __str(x) ___str(x)
@@ -102,8 +112,20 @@ struct libc_iface {
 	int (*fno)(FILE *f);
 	int (*fchmod)(int fd, mode_t mode);
 	int (*access)(const char *path, int amode);
+	int (*open)(const char *path, int flags, ...);
+	ssize_t (*write)(int fd, const void *buf, size_t count);
+	ssize_t (*pread)(int fd, void *buf, size_t count, off_t offset);
+	off_t (*lseek)(int fd, off_t offset, int whence);
+	int (*flock)(int fd, int operation);
+	int (*fallocate)(int fd, int mode, off_t offset, off_t len);
 	int (*stat)(const char *path, struct stat *buf);
 	int (*dirfd)(DIR *dirp);
+	DIR *(*opendir)(const char *path);
+	struct dirent *(*readdir)(DIR *dirp);
+	int (*closedir)(DIR *dirp);
+	int (*unlink)(const char *path);
+	int (*dup2)(int oldfd, int newfd);
+	int (*kill)(pid_t pid, int sig);
 
 	pid_t (*getpid)(void);
 	uint32_t (*gettid)(void);
@@ -124,8 +146,14 @@ struct libc_iface {
 
 	int (*pthread_mutex_lock)(pthread_mutex_t *mutex);
 	int (*pthread_mutex_unlock)(pthread_mutex_t *mutex);
+	int (*pthread_create)(pthread_t *thread, const pthread_attr_t *attr,
+			      void *(*start)(void *), void *arg);
+	int (*pthread_detach)(pthread_t thread);
+	int (*pthread_atfork)(void (*prepare)(void), void (*parent)(void),
+			      void (*child)(void));
 
 	int (*snprintf)(char *str, size_t size, const char *format, ...);
+	int (*vsnprintf)(char *str, size_t size, const char *format, va_list ap);
 	int (*printf)(const char *fmt, ...);
 	int (*fprintf)(FILE *f, const char *fmt, ...);
 	long (*strtol)(const char *str, char **endptr, int base);
@@ -135,6 +163,12 @@ struct libc_iface {
 	void *(*malloc)(size_t size);
 	void (*free)(void *ptr);
 
+	long (*syscall)(long number, ...);
+	void *(*mmap)(void *addr, size_t len, int prot, int flags,
+		      int fd, off_t offset);
+	int (*munmap)(void *addr, size_t len);
+	int (*close)(int fd);
+
 	char *(*getenv)(const char *name);
 	int (*setenv)(const char *name, const char *value, int overwrite);
 
@@ -176,6 +210,14 @@ struct tls_info;
 
 extern int  __set_wrapping(void);
 extern void __clear_wrapping(void);
+extern int  __set_wrapping_key(pthread_key_t *key);
+extern void __clear_wrapping_key(pthread_key_t *key);
+
+/* for the library the thread's current call went into */
+#define tls_set_wrapping(tls) \
+	__set_wrapping_key((tls)->lib->wrapping_key)
+#define tls_clear_wrapping(tls) \
+	__clear_wrapping_key((tls)->lib->wrapping_key)
 
 extern int  __get_libc(struct tls_info *tls, const char *symbol);
 extern void __put_libc(void);
@@ -186,8 +228,27 @@ extern void *wrapped_dlsym(const char *libpath, void **lib_handle, const char *s
 
 extern int wrapped_tracer(const char *symbol, void *symptr, void *regs, void *stack);
 
+#ifdef HAVE_EAGER_INIT
+/*
+ * Run from the library constructor instead of the first traced call:
+ * find every wrapped function, and touch the buffers the main thread
+ * (and the next EAGER_PREFAULT_THREADS threads) will log into. The
+ * module map is read by a short-lived thread. Output files, and the
+ * main thread's context, are still set up by the first logged event;
+ * only flight recorder builds install the SIGUSR2 handler up front.
+ */
+#ifndef EAGER_PREFAULT_THREADS
+#define EAGER_PREFAULT_THREADS 4
+#endif
+extern void wrap_eager_init(void);
+#else
+#define wrap_eager_init()
+#endif
+
 extern void *get_log(int release);
 extern void *__get_log(int release);
+/* the thread's log file, opened now if it has none yet */
+extern void *tls_logfile(struct tls_info *tls);
 
 extern const char *local_strrchr(const char *str, int c);
 extern int local_strcmp(const char *s1, const char *s2);
@@ -196,6 +257,30 @@ extern int local_strlen(const char *s);
 
 extern void libc_close_log(void);
 
+extern void *__open_logfile(char *name, size_t len, const char *id, int *fdp);
+
+#ifndef NO_TLS_POOL
+/*
+ * Threads share a small set of per-process log shards instead of opening
+ * one file per thread: writes to a shard are serialized, and a
+ * LOG:TID:<tid>: marker precedes output from a different thread.
+ */
+#define NR_LOG_SHARDS 4
+
+extern void *log_shard_get(struct tls_info *tls);
+extern int   log_shard_put(void *f);
+extern void  log_shards_flush(int finish);
+extern void  log_shards_init_child(void);
+
+extern void __log_lock(void *f);
+extern void __log_unlock(void *f);
+#else
+#define log_shards_flush(finish)
+#define log_shards_init_child()
+#define __log_lock(f)
+#define __log_unlock(f)
+#endif
+
 static inline int should_log(void)
 {
 	int err;
@@ -242,16 +327,20 @@ static inline int should_log(void)
 
 extern volatile int*  __errno(void);
 
+#if defined(HAVE_PERCPU_LOG)
+#define LOG_BUFFER_SIZE PERCPU_THREAD_LOGBUF_SZ
+#elif defined(HAVE_FLIGHT_RECORDER)
+#define LOG_BUFFER_SIZE FLIGHT_THREAD_LOGBUF_SZ
+#else
 #define LOG_BUFFER_SIZE (32 * 1024)
+#endif
 
+/* set (or read) on every traced call: keep the small fields together */
 struct log_info {
 	const char *symbol;
 	void *func;
 	uint32_t *regs;
 	void *stack;
-	struct timeval tv;
-	char tv_str[32];
-	int  tv_strlen;
 
 	int log_time;
 
@@ -261,12 +350,16 @@ struct log_info {
 	uint8_t symhash;
 	void *symcache;
 
+	char  *log_buffer;
+	int   *log_pos;
+
+	struct timeval tv;
+	int  tv_strlen;
+	char tv_str[32];
+
 	void **last_stack;
 	int   *last_stack_depth;
 	int   *last_stack_cnt;
-
-	char  *log_buffer;
-	int   *log_pos;
 };
 
 /*
@@ -282,9 +375,15 @@ struct ret_ctx {
 		uint8_t  u8[16];
 	} u;
 	int _errno;
-	char symmod[MAX_SYMBOL_LEN];
 	const char *sym;
-	struct timespec posix_start;
+	int log_time;         /* the clock timing it, 0 if it isn't timed */
+	uint64_t posix_start; /* ns, see wrap_time.h */
+#ifdef WRAP_RT_CORE
+	/* the call's stamp: other libraries' calls replace the thread's */
+	int  tv_strlen;
+	char tv_str[32];
+#endif
+	char symmod[MAX_SYMBOL_LEN];
 };
 
 extern struct ret_ctx *get_retmem(struct tls_info *tls);
@@ -292,6 +391,19 @@ extern struct ret_ctx *get_retmem(struct tls_info *tls);
 #define is_main() \
 	((uint32_t)libc.getpid() == libc.gettid())
 
+/* only for keys that have been created */
+#ifdef HAVE_TLS_SLOTS
+#define wrap_getspecific(key) \
+	(arch_tls_slots()[(key)])
+#define wrap_setspecific(key, val) \
+	(arch_tls_slots()[(key)] = (void *)(val))
+#else
+#define wrap_getspecific(key) \
+	libc.pthread_getspecific(key)
+#define wrap_setspecific(key, val) \
+	libc.pthread_setspecific((key), (const void *)(val))
+#endif
+
 #define mtx_lock(mtx) \
 	if (libc.pthread_mutex_lock && libc.pthread_mutex_unlock) \
 		libc.pthread_mutex_lock(mtx)
@@ -300,21 +412,64 @@ extern struct ret_ctx *get_retmem(struct tls_info *tls);
 	if (libc.pthread_mutex_lock && libc.pthread_mutex_unlock) \
 		libc.pthread_mutex_unlock(mtx)
 
-#define __log_print_raw(tvptr, f, fmt, ...) \
+/*
+ * One-time lazy setup without a lock: 'state' goes 0 (not done) -> 1
+ * (running) -> 2 (done). once_begin() returns 1 to the one caller that
+ * has to do the work, which then calls once_end(); everyone else waits
+ * here until that's done, so nobody sees half of it.
+ */
+static inline int once_begin(volatile int *state)
+{
+	if (*state == 2)
+		return 0;
+	if (__sync_bool_compare_and_swap(state, 0, 1))
+		return 1;
+	while (*state != 2)
+		__sync_synchronize();
+	return 0;
+}
+
+/* once_begin() for callers that can't wait: 0 while someone else runs it */
+static inline int once_try(volatile int *state)
+{
+	return *state != 2 && __sync_bool_compare_and_swap(state, 0, 1);
+}
+
+static inline void once_end(volatile int *state)
+{
+	__sync_synchronize();
+	*state = 2;
+}
+
+#define __log_printf(f, fmt, ...) \
 	if (f) { \
-	if (zlib.valid) \
-		zlib.gzprintf((struct gzFile *)(f), "%lu.%lu:" fmt, \
-			     (unsigned long)(tvptr)->tv_sec, \
-			     (unsigned long)(tvptr)->tv_usec, ## __VA_ARGS__ ); \
+	__log_lock(f); \
+	if (is_flight(f)) \
+		flight_printf((f), fmt, ## __VA_ARGS__ ); \
+	else if (is_container(f)) \
+		container_printf((f), fmt, ## __VA_ARGS__ ); \
+	else if (zlib.valid) \
+		zlib.gzprintf((struct gzFile *)(f), fmt, ## __VA_ARGS__ ); \
 	else \
-		libc.fprintf((FILE *)(f), "%lu.%lu:" fmt, \
-			     (unsigned long)(tvptr)->tv_sec, \
-			     (unsigned long)(tvptr)->tv_usec, ## __VA_ARGS__ ); \
+		libc.fprintf((FILE *)(f), fmt, ## __VA_ARGS__ ); \
+	__log_unlock(f); \
 	}
 
+/* a record of its own, with a new stamp */
+#define __log_print_raw(tvptr, f, fmt, ...) \
+	__log_printf(f, "%lu.%lu" SEQ_FMT ":" fmt, \
+		     (unsigned long)(tvptr)->tv_sec, \
+		     (unsigned long)(tvptr)->tv_usec SEQ_ARG, \
+		     ## __VA_ARGS__ )
+
 #define __log_print(tvptr, f, key, fmt, ...) \
 	__log_print_raw(tvptr, f, key ":" fmt "\n", ## __VA_ARGS__ )
 
+/* a line of the traced call's event: it has the call's stamp */
+#define __log_print_event(info, f, key, fmt, ...) \
+	__log_printf(f, "%.*s" key ":" fmt "\n", \
+		     (info)->tv_strlen, (info)->tv_str, ## __VA_ARGS__ )
+
 #define log_print(f, key, fmt, ...) \
 	if (f) { \
 		struct timeval tv; \
@@ -338,7 +493,7 @@ extern struct ret_ctx *get_retmem(struct tls_info *tls);
 
 #define log_flush(f) \
 	if (f) { \
-		if (zlib.valid) \
+		if (zlib.valid || is_container(f) || is_flight(f)) \
 			; /* zlib.gzflush((struct gzFile *)(f), Z_SYNC_FLUSH); */ \
 		else \
 			libc.fflush((FILE *)f); \
@@ -346,7 +501,11 @@ extern struct ret_ctx *get_retmem(struct tls_info *tls);
 
 #define log_close(f) \
 	if (f) { \
-		if (zlib.valid) { \
+		if (is_flight(f)) \
+			; /* rings are only written out on a trigger */ \
+		else if (is_container(f)) \
+			container_flush(f); \
+		else if (zlib.valid) { \
 			zlib.gzflush((struct gzFile *)f, Z_FINISH); \
 			zlib.gzclose((struct gzFile *)f); \
 		} else \
@@ -364,19 +523,55 @@ extern struct ret_ctx *get_retmem(struct tls_info *tls);
 do { \
 	int prlen = *(pos); \
 	((uint8_t *)(logbuffer))[prlen] = 0; \
-	if (zlib.valid) { \
+	__log_lock(logfile); \
+	if (is_flight(logfile)) \
+		flight_write((logfile), (logbuffer), prlen); \
+	else if (is_container(logfile)) \
+		container_write((logfile), (logbuffer), prlen); \
+	else if (zlib.valid) { \
+		ovh_enter_cur(OVH_COMPRESS); \
 		zlib.gzwrite((struct gzFile *)(logfile), (logbuffer), prlen); \
 		/* I swear there's a bug in libz's gzwrite() - this extra call \
 		 * seems to make it better, but still not OK... */ \
 		zlib.gzwrite((struct gzFile *)(logfile), " ", 1); /* why?!?! */ \
+		ovh_leave_cur(); \
 	} else \
 		libc.fwrite((logbuffer), *(pos), 1, (FILE *)(logfile)); \
+	__log_unlock(logfile); \
 	*(pos) = 0; \
 } while (0)
 
+/*
+ * hand the buffer to the per-CPU logs: non-zero if they took it. Threads
+ * only get a log file of their own if the per-CPU logs turn one down.
+ */
+#ifdef HAVE_PERCPU_LOG
+#define __bt_commit(tls, logbuffer, pos) \
+	(percpu_log_commit((tls), (const char *)(logbuffer), *(pos)) == 0 \
+	 ? (*(pos) = 0, 1) : 0)
+#define __bt_logfile(tls) tls_logfile(tls)
+#define tls_has_log(tls) 1
+#else
+#define __bt_commit(tls, logbuffer, pos) 0
+#define __bt_logfile(tls) ((tls)->logfile)
+#define tls_has_log(tls) ((tls)->logfile != NULL)
+#endif
+
 #define bt_flush(tls, info) \
-	if ((tls) && (tls)->logfile && (info)->log_pos && *((info)->log_pos) > 0) \
-		__bt_flush((tls)->logfile, (info)->log_buffer, (info)->log_pos); \
+	if ((tls) && tls_has_log(tls) && (info)->log_pos && \
+	    *((info)->log_pos) > 0) { \
+		void *__f; \
+		ovh_enter((tls), OVH_IO); \
+		if (!__bt_commit((tls), (info)->log_buffer, (info)->log_pos)) { \
+			__f = __bt_logfile(tls); \
+			if (__f) \
+				__bt_flush(__f, (info)->log_buffer, \
+					   (info)->log_pos); \
+			else \
+				*((info)->log_pos) = 0; \
+		} \
+		ovh_leave(tls); \
+	}
 
 #ifdef AGGRESIVE_FLUSHING
 #define BT_EXTRA_FLUSH(tls,info) \
@@ -427,6 +622,14 @@ extern void __bt_raw_print(struct tls_info *tls,
 		*((volatile int *)(0xFFFF0000 | (uint32_t)(X))) = X; \
 	} while (0)
 
+#ifdef WRAP_RT_GLUE
+/* the glue has no log of its own (see wrap_rt.h) */
+#define BUG(X) \
+	_BUG(X)
+
+#define BUG_MSG(X,fmt,...) \
+	_BUG(X)
+#else
 #define BUG(X) \
 	do { \
 		void *f; \
@@ -451,6 +654,7 @@ extern void __bt_raw_print(struct tls_info *tls,
 		} \
 		_BUG(X); \
 	} while (0)
+#endif /* WRAP_RT_GLUE */
 
 #ifdef _LIBC
 #define SYMERR(X) \
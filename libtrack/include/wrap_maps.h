@@ -0,0 +1,84 @@
+/*
+ * wrap_maps.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Module map: the executable mappings of this process, read from
+ * /proc/self/maps into a table sorted by address.
+ *
+ * Every table has a generation number. Before a thread logs anything
+ * that needs the map offline (e.g. raw stack snapshots), it logs the
+ * table into its own stream, once per generation:
+ *	MAP:<gen>:<start>:<end>:<file offset>:<path>:
+ * (addresses in hex; anonymous code has an empty or [bracketed] path).
+ * A new generation is started when code shows up outside of the table
+ * (a dlopen), after a dlclose, after a fork, and when a log file is
+ * rotated, so that every file carries the map its records refer to.
+ */
+#ifndef WRAP_MAPS_H
+#define WRAP_MAPS_H
+
+#include <stdint.h>
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+#define MAPS_PATH        "/proc/self/maps"
+#define MAPS_REFRESH_MS  100     /* re-read the maps at most this often */
+
+struct wmap {
+	uintptr_t   start;
+	uintptr_t   end;
+	uint32_t    offset;
+	const char *path;
+};
+
+struct wmap_table {
+	volatile uint32_t gen;
+	int         count;
+	size_t      size;           /* bytes allocated for the table */
+	struct wmap ent[0];         /* followed by the paths */
+};
+
+/* what a thread has logged of the map, and where its stack is */
+struct maps_thread {
+	uint32_t  gen;
+	uintptr_t stack_lo;
+	uintptr_t stack_hi;
+};
+
+struct tls_info;
+
+extern const struct wmap_table *maps_get(void);
+extern const struct wmap_table *maps_refresh(void);
+extern const struct wmap *maps_find(const struct wmap_table *t,
+				    uintptr_t addr);
+/* maps_find(), refreshing the map first if 'addr' isn't in it */
+extern const struct wmap *maps_lookup(uintptr_t addr,
+				      const struct wmap_table **tp);
+
+/*
+ * Code was unloaded (a dlclose): the next lookup reads the maps again,
+ * even for an address the current table still holds.
+ */
+extern void maps_invalidate(void);
+
+/* start a new generation: every thread logs the map again */
+extern void maps_touch(void);
+
+/* log 't' into the thread's stream if it hasn't seen this generation */
+extern void maps_log(struct tls_info *tls, const struct wmap_table *t);
+/*
+ * One MAP line of 't'. maps_touch() can bump t->gen at any time: read it
+ * once, and pass the same 'gen' for every line of the table.
+ */
+extern int  maps_line(const struct wmap_table *t, uint32_t gen, int i,
+		      char *buf, int len);
+
+/* bounds of the (stack) mapping holding 'sp' */
+extern int  maps_stack_bounds(uintptr_t sp, uintptr_t *lo, uintptr_t *hi);
+
+extern void maps_init_child(void);
+
+__END_DECLS
+
+#endif /* WRAP_MAPS_H */
@@ -0,0 +1,148 @@
+/*
+ * wrap_overhead.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Optional accounting of the tracer's own cost (build with
+ * -DHAVE_OVERHEAD).
+ *
+ * Each thread adds up the time it spends in wrapped_tracer(),
+ * log_backtrace(), the flushing of its log buffer and wrapped_return(),
+ * split by what it was doing:
+ *	unwind    walking (or copying) the stack
+ *	format    turning calls and frames into log lines (symbol lookups
+ *	          included)
+ *	compress  zlib, when the output is compressed: gzwrite() does the
+ *	          writes of a gzip log as well
+ *	io        handing log buffers to the output (a file, a container
+ *	          segment, a per-CPU buffer or a flight recorder ring)
+ *	other     the rest: TLS, symbol cache and configuration lookups...
+ * Time is charged to the innermost stage only. Every OVH_REPORT_CALLS
+ * traced calls, and when its log is closed, a thread logs its totals so
+ * far:
+ *	LOG:OVERHEAD:<tid>:<calls>:<total ns>:<unwind ns>:<format ns>:
+ *		<compress ns>:<io ns>:<other ns>:
+ * The same record, with a tid of 0, follows every LOG:STATS record: it
+ * adds up what all the threads of the process had reported by then.
+ * wrap_throttle.h holds this cost to a budget.
+ */
+#ifndef WRAP_OVERHEAD_H
+#define WRAP_OVERHEAD_H
+
+#ifdef HAVE_OVERHEAD
+
+#include <stdint.h>
+
+#include "wrap_time.h"
+
+#define OVH_OTHER     0
+#define OVH_UNWIND    1
+#define OVH_FORMAT    2
+#define OVH_COMPRESS  3
+#define OVH_IO        4
+#define OVH_NR        5
+
+#define OVH_DEPTH         8
+#define OVH_REPORT_CALLS  4096
+
+struct ovh_stats {
+	uint64_t calls;
+	uint64_t ns[OVH_NR];
+};
+
+struct ovh_thread {
+	struct ovh_stats now;
+	struct ovh_stats reported;  /* already added to the process totals */
+	uint64_t mark;              /* when the current stage was (re)entered */
+	uint64_t call_start;        /* when the outermost stage was entered */
+	uint64_t call_ns;           /* time spent under the last outermost one */
+	int depth;
+	uint8_t stack[OVH_DEPTH];
+};
+
+struct tls_info;
+
+/* anything nested deeper than OVH_DEPTH is charged to the last stage */
+static inline void __ovh_charge(struct ovh_thread *o, uint64_t now)
+{
+	int top = o->depth > OVH_DEPTH ? OVH_DEPTH : o->depth;
+
+	o->now.ns[o->stack[top - 1]] += now - o->mark;
+	o->mark = now;
+}
+
+static inline void __ovh_enter(struct ovh_thread *o, int stage)
+{
+	uint64_t now = wtime_wall_ns();
+
+	if (o->depth > 0)
+		__ovh_charge(o, now);
+	else
+		o->mark = o->call_start = now;
+	if (o->depth < OVH_DEPTH)
+		o->stack[o->depth] = (uint8_t)stage;
+	o->depth++;
+}
+
+static inline void __ovh_leave(struct ovh_thread *o)
+{
+	uint64_t now;
+
+	if (o->depth <= 0)
+		return;
+	now = wtime_wall_ns();
+	__ovh_charge(o, now);
+	if (--o->depth == 0)
+		o->call_ns = now - o->call_start;
+}
+
+#define ovh_enter(tls, stage) \
+	do { \
+		if (tls) \
+			__ovh_enter(&(tls)->ovh, (stage)); \
+	} while (0)
+
+#define ovh_leave(tls) \
+	do { \
+		if (tls) \
+			__ovh_leave(&(tls)->ovh); \
+	} while (0)
+
+/* for code that doesn't have the thread's context at hand */
+#define ovh_enter_cur(stage) \
+	do { \
+		struct tls_info *__otls = peek_tls(); \
+		ovh_enter(__otls, (stage)); \
+	} while (0)
+
+#define ovh_leave_cur() \
+	do { \
+		struct tls_info *__otls = peek_tls(); \
+		ovh_leave(__otls); \
+	} while (0)
+
+/* one more traced call: logs the thread's totals every so often */
+#define ovh_count(tls) \
+	do { \
+		if (++(tls)->ovh.now.calls - (tls)->ovh.reported.calls \
+		    >= OVH_REPORT_CALLS) \
+			ovh_report(tls); \
+	} while (0)
+
+extern void ovh_report(struct tls_info *tls);
+extern void ovh_get_stats(struct ovh_stats *st);
+/* the process totals as a LOG:OVERHEAD record (no timestamp) */
+extern int  ovh_stats_line(char *buf, int len);
+extern void ovh_init_child(void);
+
+#else
+#define ovh_enter(tls, stage)
+#define ovh_leave(tls)
+#define ovh_enter_cur(stage)
+#define ovh_leave_cur()
+#define ovh_count(tls)
+#define ovh_report(tls)
+#define ovh_stats_line(buf, len) ((void)(buf), 0)
+#define ovh_init_child()
+#endif /* HAVE_OVERHEAD */
+
+#endif /* WRAP_OVERHEAD_H */
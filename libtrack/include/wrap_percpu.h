@@ -0,0 +1,56 @@
+/*
+ * wrap_percpu.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Optional per-CPU log buffers (build with -DHAVE_PERCPU_LOG).
+ *
+ * Instead of flushing a (mostly empty) 32k buffer per thread into the
+ * log, each event is committed at the end of wrapped_tracer() into a
+ * buffer belonging to the CPU we're running on. Space is reserved with a
+ * restartable sequence (no locks, no atomics) where the kernel and CPU
+ * support it, or under a per-CPU mutex otherwise. A background thread
+ * drains the buffers into the trace container (or into
+ * <pid>.percpu.<lib>.<prog>.log[.gz] without one), preceding each record
+ * with "LOG:TID:<tid>:<seq>:" so the parser can put every thread's output
+ * back together (and in order). The drainer is started by the first
+ * commit, which doesn't wait for it. Threads only open a log of their own
+ * for events the per-CPU buffers turn down.
+ */
+#ifndef WRAP_PERCPU_H
+#define WRAP_PERCPU_H
+
+#ifdef HAVE_PERCPU_LOG
+
+#include <stdint.h>
+
+#define PERCPU_MAX_CPUS   32
+#define PERCPU_BUF_SZ     (64 * 1024)
+
+/* the per-thread buffer only has to hold a single event */
+#define PERCPU_THREAD_LOGBUF_SZ (8 * 1024)
+
+/* room for a 32-byte aligned struct wrap_rseq (see wrap_rseq.h) */
+#define PERCPU_RSEQ_STORAGE 64
+
+struct percpu_thread {
+	char rseq_storage[PERCPU_RSEQ_STORAGE];
+	void *rseq;
+	int rseq_state;   /* 0 = untried, 1 = ours, 2 = libc's, -1 = none */
+	uint32_t seq;     /* per-thread record sequence number */
+};
+
+struct tls_info;
+
+/* returns < 0 if the caller should write 'buf' to its log file itself */
+extern int  percpu_log_commit(struct tls_info *tls, const char *buf, int len);
+extern void percpu_log_sync(int finish);
+extern void percpu_thread_release(struct tls_info *tls);
+extern void percpu_init_child(void);
+
+#else
+#define percpu_log_sync(finish)
+#define percpu_thread_release(tls)
+#define percpu_init_child()
+#endif /* HAVE_PERCPU_LOG */
+
+#endif /* WRAP_PERCPU_H */
@@ -0,0 +1,148 @@
+/*
+ * wrap_rseq.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Minimal restartable sequences (rseq) support for the per-CPU log
+ * buffers: thread registration and a single critical section.
+ */
+#ifndef WRAP_RSEQ_H
+#define WRAP_RSEQ_H
+
+#include <stdint.h>
+
+#if (defined(__x86_64__) || (defined(__arm__) && !defined(__thumb__))) \
+	&& defined(__linux__)
+#define HAVE_WRAP_RSEQ
+#endif
+
+#ifndef __NR_rseq
+#  if defined(__x86_64__)
+#    define __NR_rseq 334
+#  elif defined(__arm__)
+#    define __NR_rseq 398
+#  endif
+#endif
+
+/* these must match the C library's, in case it registered for us */
+#if defined(__x86_64__)
+#define WRAP_RSEQ_SIG 0x53053053
+#else
+#define WRAP_RSEQ_SIG 0xe7f5def3
+#endif
+
+#define WRAP_RSEQ_FLAG_UNREGISTER 1
+
+#define __rseq_str_1(x) #x
+#define __rseq_str(x) __rseq_str_1(x)
+
+/* kernel ABI: include/uapi/linux/rseq.h */
+struct wrap_rseq {
+	uint32_t cpu_id_start;
+	uint32_t cpu_id;
+	uint64_t rseq_cs;
+	uint32_t flags;
+	uint32_t __pad[3];
+} __attribute__((aligned(32)));
+
+/* storage for a struct wrap_rseq that needs no particular alignment */
+#define WRAP_RSEQ_AREA_SZ (sizeof(struct wrap_rseq) * 2)
+
+static inline struct wrap_rseq *wrap_rseq_area(void *storage)
+{
+	return (struct wrap_rseq *)(((uintptr_t)storage + 31) & ~(uintptr_t)31);
+}
+
+#ifdef HAVE_WRAP_RSEQ
+/*
+ * On the CPU 'cpu': if (*v1 == e1 && *v2 == e2) *v2 = newv
+ *
+ * Returns 0 on success, 1 if a comparison failed, and -1 if we weren't
+ * on 'cpu' or were preempted/migrated/signaled (just try again).
+ */
+static inline int wrap_rseq_cmp2_store(struct wrap_rseq *rs, int cpu,
+				       volatile uint32_t *v1, uint32_t e1,
+				       volatile uint32_t *v2, uint32_t e2,
+				       uint32_t newv)
+{
+#if defined(__x86_64__)
+	__asm__ __volatile__ goto(
+		".pushsection __rseq_cs, \"aw\"\n\t"
+		".balign 32\n\t"
+		"3:\n\t"
+		".long 0x0, 0x0\n\t"
+		".quad 1f, (2f - 1f), 4f\n\t"
+		".popsection\n\t"
+		"leaq 3b(%%rip), %%rax\n\t"
+		"movq %%rax, %[rseq_cs]\n\t"
+		"1:\n\t"
+		"cmpl %[cpu], %[cpu_id]\n\t"
+		"jnz 4f\n\t"
+		"cmpl %[e1], %[v1]\n\t"
+		"jnz %l[cmpfail]\n\t"
+		"cmpl %[e2], %[v2]\n\t"
+		"jnz %l[cmpfail]\n\t"
+		"movl %[newv], %[v2]\n\t"
+		"2:\n\t"
+		".pushsection __rseq_failure, \"ax\"\n\t"
+		".long " __rseq_str(WRAP_RSEQ_SIG) "\n\t"
+		"4:\n\t"
+		"jmp %l[abort]\n\t"
+		".popsection\n\t"
+		: /* no outputs */
+		: [cpu_id] "m" (rs->cpu_id),
+		  [rseq_cs] "m" (rs->rseq_cs),
+		  [cpu] "r" (cpu),
+		  [v1] "m" (*v1), [e1] "r" (e1),
+		  [v2] "m" (*v2), [e2] "r" (e2),
+		  [newv] "r" (newv)
+		: "memory", "cc", "rax"
+		: abort, cmpfail);
+#elif defined(__arm__)
+	__asm__ __volatile__ goto(
+		".pushsection __rseq_cs, \"aw\"\n\t"
+		".balign 32\n\t"
+		"3:\n\t"
+		".word 0x0, 0x0\n\t"
+		".word 1f, 0x0, (2f - 1f), 0x0, 4f, 0x0\n\t"
+		".popsection\n\t"
+		/* PC-relative, as symaddr in asm/wrap.S: no text relocs */
+		"movw ip, #:lower16:(3b - . - 16)\n\t"
+		"movt ip, #:upper16:(3b - . - 12)\n\t"
+		"add ip, pc\n\t"
+		"str ip, %[rseq_cs]\n\t"
+		"1:\n\t"
+		"ldr ip, %[cpu_id]\n\t"
+		"cmp ip, %[cpu]\n\t"
+		"bne 4f\n\t"
+		"ldr ip, %[v1]\n\t"
+		"cmp ip, %[e1]\n\t"
+		"bne %l[cmpfail]\n\t"
+		"ldr ip, %[v2]\n\t"
+		"cmp ip, %[e2]\n\t"
+		"bne %l[cmpfail]\n\t"
+		"str %[newv], %[v2]\n\t"
+		"2:\n\t"
+		".pushsection __rseq_failure, \"ax\"\n\t"
+		".word " __rseq_str(WRAP_RSEQ_SIG) "\n\t"
+		"4:\n\t"
+		"b %l[abort]\n\t"
+		".popsection\n\t"
+		: /* no outputs */
+		: [cpu_id] "m" (rs->cpu_id),
+		  [rseq_cs] "m" (rs->rseq_cs),
+		  [cpu] "r" (cpu),
+		  [v1] "m" (*v1), [e1] "r" (e1),
+		  [v2] "m" (*v2), [e2] "r" (e2),
+		  [newv] "r" (newv)
+		: "memory", "cc", "ip"
+		: abort, cmpfail);
+#endif
+	return 0;
+abort:
+	return -1;
+cmpfail:
+	return 1;
+}
+#endif /* HAVE_WRAP_RSEQ */
+
+#endif /* WRAP_RSEQ_H */
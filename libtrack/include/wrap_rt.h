@@ -0,0 +1,59 @@
+/*
+ * wrap_rt.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * One tracer runtime for all the wrapped libraries of a process
+ * (wraplib.sh --shared-runtime).
+ *
+ * By default, each wrapped library links in a copy of the whole engine:
+ * its own TLS key, caches, log buffers and log files. With a shared
+ * runtime, the engine (src/ and the platform's libc handlers) is built
+ * once, as libtrack_rt.so, with -DWRAP_RT_CORE. Each wrapped library
+ * keeps only its glue (src/wrap_lib.c with -DWRAP_RT_GLUE): its entry
+ * points and symbol table, and the TLS slot its entry points use to
+ * return through wrapped_return(). The glue registers its library when
+ * it's loaded and hands every traced call to the runtime. A thread then
+ * has one context, one set of caches and one ordered event stream,
+ * whichever libraries it calls into. What a call has to come back with
+ * (its return value, start time and stamp) is kept per library, in the
+ * slot the runtime gave it: a call from one wrapped library into another
+ * can't clobber the caller's.
+ */
+#ifndef WRAP_RT_H
+#define WRAP_RT_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+/* wrapped libraries a runtime can trace */
+#define WRAP_RT_MAX_LIBS 8
+
+/* a wrapped library, as its glue describes it to the runtime */
+struct wrap_rt_lib {
+	const char *name;
+	/* its return state slot in every thread: -1 until registered */
+	int id;
+	/* the recursion guard (and saved LR) of this library's entry points */
+	pthread_key_t *wrapping_key;
+	/* is 'addr' in the text of the real library? */
+	int (*in_text)(unsigned long addr);
+};
+
+#if defined(WRAP_RT_CORE) || defined(WRAP_RT_GLUE)
+extern int      wrap_rt_register(struct wrap_rt_lib *lib);
+extern int      wrap_rt_trace(struct wrap_rt_lib *lib, const char *symbol,
+			      void *symptr, void *regs, void *stack);
+extern uint32_t wrap_rt_return(struct wrap_rt_lib *lib, uint32_t fret);
+#endif
+
+#ifdef WRAP_RT_GLUE
+/* from the wrapped library's constructor */
+extern void wrap_rt_glue_init(void);
+#endif
+
+__END_DECLS
+
+#endif /* WRAP_RT_H */
@@ -0,0 +1,42 @@
+/*
+ * wrap_seq.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Optional global event sequence numbers (build with -DHAVE_EVENT_SEQ).
+ *
+ * gettimeofday() timestamps can't order two events of the same
+ * microsecond, in different threads or processes. With sequence numbers,
+ * every traced call, and every LOG record, takes the next value of a
+ * counter mapped from SEQ_MAP_PATH: one counter for every traced process
+ * on the system. If the file can't be mapped, the process falls back on
+ * a counter of its own, which still orders its own threads. The number
+ * follows the timestamp, in the same field:
+ *	<sec>.<usec>/<seq>:CALL:...
+ * and the lines that make up an event (its backtrace, a signal handler
+ * it installs) share its number: they're printed with the event's stamp
+ * (__log_print_event()), not a new one.
+ * parser/scripts/merge_logs.py merges log files into one stream in that
+ * order.
+ */
+#ifndef WRAP_SEQ_H
+#define WRAP_SEQ_H
+
+#ifdef HAVE_EVENT_SEQ
+
+#include <stdint.h>
+
+#define SEQ_MAP_PATH  LOGFILE_PATH "/.seq"
+#define SEQ_MAP_SZ    4096
+
+extern uint64_t seq_next(void);
+
+/* to follow "%lu.%lu" (and its arguments) in a timestamp */
+#define SEQ_FMT "/%llu"
+#define SEQ_ARG , (unsigned long long)seq_next()
+
+#else
+#define SEQ_FMT ""
+#define SEQ_ARG
+#endif /* HAVE_EVENT_SEQ */
+
+#endif /* WRAP_SEQ_H */
@@ -0,0 +1,40 @@
+/*
+ * wrap_syms.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Address to symbol lookups, without dladdr().
+ *
+ * dladdr() takes the loader lock and only knows about dynamic symbols.
+ * Instead, the first lookup in a module (a mapping of the module map,
+ * see wrap_maps.h) reads the function symbols of its file, .symtab if
+ * it has one, .dynsym otherwise, into an array sorted by address: every
+ * lookup after that is a binary search, shared by all threads. Code
+ * that shows up later (a dlopen) or goes away (a dlclose, which may put
+ * another module at the same addresses) gets a new module map, and with
+ * it new lookups: a module's symbols are only reused for a mapping of
+ * the same file at the same place. Symbol tables are kept for the life
+ * of the process.
+ *
+ * If a module's file can't be read, lookups fall back to dladdr().
+ */
+#ifndef WRAP_SYMS_H
+#define WRAP_SYMS_H
+
+#include <dlfcn.h>
+#include <stdint.h>
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+#define SYMS_MAX_FILE_MB  256     /* don't map larger files than this */
+
+/*
+ * Fill 'dli' as dladdr() would, but with dli_sname and dli_saddr NULL
+ * when 'addr' isn't within any function (not the closest symbol below).
+ * Returns 0 if nothing is known about 'addr'.
+ */
+extern int syms_dladdr(const void *addr, Dl_info *dli);
+
+__END_DECLS
+
+#endif /* WRAP_SYMS_H */
@@ -0,0 +1,81 @@
+/*
+ * wrap_throttle.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Hold the tracer to a CPU overhead budget (needs -DHAVE_OVERHEAD).
+ *
+ * THROTTLE_CFG_PATH holds the budget, in percent of the CPU time of the
+ * traced threads themselves, e.g. "3" or "0.5"; without it nothing is
+ * throttled. Every THROTTLE_CALLS traced calls, a thread compares the
+ * time it spent in the tracer (see wrap_overhead.h) with the CPU time it
+ * used for anything else. Over budget, the tracer first logs shorter
+ * backtraces (down to THROTTLE_MIN_FRAMES), then logs only one call in
+ * 2, 4, ... 2^THROTTLE_MAX_SHIFT of its most expensive symbol, and in
+ * the end only counts the calls of that symbol. Well under budget
+ * (below half of it), it goes back the same way, one step at a time.
+ * Steps are THROTTLE_HOLD_MS apart at least, for the whole process.
+ *
+ * Every step is logged, with the overhead (per mille) that led to it:
+ *	LOG:OVERHEAD:FRAMES:<overhead>:<max frames>:
+ *	LOG:OVERHEAD:RATE:<overhead>:<sym>:<1 in N logged>:<calls>:<logged>:
+ * where N is 0 for a symbol that is only counted, and <calls> and
+ * <logged> add up (from process start) the calls of the symbol and the
+ * ones that made it to the log. The RATE records of every symbol that
+ * isn't fully traced are repeated with each LOG:OVERHEAD record of a
+ * thread, so each logged call of <sym> stands for <calls>/<logged> calls
+ * in the last of them.
+ *
+ * Special symbols (fork, exit, signal...) are never throttled.
+ */
+#ifndef WRAP_THROTTLE_H
+#define WRAP_THROTTLE_H
+
+#ifdef HAVE_OVERHEAD
+
+#include <stdint.h>
+
+#define THROTTLE_CFG_PATH    LOGFILE_PATH "/throttle.conf"
+
+#define THROTTLE_SYMS        512
+#define THROTTLE_CALLS       256
+#define THROTTLE_MIN_CPU_NS  (20 * 1000 * 1000)
+#define THROTTLE_HOLD_MS     250
+#define THROTTLE_MIN_FRAMES  8
+#define THROTTLE_MAX_SHIFT   10
+#define THROTTLE_COUNT_ONLY  (THROTTLE_MAX_SHIFT + 1)
+
+struct throttle_sym;
+struct tls_info;
+
+/* per-thread state */
+struct throttle_thread {
+	struct throttle_sym *sym;   /* the call in progress */
+	uint32_t calls;
+	uint64_t cpu_ns;            /* at the last check */
+	uint64_t tracer_ns;
+};
+
+extern volatile int throttle_frames;
+
+/*
+ * Non-zero if this call should only be counted. 'special' tells (once per
+ * symbol) whether a symbol must never be throttled.
+ */
+extern int  throttle_skip(struct tls_info *tls,
+			  int (*special)(struct tls_info *tls));
+/* the call is done: what did it cost? */
+extern void throttle_account(struct tls_info *tls);
+extern void throttle_report(struct tls_info *tls);
+extern void throttle_init_child(void);
+
+#define throttle_max_frames() (throttle_frames)
+
+#else
+#define throttle_skip(tls, special) 0
+#define throttle_account(tls)
+#define throttle_report(tls)
+#define throttle_init_child()
+#define throttle_max_frames() MAX_BT_FRAMES
+#endif /* HAVE_OVERHEAD */
+
+#endif /* WRAP_THROTTLE_H */
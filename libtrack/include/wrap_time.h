@@ -0,0 +1,79 @@
+/*
+ * wrap_time.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Cheap timestamps for timing wrapped calls.
+ *
+ * The timing field of ENABLE_LOG_PATH selects the clock:
+ *	0 no timing
+ *	1 wall time (TSC / generic timer, or a vDSO-backed monotonic clock)
+ *	2 thread CPU time (per-thread perf_event counter read with rdpmc,
+ *	  or CLOCK_THREAD_CPUTIME_ID when that isn't available)
+ */
+#ifndef WRAP_TIME_H
+#define WRAP_TIME_H
+
+#include <stdint.h>
+#include <time.h>
+
+#include "wrap_lib.h"
+#include "wtime_clock.h"
+
+#define WTIME_NONE    0
+#define WTIME_WALL    1
+#define WTIME_THREAD  2
+
+/* per-thread state of the thread CPU time clock */
+struct wtime_thread {
+	int   state; /* 0 = untried, 1 = perf counter, -1 = fallback */
+	int   fd;
+	void *pc;    /* struct perf_event_mmap_page */
+	/*
+	 * counter values are anchored to CLOCK_THREAD_CPUTIME_ID so that
+	 * falling back mid-call doesn't produce a bogus delta
+	 */
+	uint64_t base_ns;
+	uint64_t base_cyc;
+};
+
+/* process-wide counter -> nanosecond conversion */
+struct wtime_clock {
+	uint32_t mult;  /* 0 if the counter isn't usable */
+	uint32_t shift;
+};
+
+extern struct wtime_clock wclock;
+
+extern void init_wtime(void);
+
+extern uint64_t wtime_thread_ns(struct wtime_thread *wt);
+extern void wtime_release_thread(struct wtime_thread *wt);
+
+static inline uint64_t wtime_cyc2ns(uint64_t cyc)
+{
+	return __wtime_cyc2ns(cyc, wclock.mult, wclock.shift);
+}
+
+static inline uint64_t wtime_wall_ns(void)
+{
+	struct timespec ts;
+#ifdef HAVE_WTIME_COUNTER
+	if (wclock.mult)
+		return wtime_cyc2ns(wtime_cycles());
+#endif
+	libc.clock_gettime(CLOCK_MONOTONIC, &ts);
+	return wtime_ts2ns(&ts);
+}
+
+/*
+ * Return a timestamp (in ns) from the given clock.
+ * Only differences between two values from the same clock are meaningful.
+ */
+static inline uint64_t wtime_now(int clk, struct wtime_thread *wt)
+{
+	if (clk == WTIME_THREAD)
+		return wtime_thread_ns(wt);
+	return wtime_wall_ns();
+}
+
+#endif /* WRAP_TIME_H */
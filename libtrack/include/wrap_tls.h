@@ -7,23 +7,60 @@
 #define WRAP_TLS_H
 
 #include "wrap_lib.h"
+#include "wrap_time.h"
+#include "wrap_maps.h"
+#include "wrap_overhead.h"
+#include "wrap_throttle.h"
 #include <pthread.h>
 
 #define TLS_MAX_STRING_LEN 256
 
+/*
+ * Fields used on every traced call come first, so that they share the
+ * same few cache lines; names and per-feature state follow.
+ */
 struct tls_info {
-	char logname[TLS_MAX_STRING_LEN];
+	struct log_info info;
 	void *logfile;
-
 	void *logbuffer;
-
 	void *btcache;
 
+	struct wtime_thread wt;
+
+#ifdef WRAP_RT_CORE
+	struct ret_ctx ret[WRAP_RT_MAX_LIBS]; /* by wrap_rt_lib id */
+#else
+	struct ret_ctx ret[1];
+#endif
+	struct wrap_rt_lib *lib;    /* where the current call went */
+	int in_trace;               /* tracer / return path frames */
+
+#ifdef HAVE_OVERHEAD
+	struct ovh_thread ovh;      /* also touched on every call */
+	struct throttle_thread thr;
+#endif
+
+	char logname[TLS_MAX_STRING_LEN];
+#ifdef NO_TLS_POOL
+	int logfd;                  /* under logfile, -1 if not ours */
+#endif
+
 	char dvm_threadname[TLS_MAX_STRING_LEN];
 	void *dvmstack;
 
-	struct ret_ctx ret;
-	struct log_info info;
+	struct maps_thread maps;
+
+#ifdef HAVE_PERCPU_LOG
+	struct percpu_thread pcpu;
+#endif
+
+#ifdef HAVE_FLIGHT_RECORDER
+	struct flight_ring *flight;
+#endif
+
+#ifdef HAVE_CCT
+	struct cct *cct;
+#endif
 
 #ifdef ANDROID
 	__pthread_cleanup_t pth_cleanup;
@@ -34,7 +71,67 @@ struct tls_info {
 #define wsym(TLS) \
 	((TLS)->info.symbol)
 
+/* the return state of the last call into 'lib' */
+#ifdef WRAP_RT_CORE
+#define tls_ret(TLS, LIB) \
+	(&(TLS)->ret[(LIB)->id])
+#else
+#define tls_ret(TLS, LIB) \
+	(&(TLS)->ret[0])
+#endif
+
+/*
+ * What the thread knows about the call being traced. A traced call made
+ * while another is in the tracer or its return path (by whatever a
+ * special handler runs with the wrapping key cleared, or by a signal
+ * handler, into any library) replaces all of it: the nested call saves
+ * it and puts it back, for get_retmem() and the handler. The log buffer
+ * is the thread's, not the call's.
+ */
+struct tls_call {
+	struct wrap_rt_lib *lib;
+	struct log_info info;
+};
+
+static inline void tls_save_call(struct tls_info *tls, struct tls_call *c)
+{
+	c->lib = tls->lib;
+	c->info.symbol = tls->info.symbol;
+	c->info.func = tls->info.func;
+	c->info.regs = tls->info.regs;
+	c->info.stack = tls->info.stack;
+	c->info.log_time = tls->info.log_time;
+	c->info.should_log = tls->info.should_log;
+	c->info.should_handle = tls->info.should_handle;
+	c->info.should_mod_sym = tls->info.should_mod_sym;
+	c->info.symhash = tls->info.symhash;
+	c->info.symcache = tls->info.symcache;
+	c->info.tv = tls->info.tv;
+	c->info.tv_strlen = tls->info.tv_strlen;
+	libc.memcpy(c->info.tv_str, tls->info.tv_str, sizeof(c->info.tv_str));
+}
+
+static inline void tls_restore_call(struct tls_info *tls,
+				    const struct tls_call *c)
+{
+	tls->lib = c->lib;
+	tls->info.symbol = c->info.symbol;
+	tls->info.func = c->info.func;
+	tls->info.regs = c->info.regs;
+	tls->info.stack = c->info.stack;
+	tls->info.log_time = c->info.log_time;
+	tls->info.should_log = c->info.should_log;
+	tls->info.should_handle = c->info.should_handle;
+	tls->info.should_mod_sym = c->info.should_mod_sym;
+	tls->info.symhash = c->info.symhash;
+	tls->info.symcache = c->info.symcache;
+	tls->info.tv = c->info.tv;
+	tls->info.tv_strlen = c->info.tv_strlen;
+	libc.memcpy(tls->info.tv_str, c->info.tv_str, sizeof(tls->info.tv_str));
+}
+
 extern void init_tls(void);
+extern int  tls_atfork_ready(void);
 
 extern struct tls_info *get_tls(void);
 extern struct tls_info *peek_tls(void);
@@ -42,7 +139,9 @@ extern struct tls_info *peek_tls(void);
 extern void clear_tls(int release_key);
 
 extern void tls_release_logfile(struct tls_info *tls);
+extern void tls_drop_logfile(struct tls_info *tls);
 extern void tls_release_logbuffer(struct tls_info *tls);
+extern void tls_reset_logbuffer(struct tls_info *tls);
 extern void tls_release_btcache(struct tls_info *tls);
 extern void tls_release_dvmstack(struct tls_info *tls);
 
@@ -0,0 +1,149 @@
+/*
+ * wtime_clock.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Clock arithmetic shared by the timing backend (wrap_time.h) and the x86
+ * interposer (arch/x86/src/logtime.c): reading the cycle counter,
+ * converting cycles to ns with a mult/shift pair, and on x86, checking
+ * for an invariant TSC and reading perf_event counters from user space.
+ * Nothing in here calls into the C library.
+ */
+#ifndef WTIME_CLOCK_H
+#define WTIME_CLOCK_H
+
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__i386__) || defined(__x86_64__) || defined(__aarch64__)
+#define HAVE_WTIME_COUNTER
+#endif
+
+#if defined(__i386__) || defined(__x86_64__)
+#define HAVE_WTIME_PERF
+#include <linux/perf_event.h>
+#endif
+
+#define WTIME_CALIBRATE_NS 1000000 /* 1ms */
+#define WTIME_SHIFT        24
+
+static inline uint64_t wtime_cycles(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	uint32_t lo, hi;
+	__asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+	return ((uint64_t)hi << 32) | lo;
+#elif defined(__aarch64__)
+	uint64_t cyc;
+	__asm__ __volatile__("isb; mrs %0, cntvct_el0" : "=r"(cyc) :: "memory");
+	return cyc;
+#else
+	return 0;
+#endif
+}
+
+static inline uint64_t __wtime_cyc2ns(uint64_t cyc, uint32_t mult,
+				      uint32_t shift)
+{
+	uint64_t quot, rem;
+
+	quot = cyc >> shift;
+	rem = cyc & (((uint64_t)1 << shift) - 1);
+	return quot * mult + ((rem * mult) >> shift);
+}
+
+static inline uint64_t wtime_ts2ns(const struct timespec *ts)
+{
+	return (uint64_t)ts->tv_sec * 1000000000ULL + (uint64_t)ts->tv_nsec;
+}
+
+/*
+ * The multiplier (for WTIME_SHIFT) that turns counter cycles into ns,
+ * measured against 'mono_ns' over WTIME_CALIBRATE_NS: 0 if the counter
+ * doesn't count.
+ */
+static inline uint32_t wtime_calibrate(uint64_t (*mono_ns)(void))
+{
+	uint64_t c0, c1, t0, t1;
+
+	t0 = mono_ns();
+	c0 = wtime_cycles();
+	do {
+		t1 = mono_ns();
+	} while (t1 - t0 < WTIME_CALIBRATE_NS);
+	c1 = wtime_cycles();
+
+	if (c1 <= c0)
+		return 0;
+	return (uint32_t)(((t1 - t0) << WTIME_SHIFT) / (c1 - c0));
+}
+
+#ifdef HAVE_WTIME_PERF
+/* a TSC that stops or changes rate isn't a clock */
+static inline int wtime_tsc_invariant(void)
+{
+	uint32_t a, b, c, d;
+
+	__asm__ __volatile__("cpuid"
+			     : "=a"(a), "=b"(b), "=c"(c), "=d"(d)
+			     : "a"(0x80000000));
+	if (a < 0x80000007)
+		return 0;
+	__asm__ __volatile__("cpuid"
+			     : "=a"(a), "=b"(b), "=c"(c), "=d"(d)
+			     : "a"(0x80000007));
+	return !!(d & (1 << 8));
+}
+
+/*
+ * The kernel exports its own TSC -> ns conversion in the perf mmap page:
+ * 0 if this one has it.
+ */
+static inline int wtime_perf_params(const struct perf_event_mmap_page *pc,
+				    uint32_t *mult, uint32_t *shift)
+{
+	if (!pc->cap_user_time || !pc->time_mult)
+		return -1;
+	*mult = pc->time_mult;
+	*shift = pc->time_shift;
+	return 0;
+}
+
+static inline uint64_t wtime_rdpmc(uint32_t idx)
+{
+	uint32_t lo, hi;
+	__asm__ __volatile__("rdpmc" : "=a"(lo), "=d"(hi) : "c"(idx));
+	return ((uint64_t)hi << 32) | lo;
+}
+
+/*
+ * self-monitoring read of the counter (see linux/perf_event.h)
+ */
+static inline int wtime_perf_read(struct perf_event_mmap_page *pc,
+				  uint64_t *cyc)
+{
+	uint32_t seq, idx;
+	uint64_t count;
+	int64_t pmc;
+	uint16_t width;
+
+	do {
+		seq = pc->lock;
+		__asm__ __volatile__("" ::: "memory");
+		idx = pc->index;
+		if (!idx) /* not scheduled on a hardware counter */
+			return -1;
+		count = pc->offset;
+		width = pc->pmc_width;
+		pmc = (int64_t)wtime_rdpmc(idx - 1);
+		pmc <<= 64 - width;
+		pmc >>= 64 - width;
+		count += pmc;
+		__asm__ __volatile__("" ::: "memory");
+	} while (pc->lock != seq);
+
+	*cyc = count;
+	return 0;
+}
+#endif /* HAVE_WTIME_PERF */
+
+#endif /* WTIME_CLOCK_H */
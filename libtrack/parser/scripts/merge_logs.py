@@ -0,0 +1,65 @@
+#!/usr/bin/env python
+"""
+Merge the per-thread logs of a trace directory (or just some logs) into
+one ordered stream, by event sequence number when libtrack was built
+with --event-seq, by timestamp otherwise. libtrack/tools/trace_merge
+does the same natively, for directories too big for this.
+"""
+import gzip
+import os
+import sys
+from telesphorus.helpers import merge
+
+
+def main(argv=sys.argv):
+    """
+    Merge trace logs into a single stream, on stdout or in a file.
+    """
+    out = None
+    by = None
+    inputs = []
+    args = argv[1:]
+    while args:
+        arg = args.pop(0)
+        if arg == "-o" and args:
+            out = args.pop(0)
+        elif arg == "--by-seq":
+            by = merge.BY_SEQ
+        elif arg == "--by-time":
+            by = merge.BY_TIME
+        elif arg.startswith("-"):
+            usage(argv)
+        else:
+            inputs.append(arg)
+    if not inputs:
+        usage(argv)
+
+    filenames = []
+    for path in inputs:
+        if os.path.isdir(path):
+            for top, _, files in os.walk(path):
+                filenames.extend(os.path.join(top, f) for f in sorted(files)
+                                 if merge.is_log(f))
+        else:
+            filenames.append(path)
+
+    if out is None:
+        f = sys.stdout
+    elif out.endswith('.gz'):
+        f = gzip.open(out, 'wb')
+    else:
+        f = open(out, 'w')
+    for line in merge.merge(filenames, by):
+        f.write(line)
+    if f is not sys.stdout:
+        f.close()
+
+
+def usage(argv):
+    sys.stderr.write("Usage:%s [-o OUT[.gz]] [--by-seq|--by-time] "
+                     "TRACE-DIR|LOG...\n" % argv[0])
+    sys.exit(-1)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,180 @@
+"""
+Reader for per-process trace containers (<pid>.<prog>.trace)
+
+See libtrack/include/wrap_container.h for the format.
+"""
+from __future__ import division
+import os
+import struct
+import zlib
+
+CHUNK = struct.Struct('<4sHBBII16sQQIIQ')
+INDEX_ENT = struct.Struct('<QIIQQ')
+TRAILER = struct.Struct('<8sQ')
+
+MAGIC = b'WTC1'
+END_MAGIC = b'WTCINDEX'
+
+DATA = 1
+INDEX = 2
+PAD = 3
+
+RAW = 0
+ZLIB = 1
+
+NO_PREV = (1 << 64) - 1
+
+
+class Chunk(object):
+    """A chunk header, and where it is in the file"""
+
+    def __init__(self, offset, raw):
+        (self.magic, self.hdr_len, self.type, self.codec, self.pid,
+         self.tid, lib, self.first_ts, self.last_ts, self.len,
+         self.raw_len, self.prev) = CHUNK.unpack(raw)
+        self.lib = lib.split(b'\0', 1)[0].decode('ascii', 'replace')
+        self.offset = offset
+
+    @property
+    def end(self):
+        """offset just past the payload"""
+        return self.offset + self.hdr_len + self.len
+
+
+def read_header(f, offset):
+    """Returns the Chunk at 'offset', or None if there isn't a valid one"""
+    f.seek(offset)
+    raw = f.read(CHUNK.size)
+    if len(raw) < CHUNK.size or raw[:4] != MAGIC:
+        return None
+    return Chunk(offset, raw)
+
+
+def resync(f, offset, size):
+    """Returns the offset of the next chunk magic after 'offset', or 'size'
+
+    Needed when a library died without closing its mapped segment: the
+    unused part of the segment is all zeros.
+    """
+    block = 1 << 16
+    pos = offset + 1
+    while pos < size:
+        f.seek(pos)
+        data = f.read(block + len(MAGIC) - 1)
+        found = data.find(MAGIC)
+        if found >= 0:
+            return pos + found
+        pos += block
+    return size
+
+
+def walk_headers(f, size):
+    """Finds every chunk by hopping from header to header"""
+    chunks = []
+    offset = 0
+    while offset + CHUNK.size <= size:
+        chunk = read_header(f, offset)
+        if chunk is None:
+            # a trailer sits between an index and whatever follows it
+            f.seek(offset)
+            if f.read(len(END_MAGIC)) == END_MAGIC:
+                offset += TRAILER.size
+                continue
+            offset = resync(f, offset, size)
+            continue
+        chunks.append(chunk)
+        offset = chunk.end
+    return chunks
+
+
+def read_index(f, size):
+    """Finds every chunk through the trailer / index chain
+
+    Returns None unless the indices account for the whole file (some
+    library didn't get to write its index, or is still writing).
+    """
+    if size < TRAILER.size:
+        return None
+    f.seek(size - TRAILER.size)
+    magic, index = TRAILER.unpack(f.read(TRAILER.size))
+    if magic != END_MAGIC:
+        return None
+
+    chunks = []
+    covered = 0
+    seen = set()
+    while index != NO_PREV and index not in seen:
+        seen.add(index)
+        idx = read_header(f, index)
+        if idx is None or idx.type != INDEX:
+            return None
+        f.seek(index + idx.hdr_len)
+        data = f.read(idx.len)
+        for pos in range(0, len(data) - INDEX_ENT.size + 1, INDEX_ENT.size):
+            offset, _, length, _, _ = INDEX_ENT.unpack_from(data, pos)
+            chunk = read_header(f, offset)
+            if chunk is None or chunk.hdr_len + chunk.len != length:
+                return None
+            chunks.append(chunk)
+            covered += length
+        covered += idx.hdr_len + idx.len + TRAILER.size
+        index = idx.prev
+
+    if covered != size:
+        return None
+    chunks.sort(key=lambda c: c.offset)
+    return chunks
+
+
+def data_chunks(filename):
+    """Returns the headers of all data chunks in a container, in file order"""
+    size = os.path.getsize(filename)
+    with open(filename, 'rb') as f:
+        chunks = read_index(f, size)
+        if chunks is None:
+            chunks = walk_headers(f, size)
+    return [c for c in chunks if c.type == DATA]
+
+
+def read_payload(filename, chunk):
+    """Decodes one chunk: independent of every other chunk, so this can be
+    farmed out to a multiprocessing.Pool"""
+    with open(filename, 'rb') as f:
+        f.seek(chunk.offset + chunk.hdr_len)
+        data = f.read(chunk.len)
+    if chunk.codec == ZLIB:
+        data = zlib.decompress(data)
+    return data
+
+
+def _decode(args):
+    return read_payload(*args)
+
+
+def read_lines(filename, pool=None):
+    """Returns the lines of a container as one log shard would have them
+
+    Each run of a thread's chunks is preceded by a "0.0:LOG:TID:<tid>:"
+    marker, so the result can go straight to parsing.demux_shard().
+    """
+    chunks = data_chunks(filename)
+    jobs = [(filename, c) for c in chunks]
+    if pool is not None:
+        payloads = pool.map(_decode, jobs)
+    else:
+        payloads = [_decode(job) for job in jobs]
+
+    # a long write can continue in the thread's next chunk
+    lines = []
+    tid, text = None, []
+    for chunk, data in zip(chunks, payloads):
+        if chunk.tid != tid and text:
+            lines.append('0.0:LOG:TID:%d:\n' % tid)
+            lines.extend(''.join(text).splitlines(True))
+            text = []
+        tid = chunk.tid
+        text.append(data.decode('latin-1'))
+    if text:
+        lines.append('0.0:LOG:TID:%d:\n' % tid)
+        lines.extend(''.join(text).splitlines(True))
+    return lines
@@ -0,0 +1,222 @@
+"""
+Streaming k-way merge of trace logs into one ordered stream
+
+Every event in a log starts with a "<sec>.<usec>:" timestamp, or with
+"<sec>.<usec>/<seq>:" when libtrack numbers events (wraplib.sh
+--event-seq, see libtrack/include/wrap_seq.h). The lines that follow it
+with the same stamp (its backtrace), or with a "0.0:" one, belong to the
+same event. Events are merged by sequence number when every log has
+them, by timestamp otherwise, keeping only one event per log in memory.
+Each log has to be in order itself, as per-thread logs and log shards
+are; every thread in a trace container is a stream of its own.
+
+The merged stream reads like a log shard: a "0.0:LOG:TID:<tid>:" marker
+precedes output from a different thread.
+"""
+from __future__ import division
+import gzip
+import heapq
+import itertools
+import os
+import re
+
+from telesphorus.helpers import container
+
+BY_SEQ = 'seq'
+BY_TIME = 'time'
+
+_LOG_NAME = re.compile(r'^\d+\.(\d+|[^.]+)\..*\.log(\.gz)?$')
+
+
+def is_log(filename):
+    """Is this a trace log (or a trace container) libtrack wrote?"""
+    name = os.path.basename(filename)
+    return name.endswith('.trace') or _LOG_NAME.match(name) is not None
+
+
+def parse_stamp(line):
+    """Returns the (sec, usec, seq) stamp of a line, with a seq of None
+    if it isn't numbered, or None if the line has no stamp"""
+    field = line.split(':', 1)[0]
+    seq = None
+    if '/' in field:
+        field, seq = field.split('/', 1)
+    parts = field.split('.')
+    if len(parts) != 2:
+        return None
+    try:
+        sec, usec = int(parts[0]), int(parts[1])
+        if seq is not None:
+            seq = int(seq)
+    except ValueError:
+        return None
+    return (sec, usec, seq)
+
+
+def _file_tid(filename):
+    """<pid>.<tid>.<lib>.<prog>.log: per-thread logs are named after
+    their thread"""
+    parts = os.path.basename(filename).split('.')
+    try:
+        return int(parts[1])
+    except (ValueError, IndexError):
+        return None
+
+
+def open_lines(filename):
+    """Returns an iterator over the lines of a log or a compressed log"""
+    with open(filename, 'rb') as f:
+        magic = f.read(2)
+    if magic == b'\x1f\x8b':
+        return gzip.open(filename, 'rb')
+    return open(filename)
+
+
+def _chunk_lines(filename, chunks):
+    """Yields the lines of a thread's chunks, decoding one chunk at a time"""
+    rest = ''
+    for chunk in chunks:
+        # a long write can continue in the thread's next chunk
+        data = rest + container.read_payload(filename, chunk)
+        lines = data.splitlines(True)
+        rest = ''
+        if lines and not lines[-1].endswith('\n'):
+            rest = lines.pop()
+        for line in lines:
+            yield line
+    if rest:
+        yield rest
+
+
+def streams(filename):
+    """Returns the (tid, lines) streams of a log, or of every thread in a
+    trace container: its threads' chunks are interleaved in the order they
+    were written, not in time order, so each thread's are read on their
+    own, as the merge gets to them"""
+    if not filename.endswith('.trace'):
+        return [(_file_tid(filename), open_lines(filename))]
+    threads = {}
+    order = []
+    for chunk in container.data_chunks(filename):
+        if chunk.tid not in threads:
+            threads[chunk.tid] = []
+            order.append(chunk.tid)
+        threads[chunk.tid].append(chunk)
+    return [(tid, _chunk_lines(filename, threads[tid])) for tid in order]
+
+
+def events(lines, tid=None):
+    """Yields (stamp, tid, lines) for every event of a log, in log order
+
+    "LOG:TID:<tid>:" markers aren't part of any event: they tell which
+    thread the events after them come from. Backtrace lines are written
+    as "...\\n ", so the line after one starts with a space: that's dropped.
+    """
+    stamp, ev = None, []
+    for line in lines:
+        line = line.lstrip(' ')
+        if not line.strip():
+            continue
+        if not line.endswith('\n'):
+            line += '\n'
+        labels = line.split(':', 4)
+        if labels[1:3] == ['LOG', 'TID']:
+            if ev:
+                yield stamp, tid, ev
+                stamp, ev = None, []
+            try:
+                tid = int(labels[3])
+            except (ValueError, IndexError):
+                tid = None
+            continue
+        cur = parse_stamp(line)
+        if cur is None or cur[:2] == (0, 0) or cur == stamp:
+            if not ev:
+                stamp = stamp or (0, 0, None)
+            ev.append(line)
+            continue
+        if ev:
+            yield stamp, tid, ev
+        stamp, ev = cur, [line]
+    if ev:
+        yield stamp, tid, ev
+
+
+def _key(stamp, by, last):
+    """the merge key of an event: unstamped ones stay after the one
+    before them"""
+    if by == BY_SEQ:
+        if stamp[2] is None:
+            return last
+        return (stamp[2],)
+    if stamp[:2] == (0, 0):
+        return last
+    return stamp[:2]
+
+
+def _peek(filenames):
+    """Returns [first stamp, events] for every stream of the logs: its
+    events up to the first stamped one (None if it has none) are read
+    once, and put back in front of the rest"""
+    peeked = []
+    for filename in filenames:
+        for tid, lines in streams(filename):
+            it = events(lines, tid)
+            head, first = [], None
+            for ev in it:
+                head.append(ev)
+                if ev[0][:2] != (0, 0):
+                    first = ev[0]
+                    break
+            peeked.append((first, itertools.chain(head, it)))
+    return peeked
+
+
+def _order(peeked):
+    numbered = False
+    for first, _ in peeked:
+        if first is None:
+            continue
+        if first[2] is None:
+            return BY_TIME
+        numbered = True
+    return BY_SEQ if numbered else BY_TIME
+
+
+def merge_order(filenames):
+    """BY_SEQ if the first stamped event of every stream is numbered (and
+    there is one), BY_TIME otherwise: tools/trace_merge decides the same
+    way"""
+    return _order(_peek(filenames))
+
+
+def merge(filenames, by=None):
+    """Yields the lines of many logs as one ordered stream
+
+    Args:
+        filenames: logs and trace containers
+        by: BY_SEQ, BY_TIME, or None to choose with merge_order()
+    """
+    peeked = _peek(filenames)
+    if by is None:
+        by = _order(peeked)
+    heap = []
+
+    def push(idx, it, last):
+        for stamp, tid, ev in it:
+            key = _key(stamp, by, last)
+            heapq.heappush(heap, (key, idx, tid, ev, it))
+            return
+
+    for idx, (_, it) in enumerate(peeked):
+        push(idx, it, (0,))
+
+    tid = None
+    while heap:
+        key, idx, ev_tid, ev, it = heapq.heappop(heap)
+        if ev_tid is not None and ev_tid != tid:
+            tid = ev_tid
+            yield '0.0:LOG:TID:%d:\n' % tid
+        for line in ev:
+            yield line
+        push(idx, it, key)
@@ -5,6 +5,8 @@ goees here
 from __future__ import division
 import sys
 import re
+from telesphorus.helpers import container
+from telesphorus.helpers import unwind
 
 def yield_paths(filename, timing_info=None, filter_calls=[]):
     """Retrieves full paths from a trace file
@@ -25,13 +27,106 @@ def yield_paths(filename, timing_info=None, filter_calls=[]):
     Raises:
         Exception: if log file is corrupted
     """
+    # raw stack snapshots are unwound with the module map of the process
+    unwinder = unwind.Unwinder()
+    if filename.endswith('.trace'):
+        # per-process chunked container: one file for every thread/library
+        try:
+            lines = container.read_lines(filename)
+        except (IOError, ValueError, container.zlib.error), error:
+            print >> sys.stderr, "Error reading trace container: %s" % error
+            return
+        for stream in demux_shard(lines):
+            for path in _yield_paths(iter(stream), filename, timing_info,
+                                     filter_calls, unwinder):
+                yield path
+        return
+
     try:
         f = open(filename)
     except IOError, error:
         print >> sys.stderr, "I/O error while opening file: %s" % error
         return
 
+    if ('.shard' in filename or '.percpu.' in filename
+            or '.flight' in filename):
+        # log shards, per-CPU logs and flight recorder dumps interleave
+        # output from many threads
+        streams = demux_shard(f)
+        f.close()
+        for lines in streams:
+            for path in _yield_paths(iter(lines), filename, timing_info,
+                                     filter_calls, unwinder):
+                yield path
+        return
+
+    for path in _yield_paths(f, filename, timing_info, filter_calls,
+                             unwinder):
+        yield path
+    f.close()
+
+def demux_shard(f):
+    """Splits a log shard into per-thread streams of lines
+
+    Output from a thread is preceded by a "LOG:TID:<tid>:" marker
+    whenever a different thread wrote to the shard before it. Per-CPU
+    logs mark every record as "LOG:TID:<tid>:<seq>:", and a thread's
+    records can come out of different CPUs' buffers in any order: they
+    are put back in <seq> order.
+
+    Args:
+        f: iterable of lines
+
+    Returns:
+        list of per-thread lists of lines, in order of first appearance
+    """
+    streams = {}
+    order = []
+    current = None
+    seq = None
+    for line in f:
+        labels = line.split(':')
+        if labels[1:3] == ['LOG', 'TID']:
+            try:
+                current = int(labels[3])
+            except (ValueError, IndexError):
+                current = None
+            try:
+                seq = int(labels[4])
+            except (ValueError, IndexError):
+                seq = None
+            if current not in streams:
+                streams[current] = []
+                order.append(current)
+            streams[current].append((seq, []))
+            continue
+        if current not in streams:
+            streams[current] = [(None, [])]
+            order.append(current)
+        streams[current][-1][1].append(line)
+
+    result = []
+    for tid in order:
+        chunks = streams[tid]
+        if any(s is not None for s, _ in chunks):
+            # unnumbered output stays after the record before it
+            last = -1
+            keyed = []
+            for s, chunk in chunks:
+                if s is not None:
+                    last = s
+                keyed.append((last, chunk))
+            chunks = sorted(keyed, key=lambda c: c[0])
+        lines = []
+        for _, chunk in chunks:
+            lines.extend(chunk)
+        result.append(lines)
+    return result
+
+def _yield_paths(f, filename, timing_info, filter_calls, unwinder):
+    """Retrieves full paths from an iterator over the lines of a trace"""
     cache = Cache()
+    f = unwinder.expand(f)
     for line in f:
         try:
             labels = line.split(':')[:3]
@@ -85,6 +180,20 @@ def yield_paths(filename, timing_info=None, filter_calls=[]):
                 continue
                 #return
 
+        elif labels[1:] in [['CCT', 'START']]:
+            try:
+                nodes = int(line.split(':')[3])
+                for path in cct_paths(f, nodes):
+                    if path[-1] in filter_calls:
+                        continue
+                    yield path
+            except (ValueError, IndexError), error:
+                #print >> sys.stderr, "Error:", error, "in file:", filename
+                continue
+            except StopIteration, error:
+                #print >> sys.stderr, "Error:", error, "unexpected end in File:", filename
+                continue
+
         elif labels[1:] in [['DVM', 'BT_START']]:
             try:
                 frames = int(line.split(':')[3])
@@ -173,7 +282,121 @@ def yield_paths(filename, timing_info=None, filter_calls=[]):
                 yield cache.dalvik_path + cache.native_path
             else:
                 yield cache.native_path
-    f.close()
+
+class CctPath(list):
+    """A path out of a calling-context tree (CCT:START): it stands for
+    'calls' calls of the wrapped function at its end, which took 'ns'
+    altogether. node_times holds [inclusive, exclusive] ns for the frames
+    of the tree this path is the first one to go through.
+    """
+
+    def __init__(self, path, calls, ns):
+        list.__init__(self, path)
+        self.calls = calls
+        self.ns = ns
+        self.node_times = {}
+
+def cct_paths(f, nodes):
+    """Reads the 'nodes' lines of a calling-context tree and returns one
+    path per wrapped call site (leaf) -- names as in Cache.set_native
+    """
+    tree = {0: (None, [], 0, 0, 0)}
+    leaves = []
+    for _ in range(nodes):
+        fields = f.next().split(':')
+        node = int(fields[2])
+        parent = int(fields[3])
+        calls, incl, excl = int(fields[5]), int(fields[6]), int(fields[7])
+        name, lib = fields[8], fields[9].split('(')[0]
+        path = tree[parent][1]
+        if lib != '_ibc_so':
+            if name[:11] == "epoll_wait_":
+                name = "epoll_wait_"
+            path = path + [name + ':' + lib]
+        tree[node] = (parent, path, calls, incl, excl)
+        if fields[4] == 'L':
+            leaves.append(node)
+
+    paths = []
+    claimed = set([0])
+    for leaf in leaves:
+        _, path, calls, incl, _ = tree[leaf]
+        if not path or not calls:
+            continue
+        cct_path = CctPath(path, calls, incl)
+        node = tree[leaf][0]
+        while node not in claimed:
+            claimed.add(node)
+            parent, node_path, _, incl, excl = tree[node]
+            if node_path and node_path is not tree[parent][1]:
+                times = cct_path.node_times.setdefault(node_path[-1], [0, 0])
+                times[0] += incl
+                times[1] += excl
+            node = parent
+        paths.append(cct_path)
+    return paths
+
+OVERHEAD_FIELDS = ('calls', 'total', 'unwind', 'format', 'compress', 'io',
+                   'other')
+
+def _log_lines(filename):
+    """Returns the lines of a trace file, or of a trace container."""
+    if filename.endswith('.trace'):
+        try:
+            return container.read_lines(filename)
+        except (IOError, ValueError, container.zlib.error), error:
+            print >> sys.stderr, "Error reading trace container: %s" % error
+            return []
+    try:
+        with open(filename) as f:
+            return f.readlines()
+    except IOError, error:
+        print >> sys.stderr, "I/O error while opening file: %s" % error
+        return []
+
+def tracer_overhead(filename):
+    """Returns the tracer's own time from the LOG:OVERHEAD records of a
+    trace file (libtrack built with --overhead), as {tid: {field: value}}
+    with OVERHEAD_FIELDS as fields, in ns but for 'calls'. Records add up
+    from the start of a thread, so the last one of each thread is kept;
+    tid 0 holds the process totals as of the last LOG:STATS record.
+    """
+    overhead = {}
+    for line in _log_lines(filename):
+        fields = line.split(':')
+        if fields[1:3] != ['LOG', 'OVERHEAD']:
+            continue
+        try:
+            tid = int(fields[3])
+            values = [int(v) for v in fields[4:4 + len(OVERHEAD_FIELDS)]]
+        except (ValueError, IndexError):
+            continue
+        if len(values) == len(OVERHEAD_FIELDS):
+            overhead[tid] = dict(zip(OVERHEAD_FIELDS, values))
+    return overhead
+
+def throttle_weights(filename):
+    """Returns {symbol: weight} from the LOG:OVERHEAD:RATE records of a
+    trace file (see wrap_throttle.h): each logged call of a throttled
+    symbol stands for 'weight' calls. Symbols that were never throttled
+    aren't listed (their weight is 1); a weight of None means the symbol
+    was only counted.
+    """
+    weights = {}
+    for line in _log_lines(filename):
+        fields = line.split(':')
+        if fields[1:4] != ['LOG', 'OVERHEAD', 'RATE']:
+            continue
+        try:
+            sym = fields[5]
+            calls, logged = int(fields[7]), int(fields[8])
+        except (ValueError, IndexError):
+            continue
+        if logged:
+            weights[sym] = float(calls) / logged
+        else:
+            weights[sym] = None
+    return weights
 
 class Cache():
     """class documentation"""
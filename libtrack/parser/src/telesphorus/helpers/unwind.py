@@ -0,0 +1,669 @@
+"""
+Offline unwinder for raw stack snapshots (BT:RAW, see
+libtrack/include/backtrace.h) taken on ARM
+
+A BT:RAW record holds the caller's registers (r0-r11,lr), its sp, and a
+copy of the stack above sp. The module map logged before it (MAP:, see
+libtrack/include/wrap_maps.h) says which library each address belongs
+to. The libraries themselves are looked up under $TELESPHORUS_SYMFS
+(e.g. the "symbols" directory of an Android build), then at the path
+they had on the device.
+
+Frames are unwound with the DWARF CFI of each library (.debug_frame or
+.eh_frame). Where a library has none, the stack is scanned for the next
+word that returns right after a call instruction. Each record is turned
+back into the "BT:START" lines the rest of the parser understands.
+
+Caller-only records (BT:CALLER) are one frame deep: the module and file
+offset of the caller's return address. They come out as backtraces of
+that single frame.
+"""
+from __future__ import division
+import base64
+import bisect
+import os
+import struct
+
+SYMFS_ENV = 'TELESPHORUS_SYMFS'
+
+ARM_SP = 13
+ARM_LR = 14
+ARM_PC = 15
+
+MAX_FRAMES = 128
+
+# DW_EH_PE_pcrel pointer encoding
+PE_PCREL = 0x10
+
+_ELF_CACHE = {}
+
+
+def _uleb(data, pos):
+    result = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        result |= (byte & 0x7f) << shift
+        shift += 7
+        if byte < 0x80:
+            return result, pos
+
+
+def _sleb(data, pos):
+    result = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        result |= (byte & 0x7f) << shift
+        shift += 7
+        if byte < 0x80:
+            if byte & 0x40:
+                result -= 1 << shift
+            return result, pos
+
+
+class Cie(object):
+    """A Common Information Entry"""
+
+    def __init__(self):
+        self.code_align = 1
+        self.data_align = 1
+        self.ra_reg = ARM_LR
+        self.fde_enc = 0
+        self.insns = (0, 0)
+
+
+class Elf(object):
+    """The bits of a (little endian) ELF file an unwinder needs"""
+
+    def __init__(self, path):
+        with open(path, 'rb') as fh:
+            self.data = bytearray(fh.read())
+        data = self.data
+        if data[:4] != bytearray(b'\x7fELF') or data[5] != 1:
+            raise ValueError("%s: not a little endian ELF file" % path)
+        self.is64 = data[4] == 2
+        if self.is64:
+            (phoff, shoff) = struct.unpack_from('<QQ', data, 32)
+            (phentsize, phnum, shentsize, shnum,
+             shstrndx) = struct.unpack_from('<HHHHH', data, 54)
+            self.addr_fmt = '<Q'
+        else:
+            (phoff, shoff) = struct.unpack_from('<II', data, 28)
+            (phentsize, phnum, shentsize, shnum,
+             shstrndx) = struct.unpack_from('<HHHHH', data, 42)
+            self.addr_fmt = '<I'
+        self.addr_size = struct.calcsize(self.addr_fmt)
+
+        self.loads = []
+        for i in range(phnum):
+            off = phoff + i * phentsize
+            if self.is64:
+                (p_type, _, p_offset, p_vaddr, _,
+                 p_filesz, _, _) = struct.unpack_from('<IIQQQQQQ', data, off)
+            else:
+                (p_type, p_offset, p_vaddr, _,
+                 p_filesz, _, _, _) = struct.unpack_from('<8I', data, off)
+            if p_type == 1:  # PT_LOAD
+                self.loads.append((p_offset, p_vaddr, p_filesz))
+
+        self.sections = {}
+        headers = []
+        for i in range(shnum):
+            off = shoff + i * shentsize
+            if self.is64:
+                (name, sh_type, _, addr, offset, size,
+                 link, _, _, _) = struct.unpack_from('<IIQQQQIIQQ', data, off)
+            else:
+                (name, sh_type, _, addr, offset, size,
+                 link, _, _, _) = struct.unpack_from('<10I', data, off)
+            headers.append((name, sh_type, addr, offset, size, link))
+        if shstrndx < len(headers):
+            strtab = headers[shstrndx][3]
+            for hdr in headers:
+                self.sections[self._str(strtab + hdr[0])] = hdr
+
+        self.syms = []
+        self.sym_addrs = []
+        self.fdes = []
+        self.fde_addrs = []
+        self._load_syms(headers)
+        self._load_cfi()
+
+    def _str(self, off):
+        end = self.data.find(bytearray(b'\0'), off)
+        return bytes(self.data[off:end]).decode('latin-1')
+
+    def vaddr(self, offset):
+        """The link-time address of a file offset"""
+        for p_offset, p_vaddr, p_filesz in self.loads:
+            if p_offset <= offset < p_offset + p_filesz:
+                return offset - p_offset + p_vaddr
+        return offset
+
+    def read(self, vaddr, size):
+        """Bytes of the file at a link-time address (None if not in it)"""
+        for p_offset, p_vaddr, p_filesz in self.loads:
+            if p_vaddr <= vaddr and vaddr + size <= p_vaddr + p_filesz:
+                off = vaddr - p_vaddr + p_offset
+                return self.data[off:off + size]
+        return None
+
+    def _load_syms(self, headers):
+        for name in ('.symtab', '.dynsym'):
+            sec = self.sections.get(name)
+            if sec is None or sec[5] >= len(headers):
+                continue
+            _, _, _, offset, size, link = sec
+            strtab = headers[link][3]
+            if self.is64:
+                fmt, entsize = '<IBBHQQ', 24
+            else:
+                fmt, entsize = '<IIIBBH', 16
+            syms = []
+            for off in range(offset, offset + size - entsize + 1, entsize):
+                if self.is64:
+                    (st_name, st_info, _, _, value,
+                     st_size) = struct.unpack_from(fmt, self.data, off)
+                else:
+                    (st_name, value, st_size, st_info,
+                     _, _) = struct.unpack_from(fmt, self.data, off)
+                if st_info & 0xf != 2 or not value:  # STT_FUNC
+                    continue
+                syms.append((value & ~1, st_size, self._str(strtab + st_name)))
+            if syms:
+                syms.sort()
+                self.syms = syms
+                self.sym_addrs = [s[0] for s in syms]
+                return
+
+    def symbol(self, vaddr):
+        """(name, offset) of the function holding a link-time address"""
+        idx = bisect.bisect_right(self.sym_addrs, vaddr) - 1
+        if idx < 0:
+            return '??', vaddr
+        addr, size, name = self.syms[idx]
+        if size and vaddr >= addr + size:
+            return '??', vaddr
+        return name, vaddr - addr
+
+    def _read_enc(self, pos, enc, sec_addr, sec_off):
+        """Read a DW_EH_PE encoded pointer: (value, next position)"""
+        data = self.data
+        fmt = enc & 0x0f
+        start = pos
+        if fmt == 0x00:
+            val = struct.unpack_from(self.addr_fmt, data, pos)[0]
+            pos += self.addr_size
+        elif fmt == 0x01:
+            val, pos = _uleb(data, pos)
+        elif fmt == 0x09:
+            val, pos = _sleb(data, pos)
+        else:
+            sfmt = {0x02: '<H', 0x03: '<I', 0x04: '<Q',
+                    0x0a: '<h', 0x0b: '<i', 0x0c: '<q'}.get(fmt)
+            if sfmt is None:
+                raise ValueError("unsupported pointer encoding 0x%x" % enc)
+            val = struct.unpack_from(sfmt, data, pos)[0]
+            pos += struct.calcsize(sfmt)
+        if enc & 0x70 == PE_PCREL:
+            val += sec_addr + (start - sec_off)
+        return val & ((1 << (8 * self.addr_size)) - 1), pos
+
+    def _parse_cie(self, pos, end, is_eh, sec_addr, sec_off):
+        data = self.data
+        cie = Cie()
+        version = data[pos]
+        pos += 1
+        aug_end = data.find(bytearray(b'\0'), pos)
+        aug = bytes(data[pos:aug_end]).decode('latin-1')
+        pos = aug_end + 1
+        if not is_eh and version >= 4:
+            pos += 2  # address_size, segment_size
+        cie.code_align, pos = _uleb(data, pos)
+        cie.data_align, pos = _sleb(data, pos)
+        if version == 1:
+            cie.ra_reg = data[pos]
+            pos += 1
+        else:
+            cie.ra_reg, pos = _uleb(data, pos)
+        cie.aug = aug
+        if aug.startswith('z'):
+            length, pos = _uleb(data, pos)
+            aug_data_end = pos + length
+            for ch in aug[1:]:
+                if ch == 'R':
+                    cie.fde_enc = data[pos]
+                    pos += 1
+                elif ch == 'L':
+                    pos += 1
+                elif ch == 'P':
+                    enc = data[pos]
+                    _, pos = self._read_enc(pos + 1, enc & 0x7f,
+                                            sec_addr, sec_off)
+            pos = aug_data_end
+        elif aug:
+            # don't know how long an unknown augmentation is
+            return None
+        cie.insns = (pos, end)
+        return cie
+
+    def _load_cfi(self):
+        for name, is_eh in (('.debug_frame', False), ('.eh_frame', True)):
+            sec = self.sections.get(name)
+            if sec is not None and sec[4] > 0:
+                try:
+                    self._parse_frames(sec, is_eh)
+                except (struct.error, IndexError, ValueError):
+                    pass
+            if self.fdes:
+                break
+        self.fdes.sort(key=lambda f: f[0])
+        self.fde_addrs = [f[0] for f in self.fdes]
+
+    def _parse_frames(self, sec, is_eh):
+        data = self.data
+        _, sh_type, sec_addr, sec_off, size, _ = sec
+        if sh_type == 8:  # SHT_NOBITS
+            return
+        cies = {}
+        pos = sec_off
+        sec_end = sec_off + size
+        while pos + 4 <= sec_end:
+            start = pos
+            length = struct.unpack_from('<I', data, pos)[0]
+            pos += 4
+            if length == 0:
+                if is_eh:
+                    break
+                continue
+            if length == 0xffffffff:
+                return  # 64-bit DWARF
+            end = pos + length
+            id_pos = pos
+            cie_id = struct.unpack_from('<I', data, pos)[0]
+            pos += 4
+            if (is_eh and cie_id == 0) or (not is_eh and cie_id == 0xffffffff):
+                cies[start] = self._parse_cie(pos, end, is_eh,
+                                              sec_addr, sec_off)
+                pos = end
+                continue
+
+            cie_pos = id_pos - cie_id if is_eh else sec_off + cie_id
+            cie = cies.get(cie_pos)
+            if cie is None:
+                pos = end
+                continue
+            if is_eh:
+                begin, pos = self._read_enc(pos, cie.fde_enc,
+                                            sec_addr, sec_off)
+                rng, pos = self._read_enc(pos, cie.fde_enc & 0x0f,
+                                          sec_addr, sec_off)
+                if cie.aug.startswith('z'):
+                    length, pos = _uleb(data, pos)
+                    pos += length
+            else:
+                begin = struct.unpack_from(self.addr_fmt, data, pos)[0]
+                rng = struct.unpack_from(self.addr_fmt, data,
+                                         pos + self.addr_size)[0]
+                pos += 2 * self.addr_size
+            if rng:
+                self.fdes.append((begin, begin + rng, cie, (pos, end)))
+            pos = end
+
+    def find_fde(self, vaddr):
+        idx = bisect.bisect_right(self.fde_addrs, vaddr) - 1
+        if idx < 0:
+            return None
+        fde = self.fdes[idx]
+        if vaddr >= fde[1]:
+            return None
+        return fde
+
+    def _run(self, cie, insns, loc, target, state, initial):
+        """Run CFA instructions until 'loc' passes 'target'"""
+        data = self.data
+        pos, end = insns
+        stack = []
+        while pos < end and loc <= target:
+            op = data[pos]
+            pos += 1
+            high, low = op & 0xc0, op & 0x3f
+            if high == 0x40:  # advance_loc
+                loc += low * cie.code_align
+            elif high == 0x80:  # offset
+                off, pos = _uleb(data, pos)
+                state['rules'][low] = ('off', off * cie.data_align)
+            elif high == 0xc0:  # restore
+                if low in initial['rules']:
+                    state['rules'][low] = initial['rules'][low]
+                else:
+                    state['rules'].pop(low, None)
+            elif op == 0x00:
+                pass
+            elif op == 0x01:  # set_loc
+                loc = struct.unpack_from(self.addr_fmt, data, pos)[0]
+                pos += self.addr_size
+            elif op in (0x02, 0x03, 0x04):  # advance_loc1/2/4
+                sfmt = {0x02: '<B', 0x03: '<H', 0x04: '<I'}[op]
+                loc += struct.unpack_from(sfmt, data, pos)[0] * cie.code_align
+                pos += struct.calcsize(sfmt)
+            elif op in (0x05, 0x11, 0x14, 0x15):
+                reg, pos = _uleb(data, pos)
+                if op in (0x05, 0x14):
+                    off, pos = _uleb(data, pos)
+                else:
+                    off, pos = _sleb(data, pos)
+                kind = 'off' if op in (0x05, 0x11) else 'val'
+                state['rules'][reg] = (kind, off * cie.data_align)
+            elif op == 0x06:  # restore_extended
+                reg, pos = _uleb(data, pos)
+                if reg in initial['rules']:
+                    state['rules'][reg] = initial['rules'][reg]
+                else:
+                    state['rules'].pop(reg, None)
+            elif op == 0x07:  # undefined
+                reg, pos = _uleb(data, pos)
+                state['rules'][reg] = ('undef', 0)
+            elif op == 0x08:  # same_value
+                reg, pos = _uleb(data, pos)
+                state['rules'].pop(reg, None)
+            elif op == 0x09:  # register
+                reg, pos = _uleb(data, pos)
+                reg2, pos = _uleb(data, pos)
+                state['rules'][reg] = ('reg', reg2)
+            elif op == 0x0a:  # remember_state
+                stack.append((dict(state['rules']), state['cfa']))
+            elif op == 0x0b:  # restore_state
+                if stack:
+                    state['rules'], state['cfa'] = stack.pop()
+            elif op == 0x0c:  # def_cfa
+                reg, pos = _uleb(data, pos)
+                off, pos = _uleb(data, pos)
+                state['cfa'] = (reg, off)
+            elif op == 0x0d:  # def_cfa_register
+                reg, pos = _uleb(data, pos)
+                state['cfa'] = (reg, state['cfa'][1])
+            elif op == 0x0e:  # def_cfa_offset
+                off, pos = _uleb(data, pos)
+                state['cfa'] = (state['cfa'][0], off)
+            elif op == 0x12:  # def_cfa_sf
+                reg, pos = _uleb(data, pos)
+                off, pos = _sleb(data, pos)
+                state['cfa'] = (reg, off * cie.data_align)
+            elif op == 0x13:  # def_cfa_offset_sf
+                off, pos = _sleb(data, pos)
+                state['cfa'] = (state['cfa'][0], off * cie.data_align)
+            elif op == 0x2e:  # GNU_args_size
+                _, pos = _uleb(data, pos)
+            elif op == 0x2f:  # GNU_negative_offset_extended
+                reg, pos = _uleb(data, pos)
+                off, pos = _uleb(data, pos)
+                state['rules'][reg] = ('off', -off * cie.data_align)
+            else:
+                # DWARF expressions: can't be followed here
+                return None
+        return state
+
+    def unwind_rules(self, vaddr):
+        """CFA and register rules at a link-time address (None if unknown)"""
+        fde = self.find_fde(vaddr)
+        if fde is None:
+            return None
+        begin, _, cie, insns = fde
+        initial = {'cfa': (ARM_SP, 0), 'rules': {}}
+        if self._run(cie, cie.insns, 0, 1 << 64, initial, initial) is None:
+            return None
+        state = {'cfa': initial['cfa'], 'rules': dict(initial['rules'])}
+        if self._run(cie, insns, begin, vaddr, state, initial) is None:
+            return None
+        return state, cie.ra_reg
+
+
+def load_elf(path):
+    """Parsed ELF file for a path on the device (None if not found)"""
+    if path in _ELF_CACHE:
+        return _ELF_CACHE[path]
+    elf = None
+    symfs = os.environ.get(SYMFS_ENV, '')
+    candidates = [path]
+    if symfs:
+        candidates.insert(0, os.path.join(symfs, path.lstrip('/')))
+    for candidate in candidates:
+        try:
+            elf = Elf(candidate)
+            break
+        except (IOError, OSError, ValueError, struct.error, IndexError):
+            continue
+    _ELF_CACHE[path] = elf
+    return elf
+
+
+class Module(object):
+    """One executable mapping from a MAP: line"""
+
+    def __init__(self, start, end, offset, path):
+        self.start = start
+        self.end = end
+        self.offset = offset
+        self.path = path
+        self.name = os.path.basename(path) if path else '??'
+
+    def elf(self):
+        if not self.path or self.path.startswith('['):
+            return None
+        return load_elf(self.path)
+
+    def vaddr(self, addr):
+        elf = self.elf()
+        off = addr - self.start + self.offset
+        return elf.vaddr(off) if elf else off
+
+
+class Unwinder(object):
+    """Turns the BT:RAW (and BT:CALLER) records of one trace back into
+    backtraces"""
+
+    def __init__(self, wrapper='libc.so'):
+        self.wrapper = wrapper
+        self.maps = {}
+        self.starts = {}
+
+    def add_map(self, line):
+        fields = line.split(':', 6)
+        try:
+            gen = int(fields[2])
+            start = int(fields[3], 16)
+            end = int(fields[4], 16)
+            offset = int(fields[5], 16)
+        except (ValueError, IndexError):
+            return
+        path = fields[6].rstrip()
+        if path.endswith(':'):
+            path = path[:-1]
+        mods = self.maps.setdefault(gen, [])
+        mods.append(Module(start, end, offset, path))
+        if len(mods) > 1 and mods[-2].start > start:
+            mods.sort(key=lambda m: m.start)
+        self.starts[gen] = None
+
+    def _modules(self, gen):
+        if gen not in self.maps:
+            # the map we need may have been overwritten (flight recorder):
+            # the closest one will mostly do
+            if not self.maps:
+                return [], []
+            older = [g for g in self.maps if g <= gen]
+            gen = max(older) if older else min(self.maps)
+        mods = self.maps[gen]
+        if self.starts.get(gen) is None:
+            self.starts[gen] = [m.start for m in mods]
+        return mods, self.starts[gen]
+
+    @staticmethod
+    def _find(mods, starts, addr):
+        idx = bisect.bisect_right(starts, addr) - 1
+        if idx >= 0 and addr < mods[idx].end:
+            return mods[idx]
+        return None
+
+    @staticmethod
+    def _after_call(mod, addr):
+        """Does 'addr' look like a return address in 'mod'?"""
+        elf = mod.elf()
+        if elf is None:
+            return True
+        vaddr = mod.vaddr(addr & ~1)
+        if addr & 1:
+            code = elf.read(vaddr - 4, 4)
+            if code is None:
+                return False
+            hw1, hw2 = struct.unpack('<HH', bytes(code))
+            if (hw1 & 0xf800) == 0xf000 and (hw2 & 0xc000) == 0xc000:
+                return True  # bl / blx <imm>
+            return (hw2 & 0xff87) == 0x4780  # blx <reg>
+        code = elf.read(vaddr - 4, 4)
+        if code is None:
+            return False
+        insn = struct.unpack('<I', bytes(code))[0]
+        return ((insn & 0x0f000000) == 0x0b000000 or
+                (insn & 0xfe000000) == 0xfa000000 or
+                (insn & 0x0ffffff0) == 0x012fff30)
+
+    def unwind(self, gen, regs, sp, stack):
+        """Return addresses of the caller and its callers"""
+        mods, starts = self._modules(gen)
+        base = sp
+        top = sp + len(stack)
+
+        def read_word(addr):
+            if base <= addr and addr + 4 <= top:
+                return struct.unpack_from('<I', stack, addr - base)[0]
+            return None
+
+        state = dict((i, v) for i, v in enumerate(regs[:12]))
+        state[ARM_SP] = sp
+        state[ARM_LR] = regs[12] if len(regs) > 12 else None
+        pc = state[ARM_LR]
+        frames = []
+        while pc and len(frames) < MAX_FRAMES:
+            frames.append(pc)
+            mod = self._find(mods, starts, pc)
+            rules = None
+            elf = mod.elf() if mod else None
+            if elf is not None:
+                rules = elf.unwind_rules(mod.vaddr(pc & ~1) - 1)
+            new = None
+            if rules is not None:
+                new = self._step(rules, state, read_word)
+                if new is not None and new.get(ARM_PC) == pc:
+                    new = None  # lr was never saved: no help
+            if new is None:
+                new = self._scan(mods, starts, state, read_word, top)
+            if new is None or new[ARM_SP] is None or \
+                    new[ARM_SP] <= state[ARM_SP]:
+                break
+            state = new
+            pc = new.get(ARM_PC)
+        return frames
+
+    @staticmethod
+    def _step(rules, state, read_word):
+        """Registers of the caller, from the CFI rules at the callee's pc"""
+        cfi, ra_reg = rules
+        cfa_reg, cfa_off = cfi['cfa']
+        if state.get(cfa_reg) is None:
+            return None
+        cfa = (state[cfa_reg] + cfa_off) & 0xffffffff
+        new = dict(state)
+        for reg, (kind, val) in cfi['rules'].items():
+            if kind == 'off':
+                new[reg] = read_word(cfa + val)
+            elif kind == 'val':
+                new[reg] = cfa + val
+            elif kind == 'reg':
+                new[reg] = state.get(val)
+            else:
+                new[reg] = None
+        new[ARM_SP] = cfa
+        new[ARM_PC] = new.get(ra_reg)
+        return new
+
+    def _scan(self, mods, starts, state, read_word, top):
+        addr = state.get(ARM_SP)
+        if addr is None:
+            return None
+        while addr + 4 <= top:
+            val = read_word(addr)
+            mod = self._find(mods, starts, val) if val else None
+            if mod is not None and self._after_call(mod, val):
+                new = dict((r, None) for r in state)
+                new[ARM_SP] = addr + 4
+                new[ARM_PC] = val
+                return new
+            addr += 4
+        return None
+
+    def frame_line(self, ts, count, pc, mods, starts):
+        addr = (pc & ~1) - 2 if pc & 1 else pc - 4
+        mod = self._find(mods, starts, pc)
+        if mod is None:
+            return "%s::%d:%x:??:+0x0:??(0x0):\n" % (ts, count, addr)
+        elf = mod.elf()
+        name, off = '??', addr - mod.start
+        if elf is not None:
+            name, off = elf.symbol(mod.vaddr(addr))
+        return "%s::%d:%x:%s:+0x%x:%s(0x%x):\n" % (
+            ts, count, addr, name, off, mod.name, mod.start - mod.offset)
+
+    def caller(self, gen, module, offset):
+        """Address of a BT:CALLER return address"""
+        mods, _ = self._modules(gen)
+        if module < 0 or not mods or module >= len(mods):
+            return offset if module < 0 else None
+        mod = mods[module]
+        return mod.start + offset - mod.offset
+
+    def expand(self, lines):
+        """Pass lines through, with BT:RAW records unwound"""
+        for line in lines:
+            labels = line.split(':', 3)
+            if labels[1:2] == ['MAP']:
+                self.add_map(line)
+                continue
+            if labels[1:3] == ['BT', 'CALLER']:
+                try:
+                    fields = line.split(':')
+                    ts = fields[0]
+                    gen = int(fields[3])
+                    symbol = fields[4]
+                    pc = self.caller(gen, int(fields[5]), int(fields[6], 16))
+                except (ValueError, IndexError):
+                    continue
+                mods, starts = self._modules(gen)
+                yield "%s:BT:START:%d:\n" % (ts, 2 if pc else 1)
+                yield "%s::0:0:%s:+0x0:%s(0x0):\n" % (ts, symbol, self.wrapper)
+                if pc:
+                    yield self.frame_line(ts, 1, pc, mods, starts)
+                continue
+            if labels[1:3] != ['BT', 'RAW']:
+                yield line
+                continue
+            try:
+                fields = line.split(':')
+                ts = fields[0]
+                gen = int(fields[3])
+                symbol = fields[4]
+                sp = int(fields[5], 16)
+                regs = [int(r, 16) for r in fields[6].split(',')]
+                stack = base64.b64decode(fields[8])
+            except (ValueError, IndexError, TypeError):
+                continue
+            mods, starts = self._modules(gen)
+            frames = self.unwind(gen, regs, sp, stack)
+            yield "%s:BT:START:%d:\n" % (ts, len(frames) + 1)
+            yield "%s::0:0:%s:+0x0:%s(0x0):\n" % (ts, symbol, self.wrapper)
+            for count, pc in enumerate(frames):
+                yield self.frame_line(ts, count + 1, pc, mods, starts)
@@ -27,6 +27,7 @@ class TraceGraph(DiGraph):
         self.filter_calls = []
         self.timing_info = {}
         self.stack_depth = {}
+        self.cct_time = {}
 
     @classmethod
     def parse_traces(cls, trace_dir, settings, filter_file):
@@ -43,70 +44,82 @@ class TraceGraph(DiGraph):
         # disable timing
         # self.timing_info = None
         for path in parsing.yield_paths(filename, self.timing_info, self.filter_calls):
-            path[-1] = re.sub(r'_B:|_D:|_E:|_F:|_f:|_K:|_k:|_P:|_p:|_?:|_S:|_U:',':',path[-1])
-            if path[-1] in self.filter_calls:
-                continue
-            if len(path) < 2:  # until now, no need keeping single call paths
-                continue
-            # keep a dict of stack depth of native calls
-            for depth in range(len(path)):
-                if path[-1 - depth].split(':')[1] == 'DVM':
-                    break
-            depth += 1
-            # drop calls with no backtraces from stack_depth
-            if  path[-2] != 'NO_BACKTRACE:NO_BACKTRACE':
-                if depth > 128: 
-                    depth = 128
-                if depth not in self.stack_depth:
-                    self.stack_depth[depth] = 1
-                else:
-                    self.stack_depth[depth] += 1
-            # keep a list of all posix calls ordered ( callers prepended )
-            # the following comment prevent any ppattern...
-            # self.posix_calls_list.append(path[-2] + ':' + path[-1])
-            # for each libc call, keep a "who called me" dict
-            if path[-1] in self.posix_calls:
-                if path[-2] in self.posix_calls[path[-1]]:
-                    self.posix_calls[path[-1]][path[-2]] += 1
-                else:
-                    self.posix_calls[path[-1]][path[-2]] = 1
-            else:
-                self.posix_calls[path[-1]] = {}
-                self.posix_calls[path[-1]][path[-2]] = 1
+            self.add_path(path)
 
-            # for each libc call, keep a "which lib called me" dict
-            if path[-1] in self.posix_calls_per_lib:
-                if path[-2].split(':')[1] in self.posix_calls_per_lib[path[-1]]:
-                    self.posix_calls_per_lib[path[-1]][path[-2].split(':')[1]] += 1
-                else:
-                    self.posix_calls_per_lib[path[-1]][path[-2].split(':')[1]] = 1
+    def add_path(self, path):
+        """Adds one path to the graph; paths out of a calling-context tree
+        count once per call they stand for"""
+        count = getattr(path, 'calls', 1)
+        for call, times in getattr(path, 'node_times', {}).items():
+            if call in self.cct_time:
+                self.cct_time[call][0] += times[0]
+                self.cct_time[call][1] += times[1]
+            else:
+                self.cct_time[call] = list(times)
+        path[-1] = re.sub(r'_B:|_D:|_E:|_F:|_f:|_K:|_k:|_P:|_p:|_?:|_S:|_U:',':',path[-1])
+        if path[-1] in self.filter_calls:
+            return
+        if len(path) < 2:  # until now, no need keeping single call paths
+            return
+        # keep a dict of stack depth of native calls
+        for depth in range(len(path)):
+            if path[-1 - depth].split(':')[1] == 'DVM':
+                break
+        depth += 1
+        # drop calls with no backtraces from stack_depth
+        if  path[-2] != 'NO_BACKTRACE:NO_BACKTRACE':
+            if depth > 128: 
+                depth = 128
+            if depth not in self.stack_depth:
+                self.stack_depth[depth] = count
+            else:
+                self.stack_depth[depth] += count
+        # keep a list of all posix calls ordered ( callers prepended )
+        # the following comment prevent any ppattern...
+        # self.posix_calls_list.append(path[-2] + ':' + path[-1])
+        # for each libc call, keep a "who called me" dict
+        if path[-1] in self.posix_calls:
+            if path[-2] in self.posix_calls[path[-1]]:
+                self.posix_calls[path[-1]][path[-2]] += count
             else:
-                self.posix_calls_per_lib[path[-1]] = {}
-                self.posix_calls_per_lib[path[-1]][path[-2].split(':')[1]] = 1
+                self.posix_calls[path[-1]][path[-2]] = count
+        else:
+            self.posix_calls[path[-1]] = {}
+            self.posix_calls[path[-1]][path[-2]] = count
 
-           # for each native library call, keep a "who I called" dict
-            if path[-2] in self.native_calls:
-                if path[-1] in self.native_calls[path[-2]]:
-                    self.native_calls[path[-2]][path[-1]] += 1
-                else:
-                    self.native_calls[path[-2]][path[-1]] = 1
+        # for each libc call, keep a "which lib called me" dict
+        if path[-1] in self.posix_calls_per_lib:
+            if path[-2].split(':')[1] in self.posix_calls_per_lib[path[-1]]:
+                self.posix_calls_per_lib[path[-1]][path[-2].split(':')[1]] += count
             else:
-                self.native_calls[path[-2]] = {}
-                self.native_calls[path[-2]][path[-1]] = 1
+                self.posix_calls_per_lib[path[-1]][path[-2].split(':')[1]] = count
+        else:
+            self.posix_calls_per_lib[path[-1]] = {}
+            self.posix_calls_per_lib[path[-1]][path[-2].split(':')[1]] = count
 
-            # keep all full paths and occurencies
-            if PATH_DELIMITER.join(path) in self.full_paths_dict:
-                self.full_paths_dict[PATH_DELIMITER.join(path)] += 1
+       # for each native library call, keep a "who I called" dict
+        if path[-2] in self.native_calls:
+            if path[-1] in self.native_calls[path[-2]]:
+                self.native_calls[path[-2]][path[-1]] += count
             else:
-                self.full_paths_dict[PATH_DELIMITER.join(path)] = 1
-            if len(path) == 1:
-                self.add_node(*path)
-                return
-            # add edges
-            for edge in zip(path, path[1:]):
+                self.native_calls[path[-2]][path[-1]] = count
+        else:
+            self.native_calls[path[-2]] = {}
+            self.native_calls[path[-2]][path[-1]] = count
+
+        # keep all full paths and occurencies
+        if PATH_DELIMITER.join(path) in self.full_paths_dict:
+            self.full_paths_dict[PATH_DELIMITER.join(path)] += count
+        else:
+            self.full_paths_dict[PATH_DELIMITER.join(path)] = count
+        if len(path) == 1:
+            self.add_node(*path)
+            return
+        # add edges
+        for edge in zip(path, path[1:]):
 #                if edge[0] == edge[1]:
 #                    continue
-                if self.has_edge(*edge):
-                    self[edge[0]][edge[1]]['weight'] += 1
-                else:
-                    self.add_edge(*edge, weight=1)
+            if self.has_edge(*edge):
+                self[edge[0]][edge[1]]['weight'] += count
+            else:
+                self.add_edge(*edge, weight=count)
@@ -72,6 +72,11 @@ __attribute__((constructor)) static void __libc_preinit()
 	sym = dlsym(real_libc_dso, "__progname");
 	if (sym)
 		progname = *(const char **)sym;
+#ifdef WRAP_RT_GLUE
+	wrap_rt_glue_init();
+#else
+	wrap_eager_init();
+#endif
 	/* (void)wrapped_tracer("__constructor__(__libc_preinit)", NULL, 0, NULL); */
 }
 
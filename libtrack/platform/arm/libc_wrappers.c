@@ -16,7 +16,11 @@
 #include "backtrace.h"
 #include "libz.h"
 #include "wrap_lib.h"
+#include "wrap_alloc.h"
 #include "wrap_tls.h"
+#include "wrap_time.h"
+#include "wrap_maps.h"
+#include "wrap_syms.h"
 #include "java_backtrace.h"
 
 extern int local_strcmp(const char *s1, const char *s2);
@@ -32,7 +36,6 @@ static int handle_exec(struct tls_info *tls);
 static int handle_fork(struct tls_info *tls);
 static int handle_prctl(struct tls_info *tls);
 static int handle_pth_setname(struct tls_info *tls);
-static int handle_pthread(struct tls_info *tls);
 static int handle_signal(struct tls_info *tls);
 static int handle_sigaction(struct tls_info *tls);
 
@@ -47,24 +50,26 @@ static int handle_accept(struct tls_info *tls);
 static int handle_closefd(struct tls_info *tls);
 static int handle_closefptr(struct tls_info *tls);
 
+static int handle_dlclose(struct tls_info *tls);
+
 static int handle_rename_fd1(struct tls_info *tls);
 static int handle_epoll(struct tls_info *tls);
 
 #define safe_call(TLS, ERR, CODE...) \
 	{ \
-		struct timespec _start, _end; \
-		__clear_wrapping(); \
+		uint64_t _start = 0, _end; \
+		tls_clear_wrapping(TLS); \
 		if ((TLS)->info.log_time) \
-			libc.clock_gettime(CLOCK_THREAD_CPUTIME_ID, &_start); \
+			_start = wtime_now((TLS)->info.log_time, &(TLS)->wt); \
 		CODE; \
 		if ((TLS)->info.log_time) { \
-			libc.clock_gettime(CLOCK_THREAD_CPUTIME_ID, &_end); \
+			_end = wtime_now((TLS)->info.log_time, &(TLS)->wt); \
 			log_posixtime(TLS, (TLS)->info.symbol, \
-				      &_start, &_end); \
+				      _start, _end); \
 			(TLS)->info.log_time = 0; \
 		} \
 		ERR = *__errno(); \
-		__set_wrapping(); \
+		tls_set_wrapping(TLS); \
 	}
 
 /*
@@ -81,7 +86,7 @@ static inline int __maybe_grow_fdtable(int fd)
 {
 	if (fd >= fdtable_sz) {
 		int newsz = fd < (MIN_FDTABLE_SZ*2) ? MIN_FDTABLE_SZ*2 : fd * 2;
-		char *newtable = (char *)libc.malloc(newsz);
+		char *newtable = (char *)walloc(newsz);
 		if (!newtable)
 			return -1;
 		/* libc_log("I:grow fdtable from %d to %d", fdtable_sz, newsz); */
@@ -89,7 +94,7 @@ static inline int __maybe_grow_fdtable(int fd)
 		if (fdtable_sz) { /* copy over the old table */
 			libc.memcpy(newtable, fdtable, fdtable_sz);
 			if (fdtable && fdtable != init_fdtable)
-				libc.free(fdtable);
+				wfree(fdtable, fdtable_sz);
 		}
 		fdtable_sz = newsz;
 		fdtable = newtable;
@@ -273,6 +278,9 @@ static struct wrap_cache_entry {
 	uint8_t noargs;
 } s_wrap_cache[WRAP_CACHE_SZ];
 
+static struct wslab wrap_cache_slab =
+	WSLAB_INIT("wrap_cache_entry", sizeof(struct wrap_cache_entry));
+
 static inline uint8_t wrap_hash(const char *name)
 {
 	uint8_t v = 0;
@@ -297,7 +305,7 @@ static void add_entry(const char *symname, handler_func handler, int flags)
 	if (entry->name) {
 		/* collision: malloc more space... */
 		struct wrap_cache_entry *e;
-		e = (struct wrap_cache_entry *)libc.malloc(sizeof(*e));
+		e = (struct wrap_cache_entry *)wslab_alloc(&wrap_cache_slab);
 		if (!e)
 			return;
 		libc.memset(e, 0, sizeof(*e));
@@ -360,7 +368,6 @@ void __hidden setup_wrap_cache(void)
 	add_entry("__fork", handle_fork, WF_WRAPSYM);
 	add_entry("__bionic_clone", handle_fork, WF_WRAPSYM);
 	add_entry("__sys_clone", handle_fork, WF_WRAPSYM);
-	add_entry("__pthread_clone", handle_pthread, WF_WRAPSYM);
 	add_entry("_exit", handle_exit, WF_WRAPSYM);
 	add_entry("_exit_thread", handle_thread_exit, WF_WRAPSYM);
 	add_entry("_exit_with_stack_teardown", handle_thread_exit, WF_WRAPSYM);
@@ -376,7 +383,6 @@ void __hidden setup_wrap_cache(void)
 	add_entry("execvp", handle_exec, WF_WRAPSYM);
 	add_entry("fork", handle_fork, WF_WRAPSYM);
 	add_entry("prctl", handle_prctl, WF_WRAPSYM);
-	add_entry("pthread_create", handle_pthread, WF_WRAPSYM);
 	add_entry("pthread_exit", handle_thread_exit, WF_WRAPSYM);
 	add_entry("pthread_setname_np", handle_pth_setname, WF_WRAPSYM);
 	add_entry("sig_action", handle_sigaction, WF_WRAPSYM);
@@ -394,6 +400,7 @@ void __hidden setup_wrap_cache(void)
 	add_entry("__sclose", handle_closefptr, WF_WRAPSYM | WF_MODSYM);
 	add_entry("accept", handle_accept, WF_WRAPSYM);
 	add_entry("close", handle_closefd, WF_WRAPSYM | WF_MODSYM);
+	add_entry("dlclose", handle_dlclose, WF_WRAPSYM);
 	add_entry("dup", handle_dup, WF_WRAPSYM);
 	add_entry("dup2", handle_dup, WF_WRAPSYM);
 	add_entry("epoll_create", handle_epoll, WF_WRAPSYM);
@@ -453,63 +460,85 @@ void __hidden setup_wrap_cache(void)
 	add_entry("clock_gettime", NULL, WF_NOTRACE | WF_NOTIME | WF_NOARGS);
 }
 
-static inline void timespec_sub(struct timespec *a, const struct timespec *b)
-{
-	a->tv_sec  -= b->tv_sec;
-	a->tv_nsec -= b->tv_nsec;
-	if (a->tv_nsec < 0) {
-		a->tv_nsec += 1000000000;
-		a->tv_sec  -= 1;
-	}
-}
-
 static inline void log_posixtime(struct tls_info *tls, const char *sym,
-				 struct timespec *start, struct timespec *end)
+				 uint64_t start, uint64_t end)
 {
-	struct timespec posix_time = *end;
-	timespec_sub(&posix_time, start);
+	uint64_t posix_time = (end > start) ? end - start : 0;
 	bt_printf(tls, "LOG:T:%s:%lu.%lu", sym,
-		  (unsigned long)posix_time.tv_sec,
-		  (unsigned long)posix_time.tv_nsec);
+		  (unsigned long)(posix_time / 1000000000ULL),
+		  (unsigned long)(posix_time % 1000000000ULL));
 }
 
 /**
  * @wrapped_return - carefully pull a stored return value from TLS and return
  *                   to the original caller
  *
+ * @param fret When called from arch_wrapped_return, the (first word of the)
+ *             wrapped function's return value: r0 is still live.
+ *
  * TODO:
  * Right now, we always return a 32-bit number. This won't work for large
  * return value functions...
  */
-uint32_t wrapped_return(void)
+#ifdef WRAP_RT_CORE
+/* the wrapped libraries' wrapped_return() hands it over (see wrap_rt.h) */
+uint32_t wrap_rt_return(struct wrap_rt_lib *lib, uint32_t fret)
+#else
+uint32_t wrapped_return(uint32_t fret)
+#endif
 {
-	/* record this ASAP */
-	struct timespec posix_end;
-	libc.clock_gettime(CLOCK_THREAD_CPUTIME_ID, &posix_end);
-
-	{
-		struct tls_info *tls;
-		struct ret_ctx *ret;
-		uint32_t rval, err = (*__errno());
-
-		tls = get_tls();
-		ret = get_retmem(tls);
-		if (!ret)
-			BUG_MSG(0x4311, "No TLS return value!");
-
-		if (tls->info.log_time) {
-			rval = 0; /* handled by arch_wrapped_return */
+	uint64_t posix_end;
+	struct tls_info *tls;
+	struct ret_ctx *ret;
+	struct tls_call outer;
+	uint32_t rval, err = (*__errno());
+	int nested;
+
+	tls = get_tls();
+	if (!tls)
+		BUG_MSG(0x4311, "No TLS return value!");
+#ifdef WRAP_RT_CORE
+	ret = tls_ret(tls, lib);
+#else
+	ret = tls_ret(tls, tls->lib);
+#endif
+
+	if (ret->log_time) {
+		/* the clock is only read for calls we time */
+		posix_end = wtime_now(ret->log_time, &tls->wt);
+		rval = 0; /* handled by arch_wrapped_return */
+		/* we interrupted another call (see struct tls_call) */
+		nested = tls->in_trace++;
+		if (nested)
+			tls_save_call(tls, &outer);
+		ovh_enter(tls, OVH_OTHER);
+#ifdef WRAP_RT_CORE
+		/* LOG:T goes with our call, whichever were traced since */
+		tls->info.tv_strlen = ret->tv_strlen;
+		libc.memcpy(tls->info.tv_str, ret->tv_str, sizeof(ret->tv_str));
+#endif
+		if (!cct_ret(tls, posix_end > ret->posix_start ?
+				   posix_end - ret->posix_start : 0)) {
+			ovh_enter(tls, OVH_FORMAT);
 			log_posixtime(tls, ret->sym,
-				      &ret->posix_start, &posix_end);
-			tls->info.log_time = 0;
-		} else {
-			err = ret->_errno;
-			rval = ret->u.u32[0];
+				      ret->posix_start, posix_end);
+			ovh_leave(tls);
 		}
-
-		(*__errno()) = err;
-		return rval;
+		ret->log_time = 0;
+		flight_ret(tls, ret->sym, fret,
+			   posix_end > ret->posix_start ?
+			   posix_end - ret->posix_start : 0);
+		ovh_leave(tls);
+		if (nested)
+			tls_restore_call(tls, &outer);
+		tls->in_trace--;
+	} else {
+		err = ret->_errno;
+		rval = ret->u.u32[0];
 	}
+
+	(*__errno()) = err;
+	return rval;
 }
 
 /*
@@ -571,6 +600,19 @@ int __hidden wrap_symbol_noargs(struct tls_info *tls)
 	return 0;
 }
 
+/**
+ * @wrap_symbol_special
+ *
+ */
+int __hidden wrap_symbol_special(struct tls_info *tls)
+{
+	struct wrap_cache_entry *e;
+	e = get_cached_sym(&tls->info);
+	if (e)
+		return e->wrapsym;
+	return 0;
+}
+
 /**
  * @wrap_symbol_callstr
  *
@@ -637,15 +679,36 @@ int handle_exit(struct tls_info *tls)
 		return 0;
 	close_dvm_iface(&dvm);
 	flush_and_close(tls);
+	percpu_log_sync(1);
+	log_shards_flush(1);
+	container_sync(1);
 	clear_tls(1);
 	return 0;
 }
 
+/* clone() and the syscall stubs under fork() don't run atfork handlers */
+static inline int is_raw_clone(const char *sym)
+{
+	return (sym[0] == '_' && sym[1] == '_') ||
+	       local_strcmp("clone", sym) == 0;
+}
+
+/*
+ * fork(), and daemon(), system() or popen() when they fork, run the
+ * atfork handlers set up in init_tls(): our logs stay open, and the child
+ * resets its own state (see tls_init_child()). A vfork() child shares our
+ * memory until it execs. Only raw clones make us close up beforehand.
+ */
 int handle_fork(struct tls_info *tls)
 {
 	if (!tls->info.should_handle)
 		return 0;
+	if (tls_atfork_ready() && !is_raw_clone(tls->info.symbol))
+		return 0;
 	flush_and_close(tls);
+	percpu_log_sync(0);
+	log_shards_flush(0);
+	container_sync(0);
 	libc.forking = libc.getpid();
 	return 0;
 }
@@ -794,19 +857,14 @@ int handle_exec(struct tls_info *tls)
 
 	close_dvm_iface(&dvm);
 	flush_and_close(tls);
+	percpu_log_sync(1);
+	log_shards_flush(1);
+	container_sync(1);
 	clear_tls(1);
 
 	return 0;
 }
 
-int handle_pthread(struct tls_info *tls)
-{
-	if (!tls->info.should_handle)
-		return 0;
-	flush_and_close(tls);
-	return 0;
-}
-
 int handle_thread_exit(struct tls_info *tls)
 {
 	if (!tls->info.should_handle)
@@ -867,6 +925,7 @@ static void wrapped_sighandler(int sig, struct siginfo *siginfo, void *ctx)
 		return; /* I guess we eat this one... */
 
 	if (sig == s_special_sig) {
+		flight_signal(sig);
 		__flush_btlog();
 		libc_log("SIG:LOG_FLUSH:%d:%s:", sig, signame(sig));
 		libc.fflush(NULL); /* flush the entire process' buffers */
@@ -896,18 +955,18 @@ static int install_sighandler(struct log_info *info,
 	if (info->should_log) {
 		Dl_info dli;
 		void *f = get_log(0);
-		if (dladdr((void *)orig, &dli)) {
-			__log_print(&info->tv, f,
-				    "SIG", "HANDLE:%s[%p](%s@%p):%d:%s:",
-				    dli.dli_sname ? dli.dli_sname : "??",
-				    (void *)orig,
-				    dli.dli_fname ? dli.dli_fname : "xx",
-				    dli.dli_fbase ? dli.dli_fbase : (void *)0,
-				    sig, signame(sig));
+		if (syms_dladdr((void *)orig, &dli)) {
+			__log_print_event(info, f,
+					  "SIG", "HANDLE:%s[%p](%s@%p):%d:%s:",
+					  dli.dli_sname ? dli.dli_sname : "??",
+					  (void *)orig,
+					  dli.dli_fname ? dli.dli_fname : "xx",
+					  dli.dli_fbase ? dli.dli_fbase : (void *)0,
+					  sig, signame(sig));
 		} else {
-			__log_print(&info->tv, f,
-				    "SIG", "HANDLE:[%p]:%d:%s:",
-				    (void *)orig, sig, signame(sig));
+			__log_print_event(info, f,
+					  "SIG", "HANDLE:[%p]:%d:%s:",
+					  (void *)orig, sig, signame(sig));
 		}
 		log_flush(f);
 	}
@@ -1057,6 +1116,43 @@ int handle_opendir(struct tls_info *tls)
 	return 1;
 }
 
+/*
+ * Once a module is gone, another one can be loaded at its addresses:
+ * make sure the module map (and with it the symbol tables, see
+ * wrap_syms.h) is read again before the next lookup.
+ */
+int handle_dlclose(struct tls_info *tls)
+{
+	struct ret_ctx *ret;
+	int rval, err;
+	struct log_info *info;
+	int (*closefunc)(void *);
+
+	info = &tls->info;
+	if (!info->should_handle)
+		return 0;
+
+	/*
+	 * handles:
+	 * int dlclose(void *handle);
+	 */
+	closefunc = info->func;
+
+	safe_call(tls, err,
+		  rval = closefunc((void *)info->regs[0]);
+		 );
+	if (rval == 0)
+		maps_invalidate();
+
+	ret = get_retmem(NULL);
+	if (!ret)
+		BUG_MSG(0x4312, "No TLS return value!");
+	ret->sym = info->symbol;
+	ret->_errno = err;
+	ret->u.u32[0] = (uint32_t)rval;
+	return 1;
+}
+
 int handle_openat(struct tls_info *tls)
 {
 	struct ret_ctx *ret;
@@ -1274,9 +1370,11 @@ int handle_pipe(struct tls_info *tls)
 	} else if (info->symbol[1] == 'o') {
 		FILE *f;
 
-		/* popen forks! */
-		flush_and_close(tls);
-		libc.forking = libc.getpid();
+		/* popen forks! (see handle_fork()) */
+		if (!tls_atfork_ready()) {
+			flush_and_close(tls);
+			libc.forking = libc.getpid();
+		}
 
 		safe_call(tls, err,
 			  f = popenfunc((const char *)info->regs[0],
@@ -1475,7 +1573,7 @@ static inline int __maybe_grow_epfds(int fd)
 		int i, j;
 		int newsz = fd < (MIN_FDTABLE_SZ/2) ? MIN_FDTABLE_SZ : fd * 2;
 		struct epoll_fd_set *newtable;
-		newtable = (struct epoll_fd_set *)libc.malloc(newsz * sizeof(*newtable));
+		newtable = (struct epoll_fd_set *)walloc(newsz * sizeof(*newtable));
 		if (!newtable)
 			return -1;
 		/* set all fds to -1 initially */
@@ -1486,7 +1584,7 @@ static inline int __maybe_grow_epfds(int fd)
 		if (s_epfds_sz) { /* copy over the old table */
 			libc.memcpy(newtable, s_epfds, s_epfds_sz * sizeof(*newtable));
 			if (s_epfds)
-				libc.free(s_epfds);
+				wfree(s_epfds, s_epfds_sz * sizeof(*newtable));
 		}
 		s_epfds_sz = newsz;
 		s_epfds = (struct epoll_fd_set *)newtable;
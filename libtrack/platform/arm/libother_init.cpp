@@ -33,5 +33,10 @@ extern const char *progname;
 __attribute__((constructor)) static void __libc_preinit()
 {
 
+#ifdef WRAP_RT_GLUE
+	wrap_rt_glue_init();
+#else
 	init_libc_iface(&libc, LIBC_PATH);
+	wrap_eager_init();
+#endif
 }
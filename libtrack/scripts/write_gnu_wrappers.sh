@@ -66,7 +66,7 @@ function echo_wrapper()
     echo "{"
     echo "       struct timespec start, end;"
     echo "       static $ftype (*fn)($farg_signatures);"
-    echo "       __sync_fetch_and_add(&entered, 1);"
+    echo "       entered++;"
     echo "       if (fn == NULL)"
     echo "           *(void **)(&fn) = dlsym(RTLD_NEXT, \"$fname\");"
     echo "       if (fn == NULL){"
@@ -76,58 +76,58 @@ function echo_wrapper()
     if [ "$farg_names" = "void" -a "$ftype" = "void " ]; then
         echo "       if (entered == 1) {"
         echo "               _backtrace();"
-        echo "               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);"
+        echo "               _gettime(&start);"
         echo "               fn();"
-        echo "               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);"
+        echo "               _gettime(&end);"
         echo "               _timespec_sub(&end, &start);"
         echo "               _logtime(\"$fname\", end);"
         echo "       } else {"
         echo "               fn();"
         echo "       }"
         echo "out:"
-        echo "       __sync_fetch_and_sub(&entered, 1);"
+        echo "       entered--;"
     elif [ "$farg_names" = "void"  -a "$ftype" != "void " ]; then
         echo "       $ftype rval;"
         echo "       if (entered == 1) {"
         echo "               _backtrace();"
-        echo "               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);"
+        echo "               _gettime(&start);"
         echo "               rval = fn();"
-        echo "               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);"
+        echo "               _gettime(&end);"
         echo "               _timespec_sub(&end, &start);"
         echo "               _logtime(\"$fname\", end);"
         echo "       } else {"
         echo "               rval = fn();"
         echo "       }"
         echo "out:"
-        echo "       __sync_fetch_and_sub(&entered, 1);"
+        echo "       entered--;"
         echo "      return rval;"
     elif [ "$farg_names" != "void"  -a  "$ftype" = "void " ]; then
         echo "       if (entered == 1) {"
         echo "               _backtrace();"
-        echo "               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);"
+        echo "               _gettime(&start);"
         echo "               fn($farg_names);"
-        echo "               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);"
+        echo "               _gettime(&end);"
         echo "               _timespec_sub(&end, &start);"
         echo "               _logtime(\"$fname\", end);"
         echo "       } else {"
         echo "               fn($farg_names);"
         echo "       }"
         echo "out:"
-        echo "       __sync_fetch_and_sub(&entered, 1);"
+        echo "       entered--;"
     else
         echo "       $ftype rval;"
         echo "       if (entered == 1) {"
         echo "               _backtrace();"
-        echo "               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);"
+        echo "               _gettime(&start);"
         echo "               rval = fn($farg_names);"
-        echo "               clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);"
+        echo "               _gettime(&end);"
         echo "               _timespec_sub(&end, &start);"
         echo "               _logtime(\"$fname\", end);"
         echo "       } else {"
         echo "               rval = fn($farg_names);"
         echo "       }"
         echo "out:"
-        echo "       __sync_fetch_and_sub(&entered, 1);"
+        echo "       entered--;"
         echo "       return rval;"
     fi
     echo "}"
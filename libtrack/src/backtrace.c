@@ -13,6 +13,8 @@
 #include "wrap_lib.h"
 #include "backtrace.h"
 #include "java_backtrace.h"
+#include "wrap_alloc.h"
+#include "wrap_syms.h"
 
 //#define OUTPUT_CACHE_STATS
 
@@ -28,6 +30,11 @@ extern void wrap_symbol_mod(struct tls_info *tls);
  */
 #define FRAMES_TO_SKIP 2
 
+/* libc's backtrace() doesn't skip our own frames */
+#define bt_max_frames() \
+	(throttle_max_frames() + FRAMES_TO_SKIP < MAX_BT_FRAMES ? \
+	 throttle_max_frames() + FRAMES_TO_SKIP : MAX_BT_FRAMES)
+
 #define TLS_LOGBUF_SZ (LOG_BUFFER_SIZE \
 		       + (4 * sizeof(int)) \
 		       + (MAX_BT_FRAMES * sizeof(void *)))
@@ -35,6 +42,9 @@ _static char main_logbuffer[TLS_LOGBUF_SZ];
 
 _static struct bt_line_cache main_btcache;
 
+static struct wslab logbuf_slab = WSLAB_INIT("logbuf", TLS_LOGBUF_SZ);
+static struct wslab btcache_slab = WSLAB_INIT("btcache", sizeof(struct bt_line_cache));
+
 
 /*
  * TODO: add some locking, and make the cache global!
@@ -54,7 +64,7 @@ _static struct bt_line_cache *get_bt_line_cache(void)
 	if (is_main())
 		cache = &main_btcache;
 	else
-		cache = (struct bt_line_cache *)libc.malloc(sizeof(*cache));
+		cache = (struct bt_line_cache *)wslab_alloc(&btcache_slab);
 	if (!cache)
 		return NULL;
 	libc.memset(cache, 0, sizeof(*cache));
@@ -68,10 +78,47 @@ void __hidden tls_release_btcache(struct tls_info *tls)
 		return;
 
 	if (tls->btcache && tls->btcache != &main_btcache)
-		libc.free(tls->btcache);
+		wslab_free(&btcache_slab, tls->btcache);
 	tls->btcache = NULL;
 }
 
+#ifdef HAVE_EAGER_INIT
+/* write to each page of 'nr' objects of 'slab', and give them back */
+static void __prefault_slab(struct wslab *slab, size_t sz, int nr)
+{
+	void *obj[EAGER_PREFAULT_THREADS];
+	int i;
+
+	if (nr > EAGER_PREFAULT_THREADS)
+		nr = EAGER_PREFAULT_THREADS;
+	for (i = 0; i < nr; i++) {
+		obj[i] = wslab_alloc(slab);
+		if (!obj[i])
+			break;
+		libc.memset(obj[i], 0, sz);
+	}
+	while (i--)
+		wslab_free(slab, obj[i]);
+}
+
+/*
+ * Page in the log buffer and backtrace cache of the main thread (if we
+ * are the main thread, and 'tls', its context if it has one yet, hasn't
+ * used them), and those the next 'nr' threads will get, before anyone
+ * logs into them.
+ */
+void __hidden bt_prefault(struct tls_info *tls, int nr)
+{
+	if (is_main() && (!tls || !tls->logbuffer))
+		libc.memset(main_logbuffer, 0, sizeof(main_logbuffer));
+	if (is_main() && (!tls || !tls->btcache))
+		libc.memset(&main_btcache, 0, sizeof(main_btcache));
+
+	__prefault_slab(&logbuf_slab, TLS_LOGBUF_SZ, nr);
+	__prefault_slab(&btcache_slab, sizeof(struct bt_line_cache), nr);
+}
+#endif
+
 struct bt_line __hidden
 *bt_cache_fetch(void *sym, struct bt_line_cache **cache_out)
 {
@@ -136,7 +183,7 @@ _static int bt_setup_logbuffer(struct tls_info *tls, struct log_info *info)
 			buf = main_logbuffer;
 		} else {
 			tls->logbuffer = (void *)1;
-			buf = (char *)libc.malloc(TLS_LOGBUF_SZ);
+			buf = (char *)wslab_alloc(&logbuf_slab);
 		}
 
 		if (!buf) {
@@ -184,16 +231,34 @@ void __hidden tls_release_logbuffer(struct tls_info *tls)
 	if (!buf || buf == (void *)1)
 		return;
 
+	pos = __bt_logpos(buf);
+	if (tls_has_log(tls) && tls->info.log_pos == pos) {
+		cct_dump(tls);
+		ovh_report(tls);
+		/* report the tracer's own memory footprint */
+		struct walloc_stats st;
+		walloc_get_stats(&st);
+		bt_printf(tls, "LOG:MEM:%lu:%lu", st.mapped, st.active);
+	}
+
 	tls->logbuffer = NULL;
 
-	pos = __bt_logpos(buf);
-	if (tls->logfile && *pos > 0) {
-		__bt_flush(tls->logfile, __bt_logbuf(buf), pos);
-		log_flush(tls->logfile);
+	if (tls_has_log(tls) && *pos > 0) {
+		void *f;
+
+		ovh_enter(tls, OVH_IO);
+		if (!__bt_commit(tls, __bt_logbuf(buf), pos)) {
+			f = __bt_logfile(tls);
+			if (f) {
+				__bt_flush(f, __bt_logbuf(buf), pos);
+				log_flush(f);
+			}
+		}
+		ovh_leave(tls);
 	}
 
 	if (buf != main_logbuffer)
-		libc.free(buf);
+		wslab_free(&logbuf_slab, buf);
 	else
 		libc.memset(buf, 0, TLS_LOGBUF_SZ);
 
@@ -204,6 +269,26 @@ void __hidden tls_release_logbuffer(struct tls_info *tls)
 	tls->info.last_stack = NULL;
 }
 
+/*
+ * Prepare a (flushed) log buffer for use by another thread
+ */
+void __hidden tls_reset_logbuffer(struct tls_info *tls)
+{
+	char *buf;
+
+	buf = tls->logbuffer;
+	if (buf == (void *)1) {
+		tls->logbuffer = NULL;
+		return;
+	}
+	if (!buf)
+		return;
+
+	*__bt_logpos(buf) = 0;
+	*__bt_last_stack_depth(buf) = 0;
+	*__bt_last_stack_cnt(buf) = 0;
+}
+
 _static void print_info(struct tls_info *tls, int count, void *sym)
 {
 	unsigned long ofst;
@@ -245,7 +330,7 @@ _static void print_info(struct tls_info *tls, int count, void *sym)
 
 do_lookup:
 	libc.memset(&dli, 0, sizeof(dli));
-	dladdr(sym, &dli);
+	syms_dladdr(sym, &dli);
 
 	if (!dli.dli_saddr) {
 		c = '+';
@@ -332,7 +417,9 @@ std_backtrace(struct tls_info *tls)
 	libc.memset(&state, 0, sizeof(state));
 	state.f = tls->logfile;
 
-	state.count = libc.backtrace(frames, MAX_BT_FRAMES);
+	ovh_enter(tls, OVH_UNWIND);
+	state.count = libc.backtrace(frames, bt_max_frames());
+	ovh_leave(tls);
 
 	for (count = 0; count < state.count; count++)
 		state.frame[count].pc = frames[count];
@@ -372,7 +459,7 @@ _static _Unwind_Reason_Code trace_func(__unwind_context* context, void* arg)
 		state->nskip++;
 		return _URC_NO_REASON;
 	}
-	if (state->count >= MAX_BT_FRAMES)
+	if (state->count >= throttle_max_frames())
 		return _URC_END_OF_STACK;
 
 	frame = &state->frame[state->count];
@@ -425,7 +512,7 @@ _static _Unwind_Reason_Code trace_func(__unwind_context* context, void* arg)
 	state->recursion = 0;
 	state->count++;
 
-	if (state->count >= MAX_BT_FRAMES)
+	if (state->count >= throttle_max_frames())
 		return _URC_END_OF_STACK;
 	return _URC_NO_REASON;
 }
@@ -462,7 +549,9 @@ unwind_backtrace(struct tls_info *tls)
 	state.f = tls->logfile;
 	state.dvm_bt = &dvm_bt;
 
+	ovh_enter(tls, OVH_UNWIND);
 	libc._Unwind_Backtrace(trace_func, &state);
+	ovh_leave(tls);
 
 	/* check the backtrace to see if it's the same as the previous one */
 	if (*(info->last_stack_depth) == state.count) {
@@ -506,11 +595,148 @@ unwind_backtrace(struct tls_info *tls)
 	bt_printf(tls, "BT:STACKMEM:%d:", stack_sz);
 }
 
+#ifdef HAVE_CCT
+/* the same frames a backtrace would print, into the calling-context tree */
+_static void __attribute__((noinline))
+cct_backtrace(struct tls_info *tls)
+{
+	struct bt_state state;
+	void *frames[MAX_BT_FRAMES];
+	int count;
+
+	libc.memset(&state, 0, sizeof(state));
+	state.f = tls->logfile;
+
+	ovh_enter(tls, OVH_UNWIND);
+	if (libc.backtrace) {
+		state.count = libc.backtrace(frames, bt_max_frames());
+		for (count = 0; count < state.count; count++)
+			state.frame[count].pc = frames[count];
+	} else if (libc._Unwind_Backtrace) {
+		libc._Unwind_Backtrace(trace_func, &state);
+	}
+	ovh_leave(tls);
+
+	cct_enter(tls, &state);
+}
+#endif
+
+#ifdef HAVE_RAW_STACK
+#define RAW_STACK_SZ (RAW_STACK_KB * 1024)
+/* everything in a BT:RAW record but the stack */
+#define RAW_HDR_SZ   (96 + MAX_LINE_LEN + (REG_LR_IDX + 1) * 9)
+
+static const char b64_chars[] =
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+_static int b64_encode(char *dst, const uint8_t *src, int len)
+{
+	char *d = dst;
+	uint32_t v;
+
+	for (; len >= 3; len -= 3, src += 3) {
+		v = (src[0] << 16) | (src[1] << 8) | src[2];
+		*d++ = b64_chars[(v >> 18) & 0x3f];
+		*d++ = b64_chars[(v >> 12) & 0x3f];
+		*d++ = b64_chars[(v >> 6) & 0x3f];
+		*d++ = b64_chars[v & 0x3f];
+	}
+	if (len) {
+		v = src[0] << 16;
+		if (len > 1)
+			v |= src[1] << 8;
+		*d++ = b64_chars[(v >> 18) & 0x3f];
+		*d++ = b64_chars[(v >> 12) & 0x3f];
+		*d++ = len > 1 ? b64_chars[(v >> 6) & 0x3f] : '=';
+		*d++ = '=';
+	}
+	return d - dst;
+}
+
+/*
+ * Copy the caller's registers and the top of its stack into the log:
+ * the same state an unwinder would start from, without the unwinding.
+ */
+_static void __attribute__((noinline))
+raw_backtrace(struct tls_info *tls)
+{
+	struct log_info *info = &tls->info;
+	struct maps_thread *mt = &tls->maps;
+	const struct wmap_table *t;
+	uintptr_t sp = (uintptr_t)info->stack;
+	uint8_t *buf;
+	int i, n, len, max, remain = 0;
+
+	maps_lookup(info->regs[REG_LR_IDX], &t);
+	maps_log(tls, t);
+
+	if (sp < mt->stack_lo || sp >= mt->stack_hi) {
+		if (maps_stack_bounds(sp, &mt->stack_lo, &mt->stack_hi) < 0)
+			mt->stack_lo = mt->stack_hi = 0;
+	}
+	len = 0;
+	if (sp >= mt->stack_lo && sp < mt->stack_hi)
+		len = (int)(mt->stack_hi - sp);
+	if (len > RAW_STACK_SZ)
+		len = RAW_STACK_SZ;
+	max = (LOG_BUFFER_SIZE - RAW_HDR_SZ - info->tv_strlen) / 4 * 3;
+	if (len > max)
+		len = max;
+	len &= ~3;
+
+	buf = __bt_raw_print_start(tls, info->tv_strlen + RAW_HDR_SZ
+					+ (len / 3 + 1) * 4, &remain);
+	if (!buf)
+		return;
+
+	n = info->tv_strlen;
+	libc.memcpy(buf, info->tv_str, n);
+	n += libc.snprintf((char *)buf + n, remain - n, "BT:RAW:%u:%.*s:%lx:",
+			   mt->gen, MAX_LINE_LEN, info->symbol,
+			   (unsigned long)sp);
+	for (i = 0; i <= REG_LR_IDX; i++)
+		n += libc.snprintf((char *)buf + n, remain - n,
+				   i ? ",%x" : "%x", info->regs[i]);
+	n += libc.snprintf((char *)buf + n, remain - n, ":%d:", len);
+	/* the copy of the stack stands in for unwinding it */
+	ovh_enter(tls, OVH_UNWIND);
+	n += b64_encode((char *)buf + n, (const uint8_t *)sp, len);
+	ovh_leave(tls);
+	buf[n++] = ':';
+	buf[n++] = '\n';
+	buf[n++] = ' ';
+	__bt_raw_print_end(tls, n);
+}
+#endif
+
+#ifdef HAVE_CALLER_ONLY
+/* which module called us, and from where: no unwinding, no dladdr */
+_static void caller_backtrace(struct tls_info *tls)
+{
+	struct log_info *info = &tls->info;
+	const struct wmap_table *t;
+	const struct wmap *m;
+	uintptr_t lr = info->regs[REG_LR_IDX];
+
+	m = maps_lookup(lr, &t);
+	maps_log(tls, t);
+
+	if (m)
+		bt_printf(tls, "BT:CALLER:%u:%s:%d:%lx:", tls->maps.gen,
+			  info->symbol, (int)(m - t->ent),
+			  (unsigned long)(lr - m->start + m->offset));
+	else
+		bt_printf(tls, "BT:CALLER:%u:%s:-1:%lx:", tls->maps.gen,
+			  info->symbol, (unsigned long)lr);
+}
+#endif
+
 void __hidden __attribute__((noinline))
 log_backtrace(struct tls_info *tls)
 {
+	ovh_enter(tls, OVH_FORMAT);
 	if (bt_setup_logbuffer(tls, &tls->info) < 0)
-		return;
+		goto out;
 
 	/*
 	 * Use a cache/table to modify info->symbol based on the function
@@ -520,13 +746,35 @@ log_backtrace(struct tls_info *tls)
 	 */
 	wrap_symbol_mod(tls);
 
+#ifdef HAVE_RAW_STACK
+	if (tls->info.regs && tls->info.stack) {
+		raw_backtrace(tls);
+		goto out;
+	}
+#endif
+#ifdef HAVE_CALLER_ONLY
+	if (tls->info.regs) {
+		caller_backtrace(tls);
+		goto out;
+	}
+#endif
+#ifdef HAVE_CCT
+	if (libc.backtrace || libc._Unwind_Backtrace) {
+		cct_backtrace(tls);
+		goto out;
+	}
+#endif
+
 	/* TODO: maybe print out function arguments? */
 	if (libc.backtrace)
 		std_backtrace(tls);
 	else if (libc._Unwind_Backtrace)
 		unwind_backtrace(tls);
 	else if (tls->logfile)
-		__log_print(&tls->info.tv, tls->logfile, "CALL", "%s", tls->info.symbol);
+		__log_print_event(&tls->info, tls->logfile, "CALL", "%s",
+				  tls->info.symbol);
+out:
+	ovh_leave(tls);
 }
 
 uint8_t __hidden *
@@ -12,6 +12,7 @@
 #include <stdio.h>
 #include <sys/types.h>
 
+#include "wrap_alloc.h"
 #include "wrap_lib.h"
 #include "java_backtrace.h"
 
@@ -63,6 +64,8 @@ struct dvm_iface dvm __hidden;
 
 _static char main_dvmstack[TLS_DVM_STACK_SZ];
 
+static struct wslab dvmstack_slab = WSLAB_INIT("dvmstack", TLS_DVM_STACK_SZ);
+
 _static void *_find_symbol_end(void *sym_start)
 {
 	Dl_info dli;
@@ -227,6 +230,7 @@ do_dvm_bt:
 		uint32_t *fp = NULL;
 		char *tname;
 		struct Method **mlist;
+		size_t mlist_sz = 0;
 		int r;
 
 		self = dvm->dvmThreadSelf();
@@ -261,7 +265,8 @@ do_dvm_bt:
 			 * because the dvm fill stack array function
 			 * doesn't care how big our array really is...
 			 */
-			mlist = libc.malloc((dvm_bt->count + 1) * sizeof(struct Method *));
+			mlist_sz = (dvm_bt->count + 1) * sizeof(struct Method *);
+			mlist = (struct Method **)walloc(mlist_sz);
 			if (!mlist) {
 				dvm_bt->count = 0;
 				return;
@@ -281,7 +286,7 @@ do_dvm_bt:
 			/* copy only the portion of data back that fits */
 			libc.memcpy(dvm_bt->mlist, mlist,
 				    dvm_bt->count * sizeof(struct Method *));
-			libc.free(mlist);
+			wfree(mlist, mlist_sz);
 		}
 	}
 
@@ -300,7 +305,7 @@ _static char *__setup_dvmstack(struct tls_info *tls, int **last_depth,
 		if (is_main())
 			last_stack = main_dvmstack;
 		else
-			last_stack = (char *)libc.malloc(TLS_DVM_STACK_SZ);
+			last_stack = (char *)wslab_alloc(&dvmstack_slab);
 		if (!last_stack)
 			return NULL;
 		libc.memset(last_stack, 0, TLS_DVM_STACK_SZ);
@@ -329,7 +334,7 @@ void __hidden tls_release_dvmstack(struct tls_info *tls)
 	libc.memset(stack, 0, TLS_DVM_STACK_SZ);
 
 	if (stack != main_dvmstack)
-		libc.free(tls->dvmstack);
+		wslab_free(&dvmstack_slab, tls->dvmstack);
 
 	tls->dvmstack = NULL;
 }
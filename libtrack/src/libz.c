@@ -49,6 +49,9 @@ void init_zlib_iface(struct zlib_iface *zlib, const char *path)
 
 #undef init_sym
 
+	if (!zlib->compress2)
+		zlib->compress2 = (typeof (zlib->compress2))dlsym(zlib->dso, "compress2");
+
 	zlib->valid = 1;
 	return;
 
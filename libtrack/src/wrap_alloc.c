@@ -0,0 +1,212 @@
+/*
+ * wrap_alloc.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * mmap-backed slab allocator for tracer-internal state (see wrap_alloc.h)
+ */
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+
+#include "wrap_lib.h"
+#include "wrap_alloc.h"
+
+#ifndef PAGE_SIZE
+#define PAGE_SIZE 4096
+#endif
+
+#define WALLOC_ALIGN      16
+#define WSLAB_CHUNK_SZ    (64 * 1024)
+
+/* power-of-two size classes for walloc(): 16 bytes .. 4k */
+#define WALLOC_MIN_SHIFT  4
+#define WALLOC_MAX_SHIFT  12
+#define WALLOC_NR_CLASSES (WALLOC_MAX_SHIFT - WALLOC_MIN_SHIFT + 1)
+
+#define __align(x, a) (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+static volatile int s_walloc_lock;
+static struct wslab *s_slabs;
+
+/* mappings made directly by walloc() for large requests */
+static unsigned long s_large_mapped;
+
+static struct wslab s_classes[WALLOC_NR_CLASSES] = {
+	WSLAB_INIT("walloc-16", 16),
+	WSLAB_INIT("walloc-32", 32),
+	WSLAB_INIT("walloc-64", 64),
+	WSLAB_INIT("walloc-128", 128),
+	WSLAB_INIT("walloc-256", 256),
+	WSLAB_INIT("walloc-512", 512),
+	WSLAB_INIT("walloc-1k", 1024),
+	WSLAB_INIT("walloc-2k", 2048),
+	WSLAB_INIT("walloc-4k", 4096),
+};
+
+static inline void walloc_lock(void)
+{
+	while (__sync_lock_test_and_set(&s_walloc_lock, 1))
+		while (s_walloc_lock)
+			;
+}
+
+static inline void walloc_unlock(void)
+{
+	__sync_lock_release(&s_walloc_lock);
+}
+
+static void *__map(size_t size)
+{
+	void *p;
+
+	if (!libc.mmap)
+		return NULL;
+	p = libc.mmap(NULL, size, PROT_READ | PROT_WRITE,
+		      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED)
+		return NULL;
+	return p;
+}
+
+/* caller must hold s_walloc_lock */
+static int wslab_grow(struct wslab *slab)
+{
+	size_t sz;
+	char *chunk;
+
+	/*
+	 * small objects are carved out of 64k chunks, big ones
+	 * (log buffers, backtrace caches) get a mapping of their own
+	 */
+	if (slab->objsz < WSLAB_CHUNK_SZ)
+		sz = WSLAB_CHUNK_SZ - (WSLAB_CHUNK_SZ % slab->objsz);
+	else
+		sz = slab->objsz;
+	sz = __align(sz, PAGE_SIZE);
+
+	chunk = (char *)__map(sz);
+	if (!chunk)
+		return -1;
+
+	slab->chunk = chunk;
+	slab->chunk_left = sz;
+	slab->mapped += sz;
+
+	if (!slab->registered) {
+		slab->registered = 1;
+		slab->next = s_slabs;
+		s_slabs = slab;
+	}
+	return 0;
+}
+
+void __hidden *wslab_alloc(struct wslab *slab)
+{
+	void *p = NULL;
+
+	walloc_lock();
+
+	if (slab->objsz < sizeof(void *))
+		slab->objsz = sizeof(void *);
+	slab->objsz = __align(slab->objsz, WALLOC_ALIGN);
+
+	if (slab->freelist) {
+		p = slab->freelist;
+		slab->freelist = *(void **)p;
+		goto out;
+	}
+
+	if (slab->chunk_left < slab->objsz && wslab_grow(slab) < 0)
+		goto out_unlock;
+
+	p = slab->chunk;
+	slab->chunk += slab->objsz;
+	slab->chunk_left -= slab->objsz;
+	slab->nr_objs++;
+
+out:
+	slab->nr_active++;
+out_unlock:
+	walloc_unlock();
+	return p;
+}
+
+void __hidden wslab_free(struct wslab *slab, void *ptr)
+{
+	if (!ptr)
+		return;
+
+	walloc_lock();
+	*(void **)ptr = slab->freelist;
+	slab->freelist = ptr;
+	slab->nr_active--;
+	walloc_unlock();
+}
+
+static inline struct wslab *size_class(size_t size)
+{
+	int i;
+
+	for (i = 0; i < WALLOC_NR_CLASSES; i++) {
+		if (size <= ((size_t)1 << (i + WALLOC_MIN_SHIFT)))
+			return &s_classes[i];
+	}
+	return NULL;
+}
+
+void __hidden *walloc(size_t size)
+{
+	struct wslab *slab;
+	void *p;
+
+	slab = size_class(size);
+	if (slab)
+		return wslab_alloc(slab);
+
+	size = __align(size, PAGE_SIZE);
+	p = __map(size);
+	if (p)
+		__sync_fetch_and_add(&s_large_mapped, size);
+	return p;
+}
+
+void __hidden wfree(void *ptr, size_t size)
+{
+	struct wslab *slab;
+
+	if (!ptr)
+		return;
+
+	slab = size_class(size);
+	if (slab) {
+		wslab_free(slab, ptr);
+		return;
+	}
+
+	size = __align(size, PAGE_SIZE);
+	if (libc.munmap)
+		libc.munmap(ptr, size);
+	__sync_fetch_and_sub(&s_large_mapped, size);
+}
+
+void __hidden walloc_get_stats(struct walloc_stats *st)
+{
+	struct wslab *slab;
+
+	st->mapped = s_large_mapped;
+	st->active = s_large_mapped;
+	st->nr_slabs = 0;
+
+	walloc_lock();
+	for (slab = s_slabs; slab; slab = slab->next) {
+		st->mapped += slab->mapped;
+		st->active += slab->nr_active * slab->objsz;
+		st->nr_slabs++;
+	}
+	walloc_unlock();
+}
+
+void __hidden walloc_init_child(void)
+{
+	s_walloc_lock = 0;
+}
@@ -0,0 +1,497 @@
+/*
+ * wrap_budget.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Log rotation policy and the LOGFILE_PATH disk budget (see wrap_budget.h)
+ */
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "wrap_lib.h"
+#include "wrap_tls.h"
+#include "wrap_alloc.h"
+#include "wrap_budget.h"
+
+#define MB (1024ULL * 1024ULL)
+
+#ifndef CLOCK_BOOTTIME
+#define CLOCK_BOOTTIME 7
+#endif
+#define PROC_HZ 100   /* USER_HZ: the unit of /proc/<pid>/stat times */
+
+/* a file that can go, see __trim() */
+struct log_old {
+	char     name[TLS_MAX_STRING_LEN];  /* in LOGFILE_PATH */
+	uint64_t size;
+	time_t   mtime;
+	int      ours;                      /* closed here: check our fds */
+};
+
+struct log_budget {
+	volatile int state;         /* 0 = defaults, 1 = reading, 2 = read */
+	uint64_t rotate_bytes;
+	uint32_t rotate_ms;
+	uint64_t budget_bytes;
+	volatile int over;          /* last check found us over budget */
+
+	/* s_stats_lock: what __trim() found, and what we wrote since */
+	volatile int trimming;
+	uint64_t total;             /* bytes in LOGFILE_PATH */
+	uint64_t since;             /* bytes we wrote during a scan */
+	uint64_t scanned_ms;
+	int nr_old;
+	struct log_old old[LOG_BUDGET_MAX_OLD];  /* oldest first */
+};
+
+/* our own open files, read from /proc/self/fd once per __trim() */
+struct log_fds {
+	int nr;
+	int all;                    /* 0: too many to tell */
+	struct {
+		dev_t dev;
+		ino_t ino;
+	} ent[LOG_BUDGET_MAX_FDS];
+};
+
+static struct log_budget s_budget = {
+	0, LOG_ROTATE_MB * MB, LOG_ROTATE_SEC * 1000, LOG_BUDGET_MB * MB, 0,
+};
+
+static struct log_stats s_stats;
+static pthread_mutex_t s_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+
+uint64_t __hidden log_now_ms(void)
+{
+	struct timeval tv;
+
+	libc.gettimeofday(&tv, NULL);
+	return (uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+/* <rotate MB>:<rotate sec>:<budget MB> */
+static void __read_cfg(struct log_budget *b)
+{
+	char buf[64];
+	char *p, *end;
+	long val;
+	FILE *f;
+
+	f = libc.fopen(LOG_BUDGET_CFG_PATH, "r");
+	if (!f)
+		return;
+	libc.memset(buf, 0, sizeof(buf));
+	if (libc.fread(buf, 1, sizeof(buf) - 1, f) <= 0)
+		goto out;
+
+	p = buf;
+	val = libc.strtol(p, &end, 10);
+	if (end != p && val >= 0)
+		b->rotate_bytes = (uint64_t)val * MB;
+	if (*end != ':')
+		goto out;
+	p = end + 1;
+	val = libc.strtol(p, &end, 10);
+	if (end != p && val >= 0)
+		b->rotate_ms = (uint32_t)val * 1000;
+	if (*end != ':')
+		goto out;
+	p = end + 1;
+	val = libc.strtol(p, &end, 10);
+	if (end != p && val >= 0)
+		b->budget_bytes = (uint64_t)val * MB;
+out:
+	libc.fclose(f);
+}
+
+static inline struct log_budget *__budget(void)
+{
+	struct log_budget *b = &s_budget;
+
+	if (once_begin(&b->state)) {
+		__read_cfg(b);
+		once_end(&b->state);
+	}
+	return b;
+}
+
+int __hidden log_should_rotate(uint64_t size, uint64_t opened_ms)
+{
+	struct log_budget *b = __budget();
+
+	if (b->rotate_bytes && size >= b->rotate_bytes)
+		return 1;
+	if (b->rotate_ms && opened_ms &&
+	    log_now_ms() - opened_ms >= b->rotate_ms)
+		return 1;
+	return 0;
+}
+
+/*
+ * When process 'pid' started, in seconds since the epoch: 0 if it isn't
+ * running, -1 if we can't tell.
+ */
+static time_t __started(long pid)
+{
+	unsigned long long ticks = 0;
+	struct timespec boot;
+	char buf[512];
+	const char *p;
+	int fd, n, field;
+
+	libc.snprintf(buf, sizeof(buf), "/proc/%ld/stat", pid);
+	fd = libc.open(buf, O_RDONLY);
+	if (fd < 0)
+		return *__errno() == ENOENT ? 0 : -1;
+	n = (int)libc.pread(fd, buf, sizeof(buf) - 1, 0);
+	libc.close(fd);
+	if (n <= 0)
+		return -1;
+	buf[n] = 0;
+
+	/* the name can hold anything: count fields from its ')' */
+	p = local_strrchr(buf, ')');
+	if (!p)
+		return -1;
+	for (field = 2; *p && field < 22; p++) {
+		if (*p == ' ')
+			field++;
+	}
+	if (*p < '0' || *p > '9')
+		return -1;
+	while (*p >= '0' && *p <= '9')
+		ticks = ticks * 10 + (unsigned long long)(*p++ - '0');
+
+	if (!libc.clock_gettime ||
+	    libc.clock_gettime(CLOCK_BOOTTIME, &boot) < 0)
+		return -1;
+	return (time_t)(log_now_ms() / 1000) - boot.tv_sec +
+	       (time_t)(ticks / PROC_HZ);
+}
+
+/* the files we have open (rotated segments of ours are closed) */
+static struct log_fds *__open_fds(void)
+{
+	char path[64];
+	struct log_fds *fds;
+	struct dirent *de;
+	struct stat fst;
+	DIR *dir;
+
+	fds = (struct log_fds *)walloc(sizeof(*fds));
+	if (!fds)
+		return NULL;
+	fds->nr = 0;
+	fds->all = 0;
+	dir = libc.opendir("/proc/self/fd");
+	if (!dir)
+		return fds;
+	fds->all = 1;
+	while ((de = libc.readdir(dir)) != NULL) {
+		if (de->d_name[0] < '0' || de->d_name[0] > '9')
+			continue;
+		libc.snprintf(path, sizeof(path), "/proc/self/fd/%s",
+			      de->d_name);
+		if (libc.stat(path, &fst) < 0 || !S_ISREG(fst.st_mode))
+			continue;
+		if (fds->nr == LOG_BUDGET_MAX_FDS) {
+			fds->all = 0;
+			break;
+		}
+		fds->ent[fds->nr].dev = fst.st_dev;
+		fds->ent[fds->nr].ino = fst.st_ino;
+		fds->nr++;
+	}
+	libc.closedir(dir);
+	return fds;
+}
+
+static int __open_here(struct log_fds **fdsp, struct stat *st)
+{
+	struct log_fds *fds = *fdsp;
+	int i;
+
+	if (!fds)
+		fds = *fdsp = __open_fds();
+	if (!fds || !fds->all)
+		return 1;
+	for (i = 0; i < fds->nr; i++) {
+		if (fds->ent[i].dev == st->st_dev &&
+		    fds->ent[i].ino == st->st_ino)
+			return 1;
+	}
+	return 0;
+}
+
+/*
+ * Is anyone still writing to this file? Its process may still have it
+ * open, however long ago it was written: it's only done once that
+ * process is gone, or once its pid belongs to a process that started
+ * after the last write. Our own files are done once we've closed them.
+ */
+static int __in_use(const char *name, struct stat *st, struct log_fds **fdsp)
+{
+	time_t started;
+	long pid;
+	char *end;
+
+	pid = libc.strtol(name, &end, 10);
+	if (end == name || *end != '.' || pid <= 0)
+		return 1; /* not ours */
+	if (libc.getpid && pid == (long)libc.getpid())
+		return __open_here(fdsp, st);
+	if (libc.kill && libc.kill((pid_t)pid, 0) < 0 && *__errno() == ESRCH)
+		return 0;
+	started = __started(pid);
+	if (started == 0)
+		return 0;
+	if (started > 0 && started > st->st_mtime + LOG_BUDGET_CLOCK_SLACK)
+		return 0;
+	return 1;
+}
+
+/* keep 'old' sorted oldest first, and only the oldest 'max' of them */
+static void __add_old(struct log_old *old, int *nr, int max,
+		      const char *name, uint64_t size, time_t mtime, int ours)
+{
+	int i = *nr;
+
+	if (i == max) {
+		if (mtime >= old[max - 1].mtime)
+			return;
+		i--;
+	} else {
+		(*nr)++;
+	}
+	for (; i > 0 && old[i - 1].mtime > mtime; i--)
+		old[i] = old[i - 1];
+	libc.snprintf(old[i].name, sizeof(old[i].name), "%s", name);
+	old[i].size = size;
+	old[i].mtime = mtime;
+	old[i].ours = ours;
+}
+
+/*
+ * Add up what LOGFILE_PATH uses, and list the least recently modified
+ * files that can go. Only "<pid>.*" files are counted: configuration and
+ * trigger files stay.
+ */
+static void __scan(struct log_budget *b, struct log_fds **fdsp)
+{
+	struct log_old *old;
+	struct dirent *de;
+	struct stat st;
+	char path[TLS_MAX_STRING_LEN];
+	uint64_t total = 0, size;
+	int nr = 0;
+	DIR *dir;
+
+	old = (struct log_old *)walloc(sizeof(b->old));
+	if (!old)
+		return;
+	dir = libc.opendir(LOGFILE_PATH);
+	if (!dir) {
+		wfree(old, sizeof(b->old));
+		return;
+	}
+
+	mtx_lock(&s_stats_lock);
+	b->since = 0;
+	mtx_unlock(&s_stats_lock);
+
+	while ((de = libc.readdir(dir)) != NULL) {
+		if (de->d_name[0] < '0' || de->d_name[0] > '9')
+			continue;
+		libc.snprintf(path, sizeof(path), "%s/%s",
+			      LOGFILE_PATH, de->d_name);
+		if (libc.stat(path, &st) < 0 || !S_ISREG(st.st_mode))
+			continue;
+		/* blocks: preallocated segments count in full */
+		size = (uint64_t)st.st_blocks * 512;
+		total += size;
+		if (__in_use(de->d_name, &st, fdsp))
+			continue;
+		__add_old(old, &nr, LOG_BUDGET_MAX_OLD, de->d_name, size,
+			  st.st_mtime, 0);
+	}
+	libc.closedir(dir);
+
+	mtx_lock(&s_stats_lock);
+	b->total = total + b->since;
+	libc.memcpy(b->old, old, nr * sizeof(*old));
+	b->nr_old = nr;
+	b->scanned_ms = log_now_ms();
+	mtx_unlock(&s_stats_lock);
+	wfree(old, sizeof(b->old));
+}
+
+/* delete the oldest files we know can go, while we're over budget */
+static void __delete_old(struct log_budget *b, struct log_fds **fdsp)
+{
+	char path[TLS_MAX_STRING_LEN];
+	struct log_old o;
+	struct stat st;
+	int i, more;
+
+	for (;;) {
+		mtx_lock(&s_stats_lock);
+		more = b->total > b->budget_bytes && b->nr_old > 0;
+		if (more) {
+			o = b->old[0];
+			b->nr_old--;
+			for (i = 0; i < b->nr_old; i++)
+				b->old[i] = b->old[i + 1];
+		}
+		mtx_unlock(&s_stats_lock);
+		if (!more)
+			break;
+
+		libc.snprintf(path, sizeof(path), "%s/%s", LOGFILE_PATH, o.name);
+		if (o.ours) {
+			/* another library of ours may still write to it */
+			if (libc.stat(path, &st) < 0 || __open_here(fdsp, &st))
+				continue;
+			o.size = (uint64_t)st.st_blocks * 512;
+		}
+		if (libc.unlink(path) < 0)
+			continue;
+		mtx_lock(&s_stats_lock);
+		b->total = b->total > o.size ? b->total - o.size : 0;
+		mtx_unlock(&s_stats_lock);
+	}
+}
+
+/*
+ * Bring LOGFILE_PATH back within budget: first with the files we already
+ * know can go, then, if that wasn't enough or it's been a while, with a
+ * new count of the directory. One process at a time: everyone else goes
+ * by their last result.
+ */
+static void __trim(struct log_budget *b)
+{
+	struct log_fds *fds = NULL;
+	uint64_t now;
+	int lockfd, rescan;
+
+	lockfd = libc.open(LOG_BUDGET_LOCK_PATH, O_RDWR | O_CREAT, 0666);
+	if (lockfd < 0)
+		return;
+	libc.fchmod(lockfd, 0666);
+	if (libc.flock(lockfd, LOCK_EX | LOCK_NB) < 0) {
+		libc.close(lockfd);
+		return;
+	}
+
+	__delete_old(b, &fds);
+	now = log_now_ms();
+	mtx_lock(&s_stats_lock);
+	rescan = b->total > b->budget_bytes || !b->scanned_ms ||
+		 now - b->scanned_ms >= LOG_BUDGET_RESCAN_MS;
+	mtx_unlock(&s_stats_lock);
+	if (rescan) {
+		__scan(b, &fds);
+		__delete_old(b, &fds);
+	}
+	mtx_lock(&s_stats_lock);
+	b->over = b->total > b->budget_bytes;
+	mtx_unlock(&s_stats_lock);
+
+	if (fds)
+		wfree(fds, sizeof(*fds));
+	libc.flock(lockfd, LOCK_UN);
+	libc.close(lockfd);
+}
+
+static void *__trim_thread(void *arg)
+{
+	struct log_budget *b = (struct log_budget *)arg;
+
+	/* nothing this thread calls should be traced */
+	__set_wrapping();
+	__trim(b);
+	__sync_lock_release(&b->trimming);
+	return NULL;
+}
+
+/*
+ * Called as files are opened and rotated, by threads we trace: all that
+ * costs anything (reading the directory and /proc, deleting files) is
+ * left to a thread of its own.
+ */
+int __hidden log_budget_enforce(void)
+{
+	struct log_budget *b = __budget();
+	pthread_t thread;
+	uint64_t now;
+	int kick;
+
+	if (!b->budget_bytes)
+		return 0;
+	if (!libc.opendir || !libc.readdir || !libc.closedir ||
+	    !libc.stat || !libc.unlink || !libc.open || !libc.flock ||
+	    !libc.pthread_create || !libc.pthread_detach)
+		return 0;
+
+	now = log_now_ms();
+	mtx_lock(&s_stats_lock);
+	kick = b->total > b->budget_bytes || !b->scanned_ms ||
+	       now - b->scanned_ms >= LOG_BUDGET_RESCAN_MS;
+	mtx_unlock(&s_stats_lock);
+
+	if (kick && !__sync_lock_test_and_set(&b->trimming, 1)) {
+		if (libc.pthread_create(&thread, NULL, __trim_thread, b) == 0)
+			libc.pthread_detach(thread);
+		else
+			__sync_lock_release(&b->trimming);
+	}
+	return b->over ? -1 : 0;
+}
+
+void __hidden log_budget_closed(const char *path, uint64_t size)
+{
+	struct log_budget *b = &s_budget;
+	const char *name;
+
+	name = local_strrchr(path, '/');
+	name = name ? name + 1 : path;
+	mtx_lock(&s_stats_lock);
+	__add_old(b->old, &b->nr_old, LOG_BUDGET_MAX_OLD, name, size,
+		  (time_t)(log_now_ms() / 1000), 1);
+	mtx_unlock(&s_stats_lock);
+}
+
+void __hidden log_account(uint64_t written, uint64_t dropped)
+{
+	mtx_lock(&s_stats_lock);
+	s_stats.written += written;
+	s_stats.dropped += dropped;
+	s_budget.total += written;
+	s_budget.since += written;
+	mtx_unlock(&s_stats_lock);
+}
+
+void __hidden log_get_stats(struct log_stats *st)
+{
+	mtx_lock(&s_stats_lock);
+	*st = s_stats;
+	mtx_unlock(&s_stats_lock);
+}
+
+/*
+ * The child starts counting from zero, and with a fresh lock. Our
+ * trimming thread isn't there, and our closed files aren't its own.
+ */
+void __hidden log_budget_init_child(void)
+{
+	static const pthread_mutex_t init = PTHREAD_MUTEX_INITIALIZER;
+
+	libc.memcpy(&s_stats_lock, &init, sizeof(init));
+	libc.memset(&s_stats, 0, sizeof(s_stats));
+	s_budget.trimming = 0;
+	s_budget.since = 0;
+	s_budget.scanned_ms = 0;
+	s_budget.nr_old = 0;
+}
@@ -0,0 +1,197 @@
+/*
+ * wrap_callers.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Filter traced calls by the library that made them (see wrap_callers.h)
+ */
+#include <sys/types.h>
+
+#include "wrap_lib.h"
+#include "wrap_alloc.h"
+#include "wrap_maps.h"
+#include "wrap_callers.h"
+
+#define CALLERS_CFG_SZ (CALLERS_MAX * (CALLERS_NAME_LEN + 8))
+
+struct callers_rule {
+	char name[CALLERS_NAME_LEN];
+	int  allow;
+};
+
+struct callers_cfg {
+	volatile int state;         /* 0 = not read, 1 = reading, 2 = read */
+	int nr;
+	int nr_allow;
+	struct callers_rule rule[CALLERS_MAX];
+};
+
+/*
+ * What to do with calls from each mapping of one module map. Like the
+ * maps themselves, old views are never freed.
+ */
+struct callers_view {
+	const struct wmap_table *t;
+	uint8_t skip[0];
+};
+
+static struct callers_cfg s_callers;
+static struct callers_view * volatile s_view;
+static volatile int s_view_busy;
+
+static void __read_cfg(struct callers_cfg *c)
+{
+	struct callers_rule *r;
+	char *buf, *p, *name;
+	int n, i, allow;
+	FILE *f;
+
+	f = libc.fopen(CALLERS_CFG_PATH, "r");
+	if (!f)
+		return;
+	buf = (char *)walloc(CALLERS_CFG_SZ);
+	if (!buf)
+		goto out;
+	n = libc.fread(buf, 1, CALLERS_CFG_SZ - 1, f);
+	if (n <= 0)
+		goto out_free;
+	buf[n] = 0;
+
+	for (p = buf; *p && c->nr < CALLERS_MAX; ) {
+		while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
+			p++;
+		if (local_strncmp(p, "allow", 5) == 0)
+			allow = 1, p += 5;
+		else if (local_strncmp(p, "deny", 4) == 0)
+			allow = 0, p += 4;
+		else
+			allow = -1;
+		name = p;
+		if (allow >= 0) {
+			while (*p == ' ' || *p == '\t')
+				p++;
+			name = p;
+		}
+		while (*p && *p != '\n' && *p != '\r' &&
+		       *p != ' ' && *p != '\t')
+			p++;
+		if (allow < 0 || p == name) {
+			while (*p && *p != '\n')
+				p++;
+			continue;
+		}
+
+		r = &c->rule[c->nr];
+		for (i = 0; name + i < p && i < CALLERS_NAME_LEN - 1; i++)
+			r->name[i] = name[i];
+		r->name[i] = 0;
+		r->allow = allow;
+		c->nr_allow += allow;
+		c->nr++;
+		while (*p && *p != '\n')
+			p++;
+	}
+
+out_free:
+	wfree(buf, CALLERS_CFG_SZ);
+out:
+	libc.fclose(f);
+}
+
+/* a name with a '/' in it is a path, anything else a file name */
+static int __match(const struct callers_rule *r, const char *path)
+{
+	const char *base;
+
+	if (local_strrchr(r->name, '/'))
+		return local_strcmp(r->name, path) == 0;
+	base = local_strrchr(path, '/');
+	return local_strcmp(r->name, base ? base + 1 : path) == 0;
+}
+
+static int __skip(const struct callers_cfg *c, const char *path)
+{
+	int i, allowed = 0;
+
+	for (i = 0; i < c->nr; i++) {
+		if (!__match(&c->rule[i], path))
+			continue;
+		if (!c->rule[i].allow)
+			return 1;
+		allowed = 1;
+	}
+	return c->nr_allow && !allowed;
+}
+
+static struct callers_view *__view(const struct callers_cfg *c,
+				   const struct wmap_table *t)
+{
+	struct callers_view *v;
+	int i;
+
+	/* never wait: the builder may be the code we interrupted */
+	if (__sync_lock_test_and_set(&s_view_busy, 1))
+		return NULL;
+	v = s_view;
+	if (v && v->t == t)
+		goto out;
+	v = (struct callers_view *)walloc(sizeof(*v) + t->count);
+	if (!v)
+		goto out;
+	v->t = t;
+	for (i = 0; i < t->count; i++)
+		v->skip[i] = __skip(c, t->ent[i].path);
+	__sync_synchronize();
+	s_view = v;
+out:
+	__sync_lock_release(&s_view_busy);
+	return v;
+}
+
+/*
+ * Before the recursion guard: no locks, no allocations, no files. Only
+ * the config and view already published are looked at.
+ */
+int __hidden callers_skip(uintptr_t lr)
+{
+	struct callers_cfg *c = &s_callers;
+	struct callers_view *v = s_view;
+	const struct wmap *m;
+
+	if (c->state != 2)
+		return -1;
+	if (!c->nr)
+		return 0;
+	if (!v || v->t != maps_get())
+		return -1;
+	m = maps_find(v->t, lr);
+	if (!m)
+		return -1;
+	return v->skip[m - v->t->ent];
+}
+
+int __hidden callers_check(uintptr_t lr)
+{
+	struct callers_cfg *c = &s_callers;
+	const struct wmap_table *t;
+	const struct wmap *m;
+	struct callers_view *v;
+
+	if (once_try(&c->state)) {
+		__read_cfg(c);
+		once_end(&c->state);
+	}
+	/* someone else is still reading it: trace until it's ready */
+	if (c->state != 2 || !c->nr)
+		return 0;
+
+	m = maps_lookup(lr, &t);
+	if (!m)
+		return c->nr_allow > 0;
+
+	v = s_view;
+	if (!v || v->t != t)
+		v = __view(c, t);
+	if (!v)
+		return 0;
+	return v->skip[m - t->ent];
+}
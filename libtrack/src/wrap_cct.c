@@ -0,0 +1,299 @@
+/*
+ * wrap_cct.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Per-thread calling-context tree (see wrap_cct.h)
+ */
+#ifdef HAVE_CCT
+
+#include <dlfcn.h>
+#include <sys/types.h>
+
+#include "wrap_lib.h"
+#include "wrap_tls.h"
+#include "wrap_alloc.h"
+#include "wrap_cct.h"
+#include "wrap_syms.h"
+#include "backtrace.h"
+
+extern int local_strcmp(const char *s1, const char *s2);
+
+struct cct_node {
+	uintptr_t   pc;
+	const char *sym;            /* wrapped calls (leaves) only */
+	uint32_t    parent;
+	uint32_t    next;           /* hash chain (0 ends it: that's the root) */
+	uint32_t    calls;
+	uint64_t    ns;
+};
+
+struct cct_names {
+	struct cct_names *next;
+	size_t used;
+	char buf[];
+};
+
+struct cct {
+	pid_t pid;                  /* a forked child doesn't log our tree */
+	uint32_t nr, cap;
+	uint32_t leaf;              /* the call in progress */
+	struct cct_node *nodes;
+	uint32_t *hash;             /* 2 * cap buckets */
+	struct cct_names *names;
+};
+
+static inline uint32_t __str_hash(const char *s)
+{
+	uint32_t h = 2166136261u;
+
+	while (*s)
+		h = (h ^ (uint8_t)*s++) * 16777619u;
+	return h;
+}
+
+static inline uint32_t __bucket(struct cct *c, uint32_t parent,
+				uintptr_t pc, const char *sym)
+{
+	uint32_t h = sym ? __str_hash(sym) : (uint32_t)pc;
+
+	h ^= parent * 0x9e3779b1u;
+	h ^= h >> 15;
+	return h & (2 * c->cap - 1);
+}
+
+static int __grow(struct cct *c)
+{
+	struct cct_node *nodes;
+	uint32_t *hash, i, b, cap = c->cap ? 2 * c->cap : CCT_INIT_NODES;
+
+	if (cap > CCT_MAX_NODES)
+		return -1;
+	nodes = (struct cct_node *)walloc(cap * sizeof(*nodes));
+	hash = (uint32_t *)walloc(2 * cap * sizeof(*hash));
+	if (!nodes || !hash) {
+		if (nodes)
+			wfree(nodes, cap * sizeof(*nodes));
+		if (hash)
+			wfree(hash, 2 * cap * sizeof(*hash));
+		return -1;
+	}
+
+	if (c->nodes) {
+		libc.memcpy(nodes, c->nodes, c->nr * sizeof(*nodes));
+		wfree(c->nodes, c->cap * sizeof(*nodes));
+		wfree(c->hash, 2 * c->cap * sizeof(*hash));
+	}
+	c->nodes = nodes;
+	c->hash = hash;
+	c->cap = cap;
+
+	libc.memset(hash, 0, 2 * cap * sizeof(*hash));
+	for (i = 1; i < c->nr; i++) {
+		b = __bucket(c, nodes[i].parent, nodes[i].pc, nodes[i].sym);
+		nodes[i].next = hash[b];
+		hash[b] = i;
+	}
+	return 0;
+}
+
+static const char *__intern(struct cct *c, const char *sym)
+{
+	struct cct_names *n = c->names;
+	size_t len = local_strlen(sym) + 1;
+	char *s;
+
+	if (len > CCT_NAMES_SZ - sizeof(*n))
+		return NULL;
+	if (!n || n->used + len > CCT_NAMES_SZ - sizeof(*n)) {
+		n = (struct cct_names *)walloc(CCT_NAMES_SZ);
+		if (!n)
+			return NULL;
+		n->used = 0;
+		n->next = c->names;
+		c->names = n;
+	}
+	s = n->buf + n->used;
+	libc.memcpy(s, sym, len);
+	n->used += len;
+	return s;
+}
+
+/* the child of 'parent' for 'pc' (or the wrapped call 'sym'): 0 if full */
+static uint32_t __child(struct cct *c, uint32_t parent,
+			uintptr_t pc, const char *sym)
+{
+	struct cct_node *n;
+	uint32_t b, i;
+
+	b = __bucket(c, parent, pc, sym);
+	for (i = c->hash[b]; i; i = c->nodes[i].next) {
+		n = &c->nodes[i];
+		if (n->parent != parent)
+			continue;
+		if (sym ? (n->sym && local_strcmp(n->sym, sym) == 0)
+			: (!n->sym && n->pc == pc))
+			return i;
+	}
+
+	if (c->nr == c->cap) {
+		if (__grow(c) < 0)
+			return 0;
+		b = __bucket(c, parent, pc, sym);
+	}
+	if (sym) {
+		sym = __intern(c, sym);
+		if (!sym)
+			return 0;
+	}
+
+	i = c->nr++;
+	n = &c->nodes[i];
+	libc.memset(n, 0, sizeof(*n));
+	n->pc = pc;
+	n->sym = sym;
+	n->parent = parent;
+	n->next = c->hash[b];
+	c->hash[b] = i;
+	return i;
+}
+
+static void __reset(struct cct *c)
+{
+	struct cct_names *n;
+
+	while ((n = c->names) != NULL) {
+		c->names = n->next;
+		wfree(n, CCT_NAMES_SZ);
+	}
+	libc.memset(c->hash, 0, 2 * c->cap * sizeof(*c->hash));
+	libc.memset(&c->nodes[0], 0, sizeof(c->nodes[0]));
+	c->nr = 1;
+	c->leaf = 0;
+}
+
+static struct cct *__get(struct tls_info *tls)
+{
+	struct cct *c = tls->cct;
+
+	if (c)
+		return c;
+	c = (struct cct *)walloc(sizeof(*c));
+	if (!c)
+		return NULL;
+	libc.memset(c, 0, sizeof(*c));
+	if (__grow(c) < 0) {
+		wfree(c, sizeof(*c));
+		return NULL;
+	}
+	c->pid = libc.getpid();
+	c->nr = 1; /* the root */
+	tls->cct = c;
+	return c;
+}
+
+/*
+ * Add the path in 'state' to the tree: frame 0 is where the wrapped
+ * function was called (see print_bt_state), the rest are its callers.
+ */
+void __hidden cct_enter(struct tls_info *tls, struct bt_state *state)
+{
+	struct cct *c;
+	uint32_t cur = 0;
+	int i;
+
+	c = __get(tls);
+	if (!c)
+		return;
+	c->leaf = 0;
+	if (state->count < 1)
+		return;
+	if (c->nr + state->count > CCT_MAX_NODES)
+		cct_dump(tls);
+
+	for (i = state->count - 1; i > 0; i--) {
+		cur = __child(c, cur, (uintptr_t)state->frame[i].pc, NULL);
+		if (!cur)
+			return;
+	}
+	cur = __child(c, cur, (uintptr_t)state->frame[0].pc, tls->info.symbol);
+	if (!cur)
+		return;
+	c->nodes[cur].calls++;
+	c->leaf = cur;
+}
+
+int __hidden cct_ret(struct tls_info *tls, uint64_t ns)
+{
+	struct cct *c = tls->cct;
+
+	if (!c || !c->leaf)
+		return 0;
+	c->nodes[c->leaf].ns += ns;
+	c->leaf = 0;
+	return 1;
+}
+
+void __hidden cct_dump(struct tls_info *tls)
+{
+	struct cct *c = tls->cct;
+	struct cct_node *n;
+	uint64_t *incl, *excl;
+	size_t sz;
+	uint32_t i;
+	const char *sym, *lib;
+	Dl_info dli;
+
+	if (!c || c->nr < 2 || c->pid != libc.getpid() || !tls->logfile
+	    || !tls->info.log_pos)
+		return;
+
+	sz = 2 * c->nr * sizeof(uint64_t);
+	incl = (uint64_t *)walloc(sz);
+	if (!incl)
+		return;
+	libc.memset(incl, 0, sz);
+	excl = incl + c->nr;
+
+	/* children always come after their parent */
+	for (i = c->nr - 1; i > 0; i--) {
+		n = &c->nodes[i];
+		if (n->sym) {
+			incl[i] += n->ns;
+			excl[i] += n->ns;
+			excl[n->parent] += n->ns;
+		}
+		incl[n->parent] += incl[i];
+	}
+
+	bt_printf(tls, "CCT:START:%u:", c->nr - 1);
+	for (i = 1; i < c->nr; i++) {
+		n = &c->nodes[i];
+		libc.memset(&dli, 0, sizeof(dli));
+		syms_dladdr((void *)n->pc, &dli);
+		sym = n->sym ? n->sym : (dli.dli_sname ? dli.dli_sname : "??");
+		lib = dli.dli_fname ? dli.dli_fname : "??";
+		bt_printf(tls, "CCT:%u:%u:%c:%u:%llu:%llu:%s:%s:",
+			  i, n->parent, n->sym ? 'L' : 'F', n->calls,
+			  (unsigned long long)incl[i],
+			  (unsigned long long)excl[i], sym, lib);
+	}
+
+	wfree(incl, sz);
+	__reset(c);
+}
+
+void __hidden cct_thread_release(struct tls_info *tls)
+{
+	struct cct *c = tls->cct;
+
+	if (!c)
+		return;
+	tls->cct = NULL;
+
+	__reset(c);
+	wfree(c->nodes, c->cap * sizeof(*c->nodes));
+	wfree(c->hash, 2 * c->cap * sizeof(*c->hash));
+	wfree(c, sizeof(*c));
+}
+
+#endif /* HAVE_CCT */
@@ -0,0 +1,634 @@
+/*
+ * wrap_container.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Per-process chunked trace container (see wrap_container.h)
+ */
+#ifndef NO_TRACE_CONTAINER
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+
+#include "wrap_lib.h"
+#include "wrap_tls.h"
+#include "wrap_alloc.h"
+#include "wrap_container.h"
+#include "wrap_budget.h"
+
+extern const char *progname;
+
+#define WTC_CHUNK_SZ   (64 * 1024)
+/* compressBound() of a full chunk, plus the header */
+#define WTC_ZBUF_SZ    (sizeof(struct wtc_chunk) + WTC_CHUNK_SZ \
+			+ (WTC_CHUNK_SZ >> 12) + (WTC_CHUNK_SZ >> 14) \
+			+ (WTC_CHUNK_SZ >> 25) + 13)
+
+#define WTC_INDEX_MIN  256
+
+/* file space reserved (and mapped) by one library at a time */
+#define WTC_SEG_SZ     (1024 * 1024)
+
+#ifndef PAGE_SIZE
+#define PAGE_SIZE 4096
+#endif
+
+/* the on-disk layout can't depend on the ABI */
+typedef char __wtc_chunk_size_check[sizeof(struct wtc_chunk) == 64 ? 1 : -1];
+typedef char __wtc_ent_size_check[sizeof(struct wtc_index_ent) == 32 ? 1 : -1];
+
+struct trace_container {
+	int fd;                     /* -1: not open, -2: unavailable,
+	                               -3: over the disk budget */
+	pthread_mutex_t lock;
+	char name[TLS_MAX_STRING_LEN];
+
+	/* rotation (see wrap_budget.h) */
+	uint32_t seq;
+	uint64_t opened_ms;
+	uint64_t file_end;
+	uint64_t retry_ms;
+	int rotating;
+
+	/* output of one thread, waiting to become a chunk */
+	uint32_t tid;
+	uint32_t pending;
+	uint64_t first_ts, last_ts;
+	char *buf;
+	char *zbuf;
+
+	/* chunks written since our last index */
+	struct wtc_index_ent *index;
+	uint32_t nr_index;
+	uint32_t max_index;
+	uint64_t last_index;
+
+	/* mapped file segment chunks are copied into */
+	int use_map;                /* -1: write() chunks instead */
+	void *map;
+	size_t map_len;
+	char *seg;
+	uint64_t seg_off;
+	uint32_t seg_pos;
+};
+
+#define TRACE_CONTAINER_INIT \
+	{ -1, PTHREAD_RECURSIVE_MUTEX_INITIALIZER, "", 0, 0, 0, 0, 0, \
+	  0, 0, 0, 0, NULL, NULL, NULL, 0, 0, WTC_NO_PREV, \
+	  0, NULL, 0, NULL, 0, 0 }
+
+struct trace_container trace_container __hidden = TRACE_CONTAINER_INIT;
+
+static inline uint64_t __now_us(void)
+{
+	struct timeval tv;
+	libc.gettimeofday(&tv, NULL);
+	return (uint64_t)tv.tv_sec * 1000000ULL + tv.tv_usec;
+}
+
+static void __fill_hdr(struct wtc_chunk *hdr, int type, uint32_t tid)
+{
+	libc.memset(hdr, 0, sizeof(*hdr));
+	libc.memcpy(hdr->magic, WTC_MAGIC, sizeof(hdr->magic));
+	hdr->hdr_len = sizeof(*hdr);
+	hdr->type = type;
+	hdr->pid = (uint32_t)libc.getpid();
+	hdr->tid = tid;
+	libc.snprintf(hdr->lib, sizeof(hdr->lib), "%s", _str(_IBNAM_));
+	hdr->prev = WTC_NO_PREV;
+}
+
+/*
+ * Append 'len' bytes in a single write(): with O_APPEND the kernel puts
+ * them after everything any other writer (library) has appended, and our
+ * file position ends up right after them. Made under the file lock (see
+ * __append()).
+ */
+static int64_t __append_locked(struct trace_container *c, const void *data,
+			       size_t len)
+{
+	ssize_t ret;
+	off_t end;
+
+	ret = libc.write(c->fd, data, len);
+	if (ret != (ssize_t)len)
+		return -1;
+	end = libc.lseek(c->fd, 0, SEEK_CUR);
+	if (end == (off_t)-1)
+		return -1;
+	if ((uint64_t)end > c->file_end)
+		c->file_end = (uint64_t)end;
+	return (int64_t)end - (int64_t)len;
+}
+
+/*
+ * The lock is the one __seg_new() takes: without it, our write could land
+ * between the end of file another library just read and the space it
+ * then reserves there.
+ */
+static int64_t __append(struct trace_container *c, const void *data, size_t len)
+{
+	int64_t offset;
+
+	if (libc.flock)
+		libc.flock(c->fd, LOCK_EX);
+	offset = __append_locked(c, data, len);
+	if (libc.flock)
+		libc.flock(c->fd, LOCK_UN);
+	return offset;
+}
+
+static void __index_add(struct trace_container *c, int64_t offset,
+			struct wtc_chunk *hdr)
+{
+	struct wtc_index_ent *ent;
+
+	if (c->nr_index == c->max_index) {
+		uint32_t max = c->max_index ? c->max_index * 2 : WTC_INDEX_MIN;
+		ent = (struct wtc_index_ent *)walloc(max * sizeof(*ent));
+		if (!ent)
+			return; /* readers will walk the headers instead */
+		if (c->index) {
+			libc.memcpy(ent, c->index, c->nr_index * sizeof(*ent));
+			wfree(c->index, c->max_index * sizeof(*ent));
+		}
+		c->index = ent;
+		c->max_index = max;
+	}
+
+	ent = &c->index[c->nr_index++];
+	ent->offset = (uint64_t)offset;
+	ent->tid = hdr->tid;
+	ent->len = sizeof(*hdr) + hdr->len;
+	ent->first_ts = hdr->first_ts;
+	ent->last_ts = hdr->last_ts;
+}
+
+/*
+ * Encode the pending data as a chunk at 'dst'. Returns the chunk length,
+ * or 0 if it doesn't fit in 'room' bytes.
+ */
+static uint32_t __encode(struct trace_container *c, char *dst, size_t room)
+{
+	struct wtc_chunk *hdr = (struct wtc_chunk *)dst;
+	char *payload = dst + sizeof(*hdr);
+	unsigned long zlen;
+
+	if (room <= sizeof(*hdr))
+		return 0;
+
+	__fill_hdr(hdr, WTC_DATA, c->tid);
+	hdr->first_ts = c->first_ts;
+	hdr->last_ts = c->last_ts;
+	hdr->raw_len = c->pending;
+
+	zlen = room - sizeof(*hdr);
+	ovh_enter_cur(OVH_COMPRESS);
+	if (zlib.valid && zlib.compress2 &&
+	    zlib.compress2(payload, &zlen, c->buf, c->pending,
+			   Z_BEST_SPEED) == Z_OK && zlen < c->pending) {
+		ovh_leave_cur();
+		hdr->codec = WTC_ZLIB;
+		hdr->len = (uint32_t)zlen;
+	} else {
+		ovh_leave_cur();
+		if (room - sizeof(*hdr) < c->pending)
+			return 0;
+		hdr->codec = WTC_RAW;
+		hdr->len = c->pending;
+		libc.memcpy(payload, c->buf, c->pending);
+	}
+	return sizeof(*hdr) + hdr->len;
+}
+
+/*
+ * Reserve the next WTC_SEG_SZ bytes at the end of the file and map them.
+ * Space is allocated up front: running out of disk later would mean a
+ * SIGBUS in the traced application. Without fallocate() (or if anything
+ * fails) we go back to write()ing chunks.
+ */
+static int __seg_new(struct trace_container *c)
+{
+	off_t start, moff;
+	void *map;
+	int ret = -1;
+
+	if (c->use_map < 0 || !libc.fallocate || !libc.flock)
+		goto out;
+
+	/* the lock keeps another library from reserving the same space */
+	libc.flock(c->fd, LOCK_EX);
+	start = libc.lseek(c->fd, 0, SEEK_END);
+	if (start != (off_t)-1 &&
+	    libc.fallocate(c->fd, 0, start, WTC_SEG_SZ) == 0) {
+		moff = start & ~((off_t)PAGE_SIZE - 1);
+		map = libc.mmap(NULL, WTC_SEG_SZ + (start - moff),
+				PROT_READ | PROT_WRITE, MAP_SHARED, c->fd, moff);
+		if (map != MAP_FAILED) {
+			c->map = map;
+			c->map_len = WTC_SEG_SZ + (start - moff);
+			c->seg = (char *)map + (start - moff);
+			c->seg_off = (uint64_t)start;
+			c->seg_pos = 0;
+			ret = 0;
+		}
+	}
+	libc.flock(c->fd, LOCK_UN);
+
+out:
+	if (ret < 0)
+		c->use_map = -1;
+	return ret;
+}
+
+/*
+ * Fill the rest of the segment with a padding chunk (so readers can walk
+ * over it) and hand it to the page cache.
+ */
+static void __seg_close(struct trace_container *c)
+{
+	struct wtc_chunk *hdr;
+
+	if (!c->seg)
+		return;
+
+	hdr = (struct wtc_chunk *)(c->seg + c->seg_pos);
+	__fill_hdr(hdr, WTC_PAD, 0);
+	hdr->codec = WTC_RAW;
+	hdr->len = hdr->raw_len = WTC_SEG_SZ - c->seg_pos - sizeof(*hdr);
+	__index_add(c, (int64_t)(c->seg_off + c->seg_pos), hdr);
+
+	libc.munmap(c->map, c->map_len);
+	c->map = NULL;
+	c->seg = NULL;
+}
+
+/* copy a chunk into the mapped segment: no system calls, usually */
+static int __seal_mapped(struct trace_container *c)
+{
+	struct wtc_chunk *hdr;
+	uint32_t len = 0;
+
+	/* always leave room for the padding chunk that closes a segment */
+	if (c->seg)
+		len = __encode(c, c->seg + c->seg_pos, WTC_SEG_SZ - c->seg_pos
+			       - sizeof(struct wtc_chunk));
+	if (!len) {
+		__seg_close(c);
+		if (__seg_new(c) < 0)
+			return -1;
+		len = __encode(c, c->seg, WTC_SEG_SZ - sizeof(struct wtc_chunk));
+		if (!len)
+			return -1;
+	}
+
+	hdr = (struct wtc_chunk *)(c->seg + c->seg_pos);
+	__index_add(c, (int64_t)(c->seg_off + c->seg_pos), hdr);
+	c->seg_pos += len;
+	/* what's been written, not what's been reserved */
+	c->file_end = c->seg_off + c->seg_pos;
+	log_account(len, 0);
+	return 0;
+}
+
+/* write out pending data as a chunk: c->lock held */
+static void __seal(struct trace_container *c)
+{
+	int64_t offset;
+	uint32_t len;
+
+	if (!c->pending || c->fd < 0)
+		return;
+
+	if (c->use_map >= 0 && __seal_mapped(c) == 0) {
+		c->pending = 0;
+		return;
+	}
+
+	len = __encode(c, c->zbuf, WTC_ZBUF_SZ);
+	offset = __append(c, c->zbuf, len);
+	if (offset >= 0) {
+		__index_add(c, offset, (struct wtc_chunk *)c->zbuf);
+		log_account(len, 0);
+	} else {
+		log_account(0, c->pending);
+	}
+	c->pending = 0;
+}
+
+static int __open(struct trace_container *c)
+{
+	const char *nm;
+	off_t end;
+
+	if (c->fd >= 0)
+		return 0;
+	if (c->fd == -2 || !libc.open || !libc.write || !libc.lseek)
+		return -1;
+	if (c->fd == -3 && log_now_ms() < c->retry_ms)
+		return -1;
+
+	if (!c->buf)
+		c->buf = (char *)walloc(WTC_CHUNK_SZ);
+	if (!c->zbuf)
+		c->zbuf = (char *)walloc(WTC_ZBUF_SZ);
+	if (!c->buf || !c->zbuf)
+		goto out_err;
+
+	if (log_budget_enforce() < 0) {
+		/* keep the handle: we count what we drop until there's room */
+		c->fd = -3;
+		c->retry_ms = log_now_ms() + LOG_BUDGET_RETRY_MS;
+		return -1;
+	}
+
+	/* segments after the first one are numbered */
+	nm = local_strrchr(progname, '/');
+	nm = nm ? nm+1 : progname;
+	if (c->seq)
+		libc.snprintf(c->name, sizeof(c->name), "%s/%d.%s.%u.trace",
+			      LOGFILE_PATH, libc.getpid(), nm, c->seq);
+	else
+		libc.snprintf(c->name, sizeof(c->name), "%s/%d.%s.trace",
+			      LOGFILE_PATH, libc.getpid(), nm);
+	c->fd = libc.open(c->name, O_RDWR | O_CREAT | O_APPEND, 0666);
+	if (c->fd < 0)
+		goto out_err;
+	libc.fchmod(c->fd, 0666);
+	end = libc.lseek(c->fd, 0, SEEK_END);
+	c->file_end = end == (off_t)-1 ? 0 : (uint64_t)end;
+	c->opened_ms = log_now_ms();
+	c->pending = 0;
+	c->nr_index = 0;
+	c->last_index = WTC_NO_PREV;
+	return 0;
+
+out_err:
+	/* fall back to log files */
+	c->fd = -2;
+	return -1;
+}
+
+/* LOG:STATS (and LOG:OVERHEAD) lines of our own, as a chunk: c->lock held */
+static void __put_stats(struct trace_container *c)
+{
+	struct log_stats st;
+	struct timeval tv;
+	char ovh[128];
+
+	__seal(c);
+	log_get_stats(&st);
+	libc.gettimeofday(&tv, NULL);
+	c->tid = libc.gettid();
+	c->first_ts = c->last_ts = (uint64_t)tv.tv_sec * 1000000ULL + tv.tv_usec;
+	c->pending = libc.snprintf(c->buf, WTC_CHUNK_SZ,
+				   "%lu.%lu" SEQ_FMT ":LOG:STATS:%llu:%llu:\n",
+				   (unsigned long)tv.tv_sec,
+				   (unsigned long)tv.tv_usec SEQ_ARG,
+				   (unsigned long long)st.written,
+				   (unsigned long long)st.dropped);
+	if (ovh_stats_line(ovh, sizeof(ovh)) > 0)
+		c->pending += libc.snprintf(c->buf + c->pending,
+					    WTC_CHUNK_SZ - c->pending,
+					    "%lu.%lu" SEQ_FMT ":%s",
+					    (unsigned long)tv.tv_sec,
+					    (unsigned long)tv.tv_usec SEQ_ARG, ovh);
+	__seal(c);
+}
+
+static void __write_index(struct trace_container *c);
+
+/*
+ * Finish the current file (it gets our index, as at exit) and move on to
+ * the next segment. Other libraries in the process get there on their own
+ * once they see the size, or time, of the file they're writing to.
+ */
+static void __rotate(struct trace_container *c)
+{
+	c->rotating = 1;
+	__put_stats(c);
+	__seg_close(c);
+	if (c->nr_index)
+		__write_index(c);
+	c->rotating = 0;
+
+	libc.close(c->fd);
+	c->fd = -1;
+	log_budget_closed(c->name, c->file_end);
+	c->seq++;
+	__open(c);
+	maps_touch(); /* the new file needs the module map */
+}
+
+static inline void __check_rotate(struct trace_container *c)
+{
+	if (c->fd >= 0 && !c->rotating &&
+	    log_should_rotate(c->file_end, c->opened_ms))
+		__rotate(c);
+}
+
+/*
+ * Returns the container as a log "file" (see is_container()), or NULL
+ * if the caller should open a regular log file.
+ */
+void __hidden *container_get(struct tls_info *tls)
+{
+	struct trace_container *c = &trace_container;
+	int ret;
+
+	mtx_lock(&c->lock);
+	ret = __open(c);
+	mtx_unlock(&c->lock);
+	if (ret < 0 && c->fd != -3)
+		return NULL;
+
+	if (tls)
+		libc.memcpy(tls->logname, c->name, sizeof(tls->logname));
+	return (void *)c;
+}
+
+void __hidden container_write(void *f, const void *buf, int len)
+{
+	struct trace_container *c = (struct trace_container *)f;
+	const char *data = (const char *)buf;
+	uint32_t tid, n;
+	uint64_t now, end;
+
+	if (len <= 0)
+		return;
+	tid = libc.gettid();
+	now = __now_us();
+
+	mtx_lock(&c->lock);
+	if (c->fd < 0 && (c->fd != -3 || __open(c) < 0)) {
+		log_account(0, len);
+		goto out;
+	}
+	end = c->file_end;
+
+	/* a chunk only ever holds one thread's output */
+	if (c->pending && c->tid != tid)
+		__seal(c);
+
+	while (len > 0) {
+		if (!c->pending) {
+			c->tid = tid;
+			c->first_ts = now;
+		}
+		n = WTC_CHUNK_SZ - c->pending;
+		if (n > (uint32_t)len)
+			n = (uint32_t)len;
+		libc.memcpy(c->buf + c->pending, data, n);
+		c->pending += n;
+		c->last_ts = now;
+		data += n;
+		len -= n;
+		if (c->pending == WTC_CHUNK_SZ)
+			__seal(c);
+	}
+	if (c->file_end != end)
+		__check_rotate(c);
+out:
+	mtx_unlock(&c->lock);
+}
+
+void __hidden container_printf(void *f, const char *fmt, ...)
+{
+	char line[512];
+	va_list ap;
+	int len;
+
+	va_start(ap, fmt);
+	len = libc.vsnprintf(line, sizeof(line), fmt, ap);
+	va_end(ap);
+
+	if (len >= (int)sizeof(line))
+		len = sizeof(line) - 1;
+	container_write(f, line, len);
+}
+
+void __hidden container_flush(void *f)
+{
+	struct trace_container *c = (struct trace_container *)f;
+
+	mtx_lock(&c->lock);
+	__seal(c);
+	__check_rotate(c);
+	mtx_unlock(&c->lock);
+}
+
+/*
+ * Append our index and a trailer. The index links to the one the file
+ * currently ends with, or to our own previous index if chunks were
+ * appended after that. Other libraries may be finishing at the same time:
+ * the file lock keeps "read the last trailer, link to it, append ours"
+ * atomic. (flock(): every library has its own open file, and fcntl()
+ * locks don't exclude other users in the same process.)
+ */
+static void __write_index(struct trace_container *c)
+{
+	struct wtc_chunk *hdr;
+	struct wtc_trailer *tr, last;
+	size_t ilen, len;
+	off_t end;
+	char *buf;
+	int64_t offset;
+
+	ilen = c->nr_index * sizeof(struct wtc_index_ent);
+	len = sizeof(*hdr) + ilen + sizeof(*tr);
+	buf = (char *)walloc(len);
+	if (!buf)
+		return;
+
+	if (libc.flock)
+		libc.flock(c->fd, LOCK_EX);
+
+	hdr = (struct wtc_chunk *)buf;
+	__fill_hdr(hdr, WTC_INDEX, libc.gettid());
+	hdr->codec = WTC_RAW;
+	hdr->len = hdr->raw_len = (uint32_t)ilen;
+	hdr->prev = c->last_index;
+	if (c->nr_index) {
+		hdr->first_ts = c->index[0].first_ts;
+		hdr->last_ts = c->index[c->nr_index - 1].last_ts;
+	}
+
+	end = libc.lseek(c->fd, 0, SEEK_END);
+	if (libc.pread && end >= (off_t)sizeof(last) &&
+	    libc.pread(c->fd, &last, sizeof(last),
+		       end - sizeof(last)) == sizeof(last) &&
+	    local_strncmp(last.magic, WTC_END_MAGIC, sizeof(last.magic)) == 0)
+		hdr->prev = last.index;
+
+	libc.memcpy(buf + sizeof(*hdr), c->index, ilen);
+
+	/* the trailer needs the index offset: two appends, under the lock */
+	offset = __append_locked(c, buf, sizeof(*hdr) + ilen);
+	if (offset >= 0) {
+		tr = (struct wtc_trailer *)(buf + sizeof(*hdr) + ilen);
+		libc.memcpy(tr->magic, WTC_END_MAGIC, sizeof(tr->magic));
+		tr->index = (uint64_t)offset;
+		__append_locked(c, tr, sizeof(*tr));
+		c->last_index = (uint64_t)offset;
+	}
+
+	if (libc.flock)
+		libc.flock(c->fd, LOCK_UN);
+
+	wfree(buf, len);
+	c->nr_index = 0;
+}
+
+/*
+ * Seal pending output before fork/exit/exec; 'finish' also writes the
+ * index (a process that keeps going after an exec failure just gets
+ * another index later).
+ */
+void __hidden container_sync(int finish)
+{
+	struct trace_container *c = &trace_container;
+
+	mtx_lock(&c->lock);
+	if (c->fd >= 0) {
+		__seal(c);
+		if (finish) {
+			__put_stats(c);
+			/* the index goes after our segment */
+			__seg_close(c);
+			if (c->nr_index)
+				__write_index(c);
+		}
+	}
+	mtx_unlock(&c->lock);
+}
+
+/*
+ * The child gets a container of its own (its pid is in the name): drop
+ * the parent's without writing anything, the parent synced before fork.
+ * That includes the parent's segment: its mapping is shared with us.
+ */
+void __hidden container_init_child(void)
+{
+	static const pthread_mutex_t init = PTHREAD_RECURSIVE_MUTEX_INITIALIZER;
+	struct trace_container *c = &trace_container;
+
+	if (c->map)
+		libc.munmap(c->map, c->map_len);
+	c->map = NULL;
+	c->seg = NULL;
+	if (c->fd >= 0 && libc.close)
+		libc.close(c->fd);
+	c->fd = -1;
+	c->seq = 0;
+	c->rotating = 0;
+	c->pending = 0;
+	c->nr_index = 0;
+	c->last_index = WTC_NO_PREV;
+	c->name[0] = 0;
+	libc.memcpy(&c->lock, &init, sizeof(init));
+}
+
+#endif /* !NO_TRACE_CONTAINER */
@@ -0,0 +1,547 @@
+/*
+ * wrap_flight.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Flight recorder: per-thread event rings (see wrap_flight.h)
+ *
+ * A ring holds whole events as <u32 len><data, padded to 4 bytes>
+ * records: making room for a new one drops records from the tail. Rings
+ * outlive their threads (the last thing a thread did is often the
+ * interesting part), and are handed to new threads once FLIGHT_MAX_RINGS
+ * exist, least recently released first.
+ *
+ * Locks are test-and-set flags rather than mutexes, and the dumper only
+ * ever tries them, skipping what it can't get: a thread that stopped
+ * while holding its ring doesn't hold up the dump. Dumps open files and
+ * allocate, so they're never run from a signal handler: SIGUSR2 only
+ * leaves a note, and the next traced call (in any thread) dumps.
+ */
+#ifdef HAVE_FLIGHT_RECORDER
+
+#include <fcntl.h>
+#include <stdarg.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+
+#include "wrap_lib.h"
+#include "wrap_tls.h"
+#include "wrap_alloc.h"
+#include "wrap_flight.h"
+
+#define FLIGHT_SYM_LEN    64
+#define FLIGHT_LOCK_TRIES 1000
+
+struct flight_ring {
+	struct flight_ring *next;
+	volatile int busy;
+	volatile int writing;       /* its thread is in __ring_put() */
+	int in_use;
+	uint32_t tid;
+	uint32_t released;          /* s_release_seq when last released */
+
+	uint32_t size;              /* of data[], a multiple of 4 */
+	uint32_t head, tail;
+	uint32_t used;
+	unsigned long lost;         /* records overwritten */
+	char data[];
+};
+
+struct flight_log {
+	volatile int state;         /* 0 = not set up, 1 = setting up, 2 = ready */
+	uint32_t ring_sz;
+	uint32_t latency_us;
+	int nr_watch;
+	char watch[FLIGHT_MAX_WATCH][FLIGHT_SYM_LEN];
+
+	const volatile uint32_t *trigger;
+	volatile uint32_t trigger_seen;
+};
+
+struct flight_log __hidden flight_log;
+
+static struct flight_ring *s_rings;
+static int s_nr_rings;
+static volatile int s_rings_lock;
+static uint32_t s_release_seq;
+
+static volatile int s_dumping;
+static volatile int s_sig_pending;
+static unsigned int s_nr_dumps;
+static uint64_t s_last_dump_ms;
+static unsigned long s_suppressed;
+static unsigned long s_dropped;
+
+#define __align4(x) (((x) + 3) & ~3U)
+
+static inline void __lock(volatile int *l)
+{
+	while (__sync_lock_test_and_set(l, 1))
+		while (*l)
+			;
+}
+
+static inline int __trylock(volatile int *l)
+{
+	int tries;
+
+	for (tries = 0; tries < FLIGHT_LOCK_TRIES; tries++) {
+		if (!__sync_lock_test_and_set(l, 1))
+			return 1;
+	}
+	return 0;
+}
+
+static inline void __unlock(volatile int *l)
+{
+	__sync_lock_release(l);
+}
+
+static inline uint64_t __now_ms(void)
+{
+	struct timeval tv;
+
+	libc.gettimeofday(&tv, NULL);
+	return (uint64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+/* <ring kb>:<latency us>:<sym>[,<sym>...] */
+static void __read_cfg(struct flight_log *fl)
+{
+	char buf[FLIGHT_MAX_WATCH * FLIGHT_SYM_LEN];
+	char *p, *end;
+	long val;
+	FILE *f;
+	int n, i;
+
+	f = libc.fopen(FLIGHT_CFG_PATH, "r");
+	if (!f)
+		return;
+	libc.memset(buf, 0, sizeof(buf));
+	n = libc.fread(buf, 1, sizeof(buf) - 1, f);
+	libc.fclose(f);
+	if (n <= 0)
+		return;
+
+	p = buf;
+	val = libc.strtol(p, &end, 10);
+	if (end != p && val >= FLIGHT_MIN_RING_KB)
+		fl->ring_sz = (uint32_t)val * 1024;
+	p = end;
+	if (*p != ':')
+		return;
+	val = libc.strtol(++p, &end, 10);
+	if (end != p && val > 0)
+		fl->latency_us = (uint32_t)val;
+	p = end;
+	if (*p != ':')
+		return;
+
+	while (*p && fl->nr_watch < FLIGHT_MAX_WATCH) {
+		p++; /* ':' or ',' */
+		for (i = 0; *p && *p != ',' && *p != '\n' && *p != '\r'; p++) {
+			if (i < FLIGHT_SYM_LEN - 1)
+				fl->watch[fl->nr_watch][i++] = *p;
+		}
+		fl->watch[fl->nr_watch][i] = 0;
+		if (i)
+			fl->nr_watch++;
+		if (*p != ',')
+			break;
+	}
+}
+
+/* map the first word of the (shared) trigger file */
+static void __map_trigger(struct flight_log *fl)
+{
+	uint32_t zero = 0, val;
+	void *map;
+	int fd;
+
+	if (!libc.open || !libc.pread || !libc.write)
+		return;
+
+	fd = libc.open(FLIGHT_TRIGGER_PATH, O_RDWR | O_CREAT, 0666);
+	if (fd < 0)
+		return;
+	libc.fchmod(fd, 0666);
+	if (libc.pread(fd, &val, sizeof(val), 0) != sizeof(val) &&
+	    libc.write(fd, &zero, sizeof(zero)) != sizeof(zero)) {
+		libc.close(fd);
+		return;
+	}
+
+	map = libc.mmap(NULL, sizeof(uint32_t), PROT_READ, MAP_SHARED, fd, 0);
+	libc.close(fd);
+	if (map == MAP_FAILED)
+		return;
+	fl->trigger_seen = *(const volatile uint32_t *)map;
+	fl->trigger = (const volatile uint32_t *)map;
+}
+
+static void __setup(struct flight_log *fl)
+{
+	if (!once_begin(&fl->state))
+		return;
+	fl->ring_sz = FLIGHT_RING_KB * 1024;
+	__read_cfg(fl);
+	__map_trigger(fl);
+	once_end(&fl->state);
+}
+
+static inline void __ring_reset(struct flight_ring *r)
+{
+	r->head = r->tail = 0;
+	r->used = 0;
+	r->lost = 0;
+}
+
+static struct flight_ring *__ring_attach(struct tls_info *tls)
+{
+	struct flight_ring *r, *oldest = NULL;
+	uint32_t sz = flight_log.ring_sz ? flight_log.ring_sz
+					 : FLIGHT_RING_KB * 1024;
+
+	__lock(&s_rings_lock);
+	if (s_nr_rings >= FLIGHT_MAX_RINGS) {
+		for (r = s_rings; r; r = r->next) {
+			if (r->in_use)
+				continue;
+			if (!oldest ||
+			    (int32_t)(r->released - oldest->released) < 0)
+				oldest = r;
+		}
+		r = oldest;
+		if (r) {
+			__lock(&r->busy);
+			__ring_reset(r);
+		}
+	} else {
+		r = (struct flight_ring *)walloc(sizeof(*r) + sz);
+		if (r) {
+			libc.memset(r, 0, sizeof(*r));
+			r->size = sz;
+			r->busy = 1;
+			r->next = s_rings;
+			s_rings = r;
+			s_nr_rings++;
+		}
+	}
+	if (r) {
+		r->in_use = 1;
+		r->tid = libc.gettid();
+		__unlock(&r->busy);
+	}
+	__unlock(&s_rings_lock);
+
+	tls->flight = r;
+	return r;
+}
+
+static void __ring_put(struct flight_ring *r, const char *buf, uint32_t len)
+{
+	uint32_t need = sizeof(uint32_t) + __align4(len);
+	uint32_t pos, first;
+
+	/* a signal handler that interrupted us: it would wait for itself */
+	if (need > r->size || r->writing) {
+		s_dropped++;
+		return;
+	}
+
+	r->writing = 1;
+	__lock(&r->busy);
+	while (r->size - r->used < need) {
+		uint32_t old = *(uint32_t *)(r->data + r->tail);
+		old = sizeof(uint32_t) + __align4(old);
+		r->tail = (r->tail + old) % r->size;
+		r->used -= old;
+		r->lost++;
+	}
+
+	*(uint32_t *)(r->data + r->head) = len;
+	pos = (r->head + sizeof(uint32_t)) % r->size;
+	first = r->size - pos;
+	if (first > len)
+		first = len;
+	libc.memcpy(r->data + pos, buf, first);
+	if (len > first)
+		libc.memcpy(r->data, buf + first, len - first);
+
+	r->head = (r->head + need) % r->size;
+	r->used += need;
+	__unlock(&r->busy);
+	r->writing = 0;
+}
+
+void __hidden *flight_get(struct tls_info *tls)
+{
+	__setup(&flight_log);
+	if (tls && !tls->flight)
+		__ring_attach(tls);
+	/* even without a ring: we never fall back to writing files */
+	return &flight_log;
+}
+
+void __hidden flight_write(void *f, const void *buf, int len)
+{
+	struct tls_info *tls;
+
+	(void)f;
+	if (len <= 0)
+		return;
+	tls = peek_tls();
+	if (!tls || !tls->flight) {
+		s_dropped++;
+		return;
+	}
+	__ring_put(tls->flight, (const char *)buf, (uint32_t)len);
+}
+
+void __hidden flight_printf(void *f, const char *fmt, ...)
+{
+	char line[512];
+	va_list ap;
+	int len;
+
+	if (!libc.vsnprintf)
+		return;
+	va_start(ap, fmt);
+	len = libc.vsnprintf(line, sizeof(line), fmt, ap);
+	va_end(ap);
+
+	if (len >= (int)sizeof(line))
+		len = sizeof(line) - 1;
+	flight_write(f, line, len);
+}
+
+static int __watched(const char *sym)
+{
+	int i;
+
+	for (i = 0; i < flight_log.nr_watch; i++) {
+		if (flight_log.watch[i][0] == sym[0] &&
+		    local_strcmp(flight_log.watch[i], sym) == 0)
+			return 1;
+	}
+	return 0;
+}
+
+int __hidden flight_watch(struct tls_info *tls)
+{
+	if (flight_log.state != 2 || !wsym(tls))
+		return 0;
+	return flight_log.latency_us || __watched(wsym(tls));
+}
+
+void __hidden flight_check(struct tls_info *tls)
+{
+	uint32_t val, seen;
+	int sig;
+
+	sig = s_sig_pending;
+	if (sig && __sync_bool_compare_and_swap(&s_sig_pending, sig, 0))
+		flight_trigger(tls, "SIGNAL",
+			       libc.strsignal ? libc.strsignal(sig) : "UNKNOWN");
+
+	if (!flight_log.trigger)
+		return;
+	val = *flight_log.trigger;
+	seen = flight_log.trigger_seen;
+	if (val == seen)
+		return;
+	/* one thread (per process) gets to act on it */
+	if (!__sync_bool_compare_and_swap(&flight_log.trigger_seen, seen, val))
+		return;
+	flight_trigger(tls, "CTL", "trigger");
+}
+
+void __hidden flight_ret(struct tls_info *tls, const char *sym,
+			 uint32_t rval, uint64_t ns)
+{
+	if (!sym)
+		return;
+	if (flight_log.latency_us &&
+	    ns >= (uint64_t)flight_log.latency_us * 1000ULL)
+		flight_trigger(tls, "LATENCY", sym);
+	else if ((int32_t)rval < 0 && __watched(sym))
+		flight_trigger(tls, "ERROR", sym);
+}
+
+static inline void __dump_write(void *f, const void *buf, uint32_t len)
+{
+	if (zlib.valid)
+		zlib.gzwrite((struct gzFile *)f, (void *)buf, len);
+	else
+		libc.fwrite(buf, len, 1, (FILE *)f);
+}
+
+static void __dump_ring(void *f, struct flight_ring *r)
+{
+	char line[64];
+	uint32_t pos, left, len, first;
+	int n;
+
+	n = libc.snprintf(line, sizeof(line), "0.0:LOG:TID:%u:\n", r->tid);
+	__dump_write(f, line, n);
+
+	if (!__trylock(&r->busy)) {
+		n = libc.snprintf(line, sizeof(line), "0.0:LOG:E:FLIGHT_BUSY:\n");
+		__dump_write(f, line, n);
+		return;
+	}
+
+	pos = r->tail;
+	left = r->used;
+	while (left) {
+		len = *(uint32_t *)(r->data + pos);
+		pos = (pos + sizeof(uint32_t)) % r->size;
+		first = r->size - pos;
+		if (first > len)
+			first = len;
+		__dump_write(f, r->data + pos, first);
+		if (len > first)
+			__dump_write(f, r->data, len - first);
+		pos = (pos + __align4(len)) % r->size;
+		left -= sizeof(uint32_t) + __align4(len);
+	}
+	if (r->lost) {
+		n = libc.snprintf(line, sizeof(line),
+				  "0.0:LOG:FLIGHT:OVERWRITTEN:%lu:\n", r->lost);
+		__dump_write(f, line, n);
+	}
+
+	/* it's on disk now: don't dump it twice */
+	__ring_reset(r);
+	__unlock(&r->busy);
+}
+
+static void __dump_maps(void *f)
+{
+	const struct wmap_table *t = maps_get();
+	char line[TLS_MAX_STRING_LEN + 64];
+	uint32_t gen;
+	int i, n;
+
+	if (!t)
+		return;
+	gen = t->gen;
+	for (i = 0; i < t->count; i++) {
+		n = libc.snprintf(line, sizeof(line), "0.0:");
+		n += maps_line(t, gen, i, line + n, sizeof(line) - n - 1);
+		if (n > (int)sizeof(line) - 2)
+			n = sizeof(line) - 2;
+		line[n++] = '\n';
+		__dump_write(f, line, n);
+	}
+}
+
+/*
+ * Dump every ring into a fresh log file nobody else writes to. Not for
+ * signal handlers (see flight_signal()): the ring locks of other threads
+ * are only tried, but our own ring is locked, and the file opened, as on
+ * any traced call.
+ */
+void __hidden flight_trigger(struct tls_info *tls, const char *why,
+			     const char *what)
+{
+	struct flight_ring *r;
+	char name[TLS_MAX_STRING_LEN];
+	char id[16];
+	uint64_t now;
+	void *f;
+
+	if (flight_log.state != 2)
+		return;
+	if (!__sync_bool_compare_and_swap(&s_dumping, 0, 1))
+		return;
+
+	now = __now_ms();
+	if (s_last_dump_ms && now - s_last_dump_ms < FLIGHT_HOLDOFF_MS) {
+		s_suppressed++;
+		goto out;
+	}
+
+	/* what this thread has been doing up to the trigger goes first */
+	if (tls && tls->logfile && is_flight(tls->logfile)) {
+		bt_flush(tls, &tls->info);
+		log_print(tls->logfile, LOG, "FLIGHT:%s:%s:%lu:",
+			  why, what ? what : "", s_suppressed);
+	}
+
+	libc.snprintf(id, sizeof(id), "flight%u", s_nr_dumps);
+	f = __open_logfile(name, sizeof(name), id, NULL);
+	if (!f)
+		goto out;
+
+	/* what the rings said of the module map may have been overwritten */
+	__dump_maps(f);
+
+	if (__trylock(&s_rings_lock)) {
+		for (r = s_rings; r; r = r->next)
+			__dump_ring(f, r);
+		__unlock(&s_rings_lock);
+	}
+	if (s_dropped) {
+		libc.snprintf(name, sizeof(name),
+			      "0.0:LOG:E:FLIGHT_DROPPED:%lu:\n", s_dropped);
+		__dump_write(f, name, local_strlen(name));
+	}
+	log_close(f);
+
+	s_nr_dumps++;
+	s_last_dump_ms = now;
+	s_suppressed = 0;
+out:
+	__sync_lock_release(&s_dumping);
+}
+
+/*
+ * From a signal handler: all it does is leave a note for flight_check(),
+ * as anything else might need a lock the interrupted code holds.
+ */
+void __hidden flight_signal(int sig)
+{
+	if (flight_log.state == 2)
+		s_sig_pending = sig;
+}
+
+void __hidden flight_thread_release(struct tls_info *tls)
+{
+	struct flight_ring *r = tls->flight;
+
+	if (!r)
+		return;
+	tls->flight = NULL;
+
+	__lock(&s_rings_lock);
+	r->in_use = 0;
+	r->released = ++s_release_seq;
+	__unlock(&s_rings_lock);
+}
+
+/*
+ * The parent's threads don't exist in the child: their rings are free
+ * (and empty, the parent has the same events) for the child's threads.
+ */
+void __hidden flight_init_child(void)
+{
+	struct flight_ring *r;
+
+	s_rings_lock = 0;
+	for (r = s_rings; r; r = r->next) {
+		r->busy = 0;
+		r->writing = 0;
+		r->in_use = 0;
+		__ring_reset(r);
+	}
+	s_dumping = 0;
+	s_sig_pending = 0;
+	s_nr_dumps = 0;
+	s_last_dump_ms = 0;
+	s_suppressed = 0;
+	s_dropped = 0;
+	if (flight_log.trigger)
+		flight_log.trigger_seen = *flight_log.trigger;
+}
+
+#endif /* HAVE_FLIGHT_RECORDER */
@@ -15,9 +15,16 @@
 #include "wrap_lib.h"
 #include "backtrace.h"
 #include "java_backtrace.h"
+#include "wrap_time.h"
+#include "wrap_callers.h"
+#include "wrap_maps.h"
 
+#ifndef WRAP_RT_GLUE
 /* from platform specific code */
 extern void setup_wrap_cache(void);
+#ifdef HAVE_SIGHANDLER
+extern void setup_special_sighandler(int sig);
+#endif
 
 /* lib-specific wrapping handlers (e.g. [v]fork in libc) */
 #ifdef HAVE_WRAP_SPECIAL
@@ -25,6 +32,7 @@ extern int wrap_special(struct tls_info *tls);
 extern int wrap_symbol_notrace(struct tls_info *tls);
 extern int wrap_symbol_notime(struct tls_info *tls);
 extern int wrap_symbol_noargs(struct tls_info *tls);
+extern int wrap_symbol_special(struct tls_info *tls);
 const char *wrap_symbol_callstr(struct tls_info *tls, int *len);
 #else
 _static inline int wrap_special(struct tls_info *tls)
@@ -47,6 +55,11 @@ _static inline int wrap_symbol_noargs(struct tls_info *tls)
 	(void)tls;
 	return 0;
 }
+_static inline int wrap_symbol_special(struct tls_info *tls)
+{
+	(void)tls;
+	return 0;
+}
 _static inline const char *wrap_symbol_callstr(struct tls_info *tls, int *len)
 {
 	(void)tls;
@@ -54,6 +67,7 @@ _static inline const char *wrap_symbol_callstr(struct tls_info *tls, int *len)
 	return NULL;
 }
 #endif
+#endif /* !WRAP_RT_GLUE */
 
 const char *progname = NULL;
 
@@ -100,8 +114,14 @@ local_strlen(const char *s)
 	return len;
 }
 
+#ifndef WRAP_RT_GLUE
 struct libc_iface libc __hidden;
 
+int cached_pid = 0;
+int log_timing = 0;
+#endif
+
+#ifndef WRAP_RT_CORE
 /*
  * Symbol table / information
  *
@@ -143,9 +163,6 @@ _static int wrapped_text_size =
 #undef SAVED
 #undef SYM
 
-int cached_pid = 0;
-int log_timing = 0;
-
 _static Dl_info wrapped_dli;
 _static Dl_info dl_dli;
 
@@ -172,9 +189,10 @@ _static int is_in_wrapped_text(unsigned long addr)
  * given DSO handle.
  *
  */
-_static void *table_dlsym(void *dso, const char *sym, int allow_null)
+_static void *__table_dlsym(void *dso, const char *sym, int allow_null,
+			    struct symbol **hint)
 {
-	struct symbol *symbol;
+	struct symbol *symbol, *start = *hint;
 
 	if (!wrapped_dli.dli_fbase) {
 		void *sym;
@@ -186,29 +204,51 @@ _static void *table_dlsym(void *dso, const char *sym, int allow_null)
 			SYMERR(0x2);
 	}
 
-	for (symbol = &sym_table[0]; symbol->name; symbol++) {
+	/* search from 'hint' to the end, then from the start up to it */
+	for (symbol = start; symbol->name; symbol++) {
 		if (local_strcmp(symbol->name, sym) == 0)
-			break;
+			goto found;
 	}
-	if (!symbol->name) {
-		if (allow_null)
-			return NULL;
-		else
-			BUG_MSG(0x3, "Can't find '%s'!", sym);
+	for (symbol = &sym_table[0]; symbol < start; symbol++) {
+		if (local_strcmp(symbol->name, sym) == 0)
+			goto found;
 	}
+	if (allow_null)
+		return NULL;
+	BUG_MSG(0x3, "Can't find '%s'!", sym);
+	return NULL;
 
+found:
+	*hint = symbol + 1;
 	return (void *)((char *)wrapped_dli.dli_fbase + symbol->offset);
 }
 
-_static inline FILE *__open_stdlogfile(struct tls_info *tls)
+_static void *table_dlsym(void *dso, const char *sym, int allow_null)
+{
+	struct symbol *hint = &sym_table[0];
+
+	return __table_dlsym(dso, sym, allow_null, &hint);
+}
+#endif /* !WRAP_RT_CORE */
+
+#ifndef WRAP_RT_GLUE
+
+/*
+ * Log file names are: LOGFILE_PATH/<pid>.<id>.<lib>.<prog>.log[.gz]
+ * where <id> is the thread ID, or shardN for a shared log shard.
+ */
+_static inline void __logfile_name(char *buf, size_t len, const char *id,
+				   int use_gz)
 {
-	FILE *logf;
-	char *buf = &(tls->logname[0]);
 	const char *nm = local_strrchr(progname, '/');
-	libc.snprintf(buf, sizeof(tls->logname), "%s/%d.%d.%s.%s.log",
-		      LOGFILE_PATH, libc.getpid(),
-		      libc.gettid(), _str(_IBNAM_),
-		      nm ? nm+1 : progname);
+	libc.snprintf(buf, len, "%s/%d.%s.%s.%s.log%s",
+		      LOGFILE_PATH, libc.getpid(), id, _str(_IBNAM_),
+		      nm ? nm+1 : progname, use_gz ? ".gz" : "");
+}
+
+_static inline FILE *__open_stdlogfile(const char *buf)
+{
+	FILE *logf;
 	logf = libc.fopen(buf, "a");
 	if (!logf)
 		return NULL;
@@ -216,16 +256,10 @@ _static inline FILE *__open_stdlogfile(struct tls_info *tls)
 	return logf;
 }
 
-_static inline struct gzFile *__open_gzlogfile(struct tls_info *tls)
+_static inline struct gzFile *__open_gzlogfile(const char *buf, int *fdp)
 {
 	FILE *logf;
 	struct gzFile *gzlogf;
-	char *buf = &(tls->logname[0]);
-	const char *nm = local_strrchr(progname, '/');
-	libc.snprintf(buf, sizeof(tls->logname), "%s/%d.%d.%s.%s.log.gz",
-		      LOGFILE_PATH, libc.getpid(),
-		      libc.gettid(), _str(_IBNAM_),
-		      nm ? nm+1 : progname);
 	logf = libc.fopen(buf, "a");
 	if (!logf)
 		return NULL;
@@ -235,12 +269,296 @@ _static inline struct gzFile *__open_gzlogfile(struct tls_info *tls)
 		libc.fclose(logf);
 		return NULL;
 	}
+	if (fdp)
+		*fdp = libc.fno(logf);
 	//zlib.gzsetparams(gzlogf, Z_BEST_COMPRESSION, Z_DEFAULT_STRATEGY);
 	zlib.gzsetparams(gzlogf, Z_BEST_SPEED, Z_DEFAULT_STRATEGY);
 	zlib.gzflush(gzlogf, Z_FULL_FLUSH);
 	return gzlogf;
 }
 
+void __hidden *__open_logfile(char *name, size_t len, const char *id,
+			      int *fdp)
+{
+	void *f;
+
+	/* make room first (if we can), see wrap_budget.h */
+	log_budget_enforce();
+
+	if (zlib.valid) {
+		__logfile_name(name, len, id, 1);
+		f = (void *)__open_gzlogfile(name, fdp);
+		if (f)
+			return f;
+		zlib.valid = 0;
+		__logfile_name(name, len, id, 0);
+		f = (void *)__open_stdlogfile(name);
+		log_print(f, LOG, "E:Failed to open libz!");
+	} else {
+		__logfile_name(name, len, id, 0);
+		f = (void *)__open_stdlogfile(name);
+	}
+	if (f && fdp)
+		*fdp = libc.fno((FILE *)f);
+	return f;
+}
+
+#ifndef NO_TLS_POOL
+struct log_shard {
+	void *f;
+	int fd;
+	int refs;
+	uint32_t last_tid;
+	pthread_mutex_t lock;
+	char name[TLS_MAX_STRING_LEN];
+
+	/* rotation (see wrap_budget.h) */
+	uint32_t seq;
+	uint32_t writes;
+	uint64_t opened_ms;
+	off_t end;
+};
+
+/* how often (in writes) a shard checks its size */
+#define LOG_SHARD_CHECK 64
+
+#define LOG_SHARD_INIT \
+	{ NULL, -1, 0, 0, PTHREAD_RECURSIVE_MUTEX_INITIALIZER, "", 0, 0, 0, 0 }
+
+_static struct log_shard s_log_shards[NR_LOG_SHARDS] = {
+	LOG_SHARD_INIT, LOG_SHARD_INIT, LOG_SHARD_INIT, LOG_SHARD_INIT,
+};
+
+static inline struct log_shard *__find_shard(void *f)
+{
+	int i;
+
+	if (!f)
+		return NULL;
+	for (i = 0; i < NR_LOG_SHARDS; i++) {
+		if (s_log_shards[i].f == f)
+			return &s_log_shards[i];
+	}
+	return NULL;
+}
+
+/*
+ * Take a reference to the calling thread's log shard, opening it if
+ * needed. With a NULL 'tls', just open the main thread's shard.
+ */
+void __hidden *log_shard_get(struct tls_info *tls)
+{
+	struct log_shard *shard;
+	char id[16];
+	int idx;
+
+	if (tls)
+		idx = (int)(libc.gettid() % NR_LOG_SHARDS);
+	else
+		idx = (int)(libc.getpid() % NR_LOG_SHARDS);
+	shard = &s_log_shards[idx];
+
+	mtx_lock(&shard->lock);
+	if (!shard->f) {
+		libc.snprintf(id, sizeof(id), "shard%d", idx);
+		shard->f = __open_logfile(shard->name, sizeof(shard->name),
+					  id, &shard->fd);
+		shard->last_tid = 0;
+		shard->refs = 0;
+		shard->seq = 0;
+		shard->writes = 0;
+		shard->opened_ms = log_now_ms();
+		shard->end = 0;
+	}
+	if (shard->f && tls)
+		shard->refs++;
+	mtx_unlock(&shard->lock);
+
+	if (tls)
+		libc.memcpy(tls->logname, shard->name, sizeof(tls->logname));
+	return shard->f;
+}
+
+/*
+ * Drop a thread's reference to a log shard: the shard stays open for the
+ * next thread. Returns 0 if 'f' isn't a shard.
+ */
+int __hidden log_shard_put(void *f)
+{
+	struct log_shard *shard;
+
+	shard = __find_shard(f);
+	if (!shard)
+		return 0;
+
+	mtx_lock(&shard->lock);
+	log_flush(f);
+	if (shard->refs > 0)
+		shard->refs--;
+	mtx_unlock(&shard->lock);
+	return 1;
+}
+
+/*
+ * Push buffered shard data out to the file. Before fork() this keeps the
+ * child from inheiriting (and later re-writing) buffered parent output;
+ * at exit/exec 'finish' also terminates the gzip stream. Shards are never
+ * closed here: other threads may still be writing to them (a gzwrite
+ * after a Z_FINISH flush simply starts a new gzip member).
+ */
+void __hidden log_shards_flush(int finish)
+{
+	int i;
+
+	for (i = 0; i < NR_LOG_SHARDS; i++) {
+		struct log_shard *shard = &s_log_shards[i];
+		mtx_lock(&shard->lock);
+		if (shard->f) {
+			if (zlib.valid)
+				zlib.gzflush((struct gzFile *)shard->f,
+					     finish ? Z_FINISH : Z_SYNC_FLUSH);
+			else
+				libc.fflush((FILE *)shard->f);
+		}
+		mtx_unlock(&shard->lock);
+	}
+}
+
+/*
+ * The child of a fork() mustn't write through its parent's shards: drop
+ * them without flushing anything (the parent flushed before forking).
+ */
+void __hidden log_shards_init_child(void)
+{
+	static const struct log_shard init = LOG_SHARD_INIT;
+	int i;
+
+	for (i = 0; i < NR_LOG_SHARDS; i++) {
+		struct log_shard *shard = &s_log_shards[i];
+		if (shard->f && shard->fd >= 0 && libc.close)
+			libc.close(shard->fd);
+		libc.memcpy(shard, &init, sizeof(*shard));
+	}
+}
+
+void __hidden __log_lock(void *f)
+{
+	struct log_shard *shard;
+	uint32_t tid;
+
+	shard = __find_shard(f);
+	if (!shard)
+		return;
+
+	/* held until __log_unlock() */
+	mtx_lock(&shard->lock);
+	tid = libc.gettid();
+	if (shard->last_tid == tid)
+		return;
+	shard->last_tid = tid;
+	if (zlib.valid)
+		zlib.gzprintf((struct gzFile *)f, "0.0:LOG:TID:%d:\n", tid);
+	else
+		libc.fprintf((FILE *)f, "0.0:LOG:TID:%d:\n", tid);
+}
+
+/*
+ * Move a shard on to its next segment. Threads hold on to the shard's
+ * stream, so that stays: the gzip member is finished, and the new file
+ * takes the old one's place under the same descriptor. The next write
+ * starts a new gzip member in it.
+ */
+static void __shard_rotate(struct log_shard *shard)
+{
+	struct log_stats st;
+	struct timeval tv;
+	char id[16], ovh[128], prev[TLS_MAX_STRING_LEN];
+	int fd;
+
+	log_get_stats(&st);
+	if (ovh_stats_line(ovh, sizeof(ovh)) <= 0)
+		ovh[0] = 0;
+	libc.gettimeofday(&tv, NULL);
+	if (zlib.valid) {
+		zlib.gzprintf((struct gzFile *)shard->f,
+			      "%lu.%lu" SEQ_FMT ":LOG:STATS:%llu:%llu:\n",
+			      (unsigned long)tv.tv_sec,
+			      (unsigned long)tv.tv_usec SEQ_ARG,
+			      (unsigned long long)st.written,
+			      (unsigned long long)st.dropped);
+		if (ovh[0])
+			zlib.gzprintf((struct gzFile *)shard->f,
+				      "%lu.%lu" SEQ_FMT ":%s",
+				      (unsigned long)tv.tv_sec,
+				      (unsigned long)tv.tv_usec SEQ_ARG, ovh);
+		zlib.gzflush((struct gzFile *)shard->f, Z_FINISH);
+	} else {
+		libc.fprintf((FILE *)shard->f,
+			     "%lu.%lu" SEQ_FMT ":LOG:STATS:%llu:%llu:\n",
+			     (unsigned long)tv.tv_sec,
+			     (unsigned long)tv.tv_usec SEQ_ARG,
+			     (unsigned long long)st.written,
+			     (unsigned long long)st.dropped);
+		if (ovh[0])
+			libc.fprintf((FILE *)shard->f, "%lu.%lu" SEQ_FMT ":%s",
+				     (unsigned long)tv.tv_sec,
+				     (unsigned long)tv.tv_usec SEQ_ARG, ovh);
+		libc.fflush((FILE *)shard->f);
+	}
+
+	log_budget_enforce();
+	libc.memcpy(prev, shard->name, sizeof(prev));
+	libc.snprintf(id, sizeof(id), "shard%d.%u",
+		      (int)(shard - s_log_shards), shard->seq + 1);
+	__logfile_name(shard->name, sizeof(shard->name), id, zlib.valid);
+	fd = libc.open(shard->name, O_WRONLY | O_CREAT | O_APPEND, 0666);
+	if (fd < 0)
+		return;
+	libc.fchmod(fd, 0666);
+	if (libc.dup2(fd, shard->fd) >= 0) {
+		log_budget_closed(prev, (uint64_t)shard->end);
+		shard->seq++;
+		shard->opened_ms = log_now_ms();
+		shard->end = 0;
+		shard->last_tid = 0; /* the new file needs a LOG:TID marker */
+		maps_touch();
+	}
+	libc.close(fd);
+}
+
+static void __shard_check(struct log_shard *shard)
+{
+	off_t end;
+
+	if (shard->fd < 0 || !libc.lseek)
+		return;
+	end = libc.lseek(shard->fd, 0, SEEK_CUR);
+	if (end == (off_t)-1)
+		return;
+	if (end > shard->end) {
+		log_account((uint64_t)(end - shard->end), 0);
+		shard->end = end;
+	}
+	if (libc.open && libc.dup2 &&
+	    log_should_rotate((uint64_t)end, shard->opened_ms))
+		__shard_rotate(shard);
+}
+
+void __hidden __log_unlock(void *f)
+{
+	struct log_shard *shard;
+
+	shard = __find_shard(f);
+	if (!shard)
+		return;
+	if (++shard->writes >= LOG_SHARD_CHECK) {
+		shard->writes = 0;
+		__shard_check(shard);
+	}
+	mtx_unlock(&shard->lock);
+}
+#endif /* !NO_TLS_POOL */
+
 _static void ___open_log(struct tls_info *tls, int acquire_new, void **logf)
 {
 	void *f;
@@ -260,17 +578,22 @@ _static void ___open_log(struct tls_info *tls, int acquire_new, void **logf)
 
 	f = tls->logfile;
 	if (!f && acquire_new) {
-		if (zlib.valid) {
-			f = (void *)__open_gzlogfile(tls);
-			if (!f) {
-				zlib.valid = 0;
-				f = (void *)__open_stdlogfile(tls);
-				log_print(f, LOG, "E:Failed to open libz!");
-			}
+		f = flight_get(tls);
+		if (!f)
+			f = container_get(tls);
+#ifndef NO_TLS_POOL
+		if (!f)
+			f = log_shard_get(tls);
+#else
+		if (!f) {
+			char id[16];
+			libc.snprintf(id, sizeof(id), "%d", libc.gettid());
+			f = __open_logfile(tls->logname, sizeof(tls->logname),
+					   id, &tls->logfd);
 		} else {
-			f = (void *)__open_stdlogfile(tls);
+			tls->logfd = -1;
 		}
-
+#endif
 		if (!f)
 			return; /* can't open log file! */
 
@@ -315,6 +638,14 @@ void __hidden *get_log(int release)
 	return ___get_log(release, 1);
 }
 
+void __hidden *tls_logfile(struct tls_info *tls)
+{
+	void *f;
+
+	___open_log(tls, 1, &f);
+	return f;
+}
+
 void __hidden tls_release_logfile(struct tls_info *tls)
 {
 	void *f;
@@ -322,19 +653,45 @@ void __hidden tls_release_logfile(struct tls_info *tls)
 	if (!tls)
 		return;
 
-	f = tls->logfile;
-	if (!f)
+	if (!tls_has_log(tls))
 		return;
 
+	cct_dump(tls);
 	bt_flush(tls, &tls->info);
+	f = tls->logfile;
 	tls->logfile = NULL;
+	if (!f)
+		return;
 
 
 	log_print(f, LOG, "END(%s)", wsym(tls));
 	log_flush(f);
+#ifndef NO_TLS_POOL
+	if (log_shard_put(f))
+		return;
+#endif
 	log_close(f);
 }
 
+/*
+ * The child of a fork() has a copy of its parent's log stream, with the
+ * parent's buffered data in it: forget about it without writing anything.
+ * Shards, containers and per-CPU logs close their own descriptors (see
+ * the *_init_child() functions).
+ */
+void __hidden tls_drop_logfile(struct tls_info *tls)
+{
+	if (!tls || !tls->logfile)
+		return;
+#ifdef NO_TLS_POOL
+	if (tls->logfd >= 0 && libc.close)
+		libc.close(tls->logfd);
+	tls->logfd = -1;
+#endif
+	tls->logfile = NULL;
+	tls_reset_logbuffer(tls);
+}
+
 void __hidden libc_close_log(void)
 {
 	struct tls_info *tls;
@@ -344,7 +701,9 @@ void __hidden libc_close_log(void)
 		return;
 	tls_release_logfile(tls);
 }
+#endif /* !WRAP_RT_GLUE */
 
+#ifndef WRAP_RT_CORE
 /**
  * @wrapped_dlsym Locate a symbol within a library, possibly loading the lib.
  *
@@ -374,39 +733,195 @@ void *wrapped_dlsym(const char *libpath, void **lib_handle, const char *symbol)
 	return sym;
 }
 
+#ifdef HAVE_EAGER_INIT
+/*
+ * One per wrapper entry point (see WRAP_SLOT in asm/wrap.S): where the
+ * address of the real function is cached, and what wrapped_dlsym()
+ * needs to find it.
+ */
+struct wrap_slot {
+	void **addr;
+	const char *sym;
+	const char *libpath;
+	void **lib_handle;
+};
+
+extern struct wrap_slot __start_wrap_slots[] __attribute__((weak));
+extern struct wrap_slot __stop_wrap_slots[] __attribute__((weak));
+
+/*
+ * Fill in the cached address of every entry point at once. The entry
+ * points are generated in symbol table order, so each search starts
+ * where the last one stopped. Anything not found here is looked up by
+ * its first call, as usual.
+ */
+_static int wrapped_dlsym_all(void)
+{
+	struct symbol *hint = &sym_table[0];
+	struct wrap_slot *s;
+	void *sym;
+	int nr = 0;
+
+	if (!__start_wrap_slots)
+		return 0;
+
+	for (s = __start_wrap_slots; s < __stop_wrap_slots; s++) {
+		if (*s->addr)
+			continue;
+		if (!*s->lib_handle) {
+			*s->lib_handle = dlopen(s->libpath, RTLD_NOW | RTLD_LOCAL);
+			if (!*s->lib_handle)
+				continue;
+		}
+		sym = __table_dlsym(*s->lib_handle, s->sym, 1, &hint);
+		if (!sym)
+			continue;
+		*s->addr = sym;
+		nr++;
+	}
+	return nr;
+}
+#endif /* HAVE_EAGER_INIT */
+#endif /* !WRAP_RT_CORE */
+
+#ifndef WRAP_RT_GLUE
+#ifdef HAVE_EAGER_INIT
+/*
+ * The part of wrap_eager_init() that doesn't need to hold up the program.
+ * Output files are still only created by the first event logged: a
+ * process that never logs leaves nothing behind.
+ */
+static void *__eager_init_thread(void *arg)
+{
+	(void)arg;
+
+	maps_refresh();
+	if (should_log())
+		(void)flight_get(NULL); /* reads the configuration only */
+	return NULL;
+}
+
+void __hidden wrap_eager_init(void)
+{
+	struct tls_info *tls;
+	pthread_t thread;
+
+	if (libc.dso == (void *)1)
+		return;
+	if (!libc.dso && init_libc_iface(&libc, LIBC_PATH) < 0)
+		return;
+	if (!zlib.dso)
+		init_zlib_iface(&zlib, ZLIB_DFLT_PATH);
+
+#ifndef WRAP_RT_CORE
+	wrapped_dlsym_all(); /* the glue does it (see wrap_rt_glue_init()) */
+#endif
+	setup_wrap_cache();
+
+	/* don't set up the main thread (or its SIGUSR2 handler) yet */
+	tls = peek_tls();
+	bt_prefault(tls, EAGER_PREFAULT_THREADS);
+#if defined(HAVE_FLIGHT_RECORDER) && defined(HAVE_SIGHANDLER)
+	/* ...unless SIGUSR2 can dump the rings from the start */
+	setup_special_sighandler(SIGUSR2);
+#endif
+
+	if (!libc.pthread_create || !libc.pthread_detach)
+		return;
+	if (libc.pthread_create(&thread, NULL, __eager_init_thread, NULL) == 0)
+		libc.pthread_detach(thread);
+}
+#endif /* HAVE_EAGER_INIT */
+#endif /* !WRAP_RT_GLUE */
+
+#ifdef WRAP_RT_CORE
+/* the runtime's own threads: wrapped libraries have keys of their own */
+_static pthread_key_t s_wrapping_key = (pthread_key_t)(-1);
+#else
 pthread_key_t s_wrapping_key = (pthread_key_t)(-1);
+#endif
 
-int __hidden __set_wrapping(void)
+#ifndef WRAP_RT_GLUE
+int __hidden __set_wrapping_key(pthread_key_t *key)
 {
-	if (s_wrapping_key == (pthread_key_t)(-1)) {
-		libc.pthread_key_create(&s_wrapping_key, NULL);
-		libc.pthread_setspecific(s_wrapping_key, NULL);
+	if (*key == (pthread_key_t)(-1)) {
+		if (libc.pthread_key_create(key, NULL) != 0) {
+			/* no way to stop recursion */
+			*key = (pthread_key_t)(-1);
+			return 0;
+		}
+		wrap_setspecific(*key, NULL);
 	}
 
-	if (libc.pthread_getspecific(s_wrapping_key) != NULL)
+	if (wrap_getspecific(*key) != NULL)
 		return 0;
 
-	libc.pthread_setspecific(s_wrapping_key, (void *)1);
+	wrap_setspecific(*key, 1);
 	return 1;
 }
 
+void __hidden __clear_wrapping_key(pthread_key_t *key)
+{
+	if (*key != (pthread_key_t)(-1))
+		wrap_setspecific(*key, NULL);
+}
+
+int __hidden __set_wrapping(void)
+{
+	return __set_wrapping_key(&s_wrapping_key);
+}
+
 void __hidden __clear_wrapping(void)
 {
-	libc.pthread_setspecific(s_wrapping_key, NULL);
+	__clear_wrapping_key(&s_wrapping_key);
 }
+#endif /* !WRAP_RT_GLUE */
+
+#ifndef WRAP_RT_CORE
+/* this library, as the tracing code sees it (see wrap_rt.h) */
+static struct wrap_rt_lib s_rt_lib = {
+	.name = _str(_IBNAM_),
+	.id = -1,
+	.wrapping_key = &s_wrapping_key,
+	.in_text = is_in_wrapped_text,
+};
+#endif
 
+#ifdef WRAP_RT_GLUE
+int wrapped_tracer(const char *symbol, void *symptr, void *regs, void *stack)
+{
+	return wrap_rt_trace(&s_rt_lib, symbol, symptr, regs, stack);
+}
+
+uint32_t wrapped_return(uint32_t fret)
+{
+	return wrap_rt_return(&s_rt_lib, fret);
+}
+
+void wrap_rt_glue_init(void)
+{
+#ifdef HAVE_EAGER_INIT
+	wrapped_dlsym_all();
+#endif
+	wrap_rt_register(&s_rt_lib);
+}
+#else /* !WRAP_RT_GLUE */
 /**
- * @wrapped_tracer Default tracing function that stores a backtrace
+ * @__wrapped_tracer Default tracing function that stores a backtrace
  *
+ * @param lib The wrapped library that was called
  * @param symbol The symbol from which wrapped_tracer is being called
  * @param symptr Pointer to the function symbol in the wrapped library
  * @param regs Pointer to saved register values
  * @param stack Pointer to the top of the stack at function entry
  */
-int wrapped_tracer(const char *symbol, void *symptr, void *regs, void *stack)
+_static inline int __wrapped_tracer(struct wrap_rt_lib *lib,
+				    const char *symbol, void *symptr,
+				    void *regs, void *stack)
 {
-	int did_wrap = 0, _err, parent;
+	int did_wrap = 0, _err, parent, skip, nested = 0;
 	struct tls_info *tls = NULL;
+	struct tls_call outer;
 	uint32_t *u32regs = (uint32_t *)regs;
 
 	if (!regs || !stack || !symbol || libc.dso == (void *)1)
@@ -422,17 +937,37 @@ int wrapped_tracer(const char *symbol, void *symptr, void *regs, void *stack)
 	 * don't trace anything that originates from the wrapped library:
 	 * this is an implementation detail, and we don't want it.
 	 */
-	if (is_in_wrapped_text(u32regs[REG_LR_IDX]))
+	if (lib->in_text(u32regs[REG_LR_IDX]))
 		return 0;
 
+	/* only trace calls from the libraries we were asked to */
+	skip = callers_skip(u32regs[REG_LR_IDX]);
+	if (skip > 0) {
+		*__errno() = _err;
+		return 0;
+	}
+
 	/* we're already tracing - disable recursion */
-	if (!__set_wrapping())
+	if (!__set_wrapping_key(lib->wrapping_key))
 		return 0;
 
+	/* what callers_skip() couldn't tell without locks */
+	if (skip < 0 && callers_check(u32regs[REG_LR_IDX])) {
+		__clear_wrapping_key(lib->wrapping_key);
+		*__errno() = _err;
+		return 0;
+	}
+
 	parent = libc.forking;
 	tls = get_tls();
 	if (!tls)
 		goto out;
+	/* we interrupted another call (see struct tls_call) */
+	nested = tls->in_trace++;
+	if (nested)
+		tls_save_call(tls, &outer);
+	ovh_enter(tls, OVH_OTHER);
+	tls->lib = lib;
 
 	/* initialized once per process */
 	setup_wrap_cache();
@@ -448,13 +983,24 @@ int wrapped_tracer(const char *symbol, void *symptr, void *regs, void *stack)
 	tls->info.should_log = should_log();
 	tls->info.log_time = log_timing;
 
-	if (tls->info.should_log) {
+	if (tls->info.should_log && throttle_skip(tls, wrap_symbol_special)) {
+		/* over the overhead budget: only counted (see wrap_throttle.h) */
+		tls->info.should_log = 0;
+	} else if (tls->info.should_log) {
+#ifndef HAVE_PERCPU_LOG
 		void *f;
+#endif
 		libc.gettimeofday(&tls->info.tv, NULL);
 		tls->info.tv_strlen = libc.snprintf(tls->info.tv_str, sizeof(tls->info.tv_str) - 1,
-						    "%lu.%lu:", (unsigned long)tls->info.tv.tv_sec,
-						    (unsigned long)tls->info.tv.tv_usec);
+						    "%lu.%lu" SEQ_FMT ":",
+						    (unsigned long)tls->info.tv.tv_sec,
+						    (unsigned long)tls->info.tv.tv_usec SEQ_ARG);
 		init_dvm(&dvm);
+#ifdef HAVE_PERCPU_LOG
+		/* the event goes to this CPU's log: see bt_flush() */
+		if (parent && parent != libc.getpid())
+			bt_printf(tls, "LOG:I:FORKED:parent=%d:", parent);
+#else
 		___open_log(tls, 1, &f);
 		if (!f)
 			goto out;
@@ -462,8 +1008,10 @@ int wrapped_tracer(const char *symbol, void *symptr, void *regs, void *stack)
 			log_print(f, LOG, "I:FORKED:parent=%d:", parent);
 			log_flush(f);
 		}
+#endif
 		if (wrap_symbol_notrace(tls)) {
 			/* don't do a backtrace */
+			ovh_enter(tls, OVH_FORMAT);
 			if (wrap_symbol_noargs(tls)) {
 				int slen = 0;
 				const char *callstr;
@@ -481,6 +1029,7 @@ int wrapped_tracer(const char *symbol, void *symptr, void *regs, void *stack)
 					  symbol, u32regs[0], u32regs[1],
 					  u32regs[2], u32regs[3]);
 			}
+			ovh_leave(tls);
 		} else {
 			/* standard backtrace */
 			log_backtrace(tls);
@@ -488,6 +1037,15 @@ int wrapped_tracer(const char *symbol, void *symptr, void *regs, void *stack)
 
 		if (wrap_symbol_notime(tls))
 			tls->info.log_time = 0;
+		else if (!tls->info.log_time &&
+			 (flight_watch(tls) || cct_watch(tls)))
+			tls->info.log_time = WTIME_WALL; /* see wrapped_return() */
+#if defined(HAVE_PERCPU_LOG) || defined(HAVE_FLIGHT_RECORDER)
+		/* events go to this CPU's log (or our ring) once complete */
+		bt_flush(tls, &tls->info);
+#endif
+		flight_check(tls);
+		ovh_count(tls);
 	} else if (tls->logfile) {
 		/*
 		 * We get here is we're not logging, but we have a logfile
@@ -501,7 +1059,9 @@ int wrapped_tracer(const char *symbol, void *symptr, void *regs, void *stack)
 	did_wrap = wrap_special(tls);
 
 out:
-	__clear_wrapping();
+	ovh_leave(tls);
+	throttle_account(tls);
+	__clear_wrapping_key(lib->wrapping_key);
 
 	/*
 	 * reset errno if we didn't wrap, if we _did_ wrap the wrapped_return
@@ -511,18 +1071,76 @@ out:
 		(*__errno()) = _err;
 
 	if (tls && tls->info.should_log && tls->info.log_time) {
-		struct ret_ctx *ret = get_retmem(tls);
-		if (!ret)
-			BUG_MSG(0x4312, "No TLS return value!");
+		/* this library's own: calls it makes into others have theirs */
+		struct ret_ctx *ret = tls_ret(tls, lib);
 		ret->sym = tls->info.symbol;
+		ret->log_time = tls->info.log_time;
+#ifdef WRAP_RT_CORE
+		ret->tv_strlen = tls->info.tv_strlen;
+		libc.memcpy(ret->tv_str, tls->info.tv_str, sizeof(ret->tv_str));
+#endif
 		/* call the function, but return through wrapped_return */
 		did_wrap = -1;
-		libc.clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ret->posix_start);
+		ret->posix_start = wtime_now(tls->info.log_time, &tls->wt);
+	} else if (tls && did_wrap > 0) {
+		/* handled: wrapped_return only hands back the result */
+		tls_ret(tls, lib)->log_time = 0;
+	}
+
+	/* exit() and exec() handlers leave the thread without one */
+	if (tls && tls->in_trace) {
+		if (nested)
+			tls_restore_call(tls, &outer);
+		tls->in_trace--;
 	}
 
 	return did_wrap;
 }
 
+#ifdef WRAP_RT_CORE
+static volatile int s_rt_nr_libs;
+
+/*
+ * A wrapped library's glue checks in, from its constructor (or from its
+ * first traced call, if that comes first), and gets its return state
+ * slot. Libraries past WRAP_RT_MAX_LIBS aren't traced.
+ */
+int wrap_rt_register(struct wrap_rt_lib *lib)
+{
+	int id;
+
+	if (!lib || libc.dso == (void *)1)
+		return -1;
+	if (lib->id >= 0)
+		return 0;
+	if (!libc.dso && init_libc_iface(&libc, LIBC_PATH) < 0)
+		return -1;
+	id = __sync_fetch_and_add(&s_rt_nr_libs, 1);
+	if (id >= WRAP_RT_MAX_LIBS)
+		return -1;
+	/* two threads of the same library: the first id wins */
+	if (!__sync_bool_compare_and_swap(&lib->id, -1, id))
+		return 0;
+	/* the first one in does what each library used to do on its own */
+	if (id == 0)
+		wrap_eager_init();
+	return 0;
+}
+
+int wrap_rt_trace(struct wrap_rt_lib *lib, const char *symbol, void *symptr,
+		  void *regs, void *stack)
+{
+	if (lib->id < 0 && wrap_rt_register(lib) < 0)
+		return 0;
+	return __wrapped_tracer(lib, symbol, symptr, regs, stack);
+}
+#else
+int wrapped_tracer(const char *symbol, void *symptr, void *regs, void *stack)
+{
+	return __wrapped_tracer(&s_rt_lib, symbol, symptr, regs, stack);
+}
+#endif
+
 int __hidden init_libc_iface(struct libc_iface *iface, const char *dso_path)
 {
 	if (!iface->dso) {
@@ -571,8 +1189,20 @@ int __hidden init_libc_iface(struct libc_iface *iface, const char *dso_path)
 	init_sym(iface, 1, fno, fileno);
 	init_sym(iface, 1, fchmod,);
 	init_sym(iface, 1, access,);
+	init_sym(iface, 0, open,);
+	init_sym(iface, 0, write,);
+	init_sym(iface, 0, pread,);
+	init_sym(iface, 0, lseek,);
+	init_sym(iface, 0, flock,);
+	init_sym(iface, 0, fallocate,);
 	init_sym(iface, 0, stat,);
 	init_sym(iface, 0, dirfd,);
+	init_sym(iface, 0, opendir,);
+	init_sym(iface, 0, readdir,);
+	init_sym(iface, 0, closedir,);
+	init_sym(iface, 0, unlink,);
+	init_sym(iface, 0, dup2,);
+	init_sym(iface, 0, kill,);
 	init_sym(iface, 1, getpid,);
 	init_sym(iface, 1, gettid, __thread_selfid);
 	init_sym(iface, 1, nanosleep,);
@@ -589,8 +1219,12 @@ int __hidden init_libc_iface(struct libc_iface *iface, const char *dso_path)
 
 	init_sym(iface, 0, pthread_mutex_lock,);
 	init_sym(iface, 0, pthread_mutex_unlock,);
+	init_sym(iface, 0, pthread_create,);
+	init_sym(iface, 0, pthread_detach,);
+	init_sym(iface, 0, pthread_atfork,);
 
 	init_sym(iface, 1, snprintf,);
+	init_sym(iface, 0, vsnprintf,);
 	init_sym(iface, 1, printf,);
 	init_sym(iface, 1, fprintf,);
 	init_sym(iface, 1, strtol,);
@@ -598,6 +1232,10 @@ int __hidden init_libc_iface(struct libc_iface *iface, const char *dso_path)
 	init_sym(iface, 1, memcpy,);
 	init_sym(iface, 1, malloc,);
 	init_sym(iface, 1, free,);
+	init_sym(iface, 0, syscall,);
+	init_sym(iface, 1, mmap,);
+	init_sym(iface, 1, munmap,);
+	init_sym(iface, 0, close,);
 	init_sym(iface, 1, gettimeofday,);
 	init_sym(iface, 1, clock_gettime,);
 	init_sym(iface, 1, setenv,);
@@ -636,6 +1274,8 @@ int __hidden init_libc_iface(struct libc_iface *iface, const char *dso_path)
 	iface->memset(&dvm, 0, sizeof(dvm));
 	iface->memset(&zlib, 0, sizeof(zlib));
 
+	init_wtime();
+
 	return 0;
 }
 
@@ -645,5 +1285,10 @@ struct ret_ctx __hidden *get_retmem(struct tls_info *tls)
 		tls = get_tls();
 	if (!tls)
 		return NULL;
-	return &tls->ret;
+#ifdef WRAP_RT_CORE
+	if (!tls->lib)
+		return NULL;
+#endif
+	return tls_ret(tls, tls->lib);
 }
+#endif /* !WRAP_RT_GLUE */
@@ -0,0 +1,324 @@
+/*
+ * wrap_maps.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Module map of the traced process (see wrap_maps.h)
+ */
+#include <fcntl.h>
+#include <sys/types.h>
+
+#include "wrap_lib.h"
+#include "wrap_tls.h"
+#include "wrap_alloc.h"
+#include "wrap_budget.h"
+#include "wrap_maps.h"
+
+#define MAPS_READ_SZ (16 * 1024)
+
+/*
+ * Replaced tables are never freed: another thread may still be looking
+ * at one, and they only go away when code is loaded.
+ */
+static struct wmap_table * volatile s_table;
+static uint32_t s_gen;
+static uint64_t s_refresh_ms;
+static volatile int s_refreshing;
+static volatile int s_stale;
+
+/* the whole of /proc/self/maps, NULL terminated */
+static char *__read_maps(size_t *cap_r)
+{
+	size_t cap = MAPS_READ_SZ, len = 0;
+	char *buf, *nbuf;
+	ssize_t n;
+	int fd;
+
+	if (!libc.open || !libc.pread)
+		return NULL;
+	fd = libc.open(MAPS_PATH, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	buf = (char *)walloc(cap);
+	while (buf) {
+		n = libc.pread(fd, buf + len, cap - len - 1, (off_t)len);
+		if (n <= 0)
+			break;
+		len += n;
+		if (len < cap - 1)
+			continue;
+		nbuf = (char *)walloc(cap * 2);
+		if (nbuf)
+			libc.memcpy(nbuf, buf, len);
+		wfree(buf, cap);
+		buf = nbuf;
+		cap *= 2;
+	}
+	libc.close(fd);
+	if (!buf)
+		return NULL;
+
+	buf[len] = 0;
+	*cap_r = cap;
+	return buf;
+}
+
+static inline uintptr_t __hex(const char **s)
+{
+	const char *p = *s;
+	uintptr_t v = 0;
+	int d;
+
+	for (;; p++) {
+		if (*p >= '0' && *p <= '9')
+			d = *p - '0';
+		else if (*p >= 'a' && *p <= 'f')
+			d = *p - 'a' + 10;
+		else
+			break;
+		v = (v << 4) | d;
+	}
+	*s = p;
+	return v;
+}
+
+static inline const char *__skip_field(const char *p)
+{
+	while (*p == ' ')
+		p++;
+	while (*p && *p != ' ' && *p != '\n')
+		p++;
+	while (*p == ' ')
+		p++;
+	return p;
+}
+
+/*
+ * <start>-<end> <perms> <offset> <dev> <inode> <path>
+ * returns the start of the next line
+ */
+static const char *__parse(const char *l, struct wmap *m, int *exec,
+			   int *plen)
+{
+	const char *p = l;
+
+	m->start = __hex(&p);
+	if (*p == '-')
+		p++;
+	m->end = __hex(&p);
+	while (*p == ' ')
+		p++;
+	*exec = (p[0] && p[1] && p[2] == 'x');
+	p = __skip_field(p);
+	m->offset = (uint32_t)__hex(&p);
+	p = __skip_field(p);
+	p = __skip_field(p);
+
+	m->path = p;
+	while (*p && *p != '\n')
+		p++;
+	*plen = p - m->path;
+	return *p ? p + 1 : p;
+}
+
+static struct wmap_table *__build(void)
+{
+	struct wmap_table *t = NULL;
+	struct wmap m;
+	const char *p;
+	char *buf, *str;
+	size_t cap, size, strsz = 0;
+	int exec, plen, count = 0;
+
+	buf = __read_maps(&cap);
+	if (!buf)
+		return NULL;
+
+	for (p = buf; *p; ) {
+		p = __parse(p, &m, &exec, &plen);
+		if (!exec)
+			continue;
+		count++;
+		strsz += plen + 1;
+	}
+
+	size = sizeof(*t) + count * sizeof(struct wmap) + strsz;
+	t = (struct wmap_table *)walloc(size);
+	if (!t)
+		goto out;
+	t->size = size;
+	t->count = 0;
+	str = (char *)&t->ent[count];
+
+	for (p = buf; *p && t->count < count; ) {
+		p = __parse(p, &m, &exec, &plen);
+		if (!exec)
+			continue;
+		libc.memcpy(str, m.path, plen);
+		str[plen] = 0;
+		m.path = str;
+		str += plen + 1;
+		t->ent[t->count++] = m;
+	}
+out:
+	wfree(buf, cap);
+	return t;
+}
+
+const struct wmap_table __hidden *maps_get(void)
+{
+	return s_table;
+}
+
+const struct wmap_table __hidden *maps_refresh(void)
+{
+	struct wmap_table *t;
+	uint64_t now;
+
+	/* code outside of any library misses every time: don't queue up */
+	now = log_now_ms();
+	if (s_table && !s_stale && now - s_refresh_ms < MAPS_REFRESH_MS)
+		return s_table;
+
+	/*
+	 * Whoever is reading the maps may be the code we interrupted (from
+	 * a signal handler): never wait for it, make do with the old map.
+	 */
+	if (__sync_lock_test_and_set(&s_refreshing, 1))
+		return s_table;
+	now = log_now_ms();
+	if (s_table && !s_stale && now - s_refresh_ms < MAPS_REFRESH_MS)
+		goto out;
+	/* an unload while we read the maps leaves us stale again */
+	__sync_lock_release(&s_stale);
+	__sync_synchronize();
+	t = __build();
+	if (t) {
+		t->gen = __sync_add_and_fetch(&s_gen, 1);
+		__sync_synchronize();
+		s_table = t;
+	}
+	s_refresh_ms = now;
+out:
+	t = s_table;
+	__sync_lock_release(&s_refreshing);
+	return t;
+}
+
+const struct wmap __hidden *maps_find(const struct wmap_table *t,
+				      uintptr_t addr)
+{
+	int lo = 0, hi, mid;
+
+	if (!t || !t->count)
+		return NULL;
+	hi = t->count - 1;
+	while (lo < hi) {
+		mid = (lo + hi + 1) / 2;
+		if (t->ent[mid].start <= addr)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	if (addr < t->ent[lo].start || addr >= t->ent[lo].end)
+		return NULL;
+	return &t->ent[lo];
+}
+
+/*
+ * The mapping holding 'addr', in the current module map or, if it isn't
+ * there, in a fresh one: new code (a dlopen) means a new module map.
+ * After an unload (see maps_invalidate()) every lookup tries to refresh
+ * the map until one has been read, since the old entry for 'addr' may
+ * belong to the module that went away. '*tp' gets the table it was
+ * looked up in.
+ */
+const struct wmap __hidden *maps_lookup(uintptr_t addr,
+					const struct wmap_table **tp)
+{
+	const struct wmap_table *t;
+	const struct wmap *m;
+
+	t = maps_get();
+	m = maps_find(t, addr);
+	if (!m || s_stale) {
+		t = maps_refresh();
+		m = maps_find(t, addr);
+	}
+	*tp = t;
+	return m;
+}
+
+void __hidden maps_invalidate(void)
+{
+	s_stale = 1;
+	__sync_synchronize();
+}
+
+void __hidden maps_touch(void)
+{
+	struct wmap_table *t = s_table;
+
+	if (t)
+		t->gen = __sync_add_and_fetch(&s_gen, 1);
+}
+
+int __hidden maps_line(const struct wmap_table *t, uint32_t gen, int i,
+		       char *buf, int len)
+{
+	const struct wmap *m = &t->ent[i];
+
+	return libc.snprintf(buf, len, "MAP:%u:%lx:%lx:%x:%s:", gen,
+			     (unsigned long)m->start, (unsigned long)m->end,
+			     m->offset, m->path);
+}
+
+void __hidden maps_log(struct tls_info *tls, const struct wmap_table *t)
+{
+	char line[TLS_MAX_STRING_LEN + 64];
+	uint32_t gen;
+	int i;
+
+	if (!t)
+		return;
+	gen = t->gen;
+	if (tls->maps.gen == gen)
+		return;
+	for (i = 0; i < t->count; i++) {
+		maps_line(t, gen, i, line, sizeof(line));
+		bt_printf(tls, "%s", line);
+	}
+	tls->maps.gen = gen;
+}
+
+int __hidden maps_stack_bounds(uintptr_t sp, uintptr_t *lo, uintptr_t *hi)
+{
+	struct wmap m;
+	const char *p;
+	char *buf;
+	size_t cap;
+	int exec, plen, ret = -1;
+
+	buf = __read_maps(&cap);
+	if (!buf)
+		return -1;
+	for (p = buf; *p; ) {
+		p = __parse(p, &m, &exec, &plen);
+		if (sp >= m.start && sp < m.end) {
+			*lo = m.start;
+			*hi = m.end;
+			ret = 0;
+			break;
+		}
+	}
+	wfree(buf, cap);
+	return ret;
+}
+
+/* the child logs to new files: they need the map too */
+void __hidden maps_init_child(void)
+{
+	s_refreshing = 0;
+	s_stale = 0;
+	maps_touch();
+}
@@ -0,0 +1,98 @@
+/*
+ * wrap_overhead.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * What the tracer costs the threads it traces (see wrap_overhead.h)
+ */
+#ifdef HAVE_OVERHEAD
+
+#include <sys/types.h>
+
+#include "wrap_lib.h"
+#include "wrap_tls.h"
+#include "wrap_overhead.h"
+#include "wrap_throttle.h"
+#include "backtrace.h"
+
+static struct ovh_stats s_totals;
+static pthread_mutex_t s_totals_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int __ovh_line(char *buf, int len, uint32_t tid,
+		      const struct ovh_stats *st)
+{
+	uint64_t total = 0;
+	int i;
+
+	for (i = 0; i < OVH_NR; i++)
+		total += st->ns[i];
+	return libc.snprintf(buf, len,
+			     "LOG:OVERHEAD:%u:%llu:%llu:%llu:%llu:%llu:%llu:%llu:\n",
+			     tid, (unsigned long long)st->calls,
+			     (unsigned long long)total,
+			     (unsigned long long)st->ns[OVH_UNWIND],
+			     (unsigned long long)st->ns[OVH_FORMAT],
+			     (unsigned long long)st->ns[OVH_COMPRESS],
+			     (unsigned long long)st->ns[OVH_IO],
+			     (unsigned long long)st->ns[OVH_OTHER]);
+}
+
+/*
+ * Log this thread's totals, and add what it did since its last report
+ * to the process totals.
+ */
+void __hidden ovh_report(struct tls_info *tls)
+{
+	struct ovh_thread *o = &tls->ovh;
+	char line[128];
+	int i, len;
+
+	if (o->now.calls == 0)
+		return;
+
+	mtx_lock(&s_totals_lock);
+	s_totals.calls += o->now.calls - o->reported.calls;
+	for (i = 0; i < OVH_NR; i++)
+		s_totals.ns[i] += o->now.ns[i] - o->reported.ns[i];
+	mtx_unlock(&s_totals_lock);
+	o->reported = o->now;
+
+	len = __ovh_line(line, sizeof(line), libc.gettid(), &o->now);
+	if (len <= 0 || len >= (int)sizeof(line))
+		return;
+	line[len - 1] = 0; /* bt_printf() ends the line */
+	if (tls->info.log_pos)
+		bt_printf(tls, "%s", line);
+	else if (tls->logfile)
+		log_print(tls->logfile, LOG, "%s", line + 4);
+	throttle_report(tls);
+}
+
+void __hidden ovh_get_stats(struct ovh_stats *st)
+{
+	mtx_lock(&s_totals_lock);
+	*st = s_totals;
+	mtx_unlock(&s_totals_lock);
+}
+
+int __hidden ovh_stats_line(char *buf, int len)
+{
+	struct ovh_stats st;
+	int n;
+
+	ovh_get_stats(&st);
+	if (st.calls == 0)
+		return 0;
+	n = __ovh_line(buf, len, 0, &st);
+	return n < len ? n : 0;
+}
+
+/* the child starts counting from zero, and with a fresh lock */
+void __hidden ovh_init_child(void)
+{
+	static const pthread_mutex_t init = PTHREAD_MUTEX_INITIALIZER;
+
+	libc.memcpy(&s_totals_lock, &init, sizeof(init));
+	libc.memset(&s_totals, 0, sizeof(s_totals));
+}
+
+#endif /* HAVE_OVERHEAD */
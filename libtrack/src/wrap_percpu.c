@@ -0,0 +1,541 @@
+/*
+ * wrap_percpu.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Per-CPU log buffers (see wrap_percpu.h)
+ *
+ * Each CPU owns a pair of buffers: writers append to buf[gen & 1], the
+ * drainer flips 'gen' and writes out the other one. Appending reserves
+ * space with a restartable sequence that only succeeds if we're still on
+ * the buffer's CPU and 'gen' hasn't moved, so writers never contend on a
+ * cache line another CPU writes to. The drainer flips 'gen' from the
+ * same CPU (it pins itself there) with the same sequence.
+ *
+ * Without rseq, every slot is protected by a mutex instead. Threads that
+ * can't register with rseq in an otherwise rseq-enabled process write to
+ * a separate, mutex protected, overflow slot: the two schemes can't be
+ * mixed on one buffer.
+ */
+#ifdef HAVE_PERCPU_LOG
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <stddef.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+
+#include "wrap_lib.h"
+#include "wrap_tls.h"
+#include "wrap_alloc.h"
+#include "wrap_percpu.h"
+#include "wrap_rseq.h"
+
+#define PERCPU_OVERFLOW   PERCPU_MAX_CPUS
+#define PERCPU_NR_SLOTS   (PERCPU_MAX_CPUS + 1)
+
+#define PERCPU_DRAIN_MS   10
+#define PERCPU_FULL_TRIES 20     /* 1ms waits for the drainer before dropping */
+#define PERCPU_COMMIT_WAIT 10000 /* 100us waits for writers to finish a copy */
+
+struct pcpu_rec {
+	uint32_t tid;
+	uint32_t seq;
+	uint32_t len;
+};
+
+struct pcpu_buf {
+	volatile uint32_t reserve;  /* bytes handed out to writers */
+	volatile uint32_t commit;   /* bytes actually copied in */
+	char data[PERCPU_BUF_SZ];
+};
+
+struct pcpu_log {
+	volatile uint32_t gen;      /* writers append to buf[gen & 1] */
+	pthread_mutex_t lock;       /* non-rseq writers and the drainer */
+	struct pcpu_buf buf[2];
+};
+
+static struct pcpu_log *volatile s_pcpu[PERCPU_NR_SLOTS];
+
+/* 0 = not started, 1 = starting, 2 = running, -1 = unavailable */
+static volatile int s_drain_state;
+static volatile int s_rseq_mode;
+static volatile int s_drain_kick;
+static volatile uint32_t s_sync_req, s_sync_done;
+static volatile int s_sync_finish;
+static unsigned long s_dropped;
+
+/* drainer-only state */
+static struct percpu_thread s_drain_pt;
+static void *s_drain_f;
+static int s_drain_fd = -1;
+static char s_drain_name[TLS_MAX_STRING_LEN];
+
+#define __align4(x) (((x) + 3) & ~3U)
+
+static inline void __sleep_us(long us)
+{
+	struct timespec ts = { us / 1000000, (us % 1000000) * 1000 };
+	libc.nanosleep(&ts, NULL);
+}
+
+static int current_cpu(void)
+{
+#ifdef __NR_getcpu
+	unsigned int cpu = 0;
+	if (libc.syscall && libc.syscall(__NR_getcpu, &cpu, NULL, NULL) == 0)
+		return (int)cpu;
+#endif
+	return 0;
+}
+
+static struct pcpu_log *pcpu_slot(int cpu)
+{
+	static const pthread_mutex_t init = PTHREAD_MUTEX_INITIALIZER;
+	struct pcpu_log *pl;
+
+	pl = s_pcpu[cpu];
+	if (pl)
+		return pl;
+
+	/* fresh mappings are zeroed */
+	pl = (struct pcpu_log *)walloc(sizeof(*pl));
+	if (!pl)
+		return NULL;
+	libc.memcpy(&pl->lock, &init, sizeof(init));
+	if (!__sync_bool_compare_and_swap(&s_pcpu[cpu], NULL, pl)) {
+		wfree(pl, sizeof(*pl));
+		pl = s_pcpu[cpu];
+	}
+	return pl;
+}
+
+#ifdef HAVE_WRAP_RSEQ
+/*
+ * glibc >= 2.35 registers every thread itself, and the kernel only takes
+ * one registration per thread: use the C library's area in that case.
+ */
+static struct wrap_rseq *libc_rseq_area(void)
+{
+#if defined(__GLIBC__) && defined(__x86_64__) && defined(RTLD_DEFAULT)
+	const ptrdiff_t *offset;
+	const unsigned int *size;
+	char *tp;
+
+	offset = (const ptrdiff_t *)dlsym(RTLD_DEFAULT, "__rseq_offset");
+	size = (const unsigned int *)dlsym(RTLD_DEFAULT, "__rseq_size");
+	if (!offset || !size || !*size)
+		return NULL;
+	__asm__ ("mov %%fs:0, %0" : "=r"(tp));
+	return (struct wrap_rseq *)(tp + *offset);
+#else
+	return NULL;
+#endif
+}
+
+static struct wrap_rseq *percpu_rseq(struct percpu_thread *pt)
+{
+	struct wrap_rseq *rs;
+
+	if (pt->rseq_state)
+		return (struct wrap_rseq *)pt->rseq;
+
+	pt->rseq_state = -1;
+	if (!libc.syscall)
+		return NULL;
+
+	rs = wrap_rseq_area(pt->rseq_storage);
+	libc.memset(rs, 0, sizeof(*rs));
+	rs->cpu_id = (uint32_t)-1;
+	if (libc.syscall(__NR_rseq, rs, sizeof(*rs), 0, WRAP_RSEQ_SIG) == 0) {
+		pt->rseq_state = 1;
+	} else if ((*__errno() == EBUSY || *__errno() == EINVAL)
+		   && (rs = libc_rseq_area()) != NULL) {
+		pt->rseq_state = 2;
+	} else {
+		return NULL;
+	}
+	pt->rseq = (void *)rs;
+	return rs;
+}
+
+static void percpu_rseq_release(struct percpu_thread *pt)
+{
+	if (pt->rseq_state == 1)
+		libc.syscall(__NR_rseq, pt->rseq, sizeof(struct wrap_rseq),
+			     WRAP_RSEQ_FLAG_UNREGISTER, WRAP_RSEQ_SIG);
+	pt->rseq = NULL;
+	pt->rseq_state = 0;
+}
+#else
+#define percpu_rseq(pt) ((void)(pt), (struct wrap_rseq *)NULL)
+#define percpu_rseq_release(pt) (void)(pt)
+#endif /* HAVE_WRAP_RSEQ */
+
+/*
+ * Reserve 'need' bytes in the current CPU's buffer.
+ * Returns the buffer with the offset in 'off', or NULL if it's full.
+ */
+static struct pcpu_buf *pcpu_reserve(struct percpu_thread *pt, uint32_t need,
+				     uint32_t *off)
+{
+	struct pcpu_log *pl;
+	struct pcpu_buf *b;
+	uint32_t r;
+	int cpu, running;
+#ifdef HAVE_WRAP_RSEQ
+	struct wrap_rseq *rs = NULL;
+	uint32_t g;
+#endif
+
+	/* s_rseq_mode is only settled once the drainer is running */
+	running = (s_drain_state == 2);
+	__sync_synchronize();
+
+#ifdef HAVE_WRAP_RSEQ
+	if (running && s_rseq_mode)
+		rs = percpu_rseq(pt);
+	while (rs) {
+		cpu = (int)rs->cpu_id_start;
+		if (cpu >= PERCPU_MAX_CPUS)
+			break;
+		pl = pcpu_slot(cpu);
+		if (!pl)
+			return NULL;
+		g = pl->gen;
+		b = &pl->buf[g & 1];
+		r = b->reserve;
+		if (r + need > PERCPU_BUF_SZ)
+			return NULL;
+		if (wrap_rseq_cmp2_store(rs, cpu, &pl->gen, g,
+					 &b->reserve, r, r + need) == 0) {
+			*off = r;
+			return b;
+		}
+		/* migrated, preempted, or the drainer flipped: try again */
+	}
+#endif
+
+	if (!running || s_rseq_mode)
+		cpu = PERCPU_OVERFLOW;
+	else
+		cpu = current_cpu();
+	if (cpu >= PERCPU_MAX_CPUS)
+		cpu = PERCPU_OVERFLOW;
+	pl = pcpu_slot(cpu);
+	if (!pl)
+		return NULL;
+
+	mtx_lock(&pl->lock);
+	b = &pl->buf[pl->gen & 1];
+	r = b->reserve;
+	if (r + need <= PERCPU_BUF_SZ)
+		b->reserve = r + need;
+	else
+		b = NULL;
+	mtx_unlock(&pl->lock);
+
+	*off = r;
+	return b;
+}
+
+/*
+ * Drainer: flip the generation of slot 'cpu' so writers move to the
+ * other buffer. Returns the index of the buffer to drain, or -1.
+ */
+static int pcpu_flip(struct pcpu_log *pl, int cpu)
+{
+	uint32_t g = pl->gen;
+
+#ifdef HAVE_WRAP_RSEQ
+	if (s_rseq_mode && cpu != PERCPU_OVERFLOW) {
+		struct wrap_rseq *rs = (struct wrap_rseq *)s_drain_pt.rseq;
+		unsigned long mask = 1UL << cpu;
+		int i, ret;
+
+		if (libc.syscall(__NR_sched_setaffinity, 0,
+				 sizeof(mask), &mask) < 0)
+			return -1;
+		for (i = 0; i < 100; i++) {
+			ret = wrap_rseq_cmp2_store(rs, cpu, &pl->gen, g,
+						   &pl->gen, g, g + 1);
+			if (ret == 0)
+				return (int)(g & 1);
+			/* wait for the scheduler to move us over */
+			__sleep_us(10);
+		}
+		return -1;
+	}
+#endif
+	(void)cpu;
+	mtx_lock(&pl->lock);
+	pl->gen = g + 1;
+	mtx_unlock(&pl->lock);
+	return (int)(g & 1);
+}
+
+static void pcpu_write(void *data, int len)
+{
+	if (is_container(s_drain_f))
+		container_write(s_drain_f, data, len);
+	else if (zlib.valid)
+		zlib.gzwrite((struct gzFile *)s_drain_f, data, len);
+	else
+		libc.fwrite(data, len, 1, (FILE *)s_drain_f);
+}
+
+static void pcpu_write_out(struct pcpu_buf *b)
+{
+	struct pcpu_rec rec;
+	char marker[48];
+	uint32_t pos = 0;
+	int len;
+
+	if (!s_drain_f)
+		s_drain_f = container_get(NULL);
+	if (!s_drain_f)
+		s_drain_f = __open_logfile(s_drain_name, sizeof(s_drain_name),
+					   "percpu", &s_drain_fd);
+	if (!s_drain_f)
+		return;
+
+	while (pos + sizeof(rec) <= b->commit) {
+		libc.memcpy(&rec, b->data + pos, sizeof(rec));
+		if (!rec.len || pos + sizeof(rec) + rec.len > b->commit)
+			break;
+		len = libc.snprintf(marker, sizeof(marker), "0.0:LOG:TID:%u:%u:\n",
+				    rec.tid, rec.seq);
+		pcpu_write(marker, len);
+		pcpu_write(b->data + pos + sizeof(rec), (int)rec.len);
+		pos += __align4(sizeof(rec) + rec.len);
+	}
+}
+
+/*
+ * Write out and empty a buffer writers have moved off. Returns -1 (and
+ * leaves it alone) if a writer that reserved space in it hasn't
+ * finished its copy: resetting it under that writer would lose its
+ * commit, or let it land in reused space.
+ */
+static int pcpu_drain_buf(struct pcpu_buf *b, int wait)
+{
+	int i;
+
+	/* writers may have reserved space, then been preempted */
+	for (i = 0; b->commit != b->reserve && i < wait; i++)
+		__sleep_us(100);
+	__sync_synchronize();
+	if (b->commit != b->reserve)
+		return -1;
+
+	pcpu_write_out(b);
+	b->commit = 0;
+	__sync_synchronize();
+	b->reserve = 0;
+	return 0;
+}
+
+static void pcpu_drain_slot(struct pcpu_log *pl, int cpu)
+{
+	struct pcpu_buf *idle = &pl->buf[(pl->gen & 1) ^ 1];
+	int idx;
+
+	/* left over from the last pass: writers can't move back onto it */
+	if (idle->reserve && pcpu_drain_buf(idle, 0) < 0)
+		return;
+
+	if (!pl->buf[pl->gen & 1].reserve)
+		return;
+
+	idx = pcpu_flip(pl, cpu);
+	if (idx < 0)
+		return;
+	pcpu_drain_buf(&pl->buf[idx], PERCPU_COMMIT_WAIT);
+}
+
+static void pcpu_drain_all(void)
+{
+	unsigned long all[128 / sizeof(unsigned long)];
+	int have_mask = 0, cpu;
+
+	if (s_rseq_mode)
+		have_mask = libc.syscall(__NR_sched_getaffinity, 0,
+					 sizeof(all), all) > 0;
+
+	for (cpu = 0; cpu < PERCPU_NR_SLOTS; cpu++) {
+		if (s_pcpu[cpu])
+			pcpu_drain_slot(s_pcpu[cpu], cpu);
+	}
+
+	if (have_mask)
+		libc.syscall(__NR_sched_setaffinity, 0, sizeof(all), all);
+
+	if (s_dropped && s_drain_f) {
+		char line[64];
+		int len;
+		len = libc.snprintf(line, sizeof(line),
+				    "0.0:LOG:E:PERCPU_DROPPED:%lu:\n",
+				    __sync_fetch_and_and(&s_dropped, 0));
+		pcpu_write(line, len);
+	}
+}
+
+static void *percpu_drainer(void *arg)
+{
+	uint32_t req;
+	int i;
+
+	(void)arg;
+
+	/* nothing this thread calls should be traced */
+	__set_wrapping();
+
+	/*
+	 * Writers may only use rseq if we can follow them onto their CPU
+	 * to flip their buffers.
+	 */
+	s_rseq_mode = percpu_rseq(&s_drain_pt) != NULL && libc.syscall;
+	__sync_synchronize();
+	s_drain_state = 2;
+
+	for (;;) {
+		for (i = 0; i < PERCPU_DRAIN_MS; i++) {
+			if (s_drain_kick || s_sync_req != s_sync_done)
+				break;
+			__sleep_us(1000);
+		}
+		s_drain_kick = 0;
+		req = s_sync_req;
+
+		pcpu_drain_all();
+
+		if (req != s_sync_done && s_drain_f) {
+			if (is_container(s_drain_f))
+				container_flush(s_drain_f);
+			else if (zlib.valid)
+				zlib.gzflush((struct gzFile *)s_drain_f,
+					     s_sync_finish ? Z_FINISH : Z_SYNC_FLUSH);
+			else
+				libc.fflush((FILE *)s_drain_f);
+		}
+		s_sync_done = req;
+	}
+	return NULL;
+}
+
+/*
+ * Start the drainer on the first commit, without waiting for it: until
+ * it's running (and has picked the locking scheme, see percpu_drainer())
+ * everyone writes to the overflow slot, which is locked either way.
+ */
+static int percpu_start(void)
+{
+	pthread_t th;
+
+	if (s_drain_state == 0 &&
+	    __sync_bool_compare_and_swap(&s_drain_state, 0, 1)) {
+		if (!libc.pthread_create || !libc.nanosleep ||
+		    libc.pthread_create(&th, NULL, percpu_drainer, NULL) != 0)
+			s_drain_state = -1;
+	}
+	return s_drain_state < 0 ? -1 : 0;
+}
+
+int __hidden percpu_log_commit(struct tls_info *tls, const char *buf, int len)
+{
+	struct percpu_thread *pt = &tls->pcpu;
+	struct pcpu_rec rec;
+	struct pcpu_buf *b;
+	uint32_t need, off = 0;
+	int i;
+
+	if (len <= 0)
+		return 0;
+	if (percpu_start() < 0)
+		return -1;
+
+	need = __align4(sizeof(rec) + (uint32_t)len);
+	if (need > PERCPU_BUF_SZ / 4)
+		return -1;
+
+	rec.tid = libc.gettid();
+	rec.seq = pt->seq++;
+	rec.len = (uint32_t)len;
+
+	for (i = 0; (b = pcpu_reserve(pt, need, &off)) == NULL; i++) {
+		/* nobody to wait for yet */
+		if (i == PERCPU_FULL_TRIES || s_drain_state != 2) {
+			__sync_fetch_and_add(&s_dropped, 1);
+			return 0;
+		}
+		s_drain_kick = 1;
+		__sleep_us(1000);
+	}
+
+	libc.memcpy(b->data + off, &rec, sizeof(rec));
+	libc.memcpy(b->data + off + sizeof(rec), buf, len);
+	__sync_fetch_and_add(&b->commit, need);
+	return 0;
+}
+
+/*
+ * Wait for everything committed so far to reach the log (fork/exit/exec)
+ */
+void __hidden percpu_log_sync(int finish)
+{
+	uint32_t req;
+	int i;
+
+	/* the drainer may still be starting, with events waiting for it */
+	for (i = 0; i < 1000 && s_drain_state == 1; i++)
+		__sleep_us(1000);
+	if (s_drain_state != 2)
+		return;
+
+	s_sync_finish = finish;
+	req = __sync_add_and_fetch(&s_sync_req, 1);
+	for (i = 0; i < 1000 && (int32_t)(s_sync_done - req) < 0; i++)
+		__sleep_us(1000);
+}
+
+void __hidden percpu_thread_release(struct tls_info *tls)
+{
+	if (!tls)
+		return;
+	percpu_rseq_release(&tls->pcpu);
+}
+
+/*
+ * The drainer didn't survive the fork(): forget the parent's buffers (it
+ * synced before forking), and start a new drainer on the first commit.
+ */
+void __hidden percpu_init_child(void)
+{
+	static const pthread_mutex_t init = PTHREAD_MUTEX_INITIALIZER;
+	struct pcpu_log *pl;
+	int cpu;
+
+	for (cpu = 0; cpu < PERCPU_NR_SLOTS; cpu++) {
+		pl = s_pcpu[cpu];
+		if (!pl)
+			continue;
+		libc.memcpy(&pl->lock, &init, sizeof(init));
+		pl->buf[0].reserve = pl->buf[0].commit = 0;
+		pl->buf[1].reserve = pl->buf[1].commit = 0;
+	}
+
+	if (s_drain_f && !is_container(s_drain_f) && s_drain_fd >= 0
+	    && libc.close)
+		libc.close(s_drain_fd);
+	s_drain_f = NULL;
+	s_drain_fd = -1;
+	s_drain_pt.rseq = NULL;
+	s_drain_pt.rseq_state = 0;
+
+	s_sync_req = s_sync_done = 0;
+	s_drain_kick = 0;
+	s_dropped = 0;
+	s_drain_state = 0;
+}
+
+#endif /* HAVE_PERCPU_LOG */
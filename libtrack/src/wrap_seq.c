@@ -0,0 +1,73 @@
+/*
+ * wrap_seq.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Global event sequence numbers (see wrap_seq.h)
+ */
+#ifdef HAVE_EVENT_SEQ
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "wrap_lib.h"
+#include "wrap_seq.h"
+
+static volatile int s_seq_state;    /* 0 = not mapped, 1 = mapping, 2 = done */
+static volatile uint64_t *s_seq;
+static volatile uint64_t s_local_seq;
+
+/* the shared counter, or NULL */
+static volatile uint64_t *__map(void)
+{
+	static const char zero[SEQ_MAP_SZ];
+	void *map = MAP_FAILED;
+	off_t end;
+	int fd, n;
+
+	if (!libc.open || !libc.mmap || !libc.flock || !libc.lseek ||
+	    !libc.write)
+		return NULL;
+	fd = libc.open(SEQ_MAP_PATH, O_RDWR | O_CREAT, 0666);
+	if (fd < 0)
+		return NULL;
+	libc.fchmod(fd, 0666);
+
+	/*
+	 * whoever gets here first makes the file big enough: a mapping past
+	 * its end would fault, so anything short of that leaves us our own
+	 */
+	libc.flock(fd, LOCK_EX);
+	end = libc.lseek(fd, 0, SEEK_END);
+	while (end >= 0 && end < SEQ_MAP_SZ) {
+		n = libc.write(fd, zero, SEQ_MAP_SZ - end);
+		if (n <= 0)
+			break;
+		end += n;
+	}
+	libc.flock(fd, LOCK_UN);
+
+	if (end >= SEQ_MAP_SZ)
+		map = libc.mmap(NULL, SEQ_MAP_SZ, PROT_READ | PROT_WRITE,
+				MAP_SHARED, fd, 0);
+	libc.close(fd);
+	if (map == MAP_FAILED)
+		return NULL;
+	return (volatile uint64_t *)map;
+}
+
+uint64_t __hidden seq_next(void)
+{
+	volatile uint64_t *seq;
+
+	if (once_begin(&s_seq_state)) {
+		seq = __map();
+		s_seq = seq ? seq : &s_local_seq;
+		once_end(&s_seq_state);
+	}
+	return __sync_add_and_fetch(s_seq, 1);
+}
+
+#endif /* HAVE_EVENT_SEQ */
@@ -0,0 +1,372 @@
+/*
+ * wrap_syms.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Address to symbol lookups, without dladdr() (see wrap_syms.h)
+ */
+#include <elf.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+
+#include "wrap_lib.h"
+#include "wrap_alloc.h"
+#include "wrap_maps.h"
+#include "wrap_syms.h"
+
+#ifdef __LP64__
+#define ELFCLASS_NATIVE ELFCLASS64
+typedef Elf64_Ehdr Elf_Ehdr;
+typedef Elf64_Phdr Elf_Phdr;
+typedef Elf64_Shdr Elf_Shdr;
+typedef Elf64_Sym  Elf_Sym;
+#define ELF_ST_TYPE ELF64_ST_TYPE
+#define ELF_ST_BIND ELF64_ST_BIND
+#else
+#define ELFCLASS_NATIVE ELFCLASS32
+typedef Elf32_Ehdr Elf_Ehdr;
+typedef Elf32_Phdr Elf_Phdr;
+typedef Elf32_Shdr Elf_Shdr;
+typedef Elf32_Sym  Elf_Sym;
+#define ELF_ST_TYPE ELF32_ST_TYPE
+#define ELF_ST_BIND ELF32_ST_BIND
+#endif
+
+#define SYMS_PAGE_MASK (~(uintptr_t)4095)
+
+struct wsym {
+	uintptr_t addr;             /* link-time address */
+	uint32_t  size;
+	uint32_t  name;             /* offset into the module's names */
+	int       bind;
+};
+
+/* the symbols of one file, loaded at one address */
+struct syms_mod {
+	struct syms_mod *next;
+	const char *path;           /* points into the map that loaded it */
+	uintptr_t bias;             /* runtime - link-time address */
+	uintptr_t base;             /* dli_fbase */
+	uintptr_t end;              /* end of the highest segment */
+	uint32_t  nr;
+	struct wsym *sym;
+	char     *names;
+};
+
+/*
+ * The module of each mapping of one module map: looked up the first
+ * time an address in the mapping is. Old views are never freed.
+ */
+struct syms_view {
+	const struct wmap_table *t;
+	struct syms_mod * volatile mod[0];
+};
+
+/* a mapping whose file we couldn't read */
+static struct syms_mod s_nosyms;
+
+static struct syms_mod *s_mods;
+static struct syms_view * volatile s_view;
+static pthread_mutex_t s_syms_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline int __sym_lt(const struct wsym *a, const struct wsym *b)
+{
+	if (a->addr != b->addr)
+		return a->addr < b->addr;
+	/* at the same address: globals, then the ones with a size, first */
+	if ((a->bind == STB_GLOBAL) != (b->bind == STB_GLOBAL))
+		return a->bind == STB_GLOBAL;
+	return a->size > b->size;
+}
+
+static void __sift(struct wsym *s, uint32_t i, uint32_t n)
+{
+	struct wsym tmp;
+	uint32_t c;
+
+	for (; (c = 2 * i + 1) < n; i = c) {
+		if (c + 1 < n && __sym_lt(&s[c], &s[c + 1]))
+			c++;
+		if (!__sym_lt(&s[i], &s[c]))
+			break;
+		tmp = s[i];
+		s[i] = s[c];
+		s[c] = tmp;
+	}
+}
+
+/* no qsort() in the iface: heapsort, nothing to allocate */
+static void __sort(struct wsym *s, uint32_t n)
+{
+	struct wsym tmp;
+	uint32_t i;
+
+	for (i = n / 2; i > 0; i--)
+		__sift(s, i - 1, n);
+	for (i = n; i > 1; i--) {
+		tmp = s[0];
+		s[0] = s[i - 1];
+		s[i - 1] = tmp;
+		__sift(s, 0, i - 1);
+	}
+}
+
+static int __want(const Elf_Sym *sym)
+{
+	int type = ELF_ST_TYPE(sym->st_info);
+
+	if (sym->st_shndx == SHN_UNDEF || sym->st_shndx >= SHN_LORESERVE)
+		return 0;
+	return (type == STT_FUNC || type == STT_GNU_IFUNC) && sym->st_name;
+}
+
+/* read the function symbols out of 'shdr' into 'mod' */
+static int __load_symtab(struct syms_mod *mod, const uint8_t *file,
+			 size_t size, const Elf_Shdr *shdr,
+			 const Elf_Shdr *strtab)
+{
+	const Elf_Sym *syms;
+	const char *strs, *name;
+	uint32_t i, j, n, count = 0;
+	size_t names = 0, len;
+
+	if (shdr->sh_offset + shdr->sh_size > size ||
+	    strtab->sh_offset + strtab->sh_size > size ||
+	    shdr->sh_entsize != sizeof(Elf_Sym))
+		return -1;
+	syms = (const Elf_Sym *)(file + shdr->sh_offset);
+	strs = (const char *)(file + strtab->sh_offset);
+	n = shdr->sh_size / sizeof(Elf_Sym);
+
+	for (i = 0; i < n; i++) {
+		if (!__want(&syms[i]) || syms[i].st_name >= strtab->sh_size)
+			continue;
+		count++;
+		names += local_strlen(strs + syms[i].st_name) + 1;
+	}
+	if (!count)
+		return -1;
+
+	mod->sym = (struct wsym *)walloc(count * sizeof(struct wsym));
+	mod->names = (char *)walloc(names);
+	if (!mod->sym || !mod->names)
+		goto err;
+
+	names = 0;
+	for (i = 0, j = 0; i < n && j < count; i++) {
+		if (!__want(&syms[i]) || syms[i].st_name >= strtab->sh_size)
+			continue;
+		name = strs + syms[i].st_name;
+		len = local_strlen(name) + 1;
+		libc.memcpy(mod->names + names, name, len);
+#ifdef __arm__
+		mod->sym[j].addr = syms[i].st_value & ~(uintptr_t)1; /* thumb */
+#else
+		mod->sym[j].addr = syms[i].st_value;
+#endif
+		mod->sym[j].size = (uint32_t)syms[i].st_size;
+		mod->sym[j].name = (uint32_t)names;
+		mod->sym[j].bind = ELF_ST_BIND(syms[i].st_info);
+		names += len;
+		j++;
+	}
+	__sort(mod->sym, count);
+
+	/* one symbol per address */
+	for (i = 1, j = 1; i < count; i++) {
+		if (mod->sym[i].addr != mod->sym[j - 1].addr)
+			mod->sym[j++] = mod->sym[i];
+	}
+	mod->nr = j; /* modules aren't freed: keep the whole array */
+	return 0;
+
+err:
+	if (mod->sym)
+		wfree(mod->sym, count * sizeof(struct wsym));
+	if (mod->names)
+		wfree(mod->names, names);
+	mod->sym = NULL;
+	mod->names = NULL;
+	return -1;
+}
+
+/* symbols, and where they are, for the file mapped at 'm' */
+static int __load(struct syms_mod *mod, const struct wmap *m)
+{
+	const Elf_Ehdr *eh;
+	const Elf_Phdr *ph;
+	const Elf_Shdr *sh, *symtab = NULL, *dynsym = NULL, *tab;
+	uintptr_t lo = ~(uintptr_t)0, hi = 0;
+	uint8_t *file;
+	off_t size;
+	int fd, i, found = 0, ret = -1;
+
+	if (!m->path || m->path[0] != '/')
+		return -1;
+	fd = libc.open(m->path, O_RDONLY);
+	if (fd < 0)
+		return -1;
+	size = libc.lseek(fd, 0, SEEK_END);
+	if (size < (off_t)sizeof(*eh) ||
+	    size > (off_t)SYMS_MAX_FILE_MB * 1024 * 1024) {
+		libc.close(fd);
+		return -1;
+	}
+	file = (uint8_t *)libc.mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	libc.close(fd);
+	if (file == MAP_FAILED)
+		return -1;
+
+	eh = (const Elf_Ehdr *)file;
+	if (local_strncmp((const char *)eh->e_ident, ELFMAG, SELFMAG) != 0 ||
+	    eh->e_ident[EI_CLASS] != ELFCLASS_NATIVE ||
+	    eh->e_phoff + eh->e_phnum * sizeof(*ph) > (size_t)size ||
+	    eh->e_shoff + eh->e_shnum * sizeof(*sh) > (size_t)size)
+		goto out;
+
+	/* the load bias, from the segment this mapping comes from */
+	ph = (const Elf_Phdr *)(file + eh->e_phoff);
+	for (i = 0; i < eh->e_phnum; i++) {
+		if (ph[i].p_type != PT_LOAD)
+			continue;
+		if (ph[i].p_vaddr < lo)
+			lo = ph[i].p_vaddr;
+		if (ph[i].p_vaddr + ph[i].p_memsz > hi)
+			hi = ph[i].p_vaddr + ph[i].p_memsz;
+		if (found || m->offset < (ph[i].p_offset & SYMS_PAGE_MASK) ||
+		    m->offset >= ph[i].p_offset + ph[i].p_filesz)
+			continue;
+		mod->bias = m->start - (m->offset - ph[i].p_offset)
+				- ph[i].p_vaddr;
+		found = 1;
+	}
+	if (!found)
+		goto out;
+	mod->base = mod->bias + (lo & SYMS_PAGE_MASK);
+	mod->end = mod->bias + hi;
+
+	sh = (const Elf_Shdr *)(file + eh->e_shoff);
+	for (i = 0; i < eh->e_shnum; i++) {
+		if (sh[i].sh_type == SHT_SYMTAB)
+			symtab = &sh[i];
+		else if (sh[i].sh_type == SHT_DYNSYM)
+			dynsym = &sh[i];
+	}
+	tab = symtab ? symtab : dynsym;
+	if (!tab || tab->sh_link >= eh->e_shnum)
+		goto out;
+	ret = __load_symtab(mod, file, size, tab, &sh[tab->sh_link]);
+	if (ret < 0 && tab == symtab && dynsym &&
+	    dynsym->sh_link < eh->e_shnum)
+		ret = __load_symtab(mod, file, size, dynsym,
+				    &sh[dynsym->sh_link]);
+out:
+	libc.munmap(file, size);
+	return ret;
+}
+
+/* called with s_syms_lock held */
+static struct syms_mod *__mod(const struct wmap *m)
+{
+	struct syms_mod *mod;
+
+	/* another mapping of the same file, loaded at the same place */
+	for (mod = s_mods; mod; mod = mod->next) {
+		if (m->start >= mod->base && m->start < mod->end &&
+		    local_strcmp(mod->path, m->path) == 0)
+			break;
+	}
+	if (mod)
+		return mod;
+
+	mod = (struct syms_mod *)walloc(sizeof(*mod));
+	if (!mod)
+		return &s_nosyms;
+	libc.memset(mod, 0, sizeof(*mod));
+	if (__load(mod, m) < 0) {
+		wfree(mod, sizeof(*mod));
+		return &s_nosyms;
+	}
+	mod->path = m->path;
+	mod->next = s_mods;
+	s_mods = mod;
+	return mod;
+}
+
+static struct syms_mod *__lookup_mod(const struct wmap_table *t,
+				     const struct wmap *m)
+{
+	struct syms_view *v = s_view;
+	struct syms_mod *mod;
+	int i = m - t->ent;
+
+	if (v && v->t == t && v->mod[i])
+		return v->mod[i];
+
+	mtx_lock(&s_syms_lock);
+	v = s_view;
+	if (!v || v->t != t) {
+		v = (struct syms_view *)walloc(sizeof(*v) +
+					       t->count * sizeof(v->mod[0]));
+		if (!v) {
+			mod = &s_nosyms;
+			goto out;
+		}
+		libc.memset(v, 0, sizeof(*v) + t->count * sizeof(v->mod[0]));
+		v->t = t;
+		__sync_synchronize();
+		s_view = v;
+	}
+	mod = v->mod[i];
+	if (!mod) {
+		mod = __mod(m);
+		__sync_synchronize();
+		v->mod[i] = mod;
+	}
+out:
+	mtx_unlock(&s_syms_lock);
+	return mod;
+}
+
+int __hidden syms_dladdr(const void *addr, Dl_info *dli)
+{
+	const struct wmap_table *t;
+	const struct wmap *m;
+	const struct syms_mod *mod;
+	const struct wsym *s;
+	uintptr_t pc = (uintptr_t)addr;
+	uint32_t lo, hi, mid;
+
+	m = maps_lookup(pc, &t);
+	if (!m)
+		return dladdr(addr, dli);
+	mod = __lookup_mod(t, m);
+	if (mod == &s_nosyms)
+		return dladdr(addr, dli);
+
+	dli->dli_fname = mod->path;
+	dli->dli_fbase = (void *)mod->base;
+	dli->dli_sname = NULL;
+	dli->dli_saddr = NULL;
+
+	/* the last symbol at or below pc */
+	pc -= mod->bias;
+	if (!mod->nr || pc < mod->sym[0].addr)
+		return 1;
+	lo = 0;
+	hi = mod->nr - 1;
+	while (lo < hi) {
+		mid = (lo + hi + 1) / 2;
+		if (mod->sym[mid].addr <= pc)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	s = &mod->sym[lo];
+	if (s->size && pc >= s->addr + s->size)
+		return 1;
+	dli->dli_sname = mod->names + s->name;
+	dli->dli_saddr = (void *)(s->addr + mod->bias);
+	return 1;
+}
@@ -0,0 +1,321 @@
+/*
+ * wrap_throttle.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Hold the tracer to a CPU overhead budget (see wrap_throttle.h)
+ */
+#ifdef HAVE_OVERHEAD
+
+#include <sys/types.h>
+
+#include "wrap_lib.h"
+#include "wrap_tls.h"
+#include "wrap_overhead.h"
+#include "wrap_throttle.h"
+#include "backtrace.h"
+
+#define THROTTLE_PROBE  16
+
+struct throttle_sym {
+	const char *sym;            /* NULL: a free slot */
+	volatile uint32_t calls;
+	volatile uint32_t logged;
+	volatile uint32_t win_ns;   /* tracer time since the last step */
+	volatile uint8_t shift;     /* log 1 call in 2^shift */
+	uint8_t exempt;
+};
+
+struct throttle {
+	volatile int state;         /* 0 = not read, 1 = reading, 2 = read */
+	int budget;                 /* per mille, 0 = off */
+	volatile int busy;          /* one thread takes a step at a time */
+	int throttled;              /* symbols that aren't fully traced */
+	int permille;               /* the overhead that led to the last step */
+	uint64_t last_ms;
+	struct throttle_sym sym[THROTTLE_SYMS];
+};
+
+static struct throttle s_throttle;
+
+volatile int throttle_frames __hidden = MAX_BT_FRAMES;
+
+/* "<percent>[.<tenths>]" */
+static void __read_cfg(struct throttle *t)
+{
+	char buf[32];
+	char *end;
+	long val;
+	FILE *f;
+
+	f = libc.fopen(THROTTLE_CFG_PATH, "r");
+	if (!f)
+		return;
+	libc.memset(buf, 0, sizeof(buf));
+	if (libc.fread(buf, 1, sizeof(buf) - 1, f) <= 0)
+		goto out;
+
+	val = libc.strtol(buf, &end, 10);
+	if (end == buf || val < 0)
+		goto out;
+	val *= 10;
+	if (*end == '.' && end[1] >= '0' && end[1] <= '9')
+		val += end[1] - '0';
+	t->budget = (int)val;
+out:
+	libc.fclose(f);
+}
+
+static inline struct throttle *__throttle(void)
+{
+	struct throttle *t = &s_throttle;
+
+	if (once_begin(&t->state)) {
+		__read_cfg(t);
+		once_end(&t->state);
+	}
+	return t;
+}
+
+/* wrappers pass the same string for every call of a symbol */
+static struct throttle_sym *__lookup(struct throttle *t, struct tls_info *tls,
+				     int (*special)(struct tls_info *tls))
+{
+	const char *sym = tls->info.symbol;
+	struct throttle_sym *e;
+	uint32_t h;
+	int i;
+
+	h = (uint32_t)((uintptr_t)sym >> 2) * 2654435761u;
+	for (i = 0; i < THROTTLE_PROBE; i++) {
+		e = &t->sym[(h + i) & (THROTTLE_SYMS - 1)];
+		if (e->sym == sym)
+			return e;
+		if (!e->sym && __sync_bool_compare_and_swap(&e->sym, NULL, sym)) {
+			e->exempt = special(tls) ? 1 : 0;
+			return e;
+		}
+		if (e->sym == sym)
+			return e;
+	}
+	return NULL; /* too many symbols: this one is always traced */
+}
+
+int __hidden throttle_skip(struct tls_info *tls,
+			   int (*special)(struct tls_info *tls))
+{
+	struct throttle *t = __throttle();
+	struct throttle_sym *e;
+	uint32_t n;
+	uint8_t shift;
+
+	tls->thr.sym = NULL;
+	if (!t->budget)
+		return 0;
+
+	e = __lookup(t, tls, special);
+	if (!e)
+		return 0;
+	n = __sync_add_and_fetch(&e->calls, 1);
+	shift = e->shift;
+	if (shift >= THROTTLE_COUNT_ONLY ||
+	    (shift && (n & ((1u << shift) - 1)) != 0))
+		return 1;
+	tls->thr.sym = e;
+	return 0;
+}
+
+static void __log_line(struct tls_info *tls, const char *line)
+{
+	if (tls->info.log_pos)
+		bt_printf(tls, "LOG:%s", line);
+	else if (tls->logfile)
+		log_print(tls->logfile, LOG, "%s", line);
+}
+
+static void __log_rate(struct tls_info *tls, struct throttle_sym *e,
+		       int permille)
+{
+	char line[MAX_LINE_LEN];
+
+	libc.snprintf(line, sizeof(line), "OVERHEAD:RATE:%d:%s:%u:%u:%u:",
+		      permille, e->sym,
+		      e->shift >= THROTTLE_COUNT_ONLY ? 0 : 1u << e->shift,
+		      e->calls, e->logged);
+	__log_line(tls, line);
+}
+
+static void __log_frames(struct tls_info *tls, int permille)
+{
+	char line[64];
+
+	libc.snprintf(line, sizeof(line), "OVERHEAD:FRAMES:%d:%d:",
+		      permille, throttle_frames);
+	__log_line(tls, line);
+}
+
+/* over budget: a bit less tracing */
+static int __step_down(struct throttle *t, struct tls_info *tls, int permille)
+{
+	struct throttle_sym *e, *hot = NULL;
+	int i;
+
+	if (throttle_frames > THROTTLE_MIN_FRAMES) {
+		throttle_frames = throttle_frames / 2 < THROTTLE_MIN_FRAMES ?
+				  THROTTLE_MIN_FRAMES : throttle_frames / 2;
+		__log_frames(tls, permille);
+		return 1;
+	}
+
+	for (i = 0; i < THROTTLE_SYMS; i++) {
+		e = &t->sym[i];
+		if (!e->sym || e->exempt || e->shift >= THROTTLE_COUNT_ONLY)
+			continue;
+		if (e->win_ns && (!hot || e->win_ns > hot->win_ns))
+			hot = e;
+	}
+	if (!hot)
+		return 0;
+	if (hot->shift++ == 0)
+		t->throttled++;
+	__log_rate(tls, hot, permille);
+	return 1;
+}
+
+/* well under budget: a bit more, the least traced symbols first */
+static int __step_up(struct throttle *t, struct tls_info *tls, int permille)
+{
+	struct throttle_sym *e, *cold = NULL;
+	int i;
+
+	for (i = 0; t->throttled && i < THROTTLE_SYMS; i++) {
+		e = &t->sym[i];
+		if (e->sym && e->shift && (!cold || e->shift > cold->shift))
+			cold = e;
+	}
+	if (cold) {
+		if (--cold->shift == 0)
+			t->throttled--;
+		__log_rate(tls, cold, permille);
+		return 1;
+	}
+
+	if (throttle_frames < MAX_BT_FRAMES) {
+		throttle_frames = throttle_frames * 2 > MAX_BT_FRAMES ?
+				  MAX_BT_FRAMES : throttle_frames * 2;
+		__log_frames(tls, permille);
+		return 1;
+	}
+	return 0;
+}
+
+static void __step(struct throttle *t, struct tls_info *tls, int permille)
+{
+	uint64_t now;
+	int i, stepped = 0;
+
+	if (permille <= t->budget && permille * 2 >= t->budget)
+		return;
+	if (!__sync_bool_compare_and_swap(&t->busy, 0, 1))
+		return;
+
+	now = log_now_ms();
+	if (now - t->last_ms < THROTTLE_HOLD_MS)
+		goto out;
+
+	if (permille > t->budget)
+		stepped = __step_down(t, tls, permille);
+	else
+		stepped = __step_up(t, tls, permille);
+	if (!stepped)
+		goto out;
+
+	t->last_ms = now;
+	t->permille = permille;
+	/* the next step goes by what happens after this one */
+	for (i = 0; i < THROTTLE_SYMS; i++)
+		t->sym[i].win_ns = 0;
+out:
+	__sync_lock_release(&t->busy);
+}
+
+/*
+ * How much of this thread's CPU time went to the tracer, since the last
+ * check?
+ */
+static void __check(struct throttle *t, struct tls_info *tls)
+{
+	struct throttle_thread *th = &tls->thr;
+	uint64_t cpu, tracer = 0, d_cpu, d_tracer, app, permille;
+	int i;
+
+	cpu = wtime_thread_ns(&tls->wt);
+	for (i = 0; i < OVH_NR; i++)
+		tracer += tls->ovh.now.ns[i];
+
+	if (!th->cpu_ns)
+		goto snapshot;
+	d_cpu = cpu - th->cpu_ns;
+	if (d_cpu < THROTTLE_MIN_CPU_NS)
+		return;
+	/* the tracer's time is wall time: it may have blocked on I/O */
+	d_tracer = tracer - th->tracer_ns;
+	app = d_cpu > d_tracer ? d_cpu - d_tracer : 1;
+	permille = d_tracer * 1000 / app;
+	__step(t, tls, permille > 1000000 ? 1000000 : (int)permille);
+snapshot:
+	th->cpu_ns = cpu;
+	th->tracer_ns = tracer;
+}
+
+void __hidden throttle_account(struct tls_info *tls)
+{
+	struct throttle *t = &s_throttle;
+	struct throttle_sym *e;
+	uint64_t ns;
+
+	if (!tls || !t->budget)
+		return;
+
+	e = tls->thr.sym;
+	if (e) {
+		tls->thr.sym = NULL;
+		ns = tls->ovh.call_ns;
+		__sync_fetch_and_add(&e->logged, 1);
+		__sync_fetch_and_add(&e->win_ns,
+				     ns > 1000000000ULL ? 1000000000u
+							: (uint32_t)ns);
+	}
+	if (++tls->thr.calls < THROTTLE_CALLS)
+		return;
+	tls->thr.calls = 0;
+	__check(t, tls);
+}
+
+/* where every symbol that isn't fully traced stands */
+void __hidden throttle_report(struct tls_info *tls)
+{
+	struct throttle *t = &s_throttle;
+	int i;
+
+	if (!t->budget || !t->throttled)
+		return;
+	for (i = 0; i < THROTTLE_SYMS; i++) {
+		if (t->sym[i].sym && t->sym[i].shift)
+			__log_rate(tls, &t->sym[i], t->permille);
+	}
+}
+
+/* the child starts over: everything traced, nothing counted */
+void __hidden throttle_init_child(void)
+{
+	struct throttle *t = &s_throttle;
+
+	libc.memset(t->sym, 0, sizeof(t->sym));
+	t->busy = 0;
+	t->throttled = 0;
+	t->permille = 0;
+	t->last_ms = 0;
+	throttle_frames = MAX_BT_FRAMES;
+}
+
+#endif /* HAVE_OVERHEAD */
@@ -0,0 +1,199 @@
+/*
+ * wrap_time.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Timing backend for wrapped calls: the old code bracketed every timed
+ * call with two clock_gettime(CLOCK_THREAD_CPUTIME_ID) system calls, which
+ * dominated the measurement of short calls. Wall time now comes from a
+ * user-readable counter (TSC / generic timer) where we have one, and
+ * thread CPU time from a self-monitoring perf_event counter.
+ */
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+
+#include "wrap_lib.h"
+#include "wrap_time.h"
+
+#ifndef PAGE_SIZE
+#define PAGE_SIZE 4096
+#endif
+
+struct wtime_clock wclock __hidden;
+
+static inline uint64_t __mono_ns(void)
+{
+	struct timespec ts;
+	libc.clock_gettime(CLOCK_MONOTONIC, &ts);
+	return wtime_ts2ns(&ts);
+}
+
+#ifdef HAVE_WTIME_PERF
+static long perf_open(struct perf_event_attr *attr)
+{
+	if (!libc.syscall)
+		return -1;
+	return libc.syscall(__NR_perf_event_open, attr, 0, -1, -1, 0);
+}
+
+static struct perf_event_mmap_page *perf_map(int fd)
+{
+	void *pc;
+
+	pc = libc.mmap(NULL, PAGE_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+	if (pc == MAP_FAILED)
+		return NULL;
+	return (struct perf_event_mmap_page *)pc;
+}
+
+/* the kernel's TSC -> ns conversion: better than calibrating */
+static int perf_clock_params(void)
+{
+	struct perf_event_attr attr;
+	struct perf_event_mmap_page *pc;
+	int fd, ret = -1;
+
+	libc.memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_SOFTWARE;
+	attr.config = PERF_COUNT_SW_TASK_CLOCK;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+
+	fd = (int)perf_open(&attr);
+	if (fd < 0)
+		return -1;
+	pc = perf_map(fd);
+	if (pc) {
+		ret = wtime_perf_params(pc, &wclock.mult, &wclock.shift);
+		libc.munmap(pc, PAGE_SIZE);
+	}
+	libc.close(fd);
+	return ret;
+}
+#endif /* HAVE_WTIME_PERF */
+
+#ifdef HAVE_WTIME_COUNTER
+static void calibrate_counter(void)
+{
+	uint32_t mult;
+
+#if defined(__aarch64__)
+	uint64_t freq;
+	__asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(freq));
+	if (freq) {
+		wclock.shift = WTIME_SHIFT;
+		wclock.mult = (uint32_t)((1000000000ULL << WTIME_SHIFT) / freq);
+		return;
+	}
+#endif
+	mult = wtime_calibrate(__mono_ns);
+	if (!mult)
+		return;
+	wclock.shift = WTIME_SHIFT;
+	wclock.mult = mult;
+}
+#endif
+
+/*
+ * Called once per process (from init_libc_iface)
+ */
+void __hidden init_wtime(void)
+{
+	if (wclock.mult)
+		return;
+
+#ifdef HAVE_WTIME_COUNTER
+#ifdef HAVE_WTIME_PERF
+	if (!wtime_tsc_invariant())
+		return;
+	if (perf_clock_params() == 0)
+		return;
+#endif
+	calibrate_counter();
+#endif
+}
+
+#ifdef HAVE_WTIME_PERF
+static void wtime_open_thread(struct wtime_thread *wt)
+{
+	struct perf_event_attr attr;
+	struct perf_event_mmap_page *pc;
+	struct timespec ts;
+	int fd;
+
+	wt->state = -1;
+	wt->fd = -1;
+	wt->pc = NULL;
+
+	/* reference cycles tick at the TSC rate: convert with wclock */
+	if (!wclock.mult)
+		return;
+
+	libc.memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = PERF_COUNT_HW_REF_CPU_CYCLES;
+	attr.exclude_hv = 1;
+
+	fd = (int)perf_open(&attr);
+	if (fd < 0) {
+		/* perf_event_paranoid may only allow user-space counting */
+		attr.exclude_kernel = 1;
+		fd = (int)perf_open(&attr);
+		if (fd < 0)
+			return;
+	}
+
+	pc = perf_map(fd);
+	if (!pc) {
+		libc.close(fd);
+		return;
+	}
+	if (!pc->cap_user_rdpmc || wtime_perf_read(pc, &wt->base_cyc) < 0) {
+		libc.munmap(pc, PAGE_SIZE);
+		libc.close(fd);
+		return;
+	}
+	libc.clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	wt->base_ns = wtime_ts2ns(&ts);
+
+	wt->fd = fd;
+	wt->pc = (void *)pc;
+	wt->state = 1;
+}
+#endif /* HAVE_WTIME_PERF */
+
+uint64_t __hidden wtime_thread_ns(struct wtime_thread *wt)
+{
+	struct timespec ts;
+
+#ifdef HAVE_WTIME_PERF
+	if (wt && wt->state == 0)
+		wtime_open_thread(wt);
+	if (wt && wt->state > 0) {
+		uint64_t cyc;
+		if (wtime_perf_read((struct perf_event_mmap_page *)wt->pc,
+				     &cyc) == 0)
+			return wt->base_ns + wtime_cyc2ns(cyc - wt->base_cyc);
+	}
+#else
+	(void)wt;
+#endif
+	libc.clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return wtime_ts2ns(&ts);
+}
+
+void __hidden wtime_release_thread(struct wtime_thread *wt)
+{
+	if (!wt)
+		return;
+	if (wt->pc)
+		libc.munmap(wt->pc, PAGE_SIZE);
+	if (wt->state > 0 && wt->fd >= 0)
+		libc.close(wt->fd);
+	wt->pc = NULL;
+	wt->fd = -1;
+	wt->state = 0;
+}
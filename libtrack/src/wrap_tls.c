@@ -5,6 +5,7 @@
  */
 #include <pthread.h>
 
+#include "wrap_alloc.h"
 #include "wrap_tls.h"
 #include "wrap_lib.h"
 
@@ -22,9 +23,69 @@ static pthread_key_t s_wrap_tls_key = (pthread_key_t)-1;
 
 static struct tls_info main_tls;
 
+static struct wslab tls_slab = WSLAB_INIT("tls_info", sizeof(struct tls_info));
+
 static void __free_tls(struct tls_info *tls);
 static void thread_tls_cleanup(void *arg);
 
+#ifndef NO_TLS_POOL
+/*
+ * Contexts of exited threads are kept for new threads: thread-pool style
+ * workloads would otherwise allocate (and fill) a log buffer and a
+ * backtrace line cache for every short-lived thread.
+ */
+#define TLS_POOL_MAX 32
+
+static struct tls_info *s_tls_pool[TLS_POOL_MAX];
+static int s_tls_pool_cnt;
+static pthread_mutex_t s_tls_pool_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+static int tls_pool_put(struct tls_info *tls)
+{
+	void *logbuffer, *btcache;
+
+	/* everything tied to the exiting thread goes */
+	tls_release_dvmstack(tls);
+	tls_release_logfile(tls);
+	wtime_release_thread(&tls->wt);
+	percpu_thread_release(tls);
+	flight_thread_release(tls);
+	cct_thread_release(tls);
+
+	mtx_lock(&s_tls_pool_mtx);
+	if (s_tls_pool_cnt >= TLS_POOL_MAX) {
+		mtx_unlock(&s_tls_pool_mtx);
+		return -1;
+	}
+
+	/*
+	 * the log buffer was flushed with the log file; the backtrace line
+	 * cache holds process-wide symbol data, so it stays warm
+	 */
+	tls_reset_logbuffer(tls);
+	logbuffer = tls->logbuffer;
+	btcache = tls->btcache;
+	libc.memset(tls, 0, sizeof(*tls));
+	tls->logbuffer = logbuffer;
+	tls->btcache = btcache;
+
+	s_tls_pool[s_tls_pool_cnt++] = tls;
+	mtx_unlock(&s_tls_pool_mtx);
+	return 0;
+}
+
+static struct tls_info *tls_pool_get(void)
+{
+	struct tls_info *tls = NULL;
+
+	mtx_lock(&s_tls_pool_mtx);
+	if (s_tls_pool_cnt > 0)
+		tls = s_tls_pool[--s_tls_pool_cnt];
+	mtx_unlock(&s_tls_pool_mtx);
+	return tls;
+}
+#endif
+
 /*
  * This function will be called after a fork(), from the child process
  */
@@ -32,6 +93,22 @@ static void tls_init_child(int acquire)
 {
 	struct tls_info *tls;
 
+	walloc_init_child();
+	log_budget_init_child();
+	log_shards_init_child();
+	percpu_init_child();
+	container_init_child();
+	flight_init_child();
+	maps_init_child();
+	ovh_init_child();
+	throttle_init_child();
+#ifndef NO_TLS_POOL
+	{
+		static const pthread_mutex_t init = PTHREAD_MUTEX_INITIALIZER;
+		libc.memcpy(&s_tls_pool_mtx, &init, sizeof(init));
+	}
+#endif
+
 	if (s_wrap_tls_key == (pthread_key_t)(-1))
 		return;
 
@@ -39,8 +116,9 @@ static void tls_init_child(int acquire)
 	 * we need to clear out our TLS values, close the log file
 	 * and re-start wrapper book keeping.
 	 */
-	tls = (struct tls_info *)libc.pthread_getspecific(s_wrap_tls_key);
+	tls = (struct tls_info *)wrap_getspecific(s_wrap_tls_key);
 	if (tls) {
+		tls_drop_logfile(tls);
 		if (tls->should_cleanup) {
 			tls->should_cleanup = 0;
 			libc.__pthread_cleanup_pop(&tls->pth_cleanup, 0);
@@ -58,12 +136,43 @@ static void tls_init_child(int acquire)
 	init_tls();
 }
 
+/*
+ * fork() runs these (raw clone() calls don't, see handle_fork()): the
+ * parent keeps its logs open, and the child only finds libc.forking set
+ * to its parent's pid. It resets its state on its next traced call.
+ * Handlers are inherited by the child, so they are registered once.
+ */
+static pid_t s_fork_parent;
+static int s_atfork;
+
+static void tls_atfork_prepare(void)
+{
+	s_fork_parent = libc.getpid();
+}
+
+static void tls_atfork_child(void)
+{
+	libc.forking = s_fork_parent;
+}
+
+int __hidden tls_atfork_ready(void)
+{
+	return s_atfork;
+}
+
 void __hidden init_tls(void)
 {
+	if (!s_atfork && libc.pthread_atfork &&
+	    libc.pthread_atfork(tls_atfork_prepare, NULL,
+				tls_atfork_child) == 0)
+		s_atfork = 1;
+
 	if (s_wrap_tls_key == (pthread_key_t)(-1)) {
-		if (libc.pthread_key_create(&s_wrap_tls_key, NULL) != 0)
+		if (libc.pthread_key_create(&s_wrap_tls_key, NULL) != 0) {
+			s_wrap_tls_key = (pthread_key_t)(-1);
 			return;
-		libc.pthread_setspecific(s_wrap_tls_key, NULL);
+		}
+		wrap_setspecific(s_wrap_tls_key, NULL);
 	}
 }
 
@@ -84,9 +193,11 @@ static struct tls_info *__get_tls(int acquire, int reset)
 		if (!acquire)
 			return NULL;
 		init_tls();
+		if (s_wrap_tls_key == (pthread_key_t)(-1))
+			return NULL;
 	}
 
-	tls = (struct tls_info *)libc.pthread_getspecific(s_wrap_tls_key);
+	tls = (struct tls_info *)wrap_getspecific(s_wrap_tls_key);
 	if (tls)
 		goto out;
 
@@ -97,8 +208,16 @@ static struct tls_info *__get_tls(int acquire, int reset)
 		tls = &main_tls;
 		libc.memset(tls, 0, sizeof(*tls));
 	} else {
-		tls = (struct tls_info *)libc.malloc(sizeof(*tls));
-		libc.memset(tls, 0, sizeof(*tls));
+#ifndef NO_TLS_POOL
+		tls = tls_pool_get();
+		if (!tls)
+#endif
+		{
+			tls = (struct tls_info *)wslab_alloc(&tls_slab);
+			if (!tls)
+				goto out;
+			libc.memset(tls, 0, sizeof(*tls));
+		}
 		libc.__pthread_cleanup_push(&tls->pth_cleanup, thread_tls_cleanup, tls);
 		tls->should_cleanup = 1;
 	}
@@ -111,23 +230,35 @@ static struct tls_info *__get_tls(int acquire, int reset)
 	 */
 	setup_special_sighandler(SIGUSR2);
 
-	libc.pthread_setspecific(s_wrap_tls_key, (void *)tls);
+	wrap_setspecific(s_wrap_tls_key, tls);
 
 out:
 	if (reset)
-		libc.pthread_setspecific(s_wrap_tls_key, NULL);
+		wrap_setspecific(s_wrap_tls_key, NULL);
 
 	return tls;
 }
 
+/* the common case: a thread that already has its context */
+static inline struct tls_info *__cur_tls(void)
+{
+	if (libc.forking || s_wrap_tls_key == (pthread_key_t)(-1))
+		return NULL;
+	return (struct tls_info *)wrap_getspecific(s_wrap_tls_key);
+}
+
 struct tls_info *get_tls(void)
 {
-	return __get_tls(1, 0);
+	struct tls_info *tls = __cur_tls();
+
+	return tls ? tls : __get_tls(1, 0);
 }
 
 struct tls_info *peek_tls(void)
 {
-	return __get_tls(0, 0);
+	struct tls_info *tls = __cur_tls();
+
+	return tls ? tls : __get_tls(0, 0);
 }
 
 static void __free_tls(struct tls_info *tls)
@@ -135,16 +266,25 @@ static void __free_tls(struct tls_info *tls)
 	if (!tls)
 		return;
 
+#ifndef NO_TLS_POOL
+	if (tls != &main_tls && tls_pool_put(tls) == 0)
+		return;
+#endif
+
 	/* clear out this thread's TLS values */
 	tls_release_dvmstack(tls);
 	tls_release_btcache(tls);
 	tls_release_logbuffer(tls);
 	tls_release_logfile(tls);
+	wtime_release_thread(&tls->wt);
+	percpu_thread_release(tls);
+	flight_thread_release(tls);
+	cct_thread_release(tls);
 
 	libc.memset(tls, 0, sizeof(*tls));
 
 	if (tls != &main_tls)
-		libc.free(tls);
+		wslab_free(&tls_slab, tls);
 }
 
 void clear_tls(int release_key)
@@ -9,3 +9,33 @@ LOCAL_SRC_FILES := main.c
 LOCAL_MODULE:= argtest
 
 include $(BUILD_EXECUTABLE)
+
+# nested_libs: a wrapped library calling into another (see nested_libs.c)
+include $(CLEAR_VARS)
+
+LOCAL_CFLAGS := -g3
+LOCAL_CONLYFLAGS := -std=gnu99
+LOCAL_SRC_FILES := nest_b.c
+LOCAL_MODULE:= libnestb
+
+include $(BUILD_SHARED_LIBRARY)
+
+include $(CLEAR_VARS)
+
+LOCAL_CFLAGS := -g3
+LOCAL_CONLYFLAGS := -std=gnu99
+LOCAL_SRC_FILES := nest_a.c
+LOCAL_SHARED_LIBRARIES := libnestb
+LOCAL_MODULE:= libnesta
+
+include $(BUILD_SHARED_LIBRARY)
+
+include $(CLEAR_VARS)
+
+LOCAL_CFLAGS := -g3
+LOCAL_CONLYFLAGS := -std=gnu99
+LOCAL_SRC_FILES := nested_libs.c
+LOCAL_SHARED_LIBRARIES := libnesta
+LOCAL_MODULE:= nested_libs
+
+include $(BUILD_EXECUTABLE)
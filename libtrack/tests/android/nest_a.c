@@ -0,0 +1,19 @@
+/* nest_a.c
+ *
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * The outer library of nested_libs.c: every call into it makes a call
+ * into libnestb before it returns.
+ */
+#include <errno.h>
+
+extern int nest_b_inner(int x);
+
+int nest_a_outer(int x)
+{
+	int r;
+
+	r = nest_b_inner(x) * 2;
+	errno = EDOM;
+	return r;
+}
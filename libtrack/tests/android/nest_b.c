@@ -0,0 +1,14 @@
+/* nest_b.c
+ *
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * The inner library of nested_libs.c: called from libnesta, never
+ * directly from the program.
+ */
+#include <errno.h>
+
+int nest_b_inner(int x)
+{
+	errno = ERANGE;
+	return x + 1;
+}
@@ -0,0 +1,51 @@
+/* nested_libs.c
+ *
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * A call from one wrapped library into another, under a shared runtime
+ * (wraplib.sh --shared-runtime, see include/wrap_rt.h): libnesta's
+ * nest_a_outer() calls libnestb's nest_b_inner() before it returns, so
+ * both calls are in flight, and timed, on the same thread.
+ *
+ * Wrap both libraries with the same runtime:
+ *	wraplib.sh --lib libnesta.so --wrap-all --shared-runtime
+ *	wraplib.sh --lib libnestb.so --wrap-all --shared-runtime
+ * then run nested_libs on the device. It fails if nest_a_outer() comes
+ * back with the wrong value or errno (the inner call's return state
+ * replacing the outer one's). The trace should then hold, for every
+ * call, a LOG:T:nest_b_inner line followed by a LOG:T:nest_a_outer line
+ * with the stamp of the CALL:nest_a_outer event:
+ *	parser/scripts/merge_logs.py <trace dir> | grep -c LOG:T:nest_a_outer
+ * prints NR_CALLS.
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NR_CALLS 1000
+
+extern int nest_a_outer(int x);
+
+int main(int argc, char **argv)
+{
+	int i, r, err, fails = 0;
+
+	(void)argc;
+	(void)argv;
+
+	for (i = 0; i < NR_CALLS; i++) {
+		errno = 0;
+		r = nest_a_outer(i);
+		err = errno;
+		if (r != (i + 1) * 2 || err != EDOM) {
+			if (fails++ < 10)
+				fprintf(stderr, "nest_a_outer(%d): %d, %s "
+					"(expected %d, %s)\n", i, r,
+					strerror(err), (i + 1) * 2,
+					strerror(EDOM));
+		}
+	}
+
+	printf("nested_libs: %d/%d calls failed\n", fails, NR_CALLS);
+	return fails ? 1 : 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * bench.h
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Helpers shared by the tracer benchmarks in this directory.
+ *
+ * Every result is one line on stdout:
+ *	BENCH:<bench>:<mode>:<case>:<key>=<value>:<key>=<value>:...:
+ * where <mode> is whatever the benchmark was told with -m (run_bench.sh
+ * passes the tracer configuration it set up), so that lines from
+ * different runs can be compared with grep / cut.
+ */
+#ifndef TRACER_BENCH_H
+#define TRACER_BENCH_H
+
+#include <dirent.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static const char *bench_name = "?";
+static const char *bench_mode = "default";
+
+static inline uint64_t bench_ns(clockid_t clk)
+{
+	struct timespec ts;
+
+	clock_gettime(clk, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t bench_now_ns(void)
+{
+	return bench_ns(CLOCK_MONOTONIC);
+}
+
+/* CPU time of the calling thread */
+static inline uint64_t bench_thread_cpu_ns(void)
+{
+	return bench_ns(CLOCK_THREAD_CPUTIME_ID);
+}
+
+/*
+ * Bytes in the regular files of 'path': the interposer logs to the
+ * current directory, which run_bench.sh empties before each run.
+ */
+static inline uint64_t bench_dir_bytes(const char *path)
+{
+	char name[4096];
+	struct dirent *de;
+	struct stat st;
+	uint64_t sz = 0;
+	DIR *d;
+
+	d = opendir(path);
+	if (!d)
+		return 0;
+	while ((de = readdir(d)) != NULL) {
+		snprintf(name, sizeof(name), "%s/%s", path, de->d_name);
+		if (stat(name, &st) == 0 && S_ISREG(st.st_mode))
+			sz += (uint64_t)st.st_size;
+	}
+	closedir(d);
+	return sz;
+}
+
+static int __bench_cmp_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* sorts 'v' */
+static inline uint64_t bench_percentile(uint64_t *v, int n, double pct)
+{
+	int i;
+
+	if (n <= 0)
+		return 0;
+	qsort(v, n, sizeof(*v), __bench_cmp_u64);
+	i = (int)((double)n * pct / 100.0);
+	if (i >= n)
+		i = n - 1;
+	return v[i];
+}
+
+/*
+ * Print one result line: 'fmt' holds the key=value pairs, separated by
+ * (and ending in) ':'.
+ */
+static inline void bench_report(const char *name, const char *fmt, ...)
+{
+	va_list ap;
+
+	printf("BENCH:%s:%s:%s:", bench_name, bench_mode, name);
+	va_start(ap, fmt);
+	vprintf(fmt, ap);
+	va_end(ap);
+	printf("\n");
+	fflush(stdout);
+}
+
+#endif /* TRACER_BENCH_H */
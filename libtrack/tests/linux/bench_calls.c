@@ -0,0 +1,261 @@
+/*
+ * bench_calls.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Per-call cost of traced functions: each case calls a function (or a
+ * pair of them) in a loop, and reports ns per call, the best and the
+ * median of several rounds. Run it under run_bench.sh to compare the
+ * same cases untraced and under each tracer mode.
+ *
+ * usage: bench_calls [-m mode] [-n iterations] [-r rounds] [case ...]
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include "bench.h"
+
+#define DFLT_ITERS   100000
+#define DFLT_ROUNDS  5
+#define MAX_ROUNDS   64
+#define MAX_BUF      65536
+#define IO_SZ        64
+#define FILE_SZ      (64 * 1024)
+
+struct bench_ctx {
+	char *src;
+	char *dst;
+	int fd[2];
+};
+
+struct bench_case {
+	const char *name;
+	int calls;                  /* traced calls per iteration */
+	size_t sz;
+	int (*setup)(struct bench_ctx *ctx, const struct bench_case *bc);
+	void (*run)(struct bench_ctx *ctx, const struct bench_case *bc,
+		    long iters);
+};
+
+/*
+ * Go through pointers, so that the compiler can't inline (or drop) the
+ * calls we want to measure: they have to go through the PLT, where
+ * the interposer sits.
+ */
+static void *(*volatile p_memset)(void *, int, size_t) = memset;
+static void *(*volatile p_memcpy)(void *, const void *, size_t) = memcpy;
+static void *(*volatile p_malloc)(size_t) = malloc;
+static void (*volatile p_free)(void *) = free;
+static pid_t (*volatile p_getpid)(void) = getpid;
+
+static char tmpname[] = "/tmp/bench_calls.XXXXXX";
+
+static void run_getpid(struct bench_ctx *ctx, const struct bench_case *bc,
+		       long iters)
+{
+	while (iters--)
+		(void)p_getpid();
+}
+
+static void run_malloc(struct bench_ctx *ctx, const struct bench_case *bc,
+		       long iters)
+{
+	while (iters--)
+		p_free(p_malloc(bc->sz));
+}
+
+static void run_memset(struct bench_ctx *ctx, const struct bench_case *bc,
+		       long iters)
+{
+	while (iters--)
+		p_memset(ctx->dst, (int)iters, bc->sz);
+}
+
+static void run_memcpy(struct bench_ctx *ctx, const struct bench_case *bc,
+		       long iters)
+{
+	while (iters--)
+		p_memcpy(ctx->dst, ctx->src, bc->sz);
+}
+
+static int setup_file(struct bench_ctx *ctx, const struct bench_case *bc)
+{
+	int fd, left;
+
+	fd = mkstemp(tmpname);
+	if (fd < 0)
+		return -1;
+	unlink(tmpname);
+	strcpy(tmpname + sizeof(tmpname) - 7, "XXXXXX");
+	for (left = FILE_SZ; left > 0; left -= IO_SZ) {
+		if (write(fd, ctx->src, IO_SZ) != IO_SZ) {
+			close(fd);
+			return -1;
+		}
+	}
+	lseek(fd, 0, SEEK_SET);
+	ctx->fd[0] = ctx->fd[1] = fd;
+	return 0;
+}
+
+/* one lseek() every FILE_SZ / IO_SZ calls */
+static void run_read_file(struct bench_ctx *ctx, const struct bench_case *bc,
+			  long iters)
+{
+	while (iters--) {
+		if (read(ctx->fd[0], ctx->dst, IO_SZ) < IO_SZ)
+			lseek(ctx->fd[0], 0, SEEK_SET);
+	}
+}
+
+static void run_write_file(struct bench_ctx *ctx, const struct bench_case *bc,
+			   long iters)
+{
+	long n;
+
+	for (n = 0; n < iters; n++) {
+		if (n % (FILE_SZ / IO_SZ) == 0)
+			lseek(ctx->fd[1], 0, SEEK_SET);
+		if (write(ctx->fd[1], ctx->src, IO_SZ) < 0)
+			return;
+	}
+}
+
+static int setup_pipe(struct bench_ctx *ctx, const struct bench_case *bc)
+{
+	return pipe(ctx->fd);
+}
+
+static int setup_socket(struct bench_ctx *ctx, const struct bench_case *bc)
+{
+	return socketpair(AF_UNIX, SOCK_STREAM, 0, ctx->fd);
+}
+
+/* a write() and the read() that drains it */
+static void run_write_read(struct bench_ctx *ctx, const struct bench_case *bc,
+			   long iters)
+{
+	while (iters--) {
+		if (write(ctx->fd[1], ctx->src, IO_SZ) != IO_SZ)
+			return;
+		if (read(ctx->fd[0], ctx->dst, IO_SZ) != IO_SZ)
+			return;
+	}
+}
+
+static const struct bench_case cases[] = {
+	{ "getpid",           1, 0,     NULL,         run_getpid },
+	{ "malloc_free_64",   2, 64,    NULL,         run_malloc },
+	{ "malloc_free_4k",   2, 4096,  NULL,         run_malloc },
+	{ "malloc_free_64k",  2, 65536, NULL,         run_malloc },
+	{ "memset_64",        1, 64,    NULL,         run_memset },
+	{ "memset_4k",        1, 4096,  NULL,         run_memset },
+	{ "memset_64k",       1, 65536, NULL,         run_memset },
+	{ "memcpy_64",        1, 64,    NULL,         run_memcpy },
+	{ "memcpy_4k",        1, 4096,  NULL,         run_memcpy },
+	{ "memcpy_64k",       1, 65536, NULL,         run_memcpy },
+	{ "read_file",        1, IO_SZ, setup_file,   run_read_file },
+	{ "write_file",       1, IO_SZ, setup_file,   run_write_file },
+	{ "pipe_rw",          2, IO_SZ, setup_pipe,   run_write_read },
+	{ "socket_rw",        2, IO_SZ, setup_socket, run_write_read },
+	{ NULL, 0, 0, NULL, NULL },
+};
+
+static void run_case(struct bench_ctx *ctx, const struct bench_case *bc,
+		     long iters, int rounds)
+{
+	uint64_t ns[MAX_ROUNDS], start, min, med;
+	int r;
+
+	ctx->fd[0] = ctx->fd[1] = -1;
+	if (bc->setup && bc->setup(ctx, bc) < 0) {
+		fprintf(stderr, "%s: setup failed: %s\n", bc->name,
+			strerror(errno));
+		return;
+	}
+
+	/* warm up: first calls resolve symbols and open logs */
+	bc->run(ctx, bc, iters / 10 + 1);
+
+	for (r = 0; r < rounds; r++) {
+		start = bench_now_ns();
+		bc->run(ctx, bc, iters);
+		ns[r] = bench_now_ns() - start;
+	}
+	min = bench_percentile(ns, rounds, 0);
+	med = bench_percentile(ns, rounds, 50);
+
+	bench_report(bc->name, "iters=%ld:rounds=%d:calls=%d:"
+		     "ns_min=%.1f:ns_med=%.1f:",
+		     iters, rounds, bc->calls,
+		     (double)min / ((double)iters * bc->calls),
+		     (double)med / ((double)iters * bc->calls));
+
+	if (ctx->fd[0] >= 0)
+		close(ctx->fd[0]);
+	if (ctx->fd[1] >= 0 && ctx->fd[1] != ctx->fd[0])
+		close(ctx->fd[1]);
+}
+
+static int wanted(const struct bench_case *bc, int argc, char **argv)
+{
+	int i;
+
+	if (argc == 0)
+		return 1;
+	for (i = 0; i < argc; i++) {
+		if (strcmp(argv[i], bc->name) == 0)
+			return 1;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const struct bench_case *bc;
+	struct bench_ctx ctx;
+	long iters = DFLT_ITERS;
+	int rounds = DFLT_ROUNDS;
+	int c;
+
+	bench_name = "calls";
+	while ((c = getopt(argc, argv, "m:n:r:")) != -1) {
+		switch (c) {
+		case 'm':
+			bench_mode = optarg;
+			break;
+		case 'n':
+			iters = strtol(optarg, NULL, 0);
+			break;
+		case 'r':
+			rounds = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-m mode] [-n iterations] "
+				"[-r rounds] [case ...]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (iters < 1)
+		iters = 1;
+	if (rounds < 1)
+		rounds = 1;
+	if (rounds > MAX_ROUNDS)
+		rounds = MAX_ROUNDS;
+
+	ctx.src = malloc(MAX_BUF);
+	ctx.dst = malloc(MAX_BUF);
+	if (!ctx.src || !ctx.dst)
+		return 1;
+	memset(ctx.src, 0xa5, MAX_BUF);
+
+	for (bc = &cases[0]; bc->name; bc++) {
+		if (wanted(bc, argc - optind, argv + optind))
+			run_case(&ctx, bc, iters, rounds);
+	}
+
+	free(ctx.src);
+	free(ctx.dst);
+	return 0;
+}
@@ -0,0 +1,576 @@
+/*
+ * bench_output.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Trace output throughput, per output configuration.
+ *
+ * Events are printed into a log buffer the way __bt_printf() does it
+ * (timestamp, record, "\n "), and the buffer is handed to the output
+ * whenever the next record doesn't fit, as __bt_flush() does. Outputs:
+ *	text        plain text through stdio (no libz)
+ *	text-gz     gzwrite(), default level, with the extra " " write
+ *	            __bt_flush() does (the per-library .log.gz files)
+ *	text-gz1    gzwrite() at level 1
+ *	text-chunk  64k chunks, each compress2()ed at Z_BEST_SPEED with a
+ *	            64 byte header (the trace container)
+ *	bin         a binary encoding of the same events (symbols and call
+ *	            sites are numbered on first use), written as is
+ *	bin-chunk   the binary encoding, in compressed chunks
+ * For each output and log buffer size it reports the rate of raw
+ * events (MB/s of text), CPU time per MB of text, the output size
+ * relative to the text, and flush latency percentiles.
+ *
+ * Events are synthetic backtraces, in the format std_backtrace() logs,
+ * or the lines of a real log (-f, plain or gzipped): those can only go
+ * to the text outputs.
+ *
+ * usage: bench_output [-m mode] [-n events] [-b "buffer sizes"]
+ *                     [-o "outputs"] [-f trace.log.gz] [-d dir]
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <zlib.h>
+
+#include "bench.h"
+
+#define DFLT_EVENTS   200000
+#define DFLT_BUFS     "4096 32768 131072"
+#define DFLT_OUTPUTS  "text text-gz text-gz1 text-chunk bin bin-chunk"
+
+#define MAX_FRAMES    24
+#define NR_SYMS       48
+#define NR_SITES      1024
+#define NR_LIBS       12
+#define MAX_LINE      512
+#define MAX_REC       1024     /* longest record, text or binary */
+#define MAX_REPLAY    (1 << 20)
+#define CHUNK_SZ      (64 * 1024)
+#define CHUNK_HDR     64
+
+struct event {
+	uint64_t us;
+	uint16_t sym;
+	uint8_t  nframes;
+	uint16_t site[MAX_FRAMES];
+};
+
+struct site {
+	uint32_t pc;
+	uint32_t ofst;
+	uint16_t lib;
+	uint16_t sym;
+};
+
+struct output {
+	const char *name;
+	int binary;
+	int kind;
+};
+
+#define OUT_STDIO  0
+#define OUT_GZ     1
+#define OUT_GZ1    2
+#define OUT_CHUNK  3
+#define OUT_RAW    4
+
+static const struct output outputs[] = {
+	{ "text",       0, OUT_STDIO },
+	{ "text-gz",    0, OUT_GZ },
+	{ "text-gz1",   0, OUT_GZ1 },
+	{ "text-chunk", 0, OUT_CHUNK },
+	{ "bin",        1, OUT_RAW },
+	{ "bin-chunk",  1, OUT_CHUNK },
+	{ NULL, 0, 0 },
+};
+
+static const char *sym_names[NR_SYMS];
+static const char *lib_names[NR_LIBS] = {
+	"/system/lib/libc.so", "/system/lib/libutils.so",
+	"/system/lib/libbinder.so", "/system/lib/libandroid_runtime.so",
+	"/system/lib/libdvm.so", "/system/lib/libskia.so",
+	"/system/lib/libgui.so", "/system/lib/libui.so",
+	"/system/lib/libsqlite.so", "/system/lib/libcutils.so",
+	"/system/lib/libnativehelper.so", "/system/bin/app_process",
+};
+static struct site sites[NR_SITES];
+
+/* synthetic events, or the lines of a real log */
+static struct event *events;
+static char **lines;
+static int nr_events;
+static uint64_t text_bytes;
+
+/* the output under test */
+struct sink {
+	const struct output *out;
+	FILE *fp;
+	gzFile gz;
+	int fd;
+	char *chunk;
+	char *zbuf;
+	int pending;
+	uint64_t *lat;
+	int nr_lat;
+	int max_lat;
+	/* binary encoding: what has been defined already */
+	uint8_t sym_sent[NR_SYMS];
+	uint8_t site_sent[NR_SITES];
+	uint64_t last_us;
+};
+
+static uint32_t rnd_state = 2463534242u;
+
+static uint32_t rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+	return rnd_state;
+}
+
+/* skewed towards small values, as call sites and symbols are */
+static uint32_t rnd_skew(uint32_t n)
+{
+	uint64_t r = rnd() % n;
+
+	return (uint32_t)((r * r) / n);
+}
+
+static void make_tables(void)
+{
+	static char names[NR_SYMS][16];
+	static const char *base[] = {
+		"read", "write", "open", "close", "ioctl", "mmap", "munmap",
+		"futex", "recvfrom", "sendto", "epoll_wait", "fstat",
+	};
+	int i;
+
+	for (i = 0; i < NR_SYMS; i++) {
+		snprintf(names[i], sizeof(names[i]), "%s%s",
+			 base[i % (sizeof(base) / sizeof(base[0]))],
+			 i < 12 ? "" : (i < 24 ? "_F" : (i < 36 ? "_N" : "_P")));
+		sym_names[i] = names[i];
+	}
+	for (i = 0; i < NR_SITES; i++) {
+		sites[i].lib = rnd_skew(NR_LIBS);
+		sites[i].pc = 0x40000000 + sites[i].lib * 0x1000000
+			      + (rnd() & 0xfffffe);
+		sites[i].ofst = rnd() & 0x3fe;
+		sites[i].sym = rnd() % NR_SYMS;
+	}
+}
+
+static void make_events(int n)
+{
+	uint64_t us = 1400000000ULL * 1000000ULL;
+	struct event *e;
+	int i, j;
+
+	events = calloc(n, sizeof(*events));
+	if (!events)
+		exit(1);
+	for (i = 0; i < n; i++) {
+		e = &events[i];
+		us += 1 + rnd_skew(2000);
+		e->us = us;
+		e->sym = rnd_skew(NR_SYMS);
+		e->nframes = 4 + rnd() % (MAX_FRAMES - 4);
+		for (j = 0; j < e->nframes; j++)
+			e->site[j] = rnd_skew(NR_SITES);
+	}
+	nr_events = n;
+}
+
+static int encode_text(const struct event *e, int idx, char *tv, int tvlen,
+		       char *line, int room);
+
+/* how much text the events make: what the binary outputs replace */
+static uint64_t text_size(void)
+{
+	char tv[32], line[MAX_LINE];
+	uint64_t sz = 0;
+	int i, j, tvlen;
+
+	for (i = 0; i < nr_events; i++) {
+		tvlen = snprintf(tv, sizeof(tv), "%lu.%lu:",
+				 (unsigned long)(events[i].us / 1000000),
+				 (unsigned long)(events[i].us % 1000000));
+		for (j = 0; j <= events[i].nframes; j++)
+			sz += encode_text(&events[i], j, tv, tvlen,
+					  line, sizeof(line));
+	}
+	return sz;
+}
+
+static int read_events(const char *path, int n)
+{
+	char line[MAX_LINE];
+	gzFile f;
+	int len;
+
+	f = gzopen(path, "rb");
+	if (!f)
+		return -1;
+	lines = calloc(n, sizeof(*lines));
+	if (!lines)
+		exit(1);
+	while (nr_events < n && gzgets(f, line, sizeof(line))) {
+		len = strlen(line);
+		while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == ' '))
+			line[--len] = 0;
+		if (!len)
+			continue;
+		lines[nr_events++] = strdup(line);
+	}
+	gzclose(f);
+	return nr_events ? 0 : -1;
+}
+
+/* compress and write out the pending chunk, as the container does */
+static void chunk_seal(struct sink *s)
+{
+	unsigned long zlen = compressBound(CHUNK_SZ);
+
+	memset(s->zbuf, 0, CHUNK_HDR);
+	if (compress2((Bytef *)s->zbuf + CHUNK_HDR, &zlen,
+		      (Bytef *)s->chunk, s->pending, Z_BEST_SPEED) != Z_OK)
+		zlen = 0;
+	if (write(s->fd, s->zbuf, CHUNK_HDR + zlen) < 0)
+		perror("write");
+	s->pending = 0;
+}
+
+/* hand a full log buffer to the output: this is what we time */
+static void sink_write(struct sink *s, const char *buf, int len)
+{
+	uint64_t t0;
+	int n;
+
+	t0 = bench_now_ns();
+	switch (s->out->kind) {
+	case OUT_STDIO:
+		fwrite(buf, len, 1, s->fp);
+		break;
+	case OUT_GZ:
+	case OUT_GZ1:
+		gzwrite(s->gz, buf, len);
+		if (s->out->kind == OUT_GZ)
+			gzwrite(s->gz, " ", 1);
+		break;
+	case OUT_RAW:
+		if (write(s->fd, buf, len) < 0)
+			perror("write");
+		break;
+	case OUT_CHUNK:
+		while (len > 0) {
+			n = CHUNK_SZ - s->pending;
+			if (n > len)
+				n = len;
+			memcpy(s->chunk + s->pending, buf, n);
+			s->pending += n;
+			buf += n;
+			len -= n;
+			if (s->pending == CHUNK_SZ)
+				chunk_seal(s);
+		}
+		break;
+	}
+	if (s->nr_lat < s->max_lat)
+		s->lat[s->nr_lat++] = bench_now_ns() - t0;
+}
+
+static int put_varint(uint8_t *p, uint64_t v)
+{
+	int n = 0;
+
+	while (v >= 0x80) {
+		p[n++] = (uint8_t)(v | 0x80);
+		v >>= 7;
+	}
+	p[n++] = (uint8_t)v;
+	return n;
+}
+
+/*
+ * Binary records: 'S' <id> <name> defines a symbol, 'F' <id> <pc>
+ * <offset> <lib> <symbol> a call site, and 'E' <time delta> <symbol>
+ * <n> <site>... an event.
+ */
+static int put_sym(struct sink *s, int sym, uint8_t *p)
+{
+	int n = 0, len;
+
+	if (s->sym_sent[sym])
+		return 0;
+	s->sym_sent[sym] = 1;
+	p[n++] = 'S';
+	n += put_varint(p + n, sym);
+	len = strlen(sym_names[sym]) + 1;
+	memcpy(p + n, sym_names[sym], len);
+	return n + len;
+}
+
+static int encode_bin(struct sink *s, const struct event *e, uint8_t *p)
+{
+	const struct site *st;
+	int n = 0, i;
+
+	n += put_sym(s, e->sym, p + n);
+	for (i = 0; i < e->nframes; i++) {
+		if (s->site_sent[e->site[i]])
+			continue;
+		s->site_sent[e->site[i]] = 1;
+		st = &sites[e->site[i]];
+		n += put_sym(s, st->sym, p + n);
+		p[n++] = 'F';
+		n += put_varint(p + n, e->site[i]);
+		n += put_varint(p + n, st->pc);
+		n += put_varint(p + n, st->ofst);
+		n += put_varint(p + n, st->lib);
+		n += put_varint(p + n, st->sym);
+	}
+	p[n++] = 'E';
+	n += put_varint(p + n, e->us - s->last_us);
+	n += put_varint(p + n, e->sym);
+	p[n++] = e->nframes;
+	for (i = 0; i < e->nframes; i++)
+		n += put_varint(p + n, e->site[i]);
+	s->last_us = e->us;
+	return n;
+}
+
+/* the text std_backtrace() logs for one event, one record at a time */
+static int encode_text(const struct event *e, int idx, char *tv, int tvlen,
+		       char *line, int room)
+{
+	const struct site *st;
+	int len;
+
+	memcpy(line, tv, tvlen);
+	if (idx == 0)
+		len = snprintf(line + tvlen, room - tvlen, "BT:START:%d:\n ",
+			       e->nframes);
+	else if (idx < e->nframes) {
+		st = &sites[e->site[idx - 1]];
+		len = snprintf(line + tvlen, room - tvlen,
+			       ":%d:%x:%s:+0x%x:%s(%p):\n ",
+			       e->nframes - idx, st->pc, sym_names[st->sym],
+			       st->ofst, lib_names[st->lib],
+			       (void *)(uintptr_t)(0x40000000 + st->lib * 0x1000000));
+	} else {
+		st = &sites[e->site[idx - 1]];
+		len = snprintf(line + tvlen, room - tvlen,
+			       ":0:%x:%s:+0x%x:%s(%p):\n ",
+			       st->pc, sym_names[e->sym], st->ofst,
+			       lib_names[st->lib],
+			       (void *)(uintptr_t)(0x40000000 + st->lib * 0x1000000));
+	}
+	return tvlen + len;
+}
+
+static int sink_open(struct sink *s, const struct output *out,
+		     const char *path, int max_lat)
+{
+	memset(s, 0, sizeof(*s));
+	s->out = out;
+	s->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (s->fd < 0)
+		return -1;
+	switch (out->kind) {
+	case OUT_STDIO:
+		s->fp = fdopen(s->fd, "w");
+		if (!s->fp)
+			return -1;
+		break;
+	case OUT_GZ:
+	case OUT_GZ1:
+		s->gz = gzdopen(s->fd, out->kind == OUT_GZ ? "wb" : "wb1");
+		if (!s->gz)
+			return -1;
+		break;
+	case OUT_CHUNK:
+		s->chunk = malloc(CHUNK_SZ);
+		s->zbuf = malloc(CHUNK_HDR + compressBound(CHUNK_SZ));
+		if (!s->chunk || !s->zbuf)
+			return -1;
+		break;
+	}
+	s->max_lat = max_lat;
+	s->lat = calloc(max_lat, sizeof(*s->lat));
+	return s->lat ? 0 : -1;
+}
+
+static void sink_close(struct sink *s)
+{
+	if (s->out->kind == OUT_CHUNK && s->pending)
+		chunk_seal(s);
+	if (s->fp)
+		fclose(s->fp);
+	else if (s->gz)
+		gzclose(s->gz);
+	else
+		close(s->fd);
+	free(s->chunk);
+	free(s->zbuf);
+	free(s->lat);
+}
+
+static void run_output(const struct output *out, int bufsz, const char *dir)
+{
+	char path[4096], name[64], tv[32], *buf;
+	uint64_t raw = 0, enc = 0, t0, c0, wall, cpu, lat50, lat99, lat999;
+	struct stat st;
+	struct sink s;
+	int pos = 0, len, tvlen, i, j, nrec;
+
+	if (out->binary && lines)
+		return;
+
+	snprintf(path, sizeof(path), "%s/bench_output.%d.%s", dir,
+		 (int)getpid(), out->name);
+	buf = malloc(bufsz + 1);
+	if (!buf || sink_open(&s, out, path, nr_events * 2 + 16) < 0) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		free(buf);
+		return;
+	}
+
+	t0 = bench_now_ns();
+	c0 = bench_thread_cpu_ns();
+	for (i = 0; i < nr_events; i++) {
+		if (lines) {
+			len = strlen(lines[i]) + 2;
+			if (len > bufsz)
+				continue;
+			if (bufsz - pos - 1 < len) {
+				sink_write(&s, buf, pos);
+				pos = 0;
+			}
+			memcpy(buf + pos, lines[i], len - 2);
+			memcpy(buf + pos + len - 2, "\n ", 2);
+			pos += len;
+			enc += len;
+			continue;
+		}
+
+		tvlen = snprintf(tv, sizeof(tv), "%lu.%lu:",
+				 (unsigned long)(events[i].us / 1000000),
+				 (unsigned long)(events[i].us % 1000000));
+		nrec = out->binary ? 1 : events[i].nframes + 1;
+		for (j = 0; j < nrec; j++) {
+			/* room for the longest record we write */
+			if (bufsz - pos - 1 < MAX_REC) {
+				sink_write(&s, buf, pos);
+				pos = 0;
+			}
+			if (out->binary)
+				len = encode_bin(&s, &events[i],
+						 (uint8_t *)buf + pos);
+			else
+				len = encode_text(&events[i], j, tv, tvlen,
+						  buf + pos, MAX_LINE);
+			pos += len;
+			enc += len;
+		}
+	}
+	if (pos)
+		sink_write(&s, buf, pos);
+	lat50 = bench_percentile(s.lat, s.nr_lat, 50);
+	lat99 = bench_percentile(s.lat, s.nr_lat, 99);
+	lat999 = bench_percentile(s.lat, s.nr_lat, 99.9);
+	sink_close(&s);
+	cpu = bench_thread_cpu_ns() - c0;
+	wall = bench_now_ns() - t0;
+
+	if (stat(path, &st) < 0)
+		st.st_size = 0;
+	unlink(path);
+	free(buf);
+
+	snprintf(name, sizeof(name), "%s.%d", out->name, bufsz);
+	/* rates and sizes are relative to the text, whatever we encoded */
+	raw = out->binary ? text_bytes : enc;
+	bench_report(name, "events=%d:raw_bytes=%llu:enc_bytes=%llu:"
+		     "out_bytes=%llu:"
+		     "ratio=%.3f:mb_s=%.1f:cpu_ms_mb=%.2f:flushes=%d:"
+		     "flush_us_p50=%.1f:flush_us_p99=%.1f:flush_us_p999=%.1f:",
+		     nr_events, (unsigned long long)raw,
+		     (unsigned long long)enc,
+		     (unsigned long long)st.st_size,
+		     raw ? (double)st.st_size / (double)raw : 0.0,
+		     wall ? ((double)raw / 1e6) / ((double)wall / 1e9) : 0.0,
+		     raw ? ((double)cpu / 1e6) / ((double)raw / 1e6) : 0.0,
+		     s.nr_lat, (double)lat50 / 1e3, (double)lat99 / 1e3,
+		     (double)lat999 / 1e3);
+}
+
+int main(int argc, char **argv)
+{
+	const char *bufs = DFLT_BUFS, *outs = DFLT_OUTPUTS;
+	const char *replay = NULL, *dir = "/tmp";
+	const struct output *out;
+	long n = DFLT_EVENTS, bufsz;
+	char *p, *end, *list, *tok;
+	int c;
+
+	bench_name = "output";
+	while ((c = getopt(argc, argv, "m:n:b:o:f:d:")) != -1) {
+		switch (c) {
+		case 'm':
+			bench_mode = optarg;
+			break;
+		case 'n':
+			n = strtol(optarg, NULL, 0);
+			break;
+		case 'b':
+			bufs = optarg;
+			break;
+		case 'o':
+			outs = optarg;
+			break;
+		case 'f':
+			replay = optarg;
+			break;
+		case 'd':
+			dir = optarg;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-m mode] [-n events] "
+				"[-b \"buffer sizes\"] [-o \"outputs\"] "
+				"[-f trace.log.gz] [-d dir]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (n < 1)
+		n = 1;
+	if (n > MAX_REPLAY)
+		n = MAX_REPLAY;
+
+	if (!replay) {
+		make_tables();
+		make_events((int)n);
+		text_bytes = text_size();
+	} else if (read_events(replay, (int)n) < 0) {
+		fprintf(stderr, "%s: no events\n", replay);
+		return 1;
+	}
+
+	list = strdup(outs);
+	if (!list)
+		return 1;
+	for (tok = strtok(list, " ,"); tok; tok = strtok(NULL, " ,")) {
+		for (out = &outputs[0]; out->name; out++) {
+			if (strcmp(out->name, tok) != 0)
+				continue;
+			for (p = (char *)bufs; *p; p = end) {
+				bufsz = strtol(p, &end, 0);
+				if (end == p)
+					break;
+				if (bufsz >= 2 * MAX_REC)
+					run_output(out, (int)bufsz, dir);
+			}
+		}
+	}
+	free(list);
+	return 0;
+}
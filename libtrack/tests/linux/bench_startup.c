@@ -0,0 +1,294 @@
+/*
+ * bench_startup.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * What tracing costs a process before it does any work, and what it
+ * keeps per thread:
+ *	exec       fork + exec of this program, 'iters' times: exec-to-main
+ *	           latency, time of the first traced call (and of the
+ *	           second, for comparison) and RSS at main
+ *	sh_loop    a shell running /bin/true 'iters' times
+ *	make_j     make -j<ncpu> of 'iters' targets that each run /bin/true
+ *	tN         RSS per thread, with N threads alive that have each made
+ *	           a traced call (10, 100 and 1000 threads)
+ * Child processes inherit the environment, and so LD_PRELOAD: under
+ * run_bench.sh every process of a workload is traced. run_bench.sh also
+ * reports the difference in kB per thread with the untraced run.
+ *
+ * usage: bench_startup [-m mode] [-n iterations] [-t "thread counts"]
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "bench.h"
+
+#define DFLT_ITERS    200
+#define DFLT_THREADS  "10 100 1000"
+#define MAX_THREADS   4096
+#define STACK_SZ      (64 * 1024)
+
+struct child_result {
+	uint64_t exec_ns;
+	uint64_t first_ns;
+	uint64_t second_ns;
+	long rss_kb;
+};
+
+/* resident set size of this process, in kB */
+static long rss_kb(void)
+{
+	long size = 0, rss = 0;
+	FILE *f;
+
+	f = fopen("/proc/self/statm", "r");
+	if (!f)
+		return -1;
+	if (fscanf(f, "%ld %ld", &size, &rss) != 2)
+		rss = -1;
+	fclose(f);
+	if (rss < 0)
+		return -1;
+	return rss * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/*
+ * The exec'd side: 'arg' is when the parent was about to exec us
+ * (CLOCK_MONOTONIC is the same clock in every process). Nothing traced
+ * may be called before the first getpid(): main() only uses getopt()
+ * and strtol() on the way here.
+ */
+static int child_main(const char *arg, int fd)
+{
+	struct child_result r;
+	uint64_t t0, t1, t2;
+
+	t0 = bench_now_ns();
+	(void)getpid();
+	t1 = bench_now_ns();
+	(void)getpid();
+	t2 = bench_now_ns();
+
+	r.exec_ns = t0 - strtoull(arg, NULL, 10);
+	r.first_ns = t1 - t0;
+	r.second_ns = t2 - t1;
+	r.rss_kb = rss_kb();
+	if (write(fd, &r, sizeof(r)) != sizeof(r))
+		return 1;
+	return 0;
+}
+
+static void run_exec(const char *self, int iters)
+{
+	uint64_t *exec_ns, *first_ns, *second_ns;
+	struct child_result r;
+	char ts[32], fdstr[16];
+	long rss = 0;
+	int i, n = 0, p[2], status;
+	pid_t pid;
+
+	exec_ns = calloc(iters, sizeof(*exec_ns));
+	first_ns = calloc(iters, sizeof(*first_ns));
+	second_ns = calloc(iters, sizeof(*second_ns));
+	if (!exec_ns || !first_ns || !second_ns || pipe(p) < 0)
+		exit(1);
+	snprintf(fdstr, sizeof(fdstr), "%d", p[1]);
+
+	for (i = 0; i < iters; i++) {
+		snprintf(ts, sizeof(ts), "%llu",
+			 (unsigned long long)bench_now_ns());
+		pid = fork();
+		if (pid < 0)
+			break;
+		if (pid == 0) {
+			close(p[0]);
+			execl(self, self, "-c", ts, "-w", fdstr, (char *)NULL);
+			_exit(127);
+		}
+		waitpid(pid, &status, 0);
+		if (read(p[0], &r, sizeof(r)) != sizeof(r))
+			continue;
+		exec_ns[n] = r.exec_ns;
+		first_ns[n] = r.first_ns;
+		second_ns[n] = r.second_ns;
+		rss += r.rss_kb;
+		n++;
+	}
+	close(p[0]);
+	close(p[1]);
+
+	if (n)
+		bench_report("exec", "iters=%d:exec_us_p50=%.1f:exec_us_p99=%.1f:"
+			     "first_call_us_p50=%.2f:first_call_us_p99=%.2f:"
+			     "second_call_us_p50=%.2f:rss_kb=%ld:",
+			     n, bench_percentile(exec_ns, n, 50) / 1e3,
+			     bench_percentile(exec_ns, n, 99) / 1e3,
+			     bench_percentile(first_ns, n, 50) / 1e3,
+			     bench_percentile(first_ns, n, 99) / 1e3,
+			     bench_percentile(second_ns, n, 50) / 1e3,
+			     rss / n);
+	free(exec_ns);
+	free(first_ns);
+	free(second_ns);
+}
+
+/* run 'cmd' with /bin/sh: each of its 'procs' processes costs us_proc */
+static void run_shell(const char *name, const char *cmd, int procs)
+{
+	uint64_t t0, wall;
+	int status;
+
+	t0 = bench_now_ns();
+	status = system(cmd);
+	wall = bench_now_ns() - t0;
+	if (status != 0) {
+		fprintf(stderr, "%s: exit status %d\n", name, status);
+		return;
+	}
+	bench_report(name, "procs=%d:wall_ms=%.1f:us_proc=%.1f:",
+		     procs, wall / 1e6, (double)wall / 1e3 / procs);
+}
+
+static void run_make(int iters)
+{
+	char dir[] = "/tmp/bench_startup.XXXXXX", path[64], cmd[128];
+	FILE *f;
+	int i;
+
+	if (!mkdtemp(dir))
+		return;
+	snprintf(path, sizeof(path), "%s/Makefile", dir);
+	f = fopen(path, "w");
+	if (!f)
+		goto out;
+	fprintf(f, "all:");
+	for (i = 0; i < iters; i++)
+		fprintf(f, " t%d", i);
+	fprintf(f, "\n\nt%%:\n\t@/bin/true\n\n.PHONY: all\n");
+	fclose(f);
+
+	snprintf(cmd, sizeof(cmd), "make -s -C %s -j%ld all", dir,
+		 sysconf(_SC_NPROCESSORS_ONLN));
+	run_shell("make_j", cmd, iters + 1);
+out:
+	unlink(path);
+	rmdir(dir);
+}
+
+static pthread_barrier_t alive, done;
+
+static void *thread_fn(void *arg)
+{
+	(void)arg;
+	/* one traced call, so the tracer sets up what it needs */
+	free(malloc(16));
+	(void)getpid();
+	pthread_barrier_wait(&alive);
+	pthread_barrier_wait(&done);
+	return NULL;
+}
+
+static void run_threads(int nr)
+{
+	pthread_t *t;
+	pthread_attr_t attr;
+	long before, after;
+	char name[16];
+	int i, started;
+
+	t = calloc(nr, sizeof(*t));
+	if (!t)
+		return;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, STACK_SZ);
+	pthread_barrier_init(&alive, NULL, nr + 1);
+	pthread_barrier_init(&done, NULL, nr + 1);
+
+	before = rss_kb();
+	for (started = 0; started < nr; started++) {
+		if (pthread_create(&t[started], &attr, thread_fn, NULL) != 0)
+			break;
+	}
+	if (started < nr) {
+		/* the others wait for a barrier that will never fill up */
+		fprintf(stderr, "threads=%d: only %d threads started\n",
+			nr, started);
+		exit(1);
+	}
+	pthread_barrier_wait(&alive);
+	after = rss_kb();
+	pthread_barrier_wait(&done);
+	for (i = 0; i < nr; i++)
+		pthread_join(t[i], NULL);
+
+	pthread_barrier_destroy(&alive);
+	pthread_barrier_destroy(&done);
+	pthread_attr_destroy(&attr);
+	free(t);
+
+	snprintf(name, sizeof(name), "t%d", nr);
+	bench_report(name, "threads=%d:rss_kb=%ld:kb_thread=%.2f:",
+		     nr, after, (double)(after - before) / nr);
+}
+
+int main(int argc, char **argv)
+{
+	const char *counts = DFLT_THREADS, *child = NULL;
+	char self[4096], cmd[128];
+	int iters = DFLT_ITERS, fd = -1, c;
+	char *p, *end;
+	ssize_t len;
+	long nr;
+
+	bench_name = "startup";
+	while ((c = getopt(argc, argv, "m:n:t:c:w:")) != -1) {
+		switch (c) {
+		case 'm':
+			bench_mode = optarg;
+			break;
+		case 'n':
+			iters = (int)strtol(optarg, NULL, 0);
+			break;
+		case 't':
+			counts = optarg;
+			break;
+		case 'c':
+			child = optarg;
+			break;
+		case 'w':
+			fd = (int)strtol(optarg, NULL, 0);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-m mode] [-n iterations] "
+				"[-t \"thread counts\"]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (child)
+		return child_main(child, fd);
+	if (iters < 1)
+		iters = 1;
+
+	len = readlink("/proc/self/exe", self, sizeof(self) - 1);
+	if (len <= 0)
+		return 1;
+	self[len] = 0;
+
+	run_exec(self, iters);
+	snprintf(cmd, sizeof(cmd),
+		 "i=0; while [ $i -lt %d ]; do /bin/true; i=$((i+1)); done",
+		 iters);
+	run_shell("sh_loop", cmd, iters + 1);
+	run_make(iters);
+
+	for (p = (char *)counts; *p; p = end) {
+		nr = strtol(p, &end, 0);
+		if (end == p)
+			break;
+		if (nr >= 1 && nr <= MAX_THREADS)
+			run_threads((int)nr);
+	}
+	return 0;
+}
@@ -0,0 +1,186 @@
+/*
+ * bench_threads.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * How the tracer scales with threads: for each thread count, start that
+ * many threads at once, each doing 'ops' rounds of traced allocation
+ * and I/O (malloc, a write to /dev/null, a read from /dev/zero, free),
+ * from thread creation, so that opening and closing per-thread logs is
+ * part of the cost. For each count it reports:
+ *	ops_s_thread   operations per second, per thread
+ *	cpu_ns_op      CPU time per operation (all threads)
+ *	offcpu_ns_op   time per operation a thread spent runnable or
+ *	               blocked rather than on a CPU (lock waits, mostly)
+ *	vcsw_kop       voluntary context switches (blocking waits) per
+ *	               1000 operations
+ *	log_bytes_op   bytes logged per operation
+ * run_bench.sh turns cpu_ns_op into the tracer's share of the CPU, by
+ * comparing it with an untraced run.
+ *
+ * usage: bench_threads [-m mode] [-n ops per thread] [-t "counts"]
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+
+#include "bench.h"
+
+#define DFLT_OPS      20000
+#define DFLT_THREADS  "1 2 4 8 16 32 64 128"
+#define MAX_THREADS   1024
+#define ALLOC_SZ      256
+#define IO_SZ         64
+
+struct worker {
+	pthread_t thread;
+	long ops;
+	uint64_t wall_ns;
+	uint64_t cpu_ns;
+	long vcsw;
+	int err;
+};
+
+static pthread_barrier_t start_barrier;
+
+static void *worker_fn(void *arg)
+{
+	struct worker *w = (struct worker *)arg;
+	struct rusage ru0, ru1;
+	uint64_t t0, c0;
+	char buf[IO_SZ];
+	int out, in;
+	long i;
+	void *p;
+
+	out = open("/dev/null", O_WRONLY);
+	in = open("/dev/zero", O_RDONLY);
+	if (out < 0 || in < 0) {
+		w->err = errno;
+		pthread_barrier_wait(&start_barrier);
+		goto out;
+	}
+	memset(buf, 0x5a, sizeof(buf));
+
+	pthread_barrier_wait(&start_barrier);
+	getrusage(RUSAGE_THREAD, &ru0);
+	t0 = bench_now_ns();
+	c0 = bench_thread_cpu_ns();
+
+	for (i = 0; i < w->ops; i++) {
+		p = malloc(ALLOC_SZ);
+		if (write(out, buf, sizeof(buf)) < 0 ||
+		    read(in, p ? p : buf, sizeof(buf)) < 0)
+			w->err = errno;
+		free(p);
+	}
+
+	w->cpu_ns = bench_thread_cpu_ns() - c0;
+	w->wall_ns = bench_now_ns() - t0;
+	getrusage(RUSAGE_THREAD, &ru1);
+	w->vcsw = ru1.ru_nvcsw - ru0.ru_nvcsw;
+out:
+	if (out >= 0)
+		close(out);
+	if (in >= 0)
+		close(in);
+	return NULL;
+}
+
+static void run_threads(struct worker *w, int nr, long ops)
+{
+	uint64_t wall = 0, cpu = 0, offcpu = 0, logged;
+	long vcsw = 0;
+	double total;
+	char name[16];
+	int i, started;
+
+	logged = bench_dir_bytes(".");
+	if (pthread_barrier_init(&start_barrier, NULL, nr) != 0)
+		return;
+
+	for (started = 0; started < nr; started++) {
+		memset(&w[started], 0, sizeof(w[started]));
+		w[started].ops = ops;
+		if (pthread_create(&w[started].thread, NULL,
+				   worker_fn, &w[started]) != 0)
+			break;
+	}
+	if (started < nr) {
+		/* the rest are stuck at the barrier: there's no way out */
+		fprintf(stderr, "threads=%d: only %d threads started\n",
+			nr, started);
+		exit(1);
+	}
+	for (i = 0; i < nr; i++) {
+		pthread_join(w[i].thread, NULL);
+		if (w[i].err)
+			fprintf(stderr, "threads=%d: %s\n", nr,
+				strerror(w[i].err));
+		if (w[i].wall_ns > wall)
+			wall = w[i].wall_ns;
+		cpu += w[i].cpu_ns;
+		if (w[i].wall_ns > w[i].cpu_ns)
+			offcpu += w[i].wall_ns - w[i].cpu_ns;
+		vcsw += w[i].vcsw;
+	}
+	pthread_barrier_destroy(&start_barrier);
+	logged = bench_dir_bytes(".") - logged;
+
+	total = (double)ops * nr;
+	snprintf(name, sizeof(name), "t%d", nr);
+	bench_report(name, "threads=%d:ops=%ld:wall_ms=%.1f:"
+		     "ops_s_thread=%.0f:cpu_ns_op=%.1f:offcpu_ns_op=%.1f:"
+		     "vcsw_kop=%.2f:log_bytes_op=%.1f:",
+		     nr, ops, (double)wall / 1e6,
+		     wall ? (double)ops * 1e9 / (double)wall : 0.0,
+		     (double)cpu / total, (double)offcpu / total,
+		     (double)vcsw * 1000.0 / total, (double)logged / total);
+}
+
+int main(int argc, char **argv)
+{
+	const char *counts = DFLT_THREADS;
+	long ops = DFLT_OPS;
+	struct worker *w;
+	char *p, *end;
+	long nr;
+	int c;
+
+	bench_name = "threads";
+	while ((c = getopt(argc, argv, "m:n:t:")) != -1) {
+		switch (c) {
+		case 'm':
+			bench_mode = optarg;
+			break;
+		case 'n':
+			ops = strtol(optarg, NULL, 0);
+			break;
+		case 't':
+			counts = optarg;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-m mode] [-n ops per thread] "
+				"[-t \"counts\"]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (ops < 1)
+		ops = 1;
+
+	w = calloc(MAX_THREADS, sizeof(*w));
+	if (!w)
+		return 1;
+
+	for (p = (char *)counts; *p; p = end) {
+		nr = strtol(p, &end, 0);
+		if (end == p)
+			break;
+		if (nr >= 1 && nr <= MAX_THREADS)
+			run_threads(w, (int)nr, ops);
+	}
+
+	free(w);
+	return 0;
+}
@@ -0,0 +1,102 @@
+#!/bin/bash
+#
+# Run the tracer benchmarks in this directory under each tracer mode:
+#	off   - no interposer at all (the baseline)
+#	none  - every call goes through the interposer, nothing is logged
+#	time  - timing is logged (TRACE_MODE=time)
+#	bt    - timing and backtraces are logged (TRACE_MODE=bt, the default)
+#
+# The x86 interposer (scripts/interpose.so) is built first if needed.
+# bench_output doesn't go through the interposer: it replays events
+# through a model of the engine's output path, and only runs as "off".
+# Results (BENCH:... lines, see bench.h) go to stdout, and are appended
+# to the file given with -o, after a BENCH:RUN line saying when, where
+# and at which revision they were taken. Results with a cpu_ns_op get
+# a tracer_cpu line: the share of that CPU time the tracer added over
+# the "off" run of the same case; results with a kb_thread get a
+# tracer_kb_thread line: the memory per thread the tracer added.
+#
+# usage: run_bench.sh [-o results] [-m "modes"] [-n iterations] [bench ...]
+#
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+SCRIPTS="$HERE/../../scripts"
+INTERPOSE="$SCRIPTS/interpose.so"
+
+OUT=
+MODES="off none time bt"
+ITERS=
+BENCHES=
+
+while getopts "o:m:n:" opt; do
+	case $opt in
+		o ) OUT=$OPTARG ;;
+		m ) MODES=$OPTARG ;;
+		n ) ITERS=$OPTARG ;;
+		* ) echo "usage: $0 [-o results] [-m \"modes\"] [-n iterations] [bench ...]"
+		    exit 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+BENCHES="${@:-calls threads output startup}"
+
+make -s -C "$HERE" || exit 1
+if [ ! -f "$INTERPOSE" ]; then
+	(cd "$SCRIPTS" && ./write_gnu_wrappers.sh >/dev/null) || exit 1
+fi
+
+# the interposer logs to the current directory
+LOGDIR=$(mktemp -d /tmp/tracer_bench.XXXXXX)
+trap 'rm -rf "$LOGDIR"' EXIT
+
+function run_one()
+{
+	local bench="$1"
+	local mode="$2"
+	local args="-m $mode"
+
+	[ -z "$ITERS" ] || args="$args -n $ITERS"
+	case $mode in
+		off )
+			(cd "$LOGDIR" && "$HERE/bench_$bench" $args) ;;
+		* )
+			(cd "$LOGDIR" && TRACE_MODE=$mode LD_PRELOAD="$INTERPOSE" \
+				"$HERE/bench_$bench" $args) ;;
+	esac
+	rm -f "$LOGDIR"/*
+}
+
+{
+	echo "BENCH:RUN:$(date +%s):$(uname -n):$(uname -r):$(git -C "$HERE" rev-parse --short HEAD 2>/dev/null):"
+	for b in $BENCHES; do
+		for m in $MODES; do
+			[ "$b" != "output" -o "$m" = "off" ] || continue
+			run_one "$b" "$m"
+		done
+	done
+} | awk -F: '
+	/^BENCH:/ && $3 != "RUN" {
+		cpu = kb = ""
+		for (i = 5; i <= NF; i++) {
+			if ($i ~ /^cpu_ns_op=/)
+				cpu = substr($i, 11) + 0
+			if ($i ~ /^kb_thread=/)
+				kb = substr($i, 11) + 0
+		}
+		print
+		key = $2 ":" $4
+		if ($3 == "off") {
+			off_cpu[key] = cpu
+			off_kb[key] = kb
+		} else {
+			if (cpu != "" && off_cpu[key] != "" && cpu > 0)
+				printf "BENCH:%s:%s:%s:tracer_cpu=%.3f:\n",
+				       $2, $3, $4, (cpu - off_cpu[key]) / cpu
+			if (kb != "" && off_kb[key] != "")
+				printf "BENCH:%s:%s:%s:tracer_kb_thread=%.2f:\n",
+				       $2, $3, $4, kb - off_kb[key]
+		}
+		fflush()
+		next
+	}
+	{ print; fflush() }' | if [ -n "$OUT" ]; then tee -a "$OUT"; else cat; fi
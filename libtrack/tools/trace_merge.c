@@ -0,0 +1,941 @@
+/*
+ * trace_merge.c
+ * Copyright (C) 2014 Jeremy C. Andrus <jeremya@cs.columbia.edu>
+ *
+ * Streaming k-way merge of trace logs into one ordered stream: what
+ * parser/scripts/merge_logs.py does (the rules are in
+ * parser/src/telesphorus/helpers/merge.py), for trace directories too
+ * big for it.
+ *
+ * Inputs are per-thread logs, log shards and per-CPU logs (plain or
+ * gzipped), and trace containers, in which every thread's chunks are a
+ * stream of their own. A pool of threads reads and decompresses ahead:
+ * each stream has two blocks, one the merge works through while the
+ * other one is being filled, so memory stays at two blocks and one event
+ * per stream, however long the logs are. The merge takes the next event
+ * off a heap of the streams' current events, by sequence number when
+ * every stream has them (libtrack built with --event-seq, see
+ * include/wrap_seq.h), by timestamp otherwise. Each stream has to be in
+ * order itself.
+ *
+ * The output reads like a log shard: a "0.0:LOG:TID:<tid>:" marker
+ * precedes output from a different thread. It is gzipped if its name
+ * ends in ".gz".
+ *
+ * usage: trace_merge [-o out[.gz]] [-s | -t] [-j threads] [-b block KB]
+ *                    TRACE-DIR|LOG...
+ *	-s / -t   merge by sequence number / timestamp (default: -s if
+ *	          the first stamped event of every stream is numbered)
+ */
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include "wrap_container.h"
+
+#define DFLT_BLOCK_KB  64
+#define MAX_WORKERS    64
+
+#define BY_AUTO  0
+#define BY_SEQ   1
+#define BY_TIME  2
+
+/* block states */
+#define BLK_EMPTY    0
+#define BLK_FILLING  1
+#define BLK_FULL     2
+
+struct block {
+	char *data;
+	size_t len;
+	size_t cap;
+	int eof;                    /* nothing after this one */
+	volatile int state;
+};
+
+struct chunk_ref {
+	uint64_t offset;            /* of the payload */
+	uint32_t tid;
+	uint32_t len;
+	uint32_t raw_len;
+	uint8_t  codec;
+};
+
+/* a trace container's file and chunks: its threads' streams share them */
+struct container {
+	int fd;
+	struct chunk_ref *chunks;
+	int users;                  /* streams not closed yet */
+};
+
+/* an event: a stamped line, and the lines that go with it */
+struct event {
+	char *text;
+	size_t len;
+	size_t cap;
+	uint64_t sec, usec, seq;    /* inherited from the last event if unset */
+	int has_seq;
+	int stamped;
+	uint32_t tid;
+};
+
+struct stream {
+	int idx;
+	const char *name;
+
+	/* a log file... */
+	gzFile gz;
+	/* ...or one thread's chunks in a trace container */
+	struct container *ct;
+	int fd;
+	struct chunk_ref *chunks;
+	int nr_chunks;
+	int next_chunk;
+	char *zbuf;
+	size_t zcap;
+
+	struct block blk[2];
+	int cur;
+	size_t off;                 /* in blk[cur] */
+
+	char *line;                 /* the line we've read but not used */
+	size_t line_len;
+	size_t line_cap;
+	int have_line;
+
+	struct event ev;
+	uint32_t tid;
+	uint64_t last_sec, last_usec, last_seq;
+};
+
+struct stamp {
+	uint64_t sec, usec, seq;
+	int has_seq;
+};
+
+static size_t s_block_sz = DFLT_BLOCK_KB * 1024;
+
+static struct stream **s_streams;
+static int s_nr_streams;
+
+/* refills waiting for a worker: one per stream at most */
+static struct block **s_queue_blk;
+static struct stream **s_queue_src;
+static int s_queue_head, s_queue_len;
+static int s_quit;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t s_done = PTHREAD_COND_INITIALIZER;
+
+static void *xrealloc(void *p, size_t sz)
+{
+	p = realloc(p, sz);
+	if (!p) {
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+	return p;
+}
+
+static void reserve(char **buf, size_t *cap, size_t need)
+{
+	if (need <= *cap)
+		return;
+	while (*cap < need)
+		*cap = *cap ? *cap * 2 : 4096;
+	*buf = xrealloc(*buf, *cap);
+}
+
+/* ------------------------------------------------------------------
+ * Reading (in the workers)
+ */
+
+static void fill_log(struct stream *s, struct block *b)
+{
+	int n;
+
+	reserve(&b->data, &b->cap, s_block_sz);
+	n = gzread(s->gz, b->data, (unsigned)s_block_sz);
+	if (n < 0) {
+		fprintf(stderr, "%s: read error\n", s->name);
+		n = 0;
+	}
+	b->len = n;
+	b->eof = (size_t)n < s_block_sz;
+}
+
+/* one chunk per block */
+static void fill_chunk(struct stream *s, struct block *b)
+{
+	struct chunk_ref *c;
+	uLongf raw_len;
+	ssize_t n;
+
+	b->len = 0;
+	while (s->next_chunk < s->nr_chunks && b->len == 0) {
+		c = &s->chunks[s->next_chunk++];
+		reserve(&b->data, &b->cap, c->raw_len > c->len ?
+					   c->raw_len : c->len);
+		if (c->codec == WTC_RAW) {
+			n = pread(s->fd, b->data, c->len, c->offset);
+			b->len = n > 0 ? (size_t)n : 0;
+			continue;
+		}
+		reserve(&s->zbuf, &s->zcap, c->len);
+		n = pread(s->fd, s->zbuf, c->len, c->offset);
+		raw_len = c->raw_len;
+		if (n != (ssize_t)c->len ||
+		    uncompress((Bytef *)b->data, &raw_len,
+			       (const Bytef *)s->zbuf, c->len) != Z_OK) {
+			fprintf(stderr, "%s: bad chunk at %llu (tid %u)\n",
+				s->name, (unsigned long long)c->offset, c->tid);
+			continue;
+		}
+		b->len = raw_len;
+	}
+	b->eof = s->next_chunk >= s->nr_chunks;
+}
+
+static void *worker(void *arg)
+{
+	struct stream *s;
+	struct block *b;
+
+	(void)arg;
+	pthread_mutex_lock(&s_lock);
+	for (;;) {
+		while (!s_queue_len && !s_quit)
+			pthread_cond_wait(&s_work, &s_lock);
+		if (!s_queue_len)
+			break;
+		s = s_queue_src[s_queue_head];
+		b = s_queue_blk[s_queue_head];
+		s_queue_head = (s_queue_head + 1) % s_nr_streams;
+		s_queue_len--;
+		pthread_mutex_unlock(&s_lock);
+
+		if (s->gz)
+			fill_log(s, b);
+		else
+			fill_chunk(s, b);
+
+		pthread_mutex_lock(&s_lock);
+		b->state = BLK_FULL;
+		pthread_cond_broadcast(&s_done);
+	}
+	pthread_mutex_unlock(&s_lock);
+	return NULL;
+}
+
+/* a stream has one refill in flight at most: its blocks fill in order */
+static void request_fill(struct stream *s, struct block *b)
+{
+	pthread_mutex_lock(&s_lock);
+	b->state = BLK_FILLING;
+	s_queue_src[(s_queue_head + s_queue_len) % s_nr_streams] = s;
+	s_queue_blk[(s_queue_head + s_queue_len) % s_nr_streams] = b;
+	s_queue_len++;
+	pthread_cond_signal(&s_work);
+	pthread_mutex_unlock(&s_lock);
+}
+
+static void wait_full(struct block *b)
+{
+	pthread_mutex_lock(&s_lock);
+	while (b->state != BLK_FULL)
+		pthread_cond_wait(&s_done, &s_lock);
+	pthread_mutex_unlock(&s_lock);
+}
+
+/* ------------------------------------------------------------------
+ * Parsing (in the merge)
+ */
+
+/* the next block of a stream: 0 at the end */
+static int next_block(struct stream *s)
+{
+	struct block *b = &s->blk[s->cur], *next = &s->blk[s->cur ^ 1];
+
+	if (b->eof)
+		return 0;
+	wait_full(next);
+	b->state = BLK_EMPTY;
+	s->cur ^= 1;
+	s->off = 0;
+	if (!next->eof)
+		request_fill(s, b);
+	return 1;
+}
+
+static int read_raw_line(struct stream *s)
+{
+	struct block *b;
+	char *nl;
+	size_t n;
+
+	s->line_len = 0;
+	for (;;) {
+		b = &s->blk[s->cur];
+		if (s->off >= b->len) {
+			if (!next_block(s))
+				break;
+			continue;
+		}
+		nl = memchr(b->data + s->off, '\n', b->len - s->off);
+		n = nl ? (size_t)(nl - (b->data + s->off)) + 1 : b->len - s->off;
+		reserve(&s->line, &s->line_cap, s->line_len + n + 2);
+		memcpy(s->line + s->line_len, b->data + s->off, n);
+		s->line_len += n;
+		s->off += n;
+		if (nl)
+			break;
+	}
+	return s->line_len > 0;
+}
+
+static int is_blank(const char *p, size_t len)
+{
+	for (; len; p++, len--) {
+		if (*p != ' ' && *p != '\t' && *p != '\n' && *p != '\r' &&
+		    *p != '\v' && *p != '\f')
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * bt_printf() ends its lines with "\n ", so the line after a backtrace
+ * line starts with a space: that's dropped, and so is a line of nothing
+ * but that space.
+ */
+static int read_line(struct stream *s)
+{
+	size_t sp;
+
+	do {
+		if (!read_raw_line(s))
+			return 0;
+		for (sp = 0; sp < s->line_len && s->line[sp] == ' '; sp++)
+			;
+		if (sp) {
+			s->line_len -= sp;
+			memmove(s->line, s->line + sp, s->line_len);
+		}
+	} while (is_blank(s->line, s->line_len));
+
+	/* the end of a log that was cut short */
+	if (s->line[s->line_len - 1] != '\n')
+		s->line[s->line_len++] = '\n';
+	s->line[s->line_len] = 0;
+	return 1;
+}
+
+static int parse_u64(const char **p, uint64_t *val)
+{
+	const char *s = *p;
+
+	*val = 0;
+	while (*s >= '0' && *s <= '9')
+		*val = *val * 10 + (uint64_t)(*s++ - '0');
+	if (s == *p)
+		return 0;
+	*p = s;
+	return 1;
+}
+
+/* "<sec>.<usec>[/<seq>]:" */
+static int parse_stamp(const char *line, struct stamp *st)
+{
+	const char *p = line;
+
+	if (!parse_u64(&p, &st->sec) || *p++ != '.' ||
+	    !parse_u64(&p, &st->usec))
+		return 0;
+	st->has_seq = 0;
+	if (*p == '/') {
+		p++;
+		if (!parse_u64(&p, &st->seq))
+			return 0;
+		st->has_seq = 1;
+	}
+	return *p == ':';
+}
+
+/* "<stamp>:LOG:TID:<tid>:..." */
+static int parse_tid_marker(const char *line, uint32_t *tid)
+{
+	const char *p = strchr(line, ':');
+	uint64_t val;
+
+	if (!p || strncmp(p, ":LOG:TID:", 9) != 0)
+		return 0;
+	p += 9;
+	*tid = parse_u64(&p, &val) ? (uint32_t)val : 0;
+	return 1;
+}
+
+static void start_event(struct stream *s, const struct stamp *st, int stamped)
+{
+	struct event *ev = &s->ev;
+
+	ev->stamped = stamped;
+	ev->sec = stamped ? st->sec : s->last_sec;
+	ev->usec = stamped ? st->usec : s->last_usec;
+	ev->has_seq = stamped && st->has_seq;
+	ev->seq = ev->has_seq ? st->seq : s->last_seq;
+	ev->tid = s->tid;
+}
+
+/* 0 at the end of the stream */
+static int next_event(struct stream *s)
+{
+	struct event *ev = &s->ev;
+	struct stamp st = { 0, 0, 0, 0 };
+	int stamped;
+
+	ev->len = 0;
+	for (;;) {
+		if (!s->have_line && !read_line(s))
+			break;
+		s->have_line = 1;
+
+		if (parse_tid_marker(s->line, &s->tid)) {
+			if (ev->len) {
+				/* read again for the next event */
+				s->tid = ev->tid;
+				break;
+			}
+			s->have_line = 0;
+			continue;
+		}
+		stamped = parse_stamp(s->line, &st) && (st.sec || st.usec);
+		if (ev->len && stamped &&
+		    (!ev->stamped || st.sec != ev->sec || st.usec != ev->usec ||
+		     st.has_seq != ev->has_seq ||
+		     (st.has_seq && st.seq != ev->seq)))
+			break;
+		if (!ev->len)
+			start_event(s, &st, stamped);
+		reserve(&ev->text, &ev->cap, ev->len + s->line_len);
+		memcpy(ev->text + ev->len, s->line, s->line_len);
+		ev->len += s->line_len;
+		s->have_line = 0;
+	}
+	if (!ev->len)
+		return 0;
+	s->last_sec = ev->sec;
+	s->last_usec = ev->usec;
+	s->last_seq = ev->seq;
+	return 1;
+}
+
+/* ------------------------------------------------------------------
+ * Inputs
+ */
+
+static struct stream *new_stream(const char *name, uint32_t tid)
+{
+	struct stream *s = calloc(1, sizeof(*s));
+
+	if (!s)
+		return NULL;
+	s->name = name;
+	s->fd = -1;
+	s->tid = tid;
+	s_streams = xrealloc(s_streams, (s_nr_streams + 1) * sizeof(*s_streams));
+	s->idx = s_nr_streams;
+	s_streams[s_nr_streams++] = s;
+	return s;
+}
+
+/* <pid>.<tid>.<lib>.<prog>.log[.gz]: per-thread logs are named after their thread */
+static uint32_t file_tid(const char *path)
+{
+	const char *p = strrchr(path, '/');
+	uint64_t pid, tid;
+
+	p = p ? p + 1 : path;
+	if (!parse_u64(&p, &pid) || *p++ != '.' || !parse_u64(&p, &tid) ||
+	    *p != '.')
+		return 0;
+	return (uint32_t)tid;
+}
+
+static int add_log(const char *path)
+{
+	struct stream *s;
+	gzFile gz;
+
+	gz = gzopen(path, "rb");
+	if (!gz) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		return -1;
+	}
+	gzbuffer(gz, (unsigned)s_block_sz);
+	s = new_stream(path, file_tid(path));
+	if (!s) {
+		gzclose(gz);
+		return -1;
+	}
+	s->gz = gz;
+	return 0;
+}
+
+static int cmp_chunk(const void *a, const void *b)
+{
+	const struct chunk_ref *x = a, *y = b;
+
+	if (x->tid != y->tid)
+		return x->tid < y->tid ? -1 : 1;
+	if (x->offset != y->offset)
+		return x->offset < y->offset ? -1 : 1;
+	return 0;
+}
+
+/* where the next chunk magic is after 'offset' (a dead writer's zeros) */
+static uint64_t resync(int fd, uint64_t offset, uint64_t size)
+{
+	char buf[65536 + 3];
+	uint64_t pos = offset + 1;
+	ssize_t n;
+	char *p;
+
+	while (pos < size) {
+		n = pread(fd, buf, sizeof(buf), pos);
+		if (n < 4)
+			break;
+		p = memmem(buf, n, WTC_MAGIC, 4);
+		if (p)
+			return pos + (p - buf);
+		pos += n - 3;
+	}
+	return size;
+}
+
+/*
+ * Every thread's data chunks, found by hopping from header to header:
+ * their payloads are only read when the merge gets to them. Containers
+ * are little-endian, as is every host this is meant to run on.
+ */
+static int add_container(const char *path)
+{
+	struct chunk_ref *chunks = NULL;
+	int nr = 0, cap = 0, i, j, fd;
+	struct wtc_chunk hdr;
+	uint64_t off = 0, size;
+	struct container *ct;
+	struct stream *s;
+	struct stat sb;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0 || fstat(fd, &sb) < 0) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		if (fd >= 0)
+			close(fd);
+		return -1;
+	}
+	size = sb.st_size;
+	while (off + sizeof(hdr) <= size) {
+		if (pread(fd, &hdr, sizeof(hdr), off) != sizeof(hdr))
+			break;
+		if (memcmp(hdr.magic, WTC_MAGIC, 4) != 0) {
+			if (memcmp(&hdr, WTC_END_MAGIC, 8) == 0)
+				off += sizeof(struct wtc_trailer);
+			else
+				off = resync(fd, off, size);
+			continue;
+		}
+		if (hdr.hdr_len < sizeof(hdr))
+			break;
+		if (hdr.type == WTC_DATA && hdr.len) {
+			if (nr == cap) {
+				cap = cap ? cap * 2 : 256;
+				chunks = xrealloc(chunks, cap * sizeof(*chunks));
+			}
+			chunks[nr].offset = off + hdr.hdr_len;
+			chunks[nr].tid = hdr.tid;
+			chunks[nr].len = hdr.len;
+			chunks[nr].raw_len = hdr.raw_len;
+			chunks[nr].codec = hdr.codec;
+			nr++;
+		}
+		off += hdr.hdr_len + (uint64_t)hdr.len;
+	}
+	if (!nr) {
+		free(chunks);
+		close(fd);
+		return 0;
+	}
+
+	ct = xrealloc(NULL, sizeof(*ct));
+	ct->fd = fd;
+	ct->chunks = chunks;
+	ct->users = 0;
+
+	/* one stream per thread, its chunks in file order */
+	qsort(chunks, nr, sizeof(*chunks), cmp_chunk);
+	for (i = 0; i < nr; i = j) {
+		for (j = i; j < nr && chunks[j].tid == chunks[i].tid; j++)
+			;
+		s = new_stream(path, chunks[i].tid);
+		if (!s)
+			break;
+		s->ct = ct;
+		ct->users++;
+		s->fd = fd;
+		s->chunks = &chunks[i];
+		s->nr_chunks = j - i;
+	}
+	if (!ct->users) {
+		free(chunks);
+		free(ct);
+		close(fd);
+	}
+	return i < nr ? -1 : 0;
+}
+
+static int is_log(const char *path)
+{
+	const char *name = strrchr(path, '/');
+	size_t len;
+
+	name = name ? name + 1 : path;
+	len = strlen(name);
+	if (len > 6 && strcmp(name + len - 6, ".trace") == 0)
+		return 1;
+	if (name[0] < '0' || name[0] > '9')
+		return 0;
+	return (len > 4 && strcmp(name + len - 4, ".log") == 0) ||
+	       (len > 7 && strcmp(name + len - 7, ".log.gz") == 0);
+}
+
+static int cmp_name(const void *a, const void *b)
+{
+	return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+static int add_input(const char *path)
+{
+	size_t len = strlen(path);
+
+	if (len > 6 && strcmp(path + len - 6, ".trace") == 0)
+		return add_container(path);
+	return add_log(path);
+}
+
+static char *join(const char *dir, const char *name)
+{
+	size_t len = strlen(dir);
+	char *path = xrealloc(NULL, len + strlen(name) + 2);
+
+	if (len && dir[len - 1] == '/')
+		sprintf(path, "%s%s", dir, name);
+	else
+		sprintf(path, "%s/%s", dir, name);
+	return path;
+}
+
+/*
+ * A directory's logs, in name order, then its subdirectories' (not
+ * those behind a symlink), in the order readdir() has them: the order
+ * merge_logs.py takes them in, from os.walk().
+ */
+static void add_dir(const char *dir)
+{
+	char **files = NULL, **dirs = NULL, *path;
+	int nr_files = 0, nr_dirs = 0, i;
+	struct dirent *de;
+	struct stat sb;
+	DIR *d;
+
+	d = opendir(dir);
+	if (!d)
+		return;
+	while ((de = readdir(d)) != NULL) {
+		if (strcmp(de->d_name, ".") == 0 ||
+		    strcmp(de->d_name, "..") == 0)
+			continue;
+		path = join(dir, de->d_name);
+		if (stat(path, &sb) == 0 && S_ISDIR(sb.st_mode)) {
+			if (lstat(path, &sb) == 0 && S_ISLNK(sb.st_mode)) {
+				free(path);
+				continue;
+			}
+			dirs = xrealloc(dirs, (nr_dirs + 1) * sizeof(*dirs));
+			dirs[nr_dirs++] = path;
+		} else if (is_log(path)) {
+			files = xrealloc(files, (nr_files + 1) * sizeof(*files));
+			files[nr_files++] = path;
+		} else {
+			free(path);
+		}
+	}
+	closedir(d);
+
+	/* the streams keep their names */
+	qsort(files, nr_files, sizeof(*files), cmp_name);
+	for (i = 0; i < nr_files; i++)
+		add_input(files[i]);
+	free(files);
+
+	for (i = 0; i < nr_dirs; i++) {
+		add_dir(dirs[i]);
+		free(dirs[i]);
+	}
+	free(dirs);
+}
+
+/* ------------------------------------------------------------------
+ * Merging
+ */
+
+static int s_by = BY_AUTO;
+
+static int ev_before(const struct stream *a, const struct stream *b)
+{
+	if (s_by == BY_SEQ) {
+		if (a->ev.seq != b->ev.seq)
+			return a->ev.seq < b->ev.seq;
+	} else {
+		if (a->ev.sec != b->ev.sec)
+			return a->ev.sec < b->ev.sec;
+		if (a->ev.usec != b->ev.usec)
+			return a->ev.usec < b->ev.usec;
+	}
+	return a->idx < b->idx;
+}
+
+static void sift_down(struct stream **heap, int n, int i)
+{
+	struct stream *tmp;
+	int c;
+
+	for (;;) {
+		c = 2 * i + 1;
+		if (c >= n)
+			break;
+		if (c + 1 < n && ev_before(heap[c + 1], heap[c]))
+			c++;
+		if (!ev_before(heap[c], heap[i]))
+			break;
+		tmp = heap[i];
+		heap[i] = heap[c];
+		heap[c] = tmp;
+		i = c;
+	}
+}
+
+static void close_stream(struct stream *s)
+{
+	if (s->gz)
+		gzclose(s->gz);
+	if (s->ct && --s->ct->users == 0) {
+		close(s->ct->fd);
+		free(s->ct->chunks);
+		free(s->ct);
+	}
+	s->gz = NULL;
+	s->ct = NULL;
+	s->chunks = NULL;
+	s->fd = -1;
+	free(s->blk[0].data);
+	free(s->blk[1].data);
+	free(s->line);
+	free(s->ev.text);
+	free(s->zbuf);
+	s->blk[0].data = s->blk[1].data = s->line = s->ev.text = NULL;
+	s->zbuf = NULL;
+}
+
+struct output {
+	FILE *f;
+	gzFile gz;
+	uint32_t tid;               /* of the last event written */
+};
+
+static void out_write(struct output *o, const char *buf, size_t len)
+{
+	if (o->gz)
+		gzwrite(o->gz, buf, (unsigned)len);
+	else
+		fwrite(buf, 1, len, o->f);
+}
+
+/* the stream's current event, after a marker if it's another thread's */
+static void out_event(struct output *o, const struct stream *s)
+{
+	char marker[64];
+	int len;
+
+	if (s->ev.tid && s->ev.tid != o->tid) {
+		o->tid = s->ev.tid;
+		len = snprintf(marker, sizeof(marker),
+			       "0.0:LOG:TID:%u:\n", o->tid);
+		out_write(o, marker, len);
+	}
+	out_write(o, s->ev.text, s->ev.len);
+}
+
+static void more_files(void)
+{
+	struct rlimit rl;
+
+	/* a file per thread, all open at once */
+	if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+		rl.rlim_cur = rl.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &rl);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	pthread_t threads[MAX_WORKERS];
+	const char *outname = NULL;
+	struct stream **heap, *s;
+	struct output out = { stdout, NULL, 0 };
+	int nworkers, n, i, c, numbered = 0, unnumbered = 0;
+	struct stat sb;
+
+	nworkers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	while ((c = getopt(argc, argv, "o:stj:b:")) != -1) {
+		switch (c) {
+		case 'o':
+			outname = optarg;
+			break;
+		case 's':
+			s_by = BY_SEQ;
+			break;
+		case 't':
+			s_by = BY_TIME;
+			break;
+		case 'j':
+			nworkers = atoi(optarg);
+			break;
+		case 'b':
+			s_block_sz = (size_t)atoi(optarg) * 1024;
+			break;
+		default:
+			goto usage;
+		}
+	}
+	if (optind >= argc)
+		goto usage;
+	if (nworkers < 1)
+		nworkers = 1;
+	if (nworkers > MAX_WORKERS)
+		nworkers = MAX_WORKERS;
+	if (s_block_sz < 4096)
+		s_block_sz = 4096;
+
+	more_files();
+	for (i = optind; i < argc; i++) {
+		if (stat(argv[i], &sb) == 0 && S_ISDIR(sb.st_mode)) {
+			add_dir(argv[i]);
+		} else {
+			add_input(argv[i]);
+		}
+	}
+	if (!s_nr_streams) {
+		fprintf(stderr, "no logs\n");
+		return 1;
+	}
+
+	if (outname) {
+		n = strlen(outname);
+		if (n > 3 && strcmp(outname + n - 3, ".gz") == 0)
+			out.gz = gzopen(outname, "wb");
+		else
+			out.f = fopen(outname, "w");
+		if (!out.gz && !out.f) {
+			fprintf(stderr, "%s: %s\n", outname, strerror(errno));
+			return 1;
+		}
+	}
+	if (out.f)
+		setvbuf(out.f, NULL, _IOFBF, 1 << 20);
+
+	s_queue_src = xrealloc(NULL, s_nr_streams * sizeof(*s_queue_src));
+	s_queue_blk = xrealloc(NULL, s_nr_streams * sizeof(*s_queue_blk));
+	for (i = 0; i < nworkers; i++) {
+		if (pthread_create(&threads[i], NULL, worker, NULL) != 0)
+			break;
+	}
+	nworkers = i;
+	if (!nworkers) {
+		fprintf(stderr, "no threads\n");
+		return 1;
+	}
+
+	/* the first block of every stream, and a read-ahead for each */
+	for (i = 0; i < s_nr_streams; i++)
+		request_fill(s_streams[i], &s_streams[i]->blk[0]);
+	heap = xrealloc(NULL, s_nr_streams * sizeof(*heap));
+	n = 0;
+	for (i = 0; i < s_nr_streams; i++) {
+		s = s_streams[i];
+		wait_full(&s->blk[0]);
+		if (!s->blk[0].eof)
+			request_fill(s, &s->blk[1]);
+		/*
+		 * Unstamped events before a stream's first stamped one go
+		 * first whichever way we merge: out they go, and the order is
+		 * chosen on the first stamped event of every stream, as
+		 * merge.py does.
+		 */
+		while (next_event(s) && !s->ev.stamped)
+			out_event(&out, s);
+		if (!s->ev.len) {
+			close_stream(s);
+			continue;
+		}
+		if (s->ev.has_seq)
+			numbered++;
+		else
+			unnumbered++;
+		heap[n++] = s;
+	}
+	if (s_by == BY_AUTO)
+		s_by = (numbered && !unnumbered) ? BY_SEQ : BY_TIME;
+	for (i = n / 2 - 1; i >= 0; i--)
+		sift_down(heap, n, i);
+
+	while (n) {
+		s = heap[0];
+		out_event(&out, s);
+		if (!next_event(s)) {
+			close_stream(s);
+			heap[0] = heap[--n];
+		}
+		sift_down(heap, n, 0);
+	}
+
+	pthread_mutex_lock(&s_lock);
+	s_quit = 1;
+	pthread_cond_broadcast(&s_work);
+	pthread_mutex_unlock(&s_lock);
+	for (i = 0; i < nworkers; i++)
+		pthread_join(threads[i], NULL);
+	free(heap);
+	free(s_queue_src);
+	free(s_queue_blk);
+
+	if (out.gz)
+		return gzclose(out.gz) == Z_OK ? 0 : 1;
+	if (fflush(out.f) != 0)
+		return 1;
+	return 0;
+
+usage:
+	fprintf(stderr, "usage: %s [-o out[.gz]] [-s | -t] [-j threads] "
+		"[-b block KB] TRACE-DIR|LOG...\n", argv[0]);
+	return 1;
+}
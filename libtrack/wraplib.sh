@@ -43,6 +43,15 @@ LIBTYPE=
 LIBPATH=
 OUTDIR=.
 USE_NDK=
+PERCPU_LOG=
+FLIGHT_RECORDER=
+RAW_STACK=
+CCT=
+CALLER_ONLY=
+EAGER_INIT=
+OVERHEAD=
+EVENT_SEQ=
+SHARED_RT=
 SYMFILE=
 NAMFILE=
 
@@ -56,6 +65,15 @@ function usage() {
 	echo -e "                          [--type {elf|macho}]"
 	echo -e "                          [--out path/to/output/dir]"
 	echo -e "                          [--use-ndk]"
+	echo -e "                          [--percpu-log]"
+	echo -e "                          [--flight-recorder]"
+	echo -e "                          [--raw-stack]"
+	echo -e "                          [--cct]"
+	echo -e "                          [--caller-only]"
+	echo -e "                          [--eager-init]"
+	echo -e "                          [--overhead]"
+	echo -e "                          [--event-seq]"
+	echo -e "                          [--shared-runtime]"
 	echo -e ""
 	echo -e "\t--wrap-all                      Wrap (trace) all functions in the library"
 	echo -e "\t--wrap-specific symfile          Wrap symbols specified in symfile"
@@ -71,6 +89,16 @@ function usage() {
 	echo -e "\t--out output/dir                Directory to put output C wrappers (defaults to .)"
 	echo -e ""
 	echo -e "\t--use-ndk                       Use ndk for your build"
+	echo -e ""
+	echo -e "\t--percpu-log                    Log through per-CPU buffers instead of per-thread buffers"
+	echo -e "\t--flight-recorder               Keep events in per-thread rings, only written out on a trigger"
+	echo -e "\t--raw-stack                     Log raw stack snapshots, to be unwound offline"
+	echo -e "\t--cct                           Keep a per-thread calling-context tree instead of logging backtraces"
+	echo -e "\t--caller-only                   Log only the module (and offset) of the caller instead of backtraces"
+	echo -e "\t--eager-init                    Resolve all wrapped functions and prefault buffers when the library is loaded"
+	echo -e "\t--overhead                      Account for the tracer's own time, and log it as LOG:OVERHEAD records\n\t                                (and hold it to the budget in throttle.conf, if any)"
+	echo -e "\t--event-seq                     Number every event from one counter shared by all traced processes\n\t                                (see include/wrap_seq.h)"
+	echo -e "\t--shared-runtime                Build the tracer once, as libtrack_rt.so, for all the wrapped libraries\n\t                                (one context, cache and log per thread: see include/wrap_rt.h)"
 
     echo -e ""
 	echo -e "Environment variables:"
@@ -139,6 +167,42 @@ while [[ ! -z "$1" ]]; do
 			USE_NDK=1
 			shift
 			;;
+		--percpu-log )
+			PERCPU_LOG=1
+			shift
+			;;
+		--flight-recorder )
+			FLIGHT_RECORDER=1
+			shift
+			;;
+		--raw-stack )
+			RAW_STACK=1
+			shift
+			;;
+		--cct )
+			CCT=1
+			shift
+			;;
+		--caller-only )
+			CALLER_ONLY=1
+			shift
+			;;
+		--eager-init )
+			EAGER_INIT=1
+			shift
+			;;
+		--overhead )
+			OVERHEAD=1
+			shift
+			;;
+		--event-seq )
+			EVENT_SEQ=1
+			shift
+			;;
+		--shared-runtime )
+			SHARED_RT=1
+			shift
+			;;
 		--out )
 			OUTDIR=$2
 			shift
@@ -151,6 +215,21 @@ while [[ ! -z "$1" ]]; do
 	esac
 done
 
+if [ ! -z "${PERCPU_LOG}" -a ! -z "${FLIGHT_RECORDER}" ]; then
+	echo "E: --percpu-log and --flight-recorder can't be used together"
+	usage
+fi
+
+if [ ! -z "${RAW_STACK}" -a ! -z "${CCT}" ]; then
+	echo "E: --raw-stack and --cct can't be used together"
+	usage
+fi
+
+if [ ! -z "${CALLER_ONLY}" ] && [ ! -z "${RAW_STACK}" -o ! -z "${CCT}" ]; then
+	echo "E: --caller-only can't be used with --raw-stack or --cct"
+	usage
+fi
+
 if [ "$ARCH" = "x86" ]; then
     if [ ! -f "${CDIR}/scripts/write_gnu_wrappers.sh" ];  then
         echo "E: Missing \"write_gnu_wrappers.sh\" script"
@@ -391,6 +470,117 @@ function write_sym() {
 }
 
 
+#
+# -D flags of the optional features (see usage), one per line
+#
+function __feature_cflags() {
+	[ -z "${PERCPU_LOG}" ] || echo "-DHAVE_PERCPU_LOG"
+	[ -z "${FLIGHT_RECORDER}" ] || echo "-DHAVE_FLIGHT_RECORDER"
+	[ -z "${RAW_STACK}" ] || echo "-DHAVE_RAW_STACK"
+	[ -z "${CCT}" ] || echo "-DHAVE_CCT"
+	[ -z "${CALLER_ONLY}" ] || echo "-DHAVE_CALLER_ONLY"
+	[ -z "${EAGER_INIT}" ] || echo "-DHAVE_EAGER_INIT"
+	[ -z "${OVERHEAD}" ] || echo "-DHAVE_OVERHEAD"
+	[ -z "${EVENT_SEQ}" ] || echo "-DHAVE_EVENT_SEQ"
+}
+
+#
+# With --shared-runtime: the tracer itself, built once for all the
+# wrapped libraries (see include/wrap_rt.h). It handles the special libc
+# functions, so it's built as if for libc.
+#
+RT_DIR=
+function __setup_runtime() {
+	local linebreak=" \\"
+	local dir="$1"
+
+	if [ "${RT_DIR}" = "${dir}" ]; then
+		return
+	fi
+	RT_DIR="${dir}"
+	echo -e "\tcreating tracer runtime project in '${dir}'..."
+
+	local c_flags=$(cat <<-__EOF
+-fPIC -O3 $linebreak
+        -DHAVE_ARM_TLS_REGISTER $linebreak
+        -DANDROID_SMP=1 $linebreak
+        -fno-stack-protector $linebreak
+        -Werror $linebreak
+        -DLIBNAME=libc.so -D_IBNAM_=_ibc_so $linebreak
+        -DWRAP_RT_CORE $linebreak
+        -DHAVE_WRAP_SPECIAL $linebreak
+        -DCRT_LEGACY_WORKAROUND $linebreak
+        -DPTHREAD_DEBUG -DPTHREAD_DEBUG_ENABLED=0
+__EOF
+)
+	for f in $(__feature_cflags); do
+		c_flags=$(cat <<-__EOF
+$c_flags $linebreak
+        $f
+__EOF
+)
+	done
+	local src_files=$(cat <<-__EOF
+        platform/${ARCH}/crtbegin_so.c $linebreak
+$(ls -1 "${CDIR}/src" | awk '{print "\t\t" $0 " \\"}')
+        platform/${ARCH}/libc_wrappers.c $linebreak
+        platform/${ARCH}/\$(TARGET_ARCH)/crtend_so.S
+__EOF
+)
+	# libc comes from the wrapped libc, which loads us
+	local mk=$(cat -<<__EOF
+LOCAL_PATH := \$(call my-dir)
+include \$(CLEAR_VARS)
+LOCAL_CFLAGS := ${c_flags}
+LOCAL_CONLYFLAGS := -std=gnu99
+LOCAL_CPPFLAGS := -std=c++0x
+LOCAL_SRC_FILES := ${src_files}
+LOCAL_ARM_MODE := arm
+LOCAL_MODULE:= libtrack_rt
+LOCAL_ADDITIONAL_DEPENDENCIES := \$(LOCAL_PATH)/Android.mk
+LOCAL_SHARED_LIBRARIES := libdl
+LOCAL_STATIC_LIBRARIES := libstdc++ libstlport_static
+LOCAL_ALLOW_UNDEFINED_SYMBOLS := true
+__EOF
+)
+	if [ ! -z "$USE_NDK" ]; then
+		mk=$(cat -<<__EOF
+$mk
+LOCAL_CFLAGS += -I\$(LOCAL_PATH)/platform/${ARCH}/\$(TARGET_ARCH)/include $linebreak
+        -I\$(LOCAL_PATH)/arch/\$(TARGET_ARCH)/include $linebreak
+        -DUSE_NDK=1
+LOCAL_LDFLAGS += -nostdlib $linebreak
+        -Wl,-nostdlib -Wl,-ldl
+include \$(BUILD_SHARED_LIBRARY)
+\$(LOCAL_BUILT_MODULE): TARGET_LDLIBS :=
+\$(LOCAL_BUILT_MODULE): TARGET_LDFLAGS :=
+__EOF
+)
+	else
+		mk=$(cat -<<__EOF
+$mk
+LOCAL_C_INCLUDES := \$(LOCAL_PATH)/platform/${ARCH}/\$(TARGET_ARCH)/include $linebreak
+        \$(LOCAL_PATH)/arch/\$(TARGET_ARCH)/include $linebreak
+        external/stlport/stlport $linebreak
+        bionic $linebreak
+        bionic/libstdc++/include
+LOCAL_ASFLAGS += -fPIC $linebreak
+        -I\$(LOCAL_PATH)/arch/\$(TARGET_ARCH)/include $linebreak
+        -I\$(LOCAL_PATH)/platform/${ARCH}/\$(TARGET_ARCH)/include
+LOCAL_NO_CRT := true
+include \$(BUILD_SHARED_LIBRARY)
+__EOF
+)
+	fi
+
+	mkdir -p "$dir" 2>/dev/null
+	find "${CDIR}/src" -type f -exec ln -s "{}" "${dir}" \; 2>/dev/null
+	find "${CDIR}/include" -type f -exec ln -s "{}" "${dir}" \; 2>/dev/null
+	ln -s "${CDIR}/arch" "${dir}" 2>/dev/null
+	ln -s "${CDIR}/platform" "${dir}" 2>/dev/null
+	echo -e "${mk}" > "${dir}/Android.mk"
+}
+
 #
 # Start the output file
 #
@@ -452,6 +642,13 @@ __EOF
 )
     fi
 	fi
+	for f in $(__feature_cflags); do
+		c_flags=$(cat <<-__EOF
+$c_flags $linebreak
+        $f
+__EOF
+)
+	done
 	if [ "${ARCH}" = "arm" -o "${ARCH}" = "armv7" ]; then
 		ic_flags=$(cat <<-__EOF
 $c_flags $linebreak
@@ -477,6 +674,31 @@ __EOF
 )
 	fi
 
+	# With a shared runtime, this library only keeps its glue
+	# (see include/wrap_rt.h)
+	local rt_libs=
+	if [ ! -z "${SHARED_RT}" ]; then
+		local init_file=libother_init.cpp
+		if [ "${LIB}" = "libc.so" ]; then
+			init_file=libc_init.cpp
+		fi
+		src_files=$(cat <<-__EOF
+        platform/${ARCH}/crtbegin_so.c $linebreak
+        $(basename "$asm") $linebreak
+        wrap_lib.c $linebreak
+        platform/${ARCH}/${init_file} $linebreak
+        platform/${ARCH}/\$(TARGET_ARCH)/crtend_so.S
+__EOF
+)
+		c_flags=$(cat <<-__EOF
+$c_flags $linebreak
+        -DWRAP_RT_GLUE
+__EOF
+)
+		rt_libs=" libtrack_rt"
+		__setup_runtime "${OUTDIR}/libtrack_rt"
+	fi
+
 	# We have a special wrapper return handling function
 	# on ARM Android that we hook in here
 	if [ "${ARCH}" = "arm" ]; then
@@ -520,7 +742,7 @@ LOCAL_ARM_MODE := arm
 LOCAL_MODULE:= ${module_name}
 LOCAL_ADDITIONAL_DEPENDENCIES := \$(LOCAL_PATH)/Android.mk
 LOCAL_LDFLAGS := -L\$(LOCAL_PATH) \$(LOCAL_PATH)/${LIBPFX}${LIB} -Wl,-soname=$LIB
-LOCAL_SHARED_LIBRARIES := libdl
+LOCAL_SHARED_LIBRARIES := libdl${rt_libs}
 LOCAL_STATIC_LIBRARIES := libstdc++ libstlport_static
 LOCAL_WHOLE_STATIC_LIBRARIES :=
 LOCAL_SYSTEM_SHARED_LIBRARIES :=